@@ -0,0 +1,238 @@
+/*
+******************************************************************
+* ASBenchmark.cpp
+*******************************************************************
+* Implements all methods from ASBenchmark.h
+*******************************************************************
+*/
+
+#include "ASBenchmark.h"
+
+/*
+*******************************************************************
+* Constructor
+*******************************************************************
+*/
+
+ASBenchmark::ASBenchmark()
+{}
+
+/*
+*******************************************************************
+* Empty Constructor
+*******************************************************************
+*/
+
+ASBenchmark::ASBenchmark(const ASBenchmark&)
+{}
+
+/*
+*******************************************************************
+* Destructor
+*******************************************************************
+*/
+
+ASBenchmark::~ASBenchmark()
+{}
+
+/*
+*******************************************************************
+* METHOD: Init
+*******************************************************************
+* Starts a new run
+*
+* @param int - the frames the run is expected to last, room for
+*              them is made up front so recording does not allocate
+*/
+
+void ASBenchmark::Init(int numFrames)
+{
+	m_frames.clear();
+	m_notes.clear();
+	if(numFrames > 0)
+		m_frames.reserve(numFrames);
+}
+
+/*
+*******************************************************************
+* METHOD: Add Frame
+*******************************************************************
+* @param ASFrame - what a frame of the run cost and drew
+*/
+
+void ASBenchmark::AddFrame(const ASFrame& frame)
+{
+	m_frames.push_back(frame);
+}
+
+/*
+*******************************************************************
+* METHOD: Add Note
+*******************************************************************
+* @param const string& - lines to write after the summary, such as
+*                        what else was measured during the run
+*/
+
+void ASBenchmark::AddNote(const string& note)
+{
+	m_notes += note;
+}
+
+/*
+*******************************************************************
+* METHOD: Write CSV
+*******************************************************************
+* Writes every frame of the run to a CSV file, replacing the last
+* run's
+*
+* @param const char* - the file to write
+*
+* @return bool - True if the file was written, else false
+*/
+
+bool ASBenchmark::WriteCSV(const char* filename)
+{
+	ofstream fout;
+
+	fout.open(filename, ios::out | ios::trunc);
+	if(fout.fail())
+		return false;
+
+	fout << "frame,cpu_ms,cull_ms,nodes_visited,leaves_drawn,triangles_drawn,draw_calls" << endl;
+	for(unsigned int i = 0; i < m_frames.size(); i++)
+	{
+		const ASFrame& f = m_frames[i];
+
+		fout << f.frame << "," << f.cpuMs << "," << f.cullMs << "," << f.nodesVisited << "," << f.leavesDrawn << ","
+			 << f.trianglesDrawn << "," << f.drawCalls << "\n";
+	}
+
+	fout.close();
+	return !fout.fail();
+}
+
+/*
+*******************************************************************
+* METHOD: Summarise
+*******************************************************************
+* Writes the frame and culling time percentiles and what an average
+* frame drew, then any notes
+*
+* @param ostream& - where to write the summary
+*/
+
+void ASBenchmark::Summarise(ostream& out)
+{
+	vector<double> cpuMs, cullMs;
+	double nodes = 0.0, leaves = 0.0, triangles = 0.0, draws = 0.0;
+
+	if(m_frames.empty())
+	{
+		out << "  no frames" << endl;
+		return;
+	}
+
+	cpuMs.reserve(m_frames.size());
+	cullMs.reserve(m_frames.size());
+	for(unsigned int i = 0; i < m_frames.size(); i++)
+	{
+		cpuMs.push_back(m_frames[i].cpuMs);
+		cullMs.push_back(m_frames[i].cullMs);
+
+		nodes     += m_frames[i].nodesVisited;
+		leaves    += m_frames[i].leavesDrawn;
+		triangles += m_frames[i].trianglesDrawn;
+		draws     += m_frames[i].drawCalls;
+	}
+
+	SummariseTimes(out, "CPU frame", cpuMs);
+	SummariseTimes(out, "culling", cullMs);
+
+	double frames = (double)m_frames.size();
+	out << "  a frame visited " << (nodes / frames) << " nodes and drew " << (leaves / frames) << " leaves, "
+		<< (triangles / frames) << " triangles in " << (draws / frames) << " draw calls" << endl;
+	out << m_notes;
+}
+
+/*
+*******************************************************************
+* METHOD: Report
+*******************************************************************
+* Appends a summary of the run to ./log/benchmark.txt
+*
+* @param const char* - a label for this report
+*/
+
+void ASBenchmark::Report(const char* label)
+{
+	ofstream fout;
+
+	fout.open("./log/benchmark.txt", ios::app);
+	if(fout.fail())
+		return;
+
+	fout << "Benchmark " << label << ": " << m_frames.size() << " frames" << endl;
+	Summarise(fout);
+
+	fout.close();
+}
+
+/*
+*******************************************************************
+* METHOD: Get Frames
+*******************************************************************
+* @return const vector<ASFrame>& - every frame of the run so far
+*/
+
+const vector<ASBenchmark::ASFrame>& ASBenchmark::GetFrames()
+{
+	return m_frames;
+}
+
+/*
+*******************************************************************
+* METHOD: Percentile
+*******************************************************************
+* Nearest rank percentile, the smallest value at least p percent of
+* the values are no greater than
+*
+* @param const vector<double>& - the values, sorted
+* @param double                - the percentile, 0 to 100
+*
+* @return double - the value at that percentile, 0 if there are none
+*/
+
+double ASBenchmark::Percentile(const vector<double>& sorted, double p)
+{
+	if(sorted.empty())
+		return 0.0;
+
+	int rank = (int)ceil((p / 100.0) * sorted.size());
+	if(rank < 1)
+		rank = 1;
+	if(rank > (int)sorted.size())
+		rank = (int)sorted.size();
+
+	return sorted[rank - 1];
+}
+
+/*
+*******************************************************************
+* METHOD: Summarise Times
+*******************************************************************
+* @param ostream&        - where to write the line
+* @param const char*     - what was timed
+* @param vector<double>& - the times in ms, sorted in place
+*/
+
+void ASBenchmark::SummariseTimes(ostream& out, const char* name, vector<double>& ms)
+{
+	double total = 0.0;
+
+	for(unsigned int i = 0; i < ms.size(); i++)
+		total += ms[i];
+	sort(ms.begin(), ms.end());
+
+	out << "  " << name << " ms: mean " << (total / ms.size()) << ", p50 " << Percentile(ms, 50.0) << ", p95 "
+		<< Percentile(ms, 95.0) << ", p99 " << Percentile(ms, 99.0) << ", max " << ms.back() << endl;
+}
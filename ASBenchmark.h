@@ -0,0 +1,76 @@
+/*
+******************************************************************
+* ASBenchmark.h
+*******************************************************************
+* Collects what every frame of a benchmark run cost on the CPU and
+* what it culled and drew, then writes each frame to a CSV file and
+* a summary of the run.  Frame and culling times are summarised by
+* percentile as well as by mean, a run with a few bad frames has a
+* poor p99 even when its mean looks fine
+*******************************************************************
+*/
+
+#ifndef _ASBENCHMARK_H_
+#define _ASBENCHMARK_H_
+
+/*
+*******************************************************************
+* Includes:
+*******************************************************************
+*/
+
+#include <math.h>
+#include <vector>
+#include <algorithm>
+#include <fstream>
+#include <string>
+
+using namespace std;
+
+/*
+*******************************************************************
+* Class declaration
+*******************************************************************
+*/
+
+class ASBenchmark
+{
+public:
+	struct ASFrame
+	{
+		int    frame;
+		double cpuMs;			// the whole frame on the render thread
+		float  cullMs;
+		int    nodesVisited;
+		int    leavesDrawn;
+		int    trianglesDrawn;
+		int    drawCalls;
+	};
+
+public:
+	// Constructors and destructor
+	ASBenchmark();
+	ASBenchmark(const ASBenchmark&);
+	~ASBenchmark();
+
+	// Public methods
+	void Init(int);
+	void AddFrame(const ASFrame&);
+	void AddNote(const string&);
+	bool WriteCSV(const char*);
+	void Summarise(ostream&);
+	void Report(const char*);
+
+	const vector<ASFrame>& GetFrames();
+
+	static double Percentile(const vector<double>&, double);
+
+private:
+	void SummariseTimes(ostream&, const char*, vector<double>&);
+
+	// Private member variables
+	vector<ASFrame> m_frames;
+	string          m_notes;		// written after the summary
+};
+
+#endif
@@ -1,4 +1,3 @@
-
 /*
 ******************************************************************
 * ASCPUMonitor.cpp
@@ -8,6 +7,133 @@
 */
 
 #include "ASCPUMonitor.h"
+#include <algorithm>
+
+/*
+******************************************************************
+* Registered threads
+******************************************************************
+* Threads register before the monitor may exist, so the list is
+* kept here rather than in the monitor
+*/
+
+struct ASRegisteredThread
+{
+	const char* name;
+	double      registered;		// ASClock seconds
+	long long   startNs;		// its CPU time then
+	double      exited;			// ASClock seconds, 0 while it runs
+	long long   endNs;			// its CPU time then
+#ifdef _WIN32
+	HANDLE      handle;
+	DWORD       id;
+#elif defined(__linux__)
+	long        tid;
+#endif
+};
+
+static mutex                      s_threadLock;
+static vector<ASRegisteredThread> s_threads;
+
+// Seconds between samples
+static const double SAMPLE_SECONDS = 1.0;
+
+// Threads there is room for up front, so one that registers later does not allocate
+static const int THREADS_RESERVED = 64;
+
+#if !defined(_WIN32) && defined(__linux__)
+// Room for /proc/stat up to the last core's line
+static const int PROC_STAT_BYTES = 1 << 16;
+
+/*
+******************************************************************
+* Read Proc File
+******************************************************************
+* Reads a file under /proc with read() rather than a stream, so a
+* sample does not allocate
+*
+* @param const char* - the file
+* @param char*       - filled with as much of it as fits, null terminated
+* @param int         - the size of the buffer
+* @return int - bytes read, or -1 if the file cannot be opened
+*/
+
+static int ReadProcFile(const char* path, char* buffer, int size)
+{
+	int total = 0;
+	int got;
+
+	int file = open(path, O_RDONLY);
+	if(file < 0)
+		return -1;
+
+	while(total < size - 1 && (got = (int)read(file, buffer + total, size - 1 - total)) > 0)
+		total += got;
+	close(file);
+
+	buffer[total] = 0;
+	return total;
+}
+#endif
+
+/*
+******************************************************************
+* Read Thread Time
+******************************************************************
+* The CPU time a thread has used, in user and kernel mode
+*
+* @return long long - nanoseconds, or -1 if it cannot be read
+*/
+
+static long long ReadThreadTime(const ASRegisteredThread& thread)
+{
+#ifdef _WIN32
+	FILETIME created, exited, kernel, user;
+
+	if(!GetThreadTimes(thread.handle, &created, &exited, &kernel, &user))
+		return -1;
+
+	// FILETIMEs count 100 ns intervals
+	long long kernelTime = ((long long)kernel.dwHighDateTime << 32) | kernel.dwLowDateTime;
+	long long userTime   = ((long long)user.dwHighDateTime << 32) | user.dwLowDateTime;
+	return (kernelTime + userTime) * 100;
+#elif defined(__linux__)
+	char  path[64];
+	char  line[1024];
+	char* end;
+
+	snprintf(path, sizeof(path), "/proc/self/task/%ld/stat", thread.tid);
+	if(ReadProcFile(path, line, sizeof(line)) <= 0)
+		return -1;
+
+	// The name in brackets may hold spaces, the fields are counted from the
+	// bracket that closes it: state is field 3, utime 14 and stime 15
+	const char* field = strrchr(line, ')');
+	if(!field)
+		return -1;
+
+	field++;
+	for(int i = 3; i < 14; i++)
+	{
+		while(*field == ' ')
+			field++;
+		while(*field != ' ' && *field != 0)
+			field++;
+	}
+
+	long long utime = strtoll(field, &end, 10);
+	if(end == field)
+		return -1;
+	field = end;
+	long long stime = strtoll(field, &end, 10);
+	if(end == field)
+		return -1;
+
+	return (utime + stime) * (1000000000 / sysconf(_SC_CLK_TCK));
+#else
+	return -1;
+#endif
+}
 
 /*
 ******************************************************************
@@ -16,7 +142,12 @@
 */
 
 ASCPUMonitor::ASCPUMonitor()
-{}
+{
+	m_canReadCPU     = false;
+	m_lastSampleTime = 0.0;
+	m_sampledSeconds = 0.0;
+	m_cpuUsage       = 0;
+}
 
 /*
 ******************************************************************
@@ -24,12 +155,12 @@ ASCPUMonitor::ASCPUMonitor()
 ******************************************************************
 */
 
-ASCPUMonitor::ASCPUMonitor(const ASCPUMonitor& cpuMonitor) 
+ASCPUMonitor::ASCPUMonitor(const ASCPUMonitor&)
 {}
 
 /*
 ******************************************************************
-* ASEngine destructor 
+* ASEngine destructor
 ******************************************************************
 */
 
@@ -38,63 +169,95 @@ ASCPUMonitor::~ASCPUMonitor()
 
 /*
 ******************************************************************
-* METHOD: Init 
+* METHOD: Init
 ******************************************************************
-* Initialise the CPU Monitor, this method sets up the handle which
-* is used to query the CPU on its total usage.  This is a combined
-* CPU usage, and not individual units on the system.  If a handle
-* can't be acquired then the cpu usage returned will always be 0%
+* Initialise the CPU Monitor, this method sets up the handles which
+* are used to query the CPU on its total usage and the usage of
+* each core, then takes the first sample that the next is measured
+* from.  If the counters can't be read then the cpu usage returned
+* will always be 0%
 */
 
 void ASCPUMonitor::Init()
 {
+	m_cpuUsage       = 0;
+	m_sampledSeconds = 0.0;
+	m_coreUsage.clear();
+	m_coreBusySeconds.clear();
+	m_threads.clear();
+	m_threads.reserve(THREADS_RESERVED);
+
+#ifdef _WIN32
 	PDH_STATUS status;
 
 	// Initialse the CPU flag to true by default - this will be set
 	// to false if a handle cannot be acquired
 	m_canReadCPU = true;
 
-	// Check if a handle can be acquired on the CPU 
+	// Check if a handle can be acquired on the CPU
 	status = PdhOpenQuery(NULL, 0, &m_queryHandle);
 	if(status != ERROR_SUCCESS)
 		m_canReadCPU = false;
 
-	// Query to poll CPU usage of call CPUs in the system
+	// Query to poll CPU usage of all CPUs in the system, and of each one
 	status = PdhAddCounter(m_queryHandle, TEXT("\\Processor(_Total)\\% processor time"), 0, &m_counterHandle);
 	if(status != ERROR_SUCCESS)
 		m_canReadCPU = false;
+	status = PdhAddCounter(m_queryHandle, TEXT("\\Processor(*)\\% processor time"), 0, &m_coreHandle);
+	if(status != ERROR_SUCCESS)
+		m_canReadCPU = false;
+#elif defined(__linux__)
+	m_statBuffer.resize(PROC_STAT_BYTES);
+	m_canReadCPU = ReadProcFile("/proc/stat", &m_statBuffer[0], PROC_STAT_BYTES) > 0;
+	m_lastBusy.clear();
+	m_lastAll.clear();
+#else
+	// No counters to read here
+	m_canReadCPU = false;
+#endif
 
-	// Keep updating the sample time on each tick 
-	m_lastSampleTime = GetTickCount();
-	m_cpuUsage = 0;
+	// The first sample only sets where the next is measured from
+	m_lastSampleTime = ASClock::GetSeconds();
+	SampleCores(0.0);
+	SampleThreads(0.0);
 }
 
 /*
 ******************************************************************
 * METHOD: UpdateCPUUsage
 ******************************************************************
-* Called each frame to update the total CPU usage, m_lastSampleTime
-* is used to ensure to many queries are not run (this would introduce
+* Called each frame to update the CPU usage, m_lastSampleTime is
+* used to ensure to many queries are not run (this would introduce
 * performance hits) - therefore a sample will only be taken each second
 */
 
 void ASCPUMonitor::UpdateCPUUsage()
 {
-	PDH_FMT_COUNTERVALUE val;
+	if(ASClock::GetSeconds() >= m_lastSampleTime + SAMPLE_SECONDS)
+		Sample();
+}
 
-	// Check if we have access to the CPU
-	if(m_canReadCPU)
-	{
-		if((m_lastSampleTime + 1000) < GetTickCount())
-		{
-			m_lastSampleTime = GetTickCount();
-			PdhCollectQueryData(m_queryHandle);
-			PdhGetFormattedCounterValue(m_counterHandle, PDH_FMT_LONG, NULL, &val);
+/*
+******************************************************************
+* METHOD: Sample
+******************************************************************
+* Measures the cores and threads since the last sample, call it
+* directly to include the time since then before reporting
+*/
 
-			// Update the CPU usage for the current tick
-			m_cpuUsage = val.longValue;
-		}
-	}
+void ASCPUMonitor::Sample()
+{
+	double now     = ASClock::GetSeconds();
+	double seconds = now - m_lastSampleTime;
+
+	if(seconds <= 0.0)
+		return;
+
+	m_lastSampleTime  = now;
+	m_sampledSeconds += seconds;
+
+	SampleCores(seconds);
+	SampleThreads(seconds);
 }
 
 /*
@@ -102,31 +265,384 @@ void ASCPUMonitor::UpdateCPUUsage()
 * METHOD: Get CPU Usage
 ******************************************************************
 * Returns the current (%) of CPU usage the application is using
-* 
+*
 * @return int - the total amount of CPU usage to 0.dp
 */
 
 int ASCPUMonitor::GetCPUUsage()
 {
-	int usage;
 	if(m_canReadCPU)
 		return (int)m_cpuUsage;
-	else 
+	else
 		return 0;
 }
 
+/*
+******************************************************************
+* METHOD: Get Core Count
+******************************************************************
+* @return int - the cores the last sample saw, 0 before there was
+*               one or if they can't be read
+*/
+
+int ASCPUMonitor::GetCoreCount()
+{
+	return (int)m_coreUsage.size();
+}
+
+/*
+******************************************************************
+* METHOD: Get Core Usage
+******************************************************************
+* @param int - the core, 0 to GetCoreCount() - 1
+*
+* @return float - how busy the core was over the last sample (%)
+*/
+
+float ASCPUMonitor::GetCoreUsage(int core)
+{
+	if(core < 0 || core >= (int)m_coreUsage.size())
+		return 0.0f;
+
+	return m_coreUsage[core];
+}
+
+/*
+******************************************************************
+* METHOD: Get Thread Usage
+******************************************************************
+* @return const vector<ASThreadUsage>& - every registered thread,
+*                                        in the order they registered
+*/
+
+const vector<ASCPUMonitor::ASThreadUsage>& ASCPUMonitor::GetThreadUsage()
+{
+	return m_threads;
+}
+
+/*
+******************************************************************
+* METHOD: Summarise
+******************************************************************
+* Writes how busy each core was over every sample so far and how
+* much of a core each thread used while it was watched
+*
+* @param ostream& - where to write the summary
+*/
+
+void ASCPUMonitor::Summarise(ostream& out)
+{
+	if(m_sampledSeconds <= 0.0)
+	{
+		out << "  no CPU samples" << endl;
+		return;
+	}
+
+	out << "  " << m_coreBusySeconds.size() << " cores busy over " << m_sampledSeconds << " s (%):";
+	for(unsigned int i = 0; i < m_coreBusySeconds.size(); i++)
+		out << " " << (int)((m_coreBusySeconds[i] * 100.0 / m_sampledSeconds) + 0.5);
+	out << endl;
+
+	for(unsigned int i = 0; i < m_threads.size(); i++)
+	{
+		const ASThreadUsage& thread = m_threads[i];
+		double watched = ((thread.exited > 0.0) ? thread.exited : m_lastSampleTime) - thread.registered;
+
+		out << "  thread " << thread.name << ": " << thread.cpuSeconds << " s of CPU, "
+			<< (int)((watched > 0.0 ? thread.cpuSeconds * 100.0 / watched : 0.0) + 0.5) << "% of a core";
+		if(thread.exited > 0.0)
+			out << " until it exited";
+		out << endl;
+	}
+}
+
+/*
+******************************************************************
+* METHOD: Report
+******************************************************************
+* Appends the summary to ./log/cpu-monitor.txt
+*
+* @param const char* - a label for this report
+*/
+
+void ASCPUMonitor::Report(const char* label)
+{
+	ofstream fout;
+
+	fout.open("./log/cpu-monitor.txt", ios::app);
+	if(fout.fail())
+		return;
+
+	fout << "CPU monitor " << label << ": " << GetCPUUsage() << "% in the last sample" << endl;
+	Summarise(fout);
+
+	fout.close();
+}
+
+/*
+******************************************************************
+* METHOD: Register Thread
+******************************************************************
+* Called by a thread on itself so the monitor watches its CPU time,
+* it may be called before the monitor is made
+*
+* @param const char* - the thread's name, a string literal
+*/
+
+void ASCPUMonitor::RegisterThread(const char* name)
+{
+	ASRegisteredThread thread;
+	thread.name = name;
+
+#ifdef _WIN32
+	// GetCurrentThread() is a pseudo handle that means whichever thread uses
+	// it, so make a real one the monitor can use from its own thread
+	if(!DuplicateHandle(GetCurrentProcess(), GetCurrentThread(), GetCurrentProcess(), &thread.handle,
+						0, FALSE, DUPLICATE_SAME_ACCESS))
+		return;
+	thread.id = GetCurrentThreadId();
+#elif defined(__linux__)
+	thread.tid = (long)syscall(SYS_gettid);
+#endif
+	thread.registered = ASClock::GetSeconds();
+	thread.startNs    = ReadThreadTime(thread);
+	thread.exited     = 0.0;
+	thread.endNs      = -1;
+
+	lock_guard<mutex> guard(s_threadLock);
+	s_threads.push_back(thread);
+}
+
+/*
+******************************************************************
+* METHOD: Unregister Thread
+******************************************************************
+* Called by a registered thread as it ends, its CPU time can't be
+* read once it has gone so it is taken now
+*/
+
+void ASCPUMonitor::UnregisterThread()
+{
+	lock_guard<mutex> guard(s_threadLock);
+
+	for(unsigned int i = 0; i < s_threads.size(); i++)
+	{
+		ASRegisteredThread& thread = s_threads[i];
+#ifdef _WIN32
+		bool isCaller = (thread.id == GetCurrentThreadId());
+#elif defined(__linux__)
+		bool isCaller = (thread.tid == (long)syscall(SYS_gettid));
+#else
+		bool isCaller = false;
+#endif
+		if(isCaller && thread.exited == 0.0)
+		{
+			thread.exited = ASClock::GetSeconds();
+			thread.endNs  = ReadThreadTime(thread);
+		}
+	}
+}
+
 /*
 ******************************************************************
 * METHOD: Release
 ******************************************************************
-* Dispose of any resources held by the CPU monitor
+* Dispose of any resources held by the CPU monitor, the registered
+* threads are forgotten
 */
 
 void ASCPUMonitor::Release()
 {
 	// Release the query handle, only if it is open
+#ifdef _WIN32
 	if(m_canReadCPU)
 	{
 		PdhCloseQuery(m_queryHandle);
 	}
-}
\ No newline at end of file
+#endif
+	m_canReadCPU = false;
+
+	lock_guard<mutex> guard(s_threadLock);
+#ifdef _WIN32
+	for(unsigned int i = 0; i < s_threads.size(); i++)
+		CloseHandle(s_threads[i].handle);
+#endif
+	s_threads.clear();
+	m_threads.clear();
+}
+
+/*
+******************************************************************
+* METHOD: Sample Cores
+******************************************************************
+* Reads how busy the processor and each core has been since the
+* last sample
+*
+* @param double - seconds since the last sample, 0 for the first
+*/
+
+void ASCPUMonitor::SampleCores(double seconds)
+{
+	if(!m_canReadCPU)
+		return;
+
+#ifdef _WIN32
+	PDH_FMT_COUNTERVALUE val;
+	DWORD size  = 0;
+	DWORD count = 0;
+
+	PdhCollectQueryData(m_queryHandle);
+	if(seconds <= 0.0)
+		return;
+
+	// Update the CPU usage for the current tick
+	PdhGetFormattedCounterValue(m_counterHandle, PDH_FMT_LONG, NULL, &val);
+	m_cpuUsage = val.longValue;
+
+	// Each core is an item named by its number, the total is named _Total
+	if(PdhGetFormattedCounterArray(m_coreHandle, PDH_FMT_DOUBLE, &size, &count, NULL) == PDH_MORE_DATA)
+	{
+		m_coreItems.resize(size);
+		PDH_FMT_COUNTERVALUE_ITEM* items = (PDH_FMT_COUNTERVALUE_ITEM*)&m_coreItems[0];
+
+		if(PdhGetFormattedCounterArray(m_coreHandle, PDH_FMT_DOUBLE, &size, &count, items) == ERROR_SUCCESS)
+		{
+			for(DWORD i = 0; i < count; i++)
+			{
+				const TCHAR* name = items[i].szName;
+				int core = 0;
+
+				if(*name < '0' || *name > '9')
+					continue;
+				for(; *name >= '0' && *name <= '9'; name++)
+					core = (core * 10) + (*name - '0');
+
+				if(core >= (int)m_coreUsage.size())
+				{
+					m_coreUsage.resize(core + 1, 0.0f);
+					m_coreBusySeconds.resize(core + 1, 0.0);
+				}
+				m_coreUsage[core] = (float)items[i].FmtValue.doubleValue;
+			}
+		}
+	}
+#elif defined(__linux__)
+	// The lists are kept from one sample to the next so their memory is reused
+	vector<long long>& busy = m_busy;
+	vector<long long>& all  = m_all;
+
+	busy.clear();
+	all.clear();
+	if(ReadProcFile("/proc/stat", &m_statBuffer[0], PROC_STAT_BYTES) <= 0)
+		return;
+
+	// The total comes first as "cpu", then a line for each core as "cpu0", "cpu1" and
+	// so on.  Of user, nice, system, idle, iowait, irq, softirq and steal, idle and
+	// iowait are time spent doing nothing
+	for(const char* line = &m_statBuffer[0]; line && strncmp(line, "cpu", 3) == 0; )
+	{
+		const char* field = line;
+		long long total = 0, idle = 0;
+
+		while(*field != ' ' && *field != 0)
+			field++;
+		for(int i = 0; i < 8; i++)
+		{
+			char* end;
+			long long value = strtoll(field, &end, 10);
+			if(end == field)
+				break;
+			field = end;
+
+			total += value;
+			if(i == 3 || i == 4)
+				idle += value;
+		}
+		busy.push_back(total - idle);
+		all.push_back(total);
+
+		line = strchr(line, '\n');
+		if(line)
+			line++;
+	}
+
+	if(busy.empty())
+		return;
+
+	// Sized by the first sample, in Init(), so later ones do not allocate
+	m_coreUsage.resize(busy.size() - 1, 0.0f);
+	m_coreBusySeconds.resize(busy.size() - 1, 0.0);
+
+	if(busy.size() == m_lastBusy.size() && seconds > 0.0)
+	{
+		for(unsigned int i = 0; i < busy.size(); i++)
+		{
+			long long elapsed = all[i] - m_lastAll[i];
+			float usage = (elapsed > 0) ? (float)((busy[i] - m_lastBusy[i]) * 100.0 / elapsed) : 0.0f;
+
+			if(i == 0)
+				m_cpuUsage = (long)(usage + 0.5f);
+			else
+				m_coreUsage[i - 1] = usage;
+		}
+	}
+
+	m_lastBusy = busy;
+	m_lastAll  = all;
+#endif
+
+	for(unsigned int i = 0; i < m_coreUsage.size(); i++)
+		m_coreBusySeconds[i] += m_coreUsage[i] * seconds / 100.0;
+}
+
+/*
+******************************************************************
+* METHOD: Sample Threads
+******************************************************************
+* Reads the CPU time of each registered thread, a thread that
+* registered since the last sample is measured from when it did
+*
+* @param double - seconds since the last sample, 0 for the first
+*/
+
+void ASCPUMonitor::SampleThreads(double seconds)
+{
+	lock_guard<mutex> guard(s_threadLock);
+
+	for(unsigned int i = 0; i < s_threads.size(); i++)
+	{
+		const ASRegisteredThread& registered = s_threads[i];
+		long long cpuNs = (registered.exited > 0.0) ? registered.endNs : ReadThreadTime(registered);
+
+		if(i >= m_threads.size())
+		{
+			ASThreadUsage thread;
+			thread.name       = registered.name;
+			thread.usage      = 0.0f;
+			thread.cpuSeconds = 0.0;
+			thread.registered = registered.registered;
+			thread.lastCpuNs  = registered.startNs;
+			m_threads.push_back(thread);
+		}
+
+		ASThreadUsage& thread = m_threads[i];
+		double interval = min(seconds, m_lastSampleTime - thread.registered);
+
+		thread.exited = registered.exited;
+		thread.usage  = 0.0f;
+
+		// Start from the first time that could be read
+		if(cpuNs < 0 || thread.lastCpuNs < 0)
+		{
+			thread.lastCpuNs = cpuNs;
+			continue;
+		}
+		if(interval <= 0.0)
+			continue;
+
+		double used = (double)(cpuNs - thread.lastCpuNs) / 1000000000.0;
+		thread.usage       = (float)(used * 100.0 / interval);
+		thread.cpuSeconds += used;
+		thread.lastCpuNs   = cpuNs;
+	}
+}
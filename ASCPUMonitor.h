@@ -1,10 +1,18 @@
-
 /*
 ******************************************************************
 * ASCPUMonitor.h
 *******************************************************************
 * Keeps track of how many resources the CPU is using each second -
-* used to track performance
+* used to track performance.  Once a second it samples how busy
+* each core was and how much CPU time each engine thread used, so
+* a saturated thread shows up even when the total looks fine.
+*
+* Cores are read through PDH on Windows and /proc/stat on Linux.
+* A thread is only watched once it has called RegisterThread() on
+* itself, its time comes from GetThreadTimes() on Windows and from
+* /proc/self/task on Linux.  A thread that ends calls
+* UnregisterThread() so the time it used after the last sample is
+* still counted.  Other platforms report 0%
 *******************************************************************
 */
 
@@ -17,16 +25,37 @@
 ******************************************************************
 */
 
+#ifdef _WIN32
 #pragma comment(lib, "pdh.lib")
+#endif
 
 /*
 ******************************************************************
 * Includes
 ******************************************************************
 * + pdh - Win lib to query CPU usage
+* + ASClock.h - times the samples
 */
 
+#include <vector>
+#include <string>
+#include <fstream>
+#include <sstream>
+#include <mutex>
+#include "ASClock.h"
+
+#ifdef _WIN32
 #include <pdh.h>
+#elif defined(__linux__)
+#include <unistd.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/syscall.h>
+#endif
+
+using namespace std;
 
 /*
 ******************************************************************
@@ -34,8 +63,19 @@
 ******************************************************************
 */
 
-class ASCPUMonitor 
+class ASCPUMonitor
 {
+public:
+	struct ASThreadUsage
+	{
+		const char* name;
+		float       usage;			// % of one core over the last sample
+		double      cpuSeconds;		// CPU time since the thread registered
+		double      registered;		// ASClock seconds when it registered
+		double      exited;			// ASClock seconds when it unregistered, 0 while it runs
+		long long   lastCpuNs;		// CPU time at the last sample, -1 if it could not be read
+	};
+
 public:
 	// Constructors / Destructor prototype
 	ASCPUMonitor();
@@ -46,15 +86,42 @@ public:
 	void Init();
 	void Release();
 	void UpdateCPUUsage();
+	void Sample();
 	int  GetCPUUsage();
+	int  GetCoreCount();
+	float GetCoreUsage(int);
+	const vector<ASThreadUsage>& GetThreadUsage();
+	void Summarise(ostream&);
+	void Report(const char*);
+
+	static void RegisterThread(const char*);
+	static void UnregisterThread();
 
 private:
+	// Private methods
+	void SampleCores(double);
+	void SampleThreads(double);
+
 	// Private members
 	bool		  m_canReadCPU;
+#ifdef _WIN32
 	HQUERY		  m_queryHandle;
 	HCOUNTER	  m_counterHandle;
-	unsigned long m_lastSampleTime;
+	HCOUNTER	  m_coreHandle;		// every core, read as an array
+	vector<unsigned char> m_coreItems;
+#else
+	vector<long long> m_lastBusy;	// jiffies at the last sample, the total first then each core
+	vector<long long> m_lastAll;
+	vector<long long> m_busy;		// this sample's, copied to the above
+	vector<long long> m_all;
+	vector<char>      m_statBuffer;	// /proc/stat is read into this
+#endif
+	double		  m_lastSampleTime;
+	double		  m_sampledSeconds;	// time covered by the samples so far
 	long		  m_cpuUsage;
+	vector<float>  m_coreUsage;		// % busy over the last sample
+	vector<double> m_coreBusySeconds;	// busy time of each core over every sample
+	vector<ASThreadUsage> m_threads;
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -20,8 +20,8 @@
 
 ASCamera::ASCamera() 
 {
-	m_pos = D3DXVECTOR3(0.0f, 0.0f, 0.0f);
-	m_rot = D3DXVECTOR3(0.0f, 0.0f, 0.0f);
+	m_pos = ASVector3(0.0f, 0.0f, 0.0f);
+	m_rot = ASVector3(0.0f, 0.0f, 0.0f);
 }
 
 /*
@@ -30,7 +30,7 @@ ASCamera::ASCamera()
 ******************************************************************
 */
 
-ASCamera::ASCamera(const ASCamera& camera)
+ASCamera::ASCamera(const ASCamera&)
 {}
 
 /*
@@ -84,11 +84,11 @@ void ASCamera::SetRotation(float x, float y, float z)
 ******************************************************************
 * Returns the Camera Position matrix
 *
-* @return D3DXVECTOR3 - the position matrix
+* @return ASVector3 - the position matrix
 ******************************************************************
 */
 
-D3DXVECTOR3 ASCamera::GetPosition()
+ASVector3 ASCamera::GetPosition()
 {
 	return m_pos;
 }
@@ -99,11 +99,11 @@ D3DXVECTOR3 ASCamera::GetPosition()
 ******************************************************************
 * Returns the Cameras Rotation matrix
 *
-* @return D3DXVECTOR3 - The rotation matrix
+* @return ASVector3 - The rotation matrix
 ******************************************************************
 */
 
-D3DXVECTOR3 ASCamera::GetRotation()
+ASVector3 ASCamera::GetRotation()
 {
 	return m_rot;
 }
@@ -119,20 +119,20 @@ D3DXVECTOR3 ASCamera::GetRotation()
 
 void ASCamera::RenderCameraView()
 {
-	D3DXMATRIX cameraRot;
+	ASMatrix cameraRot;
 
 	// Set the "up" vector to point upward
-	D3DXVECTOR3 up = D3DXVECTOR3(0.0f, 
+	ASVector3 up = ASVector3(0.0f, 
 								 1.0f, 
 								 0.0f);
 
 	// Set the cameras position relative to the world
-	D3DXVECTOR3 pos = D3DXVECTOR3(m_pos.x, 
+	ASVector3 pos = ASVector3(m_pos.x, 
 								  m_pos.y, 
 								  m_pos.z);
 
 	// Set the direction the camera is looking at
-	D3DXVECTOR3 eye = D3DXVECTOR3(0.0f,
+	ASVector3 eye = ASVector3(0.0f,
 								  0.0f, 
 								  1.0f);
 
@@ -143,18 +143,18 @@ void ASCamera::RenderCameraView()
 
 	// Set the yaw pitch and roll rotations for the camera, and write it to the output
 	// matrix (cameraRot)
-	D3DXMatrixRotationYawPitchRoll(&cameraRot, yaw, pitch, roll); 
+	ASMatrixRotationYawPitchRoll(&cameraRot, yaw, pitch, roll); 
 
 	// Transform eye by the rotation matrix to get the correct view
-	D3DXVec3TransformCoord(&eye, &eye, &cameraRot);
-	D3DXVec3TransformCoord(&up, &up, &cameraRot);
+	ASVec3TransformCoord(&eye, &eye, &cameraRot);
+	ASVec3TransformCoord(&up, &up, &cameraRot);
 
 	// Translate the rotated camera to the viewer location
 	eye = pos + eye;
 
 	// Create the view matrix by multiplying the cameras eye, pos and up matrices together (this
 	// gives the cameras position relative to the world)
-	D3DXMatrixLookAtLH(&m_cameraView, &pos, &eye, &up);
+	ASMatrixLookAtLH(&m_cameraView, &pos, &eye, &up);
 }
 
 /*
@@ -163,35 +163,20 @@ void ASCamera::RenderCameraView()
 ******************************************************************
 * Return a copy of the current view matrix to an output var
 *
-* @param D3DXMATRIX& - The output variable to write the current view matrix
+* @param ASMatrix&   - The output variable to write the current view matrix
 ******************************************************************
 */
 
-void ASCamera::GetViewMatrix(D3DXMATRIX& view)
+void ASCamera::GetViewMatrix(ASMatrix& view)
 {
 	view = m_cameraView;
 	return;
 }
 
-void ASCamera::GetWorldMatrix(D3DXMATRIX& camWorld)
+void ASCamera::GetWorldMatrix(ASMatrix& camWorld)
 {
-	D3DXMATRIX cameraRot;
-	D3DXMATRIX cameraTrans;
-
-	// Set the "up" vector to point upward
-	D3DXVECTOR3 up = D3DXVECTOR3(0.0f, 
-								 1.0f, 
-								 0.0f);
-
-	// Set the cameras position relative to the world
-	D3DXVECTOR3 pos = D3DXVECTOR3(m_pos.x, 
-								  m_pos.y, 
-								  m_pos.z);
-
-	// Set the direction the camera is looking at
-	D3DXVECTOR3 eye = D3DXVECTOR3(0.0f,
-								  0.0f, 
-								  1.0f);
+	ASMatrix cameraRot;
+	ASMatrix cameraTrans;
 
 	// Set rotation of the camera on its axis in radians
 	float pitch = m_rot.x * 0.0174532925f; // X Axis Rotation
@@ -200,8 +185,8 @@ void ASCamera::GetWorldMatrix(D3DXMATRIX& camWorld)
 
 	// Set the yaw pitch and roll rotations for the camera, and write it to the output
 	// matrix (cameraRot)
-	D3DXMatrixRotationYawPitchRoll(&cameraRot, yaw, pitch, roll); 
-	D3DXMatrixTranslation(&cameraTrans, m_pos.x, m_pos.y, m_pos.z);
+	ASMatrixRotationYawPitchRoll(&cameraRot, yaw, pitch, roll); 
+	ASMatrixTranslation(&cameraTrans, m_pos.x, m_pos.y, m_pos.z);
 
 	camWorld = cameraRot * cameraTrans;
 
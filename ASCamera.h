@@ -5,7 +5,8 @@
 ******************************************************************
 * Tells the GPU the view from which we will draw our scene from.
 * The camera keeps track of what is in its view, and shall also
-* allow players to navigate the world 
+* allow players to navigate the world.  It only uses ASMath, so it
+* builds on any platform
 */
 
 #ifndef _ASCAMERA_H_
@@ -17,7 +18,7 @@
 ******************************************************************
 */
 
-#include <d3dx10math.h>
+#include "ASMath.h"
 
 /*
 ******************************************************************
@@ -38,23 +39,23 @@ public:
 	void SetPosition(float, float, float);
 
 	// Getters to retrieve the rotation and position Matrices
-	D3DXVECTOR3 GetRotation();	
-	D3DXVECTOR3 GetPosition();
+	ASVector3 GetRotation();	
+	ASVector3 GetPosition();
 
 	// Render the view
 	void RenderCameraView();
 
-	// Write the View matrix to a given D3DXMATRIX object
-	void GetViewMatrix(D3DXMATRIX&);
-	void GetWorldMatrix(D3DXMATRIX&);
+	// Write the View matrix to a given ASMatrix object
+	void GetViewMatrix(ASMatrix&);
+	void GetWorldMatrix(ASMatrix&);
 
 private:
 	// X, Y, Z Positions of the projection matrix
-	D3DXVECTOR3 m_pos;
+	ASVector3 m_pos;
 	// X, Y, Z Positions of the rotation matrix
-	D3DXVECTOR3 m_rot;
+	ASVector3 m_rot;
 	//  Matrix to describe what we are looking at (the eye of the camera)
-	D3DXMATRIX m_cameraView;
+	ASMatrix m_cameraView;
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,184 @@
+/*
+******************************************************************
+* ASCameraPath.cpp
+*******************************************************************
+* Implements all methods from ASCameraPath.h
+*******************************************************************
+*/
+
+#include "ASCameraPath.h"
+
+/*
+*******************************************************************
+* Constructor
+*******************************************************************
+*/
+
+ASCameraPath::ASCameraPath()
+{
+	m_segment = 0;
+}
+
+/*
+*******************************************************************
+* Empty Constructor
+*******************************************************************
+*/
+
+ASCameraPath::ASCameraPath(const ASCameraPath&)
+{}
+
+/*
+*******************************************************************
+* Destructor
+*******************************************************************
+*/
+
+ASCameraPath::~ASCameraPath()
+{}
+
+/*
+*******************************************************************
+* METHOD: Init
+*******************************************************************
+* Reads the keys of a path, the file is small so it is read whole
+* and parsed in memory
+*
+* @param const char* - the path file
+*
+* @return bool - True if the file held at least two keys in time
+*                order, else false
+*/
+
+bool ASCameraPath::Init(const char* filename)
+{
+	ifstream     fin;
+	stringstream text;
+	string       data;
+	ASKey        key;
+
+	m_keys.clear();
+	m_segment = 0;
+
+	fin.open(filename, ios::in | ios::binary);
+	if(fin.fail())
+		return false;
+
+	text << fin.rdbuf();
+	data = text.str();
+	fin.close();
+
+	ASTextReader reader(data.c_str(), (unsigned long)data.size());
+
+	while(true)
+	{
+		reader.SkipWhitespace();
+		if(reader.AtEnd())
+			break;
+
+		if(reader.Peek() == '#')
+		{
+			reader.SkipLine();
+			continue;
+		}
+
+		if(!reader.ReadFloat(key.time))
+			return false;
+		for(int i = 0; i < KEY_VALUES; i++)
+		{
+			if(!reader.ReadFloat(key.values[i]))
+				return false;
+		}
+
+		if(!m_keys.empty() && key.time <= m_keys.back().time)
+			return false;
+
+		m_keys.push_back(key);
+	}
+
+	if(m_keys.size() < 2)
+		return false;
+
+	// Time is counted from the first key
+	for(int i = (int)m_keys.size() - 1; i >= 0; i--)
+		m_keys[i].time -= m_keys[0].time;
+
+	return true;
+}
+
+/*
+*******************************************************************
+* METHOD: Sample
+*******************************************************************
+* Finds where the camera is a given time along the path.  Each
+* segment is a cubic Hermite curve between two keys, the tangent at
+* a key is the slope between the keys either side of it scaled to
+* the segment's length, which is Catmull-Rom for evenly spaced keys
+* and keeps the speed smooth across keys that are not.  The end keys
+* use themselves as the missing neighbour
+*
+* @param float     - seconds from the first key, held to the first
+*                    and last keys outside the path
+* @param ASVector3 - set to the camera's position
+* @param ASVector3 - set to the camera's rotation
+*/
+
+void ASCameraPath::Sample(float time, ASVector3& pos, ASVector3& rot)
+{
+	float values[KEY_VALUES];
+	int   last = (int)m_keys.size() - 1;
+
+	if(time <= m_keys[0].time)
+		time = m_keys[0].time;
+	if(time >= m_keys[last].time)
+		time = m_keys[last].time;
+
+	// Paths are flown forwards, so start looking from the segment last used
+	if(m_segment >= last || time < m_keys[m_segment].time)
+		m_segment = 0;
+	while(m_segment < last - 1 && time >= m_keys[m_segment + 1].time)
+		m_segment++;
+
+	const ASKey& k0 = m_keys[(m_segment > 0) ? m_segment - 1 : m_segment];
+	const ASKey& k1 = m_keys[m_segment];
+	const ASKey& k2 = m_keys[m_segment + 1];
+	const ASKey& k3 = m_keys[(m_segment + 2 <= last) ? m_segment + 2 : m_segment + 1];
+
+	float length = k2.time - k1.time;
+	float t      = (time - k1.time) / length;
+	float t2     = t * t;
+	float t3     = t2 * t;
+
+	// Hermite basis
+	float h00 = (2.0f * t3) - (3.0f * t2) + 1.0f;
+	float h10 = t3 - (2.0f * t2) + t;
+	float h01 = (-2.0f * t3) + (3.0f * t2);
+	float h11 = t3 - t2;
+
+	for(int i = 0; i < KEY_VALUES; i++)
+	{
+		float m1 = (k2.values[i] - k0.values[i]) * (length / (k2.time - k0.time));
+		float m2 = (k3.values[i] - k1.values[i]) * (length / (k3.time - k1.time));
+
+		values[i] = (h00 * k1.values[i]) + (h10 * m1) + (h01 * k2.values[i]) + (h11 * m2);
+	}
+
+	pos = ASVector3(values[0], values[1], values[2]);
+	rot = ASVector3(values[3], values[4], values[5]);
+}
+
+/*
+*******************************************************************
+* METHOD: Getters
+*******************************************************************
+*/
+
+float ASCameraPath::GetDuration()
+{
+	return m_keys.empty() ? 0.0f : m_keys.back().time;
+}
+
+int ASCameraPath::GetKeyCount()
+{
+	return (int)m_keys.size();
+}
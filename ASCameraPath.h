@@ -0,0 +1,77 @@
+/*
+******************************************************************
+* ASCameraPath.h
+*******************************************************************
+* A camera path read from a text file, flown by the benchmark so
+* every run draws the same frames.  Each line of the file is a key,
+* the time in seconds it is reached then the camera's position and
+* rotation:
+*
+*     # time  x  y  z  rotX  rotY  rotZ
+*     0       20 30 0  10    45    0
+*
+* Keys must be in time order and time is counted from the first,
+* lines starting with # are comments.  The camera follows a
+* Catmull-Rom spline through the keys, so it passes through every
+* key without stopping or turning sharply at it.  Rotations are
+* splined like positions, so a path that turns full circle should
+* keep counting past 360 rather than wrap
+*******************************************************************
+*/
+
+#ifndef _ASCAMERAPATH_H_
+#define _ASCAMERAPATH_H_
+
+/*
+*******************************************************************
+* Includes:
+*******************************************************************
+* + ASTextReader.h has been included to parse the keys
+* + ASMath.h has been included for the position and rotation given
+*******************************************************************
+*/
+
+#include <vector>
+#include <fstream>
+#include <sstream>
+#include "ASTextReader.h"
+#include "ASMath.h"
+
+using namespace std;
+
+/*
+*******************************************************************
+* Class declaration
+*******************************************************************
+*/
+
+class ASCameraPath
+{
+public:
+	static const int KEY_VALUES = 6;	// x, y, z, rotX, rotY, rotZ
+
+	struct ASKey
+	{
+		float time;
+		float values[KEY_VALUES];
+	};
+
+public:
+	// Constructors and destructor
+	ASCameraPath();
+	ASCameraPath(const ASCameraPath&);
+	~ASCameraPath();
+
+	// Public methods
+	bool  Init(const char*);
+	void  Sample(float, ASVector3&, ASVector3&);
+	float GetDuration();
+	int   GetKeyCount();
+
+private:
+	// Private member variables
+	vector<ASKey> m_keys;
+	int           m_segment;	// the segment last sampled, where the search starts next time
+};
+
+#endif
@@ -0,0 +1,190 @@
+/*
+******************************************************************
+* ASClock.cpp
+*******************************************************************
+* Implements all methods from ASClock.h
+*******************************************************************
+*/
+
+#include "ASClock.h"
+
+/*
+*******************************************************************
+* Counter
+*******************************************************************
+*/
+
+// The raw counter, in the counter's own ticks
+static long long ReadCounter()
+{
+#ifdef _WIN32
+	LARGE_INTEGER now;
+	QueryPerformanceCounter(&now);
+	return now.QuadPart;
+#else
+	timespec now;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return ((long long)now.tv_sec * 1000000000) + now.tv_nsec;
+#endif
+}
+
+// Ticks the counter makes a second
+static long long ReadFrequency()
+{
+#ifdef _WIN32
+	LARGE_INTEGER freq;
+	QueryPerformanceFrequency(&freq);
+	return freq.QuadPart;
+#else
+	return 1000000000;
+#endif
+}
+
+// Read once as the program loads, the frequency is fixed at boot
+static const long long s_frequency = ReadFrequency();
+static const long long s_epoch     = ReadCounter();
+
+/*
+*******************************************************************
+* Constructor
+*******************************************************************
+*/
+
+ASClock::ASClock()
+{
+	Reset();
+}
+
+/*
+*******************************************************************
+* Empty Constructor
+*******************************************************************
+*/
+
+ASClock::ASClock(const ASClock&)
+{}
+
+/*
+*******************************************************************
+* Destructor
+*******************************************************************
+*/
+
+ASClock::~ASClock()
+{}
+
+/*
+*******************************************************************
+* METHOD: Reset
+*******************************************************************
+* Starts counting from now, the next Tick() measures from here
+*/
+
+void ASClock::Reset()
+{
+	m_start  = GetNanoseconds();
+	m_last   = m_start;
+	m_delta  = 0.0;
+	m_frames = 0;
+}
+
+/*
+*******************************************************************
+* METHOD: Tick
+*******************************************************************
+* Called once a frame
+*
+* @return double - seconds since the last Tick() or Reset()
+*/
+
+double ASClock::Tick()
+{
+	long long now = GetNanoseconds();
+
+	m_delta = (double)(now - m_last) / 1000000000.0;
+	m_last  = now;
+	m_frames++;
+
+	return m_delta;
+}
+
+/*
+*******************************************************************
+* METHOD: Get Delta
+*******************************************************************
+* @return double - seconds the last Tick() measured
+*/
+
+double ASClock::GetDelta()
+{
+	return m_delta;
+}
+
+/*
+*******************************************************************
+* METHOD: Get Elapsed
+*******************************************************************
+* @return double - seconds since Reset()
+*/
+
+double ASClock::GetElapsed()
+{
+	return (double)(GetNanoseconds() - m_start) / 1000000000.0;
+}
+
+/*
+*******************************************************************
+* METHOD: Get Frame Count
+*******************************************************************
+* @return unsigned long long - calls to Tick() since Reset()
+*/
+
+unsigned long long ASClock::GetFrameCount()
+{
+	return m_frames;
+}
+
+/*
+*******************************************************************
+* METHOD: Get Nanoseconds
+*******************************************************************
+* The counter is split into whole seconds and the remainder before
+* it is scaled, so the multiply cannot overflow
+*
+* @return long long - nanoseconds since the program started, never
+*                     less than the last call returned
+*/
+
+long long ASClock::GetNanoseconds()
+{
+	long long ticks = ReadCounter() - s_epoch;
+
+	if(s_frequency == 1000000000)
+		return ticks;
+
+	return ((ticks / s_frequency) * 1000000000) + (((ticks % s_frequency) * 1000000000) / s_frequency);
+}
+
+/*
+*******************************************************************
+* METHOD: Get Seconds
+*******************************************************************
+* @return double - seconds since the program started
+*/
+
+double ASClock::GetSeconds()
+{
+	return (double)GetNanoseconds() / 1000000000.0;
+}
+
+/*
+*******************************************************************
+* METHOD: Get Milliseconds
+*******************************************************************
+* @return double - milliseconds since the program started
+*/
+
+double ASClock::GetMilliseconds()
+{
+	return (double)GetNanoseconds() / 1000000.0;
+}
@@ -0,0 +1,66 @@
+/*
+******************************************************************
+* ASClock.h
+*******************************************************************
+* The engine's clock.  Every time in the engine is read from the
+* same monotonic counter, the performance counter on Windows and
+* CLOCK_MONOTONIC elsewhere, as whole nanoseconds since the process
+* started.  Counting from the start rather than from boot keeps the
+* numbers small, so a time held in a double stays accurate to well
+* under a microsecond however long the session runs.
+*
+* The static methods read the time.  An ASClock object measures the
+* time between calls to Tick(), once a frame, and the time since
+* it was Reset()
+*******************************************************************
+*/
+
+#ifndef _ASCLOCK_H_
+#define _ASCLOCK_H_
+
+/*
+*******************************************************************
+* Includes:
+*******************************************************************
+*/
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+/*
+*******************************************************************
+* Class declaration
+*******************************************************************
+*/
+
+class ASClock
+{
+public:
+	// Constructors and destructor
+	ASClock();
+	ASClock(const ASClock&);
+	~ASClock();
+
+	// Public methods
+	void   Reset();
+	double Tick();
+	double GetDelta();
+	double GetElapsed();
+	unsigned long long GetFrameCount();
+
+	static long long GetNanoseconds();
+	static double    GetSeconds();
+	static double    GetMilliseconds();
+
+private:
+	// Private member variables
+	long long          m_start;		// ns when Reset() was called
+	long long          m_last;		// ns of the last Tick()
+	double             m_delta;		// seconds between the last two ticks
+	unsigned long long m_frames;	// calls to Tick() since Reset()
+};
+
+#endif
@@ -125,7 +125,6 @@ bool ASColorShader::InitShader(ID3D11Device* device, HWND handle, WCHAR* vsFile,
 
 	ID3D10Blob* err;
 	ID3D10Blob* vsBuffer;
-	ID3D10Blob* psBuffer;
 
 	D3D11_BUFFER_DESC mBufferDesc;
 	D3D11_INPUT_ELEMENT_DESC polyLayout[2];
@@ -133,8 +132,7 @@ bool ASColorShader::InitShader(ID3D11Device* device, HWND handle, WCHAR* vsFile,
 
 	// Compile shaders into buffers - any errors are caught and pushed to an error stack, if the 
 	// file is not found user is alerted by a popup message
-	hr = D3DX11CompileFromFile(vsFile, NULL, NULL, "ColorVertexShader", "vs_5_0", D3D10_SHADER_ENABLE_STRICTNESS, 
-							   0, NULL, &vsBuffer, &err, NULL);
+	hr = ASResourceManager::GetInstance()->AcquireVertexShader(device, vsFile, "ColorVertexShader", &m_vShader, &vsBuffer, &err);
 	if(FAILED(hr))
 	{
 		if(err)
@@ -145,8 +143,7 @@ bool ASColorShader::InitShader(ID3D11Device* device, HWND handle, WCHAR* vsFile,
 	}
 
 	// Compile the pixel shader
-	hr = D3DX11CompileFromFile(psFile, NULL, NULL, "ColorPixelShader", "ps_5_0", D3D10_SHADER_ENABLE_STRICTNESS,
-							  0, NULL, &psBuffer, &err, NULL);
+	hr = ASResourceManager::GetInstance()->AcquirePixelShader(device, psFile, "ColorPixelShader", &m_pShader, &err);
 	if(FAILED(hr))
 	{
 		if(err)
@@ -156,15 +153,6 @@ bool ASColorShader::InitShader(ID3D11Device* device, HWND handle, WCHAR* vsFile,
 		return false;
 	}
 
-	// Create shader objects from the pixel and vertex buffers. These pointers will be used to interact with the 
-	// vertex and pixel shaders
-	hr = device->CreateVertexShader(vsBuffer->GetBufferPointer(), vsBuffer->GetBufferSize(), NULL, &m_vShader);
-	if(FAILED(hr))
-		return false;
-	hr = device->CreatePixelShader(psBuffer->GetBufferPointer(), psBuffer->GetBufferSize(), NULL, &m_pShader);
-	if(FAILED(hr))
-		return false;
-
 	// Create the input layout of the vertex data. We define how far apart in memory vertex and pixel data sit,
 	// in this case every 12 bytes are position and every 16 bytes after that will be color - this tells the GPU
 	// the structure of the input, so it knows to process vertex information for 12 byes and then color information 
@@ -194,9 +182,7 @@ bool ASColorShader::InitShader(ID3D11Device* device, HWND handle, WCHAR* vsFile,
 
 	// Release the buffers and set null pointers to them as we have loaded the data into pointers
 	vsBuffer->Release();
-	psBuffer->Release();
 	vsBuffer = 0;
-	psBuffer = 0;
 
 	// Describe the constant buffer to pass to the Vertex Shader - the CB is used to talk directly to the shader
 	mBufferDesc.Usage = D3D11_USAGE_DYNAMIC;
@@ -0,0 +1,497 @@
+/*
+******************************************************************
+* ASDDSFile.cpp
+*******************************************************************
+* Implements all methods from ASDDSFile.h
+*******************************************************************
+*/
+
+#include "ASDDSFile.h"
+
+/*
+*******************************************************************
+* Constructor
+*******************************************************************
+*/
+
+ASDDSFile::ASDDSFile()
+{
+	m_format     = DXGI_FORMAT_UNKNOWN;
+	m_unitBytes  = 0;
+	m_compressed = false;
+	m_numMips    = 0;
+	m_arraySize  = 0;
+	m_sliceBytes = 0;
+}
+
+/*
+*******************************************************************
+* Empty Constructor
+*******************************************************************
+*/
+
+ASDDSFile::ASDDSFile(const ASDDSFile&)
+{}
+
+/*
+*******************************************************************
+* Destructor
+*******************************************************************
+* The mapped file is released by ASFileMap's destructor
+*/
+
+ASDDSFile::~ASDDSFile()
+{}
+
+/*
+*******************************************************************
+* METHOD: Init
+*******************************************************************
+* Maps a .dds file, checks its header and lays out where each mip
+* level lives.  Nothing is copied unless levels have to be built
+*
+* @param const char* - the .dds file to read
+*
+* @return bool - True if the file can be used, else false
+*/
+
+bool ASDDSFile::Init(const char* filename)
+{
+	AS_PROFILE("ASDDSFile::Init");
+
+	if(!m_file.Init(filename))
+		return false;
+
+	const unsigned char* data = (const unsigned char*)m_file.GetData();
+	unsigned long size        = m_file.GetSize();
+	unsigned long offset      = sizeof(unsigned int) + sizeof(ASHeader);
+
+	if(size < offset || *(const unsigned int*)data != DDS_MAGIC)
+	{
+		Release();
+		return false;
+	}
+
+	const ASHeader* header = (const ASHeader*)(data + sizeof(unsigned int));
+	if(header->size != sizeof(ASHeader) || header->pixelFormat.size != sizeof(ASPixelFormat) ||
+	   header->width == 0 || header->height == 0 || (header->caps2 & (DDSCAPS2_CUBEMAP | DDSCAPS2_VOLUME)))
+	{
+		Release();
+		return false;
+	}
+
+	// Files written for D3D10 and later carry the format in an extra header
+	m_arraySize = 1;
+	if((header->pixelFormat.flags & DDPF_FOURCC) && header->pixelFormat.fourCC == DDS_FOURCC_DX10)
+	{
+		if(size < offset + sizeof(ASHeaderDX10))
+		{
+			Release();
+			return false;
+		}
+
+		const ASHeaderDX10* dx10 = (const ASHeaderDX10*)(data + offset);
+		if(dx10->resourceDimension != DX10_DIMENSION_2D || dx10->arraySize == 0)
+		{
+			Release();
+			return false;
+		}
+
+		m_format    = (DXGI_FORMAT)dx10->dxgiFormat;
+		m_arraySize = dx10->arraySize;
+		offset  += sizeof(ASHeaderDX10);
+	}
+	else
+	{
+		m_format = GetLegacyFormat(header->pixelFormat);
+	}
+
+	if(!GetFormatInfo(m_format, m_unitBytes, m_compressed))
+	{
+		Release();
+		return false;
+	}
+
+	// Work out how many levels a full chain has and how many the file holds
+	int fullChain = 1;
+	for(unsigned int dim = max(header->width, header->height); dim > 1; dim >>= 1)
+		fullChain++;
+	fullChain = min(fullChain, (int)MAX_MIPS);
+
+	int fileMips = 1;
+	if((header->flags & DDSD_MIPMAPCOUNT) && header->mipMapCount > 0)
+		fileMips = min((int)header->mipMapCount, fullChain);
+
+	// Lay out the levels of the first slice, they follow each other with no padding and
+	// every other slice repeats the same layout straight after
+	unsigned int width  = header->width;
+	unsigned int height = header->height;
+
+	m_sliceBytes = 0;
+	for(m_numMips = 0; m_numMips < fileMips; m_numMips++)
+	{
+		LayoutMip(m_mips[m_numMips], width, height, data + offset + m_sliceBytes);
+
+		m_sliceBytes += m_mips[m_numMips].size;
+		width         = max(width >> 1, 1u);
+		height        = max(height >> 1, 1u);
+	}
+
+	if((unsigned long long)offset + ((unsigned long long)m_sliceBytes * m_arraySize) > size)
+	{
+		Release();
+		return false;
+	}
+
+	// Build the rest of the chain for single uncompressed textures, so they can be streamed too
+	if(m_numMips < fullChain && !m_compressed && m_arraySize == 1)
+		GenerateMips(fullChain);
+
+	return true;
+}
+
+/*
+*******************************************************************
+* METHOD: Release
+*******************************************************************
+* Unmaps the file, the pointers returned by GetMipData() are no
+* longer valid after this
+*/
+
+void ASDDSFile::Release()
+{
+	m_file.Release();
+	m_generated.clear();
+	m_numMips    = 0;
+	m_arraySize  = 0;
+	m_sliceBytes = 0;
+	m_format     = DXGI_FORMAT_UNKNOWN;
+}
+
+/*
+*******************************************************************
+* Getters for the whole texture
+*******************************************************************
+*/
+
+unsigned int ASDDSFile::GetWidth()
+{
+	return m_mips[0].width;
+}
+
+unsigned int ASDDSFile::GetHeight()
+{
+	return m_mips[0].height;
+}
+
+int ASDDSFile::GetMipCount()
+{
+	return m_numMips;
+}
+
+// The number of slices in a texture array, 1 for a plain texture
+int ASDDSFile::GetArraySize()
+{
+	return m_arraySize;
+}
+
+DXGI_FORMAT ASDDSFile::GetFormat()
+{
+	return m_format;
+}
+
+/*
+*******************************************************************
+* Getters for one mip level, 0 is the full size level
+*******************************************************************
+*/
+
+const void* ASDDSFile::GetMipData(int mip)
+{
+	return m_mips[mip].data;
+}
+
+unsigned int ASDDSFile::GetMipWidth(int mip)
+{
+	return m_mips[mip].width;
+}
+
+unsigned int ASDDSFile::GetMipHeight(int mip)
+{
+	return m_mips[mip].height;
+}
+
+unsigned int ASDDSFile::GetMipPitch(int mip)
+{
+	return m_mips[mip].pitch;
+}
+
+unsigned int ASDDSFile::GetMipSize(int mip)
+{
+	return m_mips[mip].size;
+}
+
+// Slice 0 is the same as GetMipData(), every slice has the same size levels
+const void* ASDDSFile::GetSliceData(int slice, int mip)
+{
+	return m_mips[mip].data + ((unsigned long long)m_sliceBytes * slice);
+}
+
+/*
+*******************************************************************
+* METHOD: Get Format Info
+*******************************************************************
+* Describes the formats this reader can stream
+*
+* @param DXGI_FORMAT   - the format
+* @param unsigned int& - output for bytes per pixel, or per 4x4 block when compressed
+* @param bool&         - output, True if the format is block compressed
+*
+* @return bool - True if the format is supported, else false
+*/
+
+bool ASDDSFile::GetFormatInfo(DXGI_FORMAT format, unsigned int& unitBytes, bool& compressed)
+{
+	switch(format)
+	{
+	case DXGI_FORMAT_BC1_UNORM:
+	case DXGI_FORMAT_BC4_UNORM:
+		unitBytes  = 8;
+		compressed = true;
+		return true;
+	case DXGI_FORMAT_BC2_UNORM:
+	case DXGI_FORMAT_BC3_UNORM:
+	case DXGI_FORMAT_BC5_UNORM:
+		unitBytes  = 16;
+		compressed = true;
+		return true;
+	case DXGI_FORMAT_R8G8B8A8_UNORM:
+	case DXGI_FORMAT_B8G8R8A8_UNORM:
+	case DXGI_FORMAT_B8G8R8X8_UNORM:
+		unitBytes  = 4;
+		compressed = false;
+		return true;
+	default:
+		return false;
+	}
+}
+
+/*
+*******************************************************************
+* METHOD: Write
+*******************************************************************
+* Writes a texture or texture array as a .dds file with the DX10
+* header.  The data is every level of slice 0 from the largest
+* down, then every level of slice 1 and so on, the same order
+* D3D11 numbers subresources in
+*
+* @param const char*  - the file to write
+* @param DXGI_FORMAT  - the format of the data, one GetFormatInfo() supports
+* @param unsigned int - the width of level 0
+* @param unsigned int - the height of level 0
+* @param int          - the number of mip levels in each slice
+* @param int          - the number of slices
+* @param const void*  - the data of every level of every slice
+*
+* @return bool - True if the whole file was written, else false
+*/
+
+bool ASDDSFile::Write(const char* filename, DXGI_FORMAT format, unsigned int width, unsigned int height,
+					  int numMips, int arraySize, const void* data)
+{
+	ASHeader           header;
+	ASHeaderDX10       dx10;
+	ofstream           fout;
+	unsigned int       unitBytes;
+	bool               compressed;
+	unsigned long long sliceBytes = 0;
+
+	if(!GetFormatInfo(format, unitBytes, compressed) || width == 0 || height == 0 ||
+	   numMips <= 0 || numMips > MAX_MIPS || arraySize <= 0)
+		return false;
+
+	for(int i = 0; i < numMips; i++)
+	{
+		unsigned int w = max(width >> i, 1u);
+		unsigned int h = max(height >> i, 1u);
+
+		if(compressed)
+			sliceBytes += (unsigned long long)max(1u, (w + 3) / 4) * max(1u, (h + 3) / 4) * unitBytes;
+		else
+			sliceBytes += (unsigned long long)w * h * unitBytes;
+	}
+
+	memset(&header, 0, sizeof(header));
+	header.size               = sizeof(ASHeader);
+	header.flags              = DDSD_REQUIRED | DDSD_MIPMAPCOUNT | (compressed ? 0 : DDSD_PITCH);
+	header.width              = width;
+	header.height             = height;
+	header.pitchOrLinearSize  = compressed ? 0 : width * unitBytes;
+	header.mipMapCount        = numMips;
+	header.pixelFormat.size   = sizeof(ASPixelFormat);
+	header.pixelFormat.flags  = DDPF_FOURCC;
+	header.pixelFormat.fourCC = DDS_FOURCC_DX10;
+	header.caps               = DDSCAPS_TEXTURE | (numMips > 1 ? DDSCAPS_MIPMAP | DDSCAPS_COMPLEX : 0);
+
+	memset(&dx10, 0, sizeof(dx10));
+	dx10.dxgiFormat        = format;
+	dx10.resourceDimension = DX10_DIMENSION_2D;
+	dx10.arraySize         = arraySize;
+
+	fout.open(filename, ios::out | ios::binary | ios::trunc);
+	if(fout.fail())
+		return false;
+
+	unsigned int magic = DDS_MAGIC;
+	fout.write((const char*)&magic, sizeof(magic));
+	fout.write((const char*)&header, sizeof(header));
+	fout.write((const char*)&dx10, sizeof(dx10));
+	fout.write((const char*)data, sliceBytes * arraySize);
+
+	bool success = !fout.fail();
+	fout.close();
+
+	// Never leave a half written texture behind
+	if(!success)
+		DeleteFileA(filename);
+
+	return success;
+}
+
+/*
+*******************************************************************
+* METHOD: Get Legacy Format
+*******************************************************************
+* Maps the pixel format of a file without the DX10 header onto a
+* DXGI format
+*
+* @param const ASPixelFormat& - the pixel format from the header
+*
+* @return DXGI_FORMAT - the format, DXGI_FORMAT_UNKNOWN if it is not supported
+*/
+
+DXGI_FORMAT ASDDSFile::GetLegacyFormat(const ASPixelFormat& pf)
+{
+	if(pf.flags & DDPF_FOURCC)
+	{
+		switch(pf.fourCC)
+		{
+		case 0x31545844:	// "DXT1"
+			return DXGI_FORMAT_BC1_UNORM;
+		case 0x32545844:	// "DXT2"
+		case 0x33545844:	// "DXT3"
+			return DXGI_FORMAT_BC2_UNORM;
+		case 0x34545844:	// "DXT4"
+		case 0x35545844:	// "DXT5"
+			return DXGI_FORMAT_BC3_UNORM;
+		case 0x31495441:	// "ATI1"
+		case 0x55344342:	// "BC4U"
+			return DXGI_FORMAT_BC4_UNORM;
+		case 0x32495441:	// "ATI2"
+		case 0x55354342:	// "BC5U"
+			return DXGI_FORMAT_BC5_UNORM;
+		default:
+			return DXGI_FORMAT_UNKNOWN;
+		}
+	}
+
+	if((pf.flags & DDPF_RGB) && pf.rgbBitCount == 32)
+	{
+		bool hasAlpha = (pf.flags & DDPF_ALPHAPIXELS) && pf.aBitMask == 0xff000000;
+
+		if(pf.rBitMask == 0x000000ff && pf.gBitMask == 0x0000ff00 && pf.bBitMask == 0x00ff0000)
+			return DXGI_FORMAT_R8G8B8A8_UNORM;
+		if(pf.rBitMask == 0x00ff0000 && pf.gBitMask == 0x0000ff00 && pf.bBitMask == 0x000000ff)
+			return hasAlpha ? DXGI_FORMAT_B8G8R8A8_UNORM : DXGI_FORMAT_B8G8R8X8_UNORM;
+	}
+
+	return DXGI_FORMAT_UNKNOWN;
+}
+
+/*
+*******************************************************************
+* METHOD: Layout Mip
+*******************************************************************
+* Fills in the size and pitch of a mip level of the given size
+*
+* @param ASMip&               - the level to fill in
+* @param unsigned int         - the width of the level in pixels
+* @param unsigned int         - the height of the level in pixels
+* @param const unsigned char* - the level's data
+*/
+
+void ASDDSFile::LayoutMip(ASMip& mip, unsigned int width, unsigned int height, const unsigned char* data)
+{
+	mip.data   = data;
+	mip.width  = width;
+	mip.height = height;
+
+	if(m_compressed)
+	{
+		mip.pitch = max(1u, (width + 3) / 4) * m_unitBytes;
+		mip.size  = mip.pitch * max(1u, (height + 3) / 4);
+	}
+	else
+	{
+		mip.pitch = width * m_unitBytes;
+		mip.size  = mip.pitch * height;
+	}
+}
+
+/*
+*******************************************************************
+* METHOD: Generate Mips
+*******************************************************************
+* Builds the levels a 32 bit file is missing, each one is a 2x2 box
+* filter of the level above.  Odd sizes repeat their last row or
+* column.  The byte order of the channels does not matter as every
+* channel is filtered the same way
+*
+* @param int - the number of levels in the full chain
+*/
+
+void ASDDSFile::GenerateMips(int fullChain)
+{
+	unsigned int total = 0;
+	int mip;
+
+	// Size the storage first so the pointers into it stay valid
+	unsigned int width  = max(m_mips[m_numMips - 1].width  >> 1, 1u);
+	unsigned int height = max(m_mips[m_numMips - 1].height >> 1, 1u);
+	for(mip = m_numMips; mip < fullChain; mip++)
+	{
+		total += width * height * m_unitBytes;
+		width  = max(width >> 1, 1u);
+		height = max(height >> 1, 1u);
+	}
+	m_generated.resize(total);
+
+	unsigned char* dest = &m_generated[0];
+	for(mip = m_numMips; mip < fullChain; mip++)
+	{
+		const ASMip& src = m_mips[mip - 1];
+		ASMip& dst       = m_mips[mip];
+
+		LayoutMip(dst, max(src.width >> 1, 1u), max(src.height >> 1, 1u), dest);
+
+		for(unsigned int y = 0; y < dst.height; y++)
+		{
+			const unsigned char* row0 = src.data + (min(y * 2,     src.height - 1) * src.pitch);
+			const unsigned char* row1 = src.data + (min(y * 2 + 1, src.height - 1) * src.pitch);
+			unsigned char* out        = dest + (y * dst.pitch);
+
+			for(unsigned int x = 0; x < dst.width; x++)
+			{
+				unsigned int x0 = min(x * 2,     src.width - 1) * 4;
+				unsigned int x1 = min(x * 2 + 1, src.width - 1) * 4;
+
+				for(int c = 0; c < 4; c++)
+					out[(x * 4) + c] = (unsigned char)((row0[x0 + c] + row0[x1 + c] + row1[x0 + c] + row1[x1 + c] + 2) / 4);
+			}
+		}
+
+		dest += dst.size;
+	}
+
+	m_numMips = fullChain;
+}
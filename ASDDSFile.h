@@ -0,0 +1,157 @@
+/*
+******************************************************************
+* ASDDSFile.h
+*******************************************************************
+* Reads a .dds texture without D3DX.  The file is mapped and its
+* header parsed so the data of each mip level can be handed to the
+* GPU straight out of the mapping, one level at a time.
+*
+* Supported are 2D textures and texture arrays in BC1-BC5 and 32
+* bit RGBA/BGRA, with either the legacy header or the DX10
+* extension.  A single 32 bit texture without a full mip chain has
+* the missing levels built once on load with a box filter, arrays
+* and compressed files use the levels they have.  Write() produces
+* the files this class reads, see ASTextureBaker
+*******************************************************************
+*/
+
+#ifndef _ASDDSFILE_H_
+#define _ASDDSFILE_H_
+
+/*
+*******************************************************************
+* Includes:
+*******************************************************************
+* + ASFileMap.h has been included to read the file in place
+* + ASProfiler.h has been included to time loading
+*******************************************************************
+*/
+
+#include <d3d11.h>
+#include <vector>
+#include <fstream>
+#include <string.h>
+#include "ASFileMap.h"
+#include "ASProfiler.h"
+
+using namespace std;
+
+/*
+*******************************************************************
+* Class declaration
+*******************************************************************
+*/
+
+class ASDDSFile
+{
+public:
+	static const int MAX_MIPS = 16;
+
+private:
+	// Flags and layouts from the DDS file format
+	static const unsigned int DDS_MAGIC          = 0x20534444;	// "DDS "
+	static const unsigned int DDS_FOURCC_DX10    = 0x30315844;	// "DX10"
+	static const unsigned int DDSD_REQUIRED      = 0x1007;		// caps, height, width and pixel format
+	static const unsigned int DDSD_PITCH         = 0x8;
+	static const unsigned int DDSD_MIPMAPCOUNT   = 0x20000;
+	static const unsigned int DDSCAPS_COMPLEX    = 0x8;
+	static const unsigned int DDSCAPS_TEXTURE    = 0x1000;
+	static const unsigned int DDSCAPS_MIPMAP     = 0x400000;
+	static const unsigned int DDPF_ALPHAPIXELS   = 0x1;
+	static const unsigned int DDPF_FOURCC        = 0x4;
+	static const unsigned int DDPF_RGB           = 0x40;
+	static const unsigned int DDSCAPS2_CUBEMAP   = 0x200;
+	static const unsigned int DDSCAPS2_VOLUME    = 0x200000;
+	static const unsigned int DX10_DIMENSION_2D  = 3;
+
+	struct ASPixelFormat
+	{
+		unsigned int size;
+		unsigned int flags;
+		unsigned int fourCC;
+		unsigned int rgbBitCount;
+		unsigned int rBitMask;
+		unsigned int gBitMask;
+		unsigned int bBitMask;
+		unsigned int aBitMask;
+	};
+	struct ASHeader
+	{
+		unsigned int  size;
+		unsigned int  flags;
+		unsigned int  height;
+		unsigned int  width;
+		unsigned int  pitchOrLinearSize;
+		unsigned int  depth;
+		unsigned int  mipMapCount;
+		unsigned int  reserved1[11];
+		ASPixelFormat pixelFormat;
+		unsigned int  caps;
+		unsigned int  caps2;
+		unsigned int  caps3;
+		unsigned int  caps4;
+		unsigned int  reserved2;
+	};
+	struct ASHeaderDX10
+	{
+		unsigned int dxgiFormat;
+		unsigned int resourceDimension;
+		unsigned int miscFlag;
+		unsigned int arraySize;
+		unsigned int miscFlags2;
+	};
+	// Where one mip level's data lives
+	struct ASMip
+	{
+		const unsigned char* data;
+		unsigned int         width;
+		unsigned int         height;
+		unsigned int         pitch;		// bytes per row, or per row of 4x4 blocks
+		unsigned int         size;
+	};
+
+public:
+	// Constructors and destructor
+	ASDDSFile();
+	ASDDSFile(const ASDDSFile&);
+	~ASDDSFile();
+
+	// Public methods
+	bool Init(const char*);
+	void Release();
+
+	unsigned int GetWidth();
+	unsigned int GetHeight();
+	int          GetMipCount();
+	int          GetArraySize();
+	DXGI_FORMAT  GetFormat();
+
+	const void*  GetMipData(int);
+	unsigned int GetMipWidth(int);
+	unsigned int GetMipHeight(int);
+	unsigned int GetMipPitch(int);
+	unsigned int GetMipSize(int);
+	const void*  GetSliceData(int, int);
+
+	static bool GetFormatInfo(DXGI_FORMAT, unsigned int&, bool&);
+	static bool Write(const char*, DXGI_FORMAT, unsigned int, unsigned int, int, int, const void*);
+
+private:
+	// Private methods
+	DXGI_FORMAT GetLegacyFormat(const ASPixelFormat&);
+	void        LayoutMip(ASMip&, unsigned int, unsigned int, const unsigned char*);
+	void        GenerateMips(int);
+
+	// Private member variables
+	ASFileMap             m_file;
+	DXGI_FORMAT           m_format;
+	unsigned int          m_unitBytes;		// bytes per pixel, or per 4x4 block when compressed
+	bool                  m_compressed;
+	int                   m_numMips;
+	int                   m_arraySize;
+	unsigned int          m_sliceBytes;		// bytes from one array slice to the next
+	ASMip                 m_mips[MAX_MIPS];	// the levels of slice 0
+	vector<unsigned char> m_generated;		// levels built on load, the rest are read from the file
+};
+
+#endif
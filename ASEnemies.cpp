@@ -18,8 +18,18 @@
 
 ASEnemies::ASEnemies()
 {
-	m_enemyInfoList = 0;
-	m_numEnemies = 0;
+	m_enemyInfoList  = 0;
+	m_posX           = 0;
+	m_posY           = 0;
+	m_posZ           = 0;
+	m_visible        = 0;
+	m_numEnemies     = 0;
+	m_instanceBuffer = 0;
+	m_instances      = 0;
+	m_enemyLods      = 0;
+	m_scale          = 1.0f;
+	m_numVisible     = 0;
+	m_nearestDistance = FLT_MAX;
 }
 
 /*
@@ -44,7 +54,9 @@ ASEnemies::~ASEnemies()
 *******************************************************************
 * METHOD: Init 
 *******************************************************************
-* Initialise the ASEnemies object
+* Initialise the ASEnemies object.  The enemies are scattered over
+* an area that grows with their number, so a larger crowd keeps the
+* same density as the original 30
 */
 
 bool ASEnemies::Init(int numEnemies)
@@ -52,13 +64,17 @@ bool ASEnemies::Init(int numEnemies)
 	float r;
 	float g;
 	float b;
+	float spread = 10.0f * sqrtf((float)numEnemies / 30.0f);
 
 	// store the number of models
 	m_numEnemies = numEnemies;
 
 	// Create a list of the menemy info
 	m_enemyInfoList = new ASEnemyInfo[m_numEnemies];
-	if(!m_enemyInfoList)
+	m_posX          = new float[m_numEnemies];
+	m_posY          = new float[m_numEnemies];
+	m_posZ          = new float[m_numEnemies];
+	if(!m_enemyInfoList || !m_posX || !m_posY || !m_posZ)
 		return false;
 
 	// Randomly generate the position of each enemy in the scene
@@ -72,9 +88,9 @@ bool ASEnemies::Init(int numEnemies)
 		m_enemyInfoList[i].color = D3DXVECTOR4(r, g, b, 1.0f);
 
 		// Generate a random position for the enemy to appear in the world
-		m_enemyInfoList[i].posX = (((float)rand()-(float)rand())/RAND_MAX) * 10.0f;
-		m_enemyInfoList[i].posY = (((float)rand()-(float)rand())/RAND_MAX) * 10.0f;
-		m_enemyInfoList[i].posZ = ((((float)rand()-(float)rand())/RAND_MAX) * 10.0f) + 5.0f;
+		m_posX[i] = (((float)rand()-(float)rand())/RAND_MAX) * spread;
+		m_posY[i] = (((float)rand()-(float)rand())/RAND_MAX) * 10.0f;
+		m_posZ[i] = ((((float)rand()-(float)rand())/RAND_MAX) * spread) + 5.0f;
 	}
 
 	return true;
@@ -103,13 +119,287 @@ int ASEnemies::GetEnemyCount()
 
 void ASEnemies::GetData(int index, float& posX, float& posY, float& posZ, D3DXVECTOR4& color)
 {
-	posX = m_enemyInfoList[index].posX;
-	posY = m_enemyInfoList[index].posY;
-	posZ = m_enemyInfoList[index].posZ;
+	posX = m_posX[index];
+	posY = m_posY[index];
+	posZ = m_posZ[index];
 
 	color = m_enemyInfoList[index].color;
 }
 
+/*
+*******************************************************************
+* METHOD: Set Position
+*******************************************************************
+* Moves an enemy, used to stand the enemies on the terrain
+*/
+
+void ASEnemies::SetPosition(int index, float posX, float posY, float posZ)
+{
+	m_posX[index] = posX;
+	m_posY[index] = posY;
+	m_posZ[index] = posZ;
+}
+
+/*
+*******************************************************************
+* METHOD: Init Instancing
+*******************************************************************
+* Creates the dynamic instance buffer, it is large enough for every
+* enemy to be visible at once so it never needs to grow
+*
+* @param ID3D11Device* - the device we are rendering with
+* @param float         - the scale the enemy model is drawn at
+*
+* @return bool - True if the buffer was created, else false
+*/
+
+bool ASEnemies::InitInstancing(ID3D11Device* device, float scale)
+{
+	D3D11_BUFFER_DESC desc;
+	HRESULT hr;
+
+	m_scale = scale;
+
+	// The CPU rewrites the buffer every frame, so it is dynamic and write only
+	desc.Usage               = D3D11_USAGE_DYNAMIC;
+	desc.ByteWidth           = sizeof(ASInstance) * m_numEnemies;
+	desc.BindFlags           = D3D11_BIND_VERTEX_BUFFER;
+	desc.CPUAccessFlags      = D3D11_CPU_ACCESS_WRITE;
+	desc.MiscFlags           = 0;
+	desc.StructureByteStride = 0;
+
+	hr = device->CreateBuffer(&desc, NULL, &m_instanceBuffer);
+	if(FAILED(hr))
+		return false;
+
+	return true;
+}
+
+/*
+*******************************************************************
+* METHOD: Prepare Instances
+*******************************************************************
+* Culls every enemy's bounding sphere against the frustum in one
+* batch, picks a level of detail for each one that survives and
+* packs their world matrices and colours into m_instances grouped
+* by level of detail.  The grouping is a counting sort so the cost
+* is two passes over the visible enemies.  Every list is taken from
+* ASFrameArena, so m_instances is only sized for the enemies in view
+* and is valid until the frame ends
+*
+* @param ASFrustrum* - the frustum for this frame
+* @param ASModel*    - the model the enemies are drawn with
+* @param D3DXVECTOR3 - the position of the camera
+* @param float       - pixels per unit at a distance of one unit
+*
+* @return int - the number of visible enemies
+*/
+
+int ASEnemies::PrepareInstances(ASFrustrum* frustum, ASModel* model, D3DXVECTOR3 camPos, float projScale)
+{
+	AS_PROFILE("ASEnemies::PrepareInstances");
+
+	ASFrameArena* arena = ASFrameArena::GetInstance();
+	D3DXVECTOR3 center = model->GetBoundingCenter() * m_scale;
+	float radius  = model->GetBoundingRadius() * m_scale;
+	int   numLods = model->GetLodCount();
+	int   i;
+
+	for(i = 0; i < ASMeshCache::MAX_LODS; i++)
+		m_lodCount[i] = 0;
+	m_nearestDistance = FLT_MAX;
+	m_numVisible      = 0;
+	m_instances       = 0;
+
+	m_visible   = arena->AllocateArray<unsigned int>(ASFrustrum::GetMaskWords(m_numEnemies));
+	m_enemyLods = arena->AllocateArray<signed char>(m_numEnemies);
+	if(!m_visible || !m_enemyLods)
+		return 0;
+
+	// Cull every enemy in one batch, then choose a level of detail for each one that
+	// survived, whole words of culled enemies are skipped at once
+	frustum->CheckSpheres(m_posX, m_posY, m_posZ, radius, center, m_numEnemies, m_visible);
+
+	for(int word = 0; word < ASFrustrum::GetMaskWords(m_numEnemies); word++)
+	{
+		for(unsigned int bits = m_visible[word]; bits != 0; bits &= bits - 1)
+		{
+			i = (word * 32) + ASFrustrum::GetLowestBit(bits);
+
+			float dx = m_posX[i] + center.x - camPos.x;
+			float dy = m_posY[i] + center.y - camPos.y;
+			float dz = m_posZ[i] + center.z - camPos.z;
+			float distance = sqrtf((dx * dx) + (dy * dy) + (dz * dz));
+			if(distance < m_nearestDistance)
+				m_nearestDistance = distance;
+
+			int lod = (numLods > 1) ? model->SelectLod(model->GetProjectedRadius(distance, m_scale, projScale)) : 0;
+			m_enemyLods[i] = (signed char)lod;
+			m_lodCount[lod]++;
+		}
+	}
+
+	// Give each level of detail its own range of the instance array
+	int numVisible = 0;
+	for(i = 0; i < ASMeshCache::MAX_LODS; i++)
+	{
+		m_lodStart[i] = numVisible;
+		numVisible   += m_lodCount[i];
+	}
+
+	if(numVisible == 0)
+		return 0;
+
+	m_instances = arena->AllocateArray<ASInstance>(numVisible);
+	if(!m_instances)
+		return 0;
+	m_numVisible = numVisible;
+
+	// Write the visible enemies into their ranges, the world matrix is a uniform
+	// scale followed by the translation
+	int next[ASMeshCache::MAX_LODS];
+	memcpy(next, m_lodStart, sizeof(next));
+
+	for(int word = 0; word < ASFrustrum::GetMaskWords(m_numEnemies); word++)
+	{
+		for(unsigned int bits = m_visible[word]; bits != 0; bits &= bits - 1)
+		{
+			i = (word * 32) + ASFrustrum::GetLowestBit(bits);
+
+			ASInstance& instance = m_instances[next[m_enemyLods[i]]++];
+			memset(&instance.world, 0, sizeof(instance.world));
+			instance.world._11 = m_scale;
+			instance.world._22 = m_scale;
+			instance.world._33 = m_scale;
+			instance.world._41 = m_posX[i];
+			instance.world._42 = m_posY[i];
+			instance.world._43 = m_posZ[i];
+			instance.world._44 = 1.0f;
+			instance.color     = m_enemyInfoList[i].color;
+		}
+	}
+
+	return m_numVisible;
+}
+
+/*
+*******************************************************************
+* METHOD: Render Instances
+*******************************************************************
+* Uploads the instances packed by PrepareInstances() and draws each
+* level of detail that has any instances with one call.  The
+* shader's parameters must already be set
+*
+* @param ID3D11DeviceContext* - the context we are rendering with
+* @param ASModel*             - the model the enemies are drawn with
+* @param ASInstanceShader*    - the shader to draw them with
+*
+* @return bool - True if the instances were drawn, else false
+*/
+
+bool ASEnemies::RenderInstances(ID3D11DeviceContext* deviceCtx, ASModel* model, ASInstanceShader* shader)
+{
+	AS_PROFILE("ASEnemies::RenderInstances");
+
+	D3D11_MAPPED_SUBRESOURCE res;
+	HRESULT hr;
+
+	if(m_numVisible == 0)
+		return true;
+
+	// Discard last frame's instances and write this frame's
+	hr = deviceCtx->Map(m_instanceBuffer, 0, D3D11_MAP_WRITE_DISCARD, 0, &res);
+	if(FAILED(hr))
+		return false;
+
+	memcpy(res.pData, m_instances, sizeof(ASInstance) * m_numVisible);
+	deviceCtx->Unmap(m_instanceBuffer, 0);
+
+	// Bind the model to slot 0 and the instances to slot 1
+	unsigned int stride = sizeof(ASInstance);
+	unsigned int offset = 0;
+
+	model->Render(deviceCtx);
+	deviceCtx->IASetVertexBuffers(1, 1, &m_instanceBuffer, &stride, &offset);
+
+	for(int i = 0; i < model->GetLodCount(); i++)
+	{
+		if(m_lodCount[i] > 0)
+		{
+			shader->RenderInstances(deviceCtx, model->GetLodIndexCount(i), model->GetLodStartIndex(i), 
+									m_lodCount[i], m_lodStart[i]);
+		}
+	}
+
+	return true;
+}
+
+/*
+*******************************************************************
+* METHOD: Get Visible Count
+*******************************************************************
+* Returns the number of enemies that survived culling this frame
+*/
+
+int ASEnemies::GetVisibleCount()
+{
+	return m_numVisible;
+}
+
+/*
+*******************************************************************
+* METHOD: Get Nearest Distance
+*******************************************************************
+* Returns the distance from the camera to the closest enemy that
+* survived culling this frame, FLT_MAX if none did
+*/
+
+float ASEnemies::GetNearestDistance()
+{
+	return m_nearestDistance;
+}
+
+/*
+*******************************************************************
+* METHOD: Get Draw Call Count
+*******************************************************************
+* Returns the number of draw calls RenderInstances() makes this
+* frame, one for every level of detail in use
+*/
+
+int ASEnemies::GetDrawCallCount()
+{
+	int numCalls = 0;
+
+	for(int i = 0; i < ASMeshCache::MAX_LODS; i++)
+	{
+		if(m_lodCount[i] > 0)
+			numCalls++;
+	}
+
+	return numCalls;
+}
+
+/*
+*******************************************************************
+* METHOD: Get Triangle Count
+*******************************************************************
+* Returns the number of triangles RenderInstances() submits this
+* frame, every visible enemy's level of detail counted once each
+*
+* @param ASModel* - the model the enemies are drawn with
+*/
+
+int ASEnemies::GetTriangleCount(ASModel* model)
+{
+	int numTriangles = 0;
+
+	for(int i = 0; i < model->GetLodCount(); i++)
+		numTriangles += (model->GetLodIndexCount(i) / 3) * m_lodCount[i];
+
+	return numTriangles;
+}
+
 /*
 *******************************************************************
 * METHOD: Release
@@ -124,4 +414,25 @@ void ASEnemies::Release()
 		delete [] m_enemyInfoList;
 		m_enemyInfoList = 0;
 	}
+	if(m_posX)
+	{
+		delete [] m_posX;
+		delete [] m_posY;
+		delete [] m_posZ;
+		m_posX = 0;
+		m_posY = 0;
+		m_posZ = 0;
+	}
+
+	// The per frame lists belong to the frame arena, they are just forgotten
+	m_visible    = 0;
+	m_instances  = 0;
+	m_enemyLods  = 0;
+	m_numVisible = 0;
+
+	if(m_instanceBuffer)
+	{
+		m_instanceBuffer->Release();
+		m_instanceBuffer = 0;
+	}
 }
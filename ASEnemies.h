@@ -4,7 +4,12 @@
 * ASEnemies.h
 *******************************************************************
 * Maintains a list of all enemies and their position within the 
-* world.
+* world.  Enemies are drawn with hardware instancing: every frame
+* the visible enemies are culled, given a level of detail and
+* packed into a dynamic instance buffer, then each level of detail
+* is drawn with a single DrawIndexedInstanced call.  The lists
+* built while doing so only last the frame, they are taken from
+* ASFrameArena rather than kept for the largest crowd possible
 *******************************************************************
 */
 
@@ -17,9 +22,16 @@
 *******************************************************************
 */
 
+#include <d3d11.h>
 #include <D3DX10math.h>
 #include <stdlib.h>
 #include <time.h>
+#include <math.h>
+#include "ASFrustrum.h"
+#include "ASModel.h"
+#include "ASInstanceShader.h"
+#include "ASProfiler.h"
+#include "ASFrameArena.h"
 
 /*
 *******************************************************************
@@ -29,14 +41,20 @@
 
 class ASEnemies 
 {
+public:
+	// Per instance data read by ASInstance.vs, the world matrix then the colour
+	struct ASInstance
+	{
+		D3DXMATRIX  world;
+		D3DXVECTOR4 color;
+	};
+
 private:
-	// Structure to hold information on an enemy entity
+	// Structure to hold information on an enemy entity, the positions are kept apart
+	// in m_posX, m_posY and m_posZ so they can be culled in batches
 	struct ASEnemyInfo	
 	{
 		D3DXVECTOR4 color;
-		float posX;
-		float posY;
-		float posZ;
 	};
 public:
 	// Constructors and destructor
@@ -50,11 +68,36 @@ public:
 
 	int GetEnemyCount();
 	void GetData(int, float&, float&, float&, D3DXVECTOR4&);
+	void SetPosition(int, float, float, float);
+
+	// Instanced rendering
+	bool InitInstancing(ID3D11Device*, float);
+	int  PrepareInstances(ASFrustrum*, ASModel*, D3DXVECTOR3, float);
+	bool RenderInstances(ID3D11DeviceContext*, ASModel*, ASInstanceShader*);
+	int  GetVisibleCount();
+	float GetNearestDistance();
+	int  GetDrawCallCount();
+	int  GetTriangleCount(ASModel*);
 
 private:
 	// Member variables
 	int m_numEnemies;
 	ASEnemyInfo* m_enemyInfoList;
+	float*       m_posX;
+	float*       m_posY;
+	float*       m_posZ;
+
+	// Instancing, m_instances holds the visible enemies grouped by level of detail.  It and
+	// the other per frame lists are in frame memory, PrepareInstances() takes them again
+	ID3D11Buffer* m_instanceBuffer;
+	ASInstance*   m_instances;
+	signed char*  m_enemyLods;		// level of detail of each visible enemy this frame
+	unsigned int* m_visible;		// bitmask of the enemies that survived culling this frame
+	float         m_scale;
+	int           m_numVisible;
+	float         m_nearestDistance;	// distance to the closest visible enemy this frame
+	int           m_lodStart[ASMeshCache::MAX_LODS];
+	int           m_lodCount[ASMeshCache::MAX_LODS];
 };
 
 #endif
\ No newline at end of file
@@ -9,6 +9,15 @@
 
 #include "ASEngine.h"
 
+/*
+******************************************************************
+* Global declarations
+******************************************************************
+*/
+
+// ASEngine instance handle (can only ever be one instance in memory)
+static ASEngine* EngineInstance = 0;
+
 /*
 ******************************************************************
 * Default constructor - sets input and graphic pointers to null
@@ -26,6 +35,28 @@ ASEngine::ASEngine()
 	m_frameTimer  = 0;
 	m_fpsCounter  = 0;
 	m_player      = 0;
+	m_fixedStep   = 0;
+	m_pipeline    = 0;
+	m_framePacer  = 0;
+	m_frameStats  = 0;
+	m_inputLog    = 0;
+	m_cameraPath  = 0;
+	m_benchmark   = 0;
+	m_benchmarkFrame = 0;
+	m_steadyFrames      = 0;
+	m_allocatingFrames  = 0;
+	m_steadyAllocations = 0;
+	m_profiling   = false;
+	m_frameRateLimit = FRAME_RATE_LIMIT;
+	m_inputLogMode   = ASInputLog::MODE_OFF;
+	m_mouseX      = 0;
+	m_mouseY      = 0;
+
+#ifdef AS_HEADLESS
+	m_frameLimit  = HEADLESS_FRAMES;
+#else
+	m_frameLimit  = 0;
+#endif
 }
 
 /*
@@ -34,7 +65,7 @@ ASEngine::ASEngine()
 ******************************************************************
 */
 
-ASEngine::ASEngine(const ASEngine& engine) 
+ASEngine::ASEngine(const ASEngine&) 
 {}
 
 /*
@@ -65,9 +96,40 @@ bool ASEngine::Init()
 	int  height  = 0;
 	bool success = false;
 
+	// Start the profiler before the threads it names are started, so loading is
+	// profiled too
+	if(m_profiling)
+	{
+		ASProfiler::GetInstance()->Init(PROFILER_ZONES);
+		ASProfiler::GetInstance()->SetThreadName("Render");
+		ASProfiler::GetInstance()->SetEnabled(true);
+	}
+
+	// Watch how much of a core this thread uses, the simulation and job threads
+	// register as they start
+	ASCPUMonitor::RegisterThread("Render");
+
+	// Scratch memory the render thread's frames share, ready before anything loads
+	if(!ASFrameArena::GetInstance()->Init(FRAME_ARENA_BYTES))
+		return false;
+
 	// Initialise the WinAPI to build window
 	InitASWindow(width, height);
 
+	// Start the job system before anything that may hand it work, and when benchmarking
+	// log what scheduling a job costs and whether it holds up under load
+	if(!ASJobSystem::GetInstance()->Init(JOB_WORKERS))
+		return false;
+	if(!m_benchmarkPath.empty())
+	{
+		ASJobSystem::GetInstance()->Benchmark(JOB_BENCHMARK_JOBS);
+		if(JOB_STRESS_ROUNDS > 0 && !ASJobSystem::GetInstance()->StressTest(JOB_STRESS_ROUNDS))
+		{
+			ShowError(L"The job system failed its stress test");
+			return false;
+		}
+	}
+
 	// Initialise a new ASInput object, this will be used to handle keyboard and
 	// mouse I/O operations, if a null pointer exists exit gracefully
 	m_input = new ASInput;
@@ -76,13 +138,41 @@ bool ASEngine::Init()
 	else
 		m_input->Init(m_hInstance, m_hwnd, width, height);
 
+#ifdef AS_HEADLESS
+	// Nobody at the keyboard, walk forward in a circle so what is in view changes every frame
+	m_input->SetKeyDown(ASInput::KEY_UP, true);
+	m_input->SetKeyDown(ASInput::KEY_LEFT, true);
+#endif
+
+	// Record this run's input, or replay a recording in its place
+	m_inputLog = new ASInputLog;
+	if(!m_inputLog)
+		return false;
+	if(!m_inputLog->Init(m_inputLogMode, m_inputLogPath.c_str()))
+	{
+		ShowError(L"Could not open the input log");
+		return false;
+	}
+	m_input->GetMouseLocation(m_mouseX, m_mouseY);
+
 	// Initialise a new ASGraphics object, this will be used to render to the screen
 	// if a null pointer exists, exit gracefully
 	m_graphics = new ASGraphics;
 	if(!m_graphics)
 		return false;
-	else
-		success = m_graphics->Init(width, height, m_hwnd);
+
+	m_graphics->SetBenchmarking(!m_benchmarkPath.empty());
+	success = m_graphics->Init(width, height, m_hwnd);
+
+	// Nothing below can run without the scene, ASGraphics says why itself but the null
+	// backend has no window to say it in
+	if(!success)
+	{
+#ifdef AS_HEADLESS
+		ShowError(L"Could not build the terrain, ./Textures/mapC.bmp and ./Textures/colorMap.bmp are needed");
+#endif
+		return false;
+	}
 
 	// Initalise the sound for the environment 
 	/*
@@ -112,6 +202,12 @@ bool ASEngine::Init()
 		return false;
 	m_cpuMonitor->Init();
 
+	// Frame time percentiles and histogram
+	m_frameStats = new ASFrameTimeStats;
+	if(!m_frameStats)
+		return false;
+	m_frameStats->Init(FRAME_STATS_WINDOW, FRAME_STATS_SPIKE_MS);
+
 	/*
 	* End of performance modules
 	*/
@@ -124,7 +220,7 @@ bool ASEngine::Init()
 	success = m_frameTimer->Init();
 	if(!m_frameTimer)
 	{
-		MessageBox(m_hwnd, L"Could not initialise the Frame Timer.", L"Error", MB_OK);
+		ShowError(L"Could not initialise the Frame Timer.");
 		return false;
 	}
 
@@ -135,6 +231,60 @@ bool ASEngine::Init()
 
 	m_player->SetPosition(SPAWN_X, SPAWN_Y, SPAWN_Z);
 
+	// Simulate in fixed ticks, both ticks start where the player spawns
+	m_fixedStep = new ASFixedStep;
+	if(!m_fixedStep)
+		return false;
+	m_fixedStep->Init(SIM_TICK_RATE, SIM_MAX_STEPS, SIM_INTERPOLATE);
+
+	m_player->GetPosition(m_currTick.pos.x, m_currTick.pos.y, m_currTick.pos.z);
+	m_player->GetRotation(m_currTick.rot.x, m_currTick.rot.y, m_currTick.rot.z);
+	m_prevTick = m_currTick;
+	m_camInfo  = m_currTick;
+
+	// The simulation takes over the enemies from where graphics placed them
+	int numEnemies = m_graphics->GetEnemyCount();
+
+	m_enemyX.resize(numEnemies);
+	m_enemyY.resize(numEnemies);
+	m_enemyZ.resize(numEnemies);
+	for(int i = 0; i < numEnemies; i++)
+		m_graphics->GetEnemyPosition(i, m_enemyX[i], m_enemyY[i], m_enemyZ[i]);
+
+	// Hands each simulated frame over to the renderer
+	m_pipeline = new ASFramePipeline;
+	if(!m_pipeline)
+		return false;
+
+	// Fly the benchmark's camera path, recording what every frame costs
+	if(!m_benchmarkPath.empty())
+	{
+		m_cameraPath = new ASCameraPath;
+		if(!m_cameraPath)
+			return false;
+		if(!m_cameraPath->Init(m_benchmarkPath.c_str()))
+		{
+			ShowError(L"Could not load the benchmark camera path");
+			return false;
+		}
+
+		m_benchmark = new ASBenchmark;
+		if(!m_benchmark)
+			return false;
+		m_benchmark->Init((int)(m_cameraPath->GetDuration() * 1000.0f / BENCHMARK_FRAME_MS) + 2);
+	}
+
+	// Holds the loop to the frame rate limit, if there is one
+	m_framePacer = new ASFramePacer;
+	if(!m_framePacer)
+		return false;
+	m_framePacer->Init(m_frameRateLimit, PACER_SPIN_MS);
+
+	// Log what each subsystem holds once everything is loaded, and start the frames
+	// with the scratch memory loading used given back
+	ASMemory::Report("after load");
+	ASFrameArena::GetInstance()->Reset();
+
 	// Catch the value of success, and determine if the window was initalised 
 	// without any errors
 	if(!success)
@@ -156,91 +306,529 @@ bool ASEngine::Init()
 
 void ASEngine::Run()
 {
-	MSG  m;
 	bool exit    = false;
 	bool success = false;
+	const ASFrameSnapshot* snapshot;
+	int    numFrames = 0;
+	double frameMs;
+	double totalMs   = 0.0;
+	double fastestMs = 0.0;
+	double slowestMs = 0.0;
+	ASVector3 lastCamera = ASVector3(SPAWN_X, SPAWN_Y, SPAWN_Z);
+	double frameStart;
+	double frameEnd;
+
+#ifndef AS_HEADLESS
+	MSG  m;
 
 	// Initialise the message structure - this sets all bytes in the struct to 0
 	ZeroMemory(&m, sizeof(MSG));
+#endif
+
+	// Start simulating, the first frame is being worked on from here
+	m_pipeline->Start(SimulateFrame, this, PIPELINE_THREADED);
+	frameEnd = ASClock::GetSeconds();
 
 	// Game loop - keep listening on the message stack, every time a new
 	// message is encountered process it, if "exit" evals to true then
 	// gracefully exit the program by calling the Release() method
 	while(!exit)
 	{
-		if(PeekMessage(&m, NULL, 0, 0, PM_REMOVE))
+		AS_PROFILE("ASEngine::Frame");
+
+		long long heapBefore = ASMemory::GetHeapAllocations();
+
+		// Stop once the frame limit is reached
+		if(m_frameLimit > 0 && numFrames >= m_frameLimit)
 		{
+			exit = true;
+			continue;
+		}
+
+#ifndef AS_HEADLESS
+		// Handle every message that came in since the last frame, check if an exit
+		// message was sent on the stack - if so set exit to true
+		while(PeekMessage(&m, NULL, 0, 0, PM_REMOVE))
+		{
+			if(m.message == WM_QUIT)
+				exit = true;
+
 			TranslateMessage(&m);
 			DispatchMessage(&m);
 		}
 
-		// Check if an exit message was sent on the stack - if so set exit to true,
-		// otherwise dispatch the message to DispatchASEvent() to handle rendering, then 
-		// check if the Frame was processed successfully, if not exit the application
-		if(m.message == WM_QUIT)
+		if(exit)
+			continue;
+#endif
+
+		// Take the frame the simulation finished, it stops publishing once escape
+		// was pressed or a frame failed
+		frameStart = ASClock::GetSeconds();
+		snapshot = m_pipeline->Acquire();
+		if(!snapshot || snapshot->quit)
+		{
+			if(snapshot && snapshot->failed)
+				ShowError(L"Frame Processing Failed");
 			exit = true;
-		else 
+			continue;
+		}
+
+		// Draw it, check if the Frame was processed successfully
+		success = DispatchASEvent(*snapshot);
+		if(!success)
 		{
-			success = DispatchASEvent();
-			if(!success)
+			ShowError(L"Frame Processing Failed");
+		}
+
+		lastCamera = snapshot->cameraPos;
+		m_pipeline->FinishFrame();
+
+		// The frame is drawn, its scratch memory can be used again
+		ASFrameArena::GetInstance()->Reset();
+
+		// Keep running totals rather than every frame, so a long run does not grow a list
+		frameMs = (ASClock::GetSeconds() - frameStart) * 1000.0;
+		totalMs += frameMs;
+		if(numFrames == 0 || frameMs < fastestMs)
+			fastestMs = frameMs;
+		if(frameMs > slowestMs)
+			slowestMs = frameMs;
+		numFrames++;
+
+		// Record what the frame cost and drew for the benchmark
+		if(m_benchmark)
+		{
+			const ASGraphics::ASFrameStats& stats = m_graphics->GetFrameStats();
+			ASBenchmark::ASFrame frame;
+
+			frame.frame          = numFrames - 1;
+			frame.cpuMs          = frameMs;
+			frame.cullMs         = stats.cullMs;
+			frame.nodesVisited   = stats.nodesVisited;
+			frame.leavesDrawn    = stats.leavesDrawn;
+			frame.trianglesDrawn = stats.trianglesDrawn;
+			frame.drawCalls      = stats.drawCalls;
+			m_benchmark->AddFrame(frame);
+		}
+
+		// Wait out the rest of the frame, the time spent here is not part of frameMs
+		m_framePacer->Wait();
+
+		// Time from the end of the last frame to the end of this one, how long the
+		// frame stayed on screen
+		double now = ASClock::GetSeconds();
+		m_frameStats->AddFrame((now - frameEnd) * 1000.0);
+		frameEnd = now;
+
+		// Once warmed up a frame should not touch the heap, count the ones that did.  The
+		// simulation runs alongside, so what it allocates is counted in the frame it overlaps
+		if(numFrames > HEAP_CHECK_WARMUP)
+		{
+			long long allocations = ASMemory::GetHeapAllocations() - heapBefore;
+
+			m_steadyFrames++;
+			if(allocations > 0)
 			{
-				MessageBox(m_hwnd, L"Frame Processing Failed", L"Error", MB_OK);
+				m_allocatingFrames++;
+				m_steadyAllocations += allocations;
 			}
 		}
+	}
 
-		// Check if escape was pressed
-		if(m_input->IsEscapeDown() == true)
-			exit = true;
+	// Take a last CPU sample so the reports cover the whole run, while the
+	// simulation thread is still there to be read
+	m_cpuMonitor->Sample();
+
+	// Wait for the simulation thread to finish before anything is released
+	m_pipeline->Stop();
+
+	ReportFrames(numFrames, totalMs, fastestMs, slowestMs, lastCamera);
+
+	// Write out every frame of the benchmark and summarise the run, with how busy
+	// each core and thread was
+	if(m_benchmark)
+	{
+		ostringstream cpu;
+		m_cpuMonitor->Summarise(cpu);
+		m_benchmark->AddNote(cpu.str());
+
+		m_benchmark->WriteCSV(BENCHMARK_CSV);
+		m_benchmark->Report(m_benchmarkPath.c_str());
+#ifdef AS_HEADLESS
+		ostringstream summary;
+		m_benchmark->Summarise(summary);
+		printf("%s", summary.str().c_str());
+#endif
 	}
 
 	return;
 }
 
+/*
+******************************************************************
+* Method: SetFrameLimit
+******************************************************************
+* Sets how many frames Run() draws before it returns, a headless
+* build starts with HEADLESS_FRAMES and a window with no limit
+*
+* @param int - the number of frames, 0 for no limit
+******************************************************************
+*/
+
+void ASEngine::SetFrameLimit(int frames)
+{
+	m_frameLimit = frames;
+}
+
+/*
+******************************************************************
+* Method: SetFrameRateLimit
+******************************************************************
+* Sets the frame rate Run() is held to, call before Init()
+*
+* @param float - frames a second, 0 for no limit
+******************************************************************
+*/
+
+void ASEngine::SetFrameRateLimit(float fps)
+{
+	m_frameRateLimit = fps;
+}
+
+/*
+******************************************************************
+* Method: SetInputLog
+******************************************************************
+* Records the input of every frame to a log, or replays a log in
+* place of the keyboard and mouse, call before Init()
+*
+* @param ASInputLog::ASMode - record, replay, or neither
+* @param const char*        - the log's path
+******************************************************************
+*/
+
+void ASEngine::SetInputLog(ASInputLog::ASMode mode, const char* path)
+{
+	m_inputLogMode = mode;
+	m_inputLogPath = path ? path : "";
+}
+
+/*
+******************************************************************
+* Method: SetBenchmark
+******************************************************************
+* Runs the benchmark instead of playing, the camera flies along a
+* path and what each frame costs is written to BENCHMARK_CSV.  The
+* run lasts as long as the path, so the frame limit is lifted.  The
+* start up benchmarks are only run and logged in this mode, call
+* before Init()
+*
+* @param const char* - the camera path file, see ASCameraPath.h
+******************************************************************
+*/
+
+void ASEngine::SetBenchmark(const char* path)
+{
+	m_benchmarkPath = path ? path : "";
+	m_frameLimit    = 0;
+}
+
+/*
+******************************************************************
+* Method: SetProfiling
+******************************************************************
+* Records the zones marked with AS_PROFILE on every thread, written
+* to PROFILER_TRACE as a Chrome trace on exit, call before Init()
+*
+* @param bool - whether to profile the run
+******************************************************************
+*/
+
+void ASEngine::SetProfiling(bool profiling)
+{
+	m_profiling = profiling;
+}
+
+/*
+******************************************************************
+* Method: GetFrameTimeStats
+******************************************************************
+* The length of the frames Run() has drawn, ask it for a summary
+* from the render thread only
+*
+* @return ASFrameTimeStats* - the statistics, 0 before Init()
+******************************************************************
+*/
+
+ASFrameTimeStats* ASEngine::GetFrameTimeStats()
+{
+	return m_frameStats;
+}
+
+/*
+******************************************************************
+* Method: ReportFrames
+******************************************************************
+* Writes how long the frames Run() drew took and where the camera
+* ended up to ./log/frames.txt, a headless build also prints it.
+* Two headless runs of the same build should end in the same place
+*
+* @param int       - the number of frames drawn
+* @param double    - the time they took in ms
+* @param double    - the time the fastest took in ms
+* @param double    - the time the slowest took in ms
+* @param ASVector3 - the camera's position in the last frame
+******************************************************************
+*/
+
+void ASEngine::ReportFrames(int frames, double total, double fastest, double slowest, ASVector3 camera)
+{
+	ostringstream line;
+
+	if(frames == 0)
+		return;
+
+	line << fixed << setprecision(3) << frames << " frames in " << total << " ms, " << (total / frames)
+		 << " ms a frame (fastest " << fastest << ", slowest " << slowest << "), camera ended at "
+		 << camera.x << " " << camera.y << " " << camera.z;
+	if(m_steadyFrames > 0)
+	{
+		line << endl << m_allocatingFrames << " of the " << m_steadyFrames << " frames after the first "
+			 << HEAP_CHECK_WARMUP << " allocated from the heap, " << m_steadyAllocations << " allocations";
+	}
+
+	ofstream fout;
+	fout.open("./log/frames.txt", ios::app);
+	if(!fout.fail())
+	{
+		fout << line.str() << endl;
+		fout.close();
+	}
+
+#ifdef AS_HEADLESS
+	const ASNullGraphics::ASStats& draws = m_graphics->GetStats();
+
+	printf("%s\n", line.str().c_str());
+	printf("%llu draws, %llu enemies drawn and %llu culled\n", draws.numDraws, draws.numVisible, draws.numCulled);
+
+	ASFrameTimeStats::ASSummary summary;
+	m_frameStats->GetSummary(summary);
+	printf("last %d frames ms: p50 %.3f, p95 %.3f, p99 %.3f, p99.9 %.3f, %d spikes\n", summary.numFrames,
+		   summary.p50Ms, summary.p95Ms, summary.p99Ms, summary.p999Ms, summary.numSpikes);
+#endif
+}
+
 /*
 ******************************************************************
 * Method: DispatchASEvent
 ******************************************************************
-* Recieves a message from the processing queue and dispatches
-* it to the ASGraphic object; ASGraphics will then handle the
-* update of the scene and return a bool based on its success
+* Runs on the render thread, updates the system statistics and
+* has the ASGraphics object draw the frame the simulation handed
+* over; ASGraphics will then handle the update of the scene and
+* return a bool based on its success
 *
+* @param ASFrameSnapshot - the simulated frame to draw
 * @return - bool : True if successful callback, else False
 ******************************************************************
 */
 
-bool ASEngine::DispatchASEvent() 
+bool ASEngine::DispatchASEvent(const ASFrameSnapshot& snapshot) 
 {
-	// Update the input controller with what is being pressed for this current frame
-	bool success = m_input->ProcessFrame();
-	if(!success)
-		return false;
+	AS_PROFILE("ASEngine::DispatchASEvent");
+
+	ASGraphics::ASCameraInfo info;
+	bool success;
 
 	// On each frame update system statistics
 	m_cpuMonitor->UpdateCPUUsage();
 	m_fpsCounter->IncrementFrameCount();
-	m_frameTimer->GetFrame();
 
-	// Recieve input state from m_Input and do some processing in the scene
-	success = ProcessInput(m_frameTimer->GetTime());
+	// Move the enemies to where the simulation left them
+	int numEnemies = (int)snapshot.entityX.size();
+	for(int i = 0; i < numEnemies; i++)
+		m_graphics->SetEnemyPosition(i, snapshot.entityX[i], snapshot.entityY[i], snapshot.entityZ[i]);
+
+	// Update the scene
+	info.pos.x = snapshot.cameraPos.x;
+	info.pos.y = snapshot.cameraPos.y;
+	info.pos.z = snapshot.cameraPos.z;
+	info.rot.x = snapshot.cameraRot.x;
+	info.rot.y = snapshot.cameraRot.y;
+	info.rot.z = snapshot.cameraRot.z;
+
+	success = m_graphics->RenderScene(info);
 	if(!success)
 		return false;
 
-	// Update the scene
-	success = m_graphics->RenderScene(m_camInfo);
+	return true;
+}
+
+/*
+******************************************************************
+* Method: SimulateFrame
+******************************************************************
+* Callback for ASFramePipeline, passes the frame on to Simulate()
+* of the engine it was started with
+*
+* @param ASFrameSnapshot - the snapshot to fill in
+* @param void*           - the ASEngine
+* @return - bool : True if successful callback, else False
+******************************************************************
+*/
+
+bool ASEngine::SimulateFrame(ASFrameSnapshot& snapshot, void* engine)
+{
+	return ((ASEngine*)engine)->Simulate(snapshot);
+}
+
+/*
+******************************************************************
+* Method: Simulate
+******************************************************************
+* Runs on the simulation thread, reads the input, runs as many
+* fixed ticks as the time since the last frame pays for and copies
+* what should be drawn into the snapshot
+*
+* @param ASFrameSnapshot - the snapshot to fill in
+* @return - bool : True if successful callback, else False
+******************************************************************
+*/
+
+bool ASEngine::Simulate(ASFrameSnapshot& snapshot)
+{
+	AS_PROFILE("ASEngine::Simulate");
+
+	// Update the input controller with what is being pressed for this current frame
+	bool success = m_input->ProcessFrame();
 	if(!success)
 		return false;
 
+	m_frameTimer->GetFrame();
+	float frameTime = m_frameTimer->GetTime();
+#ifdef AS_HEADLESS
+	if(HEADLESS_FRAME_MS > 0.0f)
+		frameTime = HEADLESS_FRAME_MS;
+#endif
+
+	// Take this frame's input, and its length, from the recording being replayed, the
+	// run ends with the recording.  Otherwise read it and record it if asked to
+	if(m_inputLog->GetMode() == ASInputLog::MODE_REPLAY)
+	{
+		if(!m_inputLog->Replay(m_inputFrame))
+		{
+			snapshot.quit = true;
+			return true;
+		}
+	}
+	else
+	{
+		ReadInputFrame(frameTime);
+		m_inputLog->Record(m_inputFrame);
+	}
+	frameTime = m_inputFrame.frameTime;
+
+	// Recieve input state from m_Input and run as many fixed ticks as the frame time pays
+	// for, keeping the state of the last two ticks
+	int steps = m_fixedStep->Advance(frameTime);
+	for(int i = 0; i < steps; i++)
+	{
+		m_prevTick = m_currTick;
+
+		success = ProcessInput(m_fixedStep->GetStep());
+		if(!success)
+			return false;
+	}
+
+	// Draw the camera part way between the last two ticks
+	InterpolateCamera(m_fixedStep->GetAlpha());
+
+	// The benchmark flies the camera along its path instead, and ends with it
+	if(m_cameraPath)
+	{
+		float seconds = (m_benchmarkFrame * BENCHMARK_FRAME_MS) / 1000.0f;
+		ASVector3 pos, rot;
+
+		if(seconds > m_cameraPath->GetDuration())
+		{
+			snapshot.quit = true;
+			return true;
+		}
+		m_benchmarkFrame++;
+
+		m_cameraPath->Sample(seconds, pos, rot);
+		m_camInfo.pos.x = pos.x;
+		m_camInfo.pos.y = pos.y;
+		m_camInfo.pos.z = pos.z;
+		m_camInfo.rot.x = rot.x;
+		m_camInfo.rot.y = rot.y;
+		m_camInfo.rot.z = rot.z;
+	}
+
+	snapshot.cameraPos = ASVector3(m_camInfo.pos.x, m_camInfo.pos.y, m_camInfo.pos.z);
+	snapshot.cameraRot = ASVector3(m_camInfo.rot.x, m_camInfo.rot.y, m_camInfo.rot.z);
+
+	// Enemies have no behaviour yet, they are copied as they are. Assigning reuses
+	// the snapshot's storage once it has grown to fit
+	snapshot.entityX = m_enemyX;
+	snapshot.entityY = m_enemyY;
+	snapshot.entityZ = m_enemyZ;
+
+	// Check if escape was pressed, this is the last frame. A replay can be cut short
+	// from the keyboard too
+	snapshot.quit = (m_inputFrame.keys & ASInputLog::KEY_BIT_ESCAPE) != 0 || m_input->IsEscapeDown();
+
 	return true;
 }
 
+/*
+******************************************************************
+* Method: ReadInputFrame
+******************************************************************
+* Reads what is held down and how far the mouse moved from the
+* ASInput controller into m_inputFrame
+*
+* @param float - the length of this frame in ms
+******************************************************************
+*/
+
+void ASEngine::ReadInputFrame(float frameTime)
+{
+	int mouseX, mouseY;
+
+	m_inputFrame.frameTime = frameTime;
+	m_inputFrame.keys      = 0;
+
+	if(m_input->IsEscapeDown())
+		m_inputFrame.keys |= ASInputLog::KEY_BIT_ESCAPE;
+	if(m_input->IsLeftArrowDown())
+		m_inputFrame.keys |= ASInputLog::KEY_BIT_LEFT;
+	if(m_input->IsRightArrowDown())
+		m_inputFrame.keys |= ASInputLog::KEY_BIT_RIGHT;
+	if(m_input->IsUpArrowDown())
+		m_inputFrame.keys |= ASInputLog::KEY_BIT_UP;
+	if(m_input->IsDownArrowDown())
+		m_inputFrame.keys |= ASInputLog::KEY_BIT_DOWN;
+	if(m_input->IsSpaceBarDown())
+		m_inputFrame.keys |= ASInputLog::KEY_BIT_SPACE;
+	if(m_input->LeftMouseClicked())
+		m_inputFrame.keys |= ASInputLog::KEY_BIT_MOUSE;
+
+	m_input->GetMouseLocation(mouseX, mouseY);
+	m_inputFrame.mouseX = (short)(mouseX - m_mouseX);
+	m_inputFrame.mouseY = (short)(mouseY - m_mouseY);
+	m_mouseX = mouseX;
+	m_mouseY = mouseY;
+}
+
 /*
 ******************************************************************
 * Method: Process Input
 ******************************************************************
-* Private interface to recieve the input from the ASInput controller
-* and then do some processing to update the scene
+* Private interface to recieve this frame's input, read from the
+* ASInput controller or replayed, and then do some processing to
+* update the scene
 *
-* @param float - the frame time in FPS so all frames are synchronised
+* @param float - the length of one simulation tick in ms
 * @return bool : True if successful callback, else False
 ******************************************************************
 */
@@ -250,34 +838,55 @@ bool ASEngine::ProcessInput(float frameTime)
 	// Bool to determine if the key is down (defaults to false and will be set 
 	// by querying the D3D input controller)
 	bool isKeyDown;
-	bool success;
 
 	m_player->SetFrameTime(frameTime);
 
 	// Handle input
-	isKeyDown = m_input->IsLeftArrowDown();
+	isKeyDown = (m_inputFrame.keys & ASInputLog::KEY_BIT_LEFT) != 0;
 	m_player->TurnLeft(isKeyDown);
 
-	isKeyDown = m_input->IsRightArrowDown();
+	isKeyDown = (m_inputFrame.keys & ASInputLog::KEY_BIT_RIGHT) != 0;
 	m_player->TurnRight(isKeyDown);
 
-	isKeyDown = m_input->IsUpArrowDown();
+	isKeyDown = (m_inputFrame.keys & ASInputLog::KEY_BIT_UP) != 0;
 	m_player->MoveForward(isKeyDown);
 
-	isKeyDown = m_input->IsDownArrowDown();
+	isKeyDown = (m_inputFrame.keys & ASInputLog::KEY_BIT_DOWN) != 0;
 	m_player->MoveBackward(isKeyDown);
 
-	isKeyDown = m_input->IsSpaceBarDown();
+	isKeyDown = (m_inputFrame.keys & ASInputLog::KEY_BIT_SPACE) != 0;
 	m_player->MoveUpward(isKeyDown);
 
-	// Set the Camera info data structure
-	m_player->GetPosition(m_camInfo.pos.x, m_camInfo.pos.y, m_camInfo.pos.z);
-	m_player->GetRotation(m_camInfo.rot.x, m_camInfo.rot.y, m_camInfo.rot.z);
+	// Record where this tick left the player
+	m_player->GetPosition(m_currTick.pos.x, m_currTick.pos.y, m_currTick.pos.z);
+	m_player->GetRotation(m_currTick.rot.x, m_currTick.rot.y, m_currTick.rot.z);
 
 	// Everything was successful
 	return true;
 }
 
+/*
+******************************************************************
+* Method: InterpolateCamera
+******************************************************************
+* Sets the camera info that is drawn to a blend of the last two
+* simulation ticks, angles are blended the short way round
+*
+* @param float - the blend, 0 gives the previous tick and 1 the last
+******************************************************************
+*/
+
+void ASEngine::InterpolateCamera(float alpha)
+{
+	m_camInfo.pos.x = ASFixedStep::Lerp(m_prevTick.pos.x, m_currTick.pos.x, alpha);
+	m_camInfo.pos.y = ASFixedStep::Lerp(m_prevTick.pos.y, m_currTick.pos.y, alpha);
+	m_camInfo.pos.z = ASFixedStep::Lerp(m_prevTick.pos.z, m_currTick.pos.z, alpha);
+
+	m_camInfo.rot.x = ASFixedStep::LerpAngle(m_prevTick.rot.x, m_currTick.rot.x, alpha);
+	m_camInfo.rot.y = ASFixedStep::LerpAngle(m_prevTick.rot.y, m_currTick.rot.y, alpha);
+	m_camInfo.rot.z = ASFixedStep::LerpAngle(m_prevTick.rot.z, m_currTick.rot.z, alpha);
+}
+
 /*
 ******************************************************************
 * Method: InitASWindow
@@ -293,6 +902,15 @@ bool ASEngine::ProcessInput(float frameTime)
 
 void ASEngine::InitASWindow(int& width, int& height)
 {
+#ifdef AS_HEADLESS
+	// No window, draw at the size one would have
+	EngineInstance = this;
+	m_hInstance = 0;
+	m_hwnd      = 0;
+	m_appName   = L"ASEngine";
+	width       = HEADLESS_WIDTH;
+	height      = HEADLESS_HEIGHT;
+#else
 	// Local variables
 	WNDCLASSEX window;
 	DEVMODE    scrSettings;
@@ -301,7 +919,7 @@ void ASEngine::InitASWindow(int& width, int& height)
 	int        posX = 0;
 	int        posY = 0;
 
-	// Set the global Engine instance handle (defined ASEngine.h), 
+	// Set the global Engine instance handle (defined ASEngine.cpp), 
 	// we now only ever have ASEngine object in memory
 	EngineInstance = this;
 
@@ -365,6 +983,7 @@ void ASEngine::InitASWindow(int& width, int& height)
 	SetFocus(m_hwnd);
 
 	ShowCursor(false);
+#endif
 
 	return;
 }
@@ -379,6 +998,7 @@ void ASEngine::InitASWindow(int& width, int& height)
 
 void ASEngine::CloseASWindow()
 {
+#ifndef AS_HEADLESS
 	// If cursor was disabled, re-show it
 	ShowCursor(true);
 
@@ -394,6 +1014,7 @@ void ASEngine::CloseASWindow()
 	// Remove application instance
 	UnregisterClass(m_appName, m_hInstance);
 	m_hInstance = 0;
+#endif
 
 	// Release pointer to the class (as we've destroyed it)
 	EngineInstance = 0;
@@ -401,6 +1022,27 @@ void ASEngine::CloseASWindow()
 	return;
 }
 
+/*
+******************************************************************
+* Method: ShowError
+******************************************************************
+* Tells the user something went wrong, in a message box, or on
+* stderr when there is no window
+*
+* @param LPCWSTR - the message
+******************************************************************
+*/
+
+void ASEngine::ShowError(LPCWSTR message)
+{
+#ifdef AS_HEADLESS
+	fwprintf(stderr, L"Error: %ls\n", message);
+#else
+	MessageBox(m_hwnd, message, L"Error", MB_OK);
+#endif
+}
+
+#ifndef AS_HEADLESS
 /*
 ******************************************************************
 * Method: MessageHandler
@@ -414,6 +1056,13 @@ void ASEngine::CloseASWindow()
 
 LRESULT CALLBACK ASEngine::MessageHandler(HWND hwnd, UINT umsg, WPARAM wparam, LPARAM lparam)
 {
+	// F9 logs what each subsystem holds right now
+	if(umsg == WM_KEYDOWN && wparam == VK_F9)
+	{
+		ASMemory::Report("on F9");
+		return 0;
+	}
+
 	return DefWindowProc(hwnd, umsg, wparam, lparam);
 }
 
@@ -452,6 +1101,7 @@ LRESULT CALLBACK WndProc(HWND hwnd, UINT umessage, WPARAM wparam, LPARAM lparam)
 		}
 	}
 }
+#endif
 
 /*
 ******************************************************************
@@ -468,9 +1118,20 @@ LRESULT CALLBACK WndProc(HWND hwnd, UINT umessage, WPARAM wparam, LPARAM lparam)
 
 void ASEngine::Release()
 {
+	// Stop the simulation thread and log how the frames were handed over
+	if(m_pipeline)
+	{
+		m_pipeline->Stop();
+		m_pipeline->Report("on exit");
+		delete m_pipeline;
+		m_pipeline = 0;
+	}
 	// Release the graphics object
 	if(m_graphics)
 	{
+#ifdef AS_HEADLESS
+		m_graphics->Report("on exit");
+#endif
 		m_graphics->Release();
 		delete m_graphics;
 		m_graphics = 0;
@@ -482,6 +1143,14 @@ void ASEngine::Release()
 		delete m_environment;
 		m_environment = 0;
 	}
+	// Finish the input log, everything recorded is written once it is released
+	if(m_inputLog)
+	{
+		m_inputLog->Report("on exit");
+		m_inputLog->Release();
+		delete m_inputLog;
+		m_inputLog = 0;
+	}
 	// Release the input object, jump straight to step 2
 	// as m_input does not allocate any new resources
 	if(m_input)
@@ -490,6 +1159,13 @@ void ASEngine::Release()
 		delete m_input;
 		m_input = 0;
 	}
+	// Log how the fixed step ran, then release it
+	if(m_fixedStep)
+	{
+		m_fixedStep->Report("on exit");
+		delete m_fixedStep;
+		m_fixedStep = 0;
+	}
 	// Release the performance objects
 	if(m_frameTimer)
 	{
@@ -499,6 +1175,7 @@ void ASEngine::Release()
 	// Release the cpu monitor
 	if(m_cpuMonitor)
 	{
+		m_cpuMonitor->Report("on exit");
 		m_cpuMonitor->Release();
 		delete m_cpuMonitor;
 		m_cpuMonitor = 0;
@@ -517,8 +1194,56 @@ void ASEngine::Release()
 		m_player = 0;
 	}
 
+	// Release the benchmark's path and results, they were written when Run() returned
+	if(m_cameraPath)
+	{
+		delete m_cameraPath;
+		m_cameraPath = 0;
+	}
+	if(m_benchmark)
+	{
+		delete m_benchmark;
+		m_benchmark = 0;
+	}
+
+	// Log how long frames stayed on screen
+	if(m_frameStats)
+	{
+		m_frameStats->Report("on exit");
+		delete m_frameStats;
+		m_frameStats = 0;
+	}
+
+	// Log how evenly frames were paced, then release the pacer
+	if(m_framePacer)
+	{
+		m_framePacer->Report("on exit");
+		m_framePacer->Release();
+		delete m_framePacer;
+		m_framePacer = 0;
+	}
+
+	// Stop the job system's workers once nothing is left to hand them work
+	ASJobSystem::GetInstance()->Report("on exit");
+	ASJobSystem::GetInstance()->Release();
+
+	// Write out what the profiler recorded, every other thread has stopped by now
+	if(m_profiling)
+	{
+		ASProfiler::GetInstance()->WriteChromeTrace(PROFILER_TRACE);
+		ASProfiler::GetInstance()->Report("on exit");
+		ASProfiler::GetInstance()->Release();
+	}
+
 	// Close the Window
 	CloseASWindow();
 
+	// Log how much scratch memory frames used, nothing is drawn from here on
+	ASFrameArena::GetInstance()->Report("on exit");
+	ASFrameArena::GetInstance()->Release();
+
+	// Every subsystem has released its memory, anything still held was leaked
+	ASMemory::Report("on exit");
+
 	return;
 }
\ No newline at end of file
@@ -5,6 +5,11 @@
 *******************************************************************
 * Encapsulates the engine logic, allowing us to separate it from
 * the main.cpp file
+*
+* Building with AS_HEADLESS defined swaps the window, input, sound
+* and graphics for null backends that need no device, so the engine
+* builds and runs anywhere.  It runs a set number of frames then
+* prints how long they took
 *******************************************************************
 */
 
@@ -27,27 +32,147 @@
 * @ASInput.h      - Used to handle input events such as keyboard and mouse
 * @ASGraphics.h   - Used to render graphics to the screen
 * @ASSound.h      - Plays sound using DXSound 
+* @ASClock.h      - The engine's clock, every time is read from it
 * @ASFrameTimer.h - High precision timer, used to keep frames synced by frame-rate
-* @ASCPUMonitor.h - Used to query the CPU for how many resources it is currently using
+* @ASCPUMonitor.h - Used to query the CPU for how busy each core and engine thread is
 * @ASFPSCounter.h - Keeps track of how many frames are being used per second
 * @ASPlayer.h	  - Dictates what way ASCamera should be drawing frames relative to its movements
+* @ASFixedStep.h  - Runs the simulation in fixed ticks whatever the frame rate
+* @ASFramePipeline.h - Runs the simulation a frame ahead on its own thread
+* @ASJobSystem.h  - Worker threads every subsystem can hand work to
+* @ASFramePacer.h - Holds the frame loop to a target rate
+* @ASInputLog.h   - Records the input each frame, or replays a recording
+* @ASCameraPath.h - The spline the benchmark flies the camera along
+* @ASBenchmark.h  - Records what each benchmark frame cost and drew
+* @ASProfiler.h   - Times the zones marked in each frame on every thread
+* @ASFrameTimeStats.h - Percentiles and a histogram of the last frames' lengths
+* @ASMemory.h     - How much memory each subsystem holds, written at load, on F9 and at exit
+* @ASFrameArena.h - Scratch memory for the render thread, given back at the end of each frame
+* @ASNull*.h      - The backends used by a headless build in place of the above
 ******************************************************************
 */
 
+#ifdef AS_HEADLESS
+#include <stdio.h>
+#include <wchar.h>
+#include "ASNullInput.h"
+#include "ASNullGraphics.h"
+#include "ASNullSound.h"
+#else
 #include <windows.h>
 
 #include "ASInput.h"
 #include "ASGraphics.h"
 #include "ASSound.h"
+#endif
+#include <string>
+#include <sstream>
+#include <iomanip>
+#include "ASClock.h"
 #include "ASFrameTimer.h"
 #include "ASCPUMonitor.h"
 #include "ASFPSCounter.h"
 #include "ASPlayer.h"
+#include "ASFixedStep.h"
+#include "ASFramePipeline.h"
+#include "ASJobSystem.h"
+#include "ASFramePacer.h"
+#include "ASInputLog.h"
+#include "ASCameraPath.h"
+#include "ASBenchmark.h"
+#include "ASProfiler.h"
+#include "ASFrameTimeStats.h"
+#include "ASMemory.h"
+#include "ASFrameArena.h"
+
+/*
+******************************************************************
+* Global configuration constants
+******************************************************************
+*/
+
+// Simulation ticks a second, the most ticks one frame may run to catch up after a
+// spike, and whether rendering blends between the last two ticks
+const float SIM_TICK_RATE   = 60.0f;
+const int   SIM_MAX_STEPS   = 5;
+const bool  SIM_INTERPOLATE = true;
+
+// Whether the simulation runs a frame ahead on its own thread, or inline before each frame
+const bool PIPELINE_THREADED = true;
+
+// Worker threads in the job system, 0 for one per core besides the main thread, and the
+// jobs in the scheduling benchmark and rounds of the stress test run at start up with
+// -benchmark (0 skips the stress test)
+const int JOB_WORKERS        = 0;
+const int JOB_BENCHMARK_JOBS = 100000;
+const int JOB_STRESS_ROUNDS  = 100;
+
+// Frames a second Run() is held to, 0 leaves it to vsync or runs flat out, and how long
+// before each frame's deadline the pacer stops sleeping and spins
+const float FRAME_RATE_LIMIT = 0.0f;
+const float PACER_SPIN_MS    = 1.5f;
+
+// Time the benchmark moves along its camera path each frame, a set time rather than
+// the real one so every run draws the same frames, and where each frame is written
+const float       BENCHMARK_FRAME_MS = 1000.0f / 60.0f;
+const char* const BENCHMARK_CSV      = "./log/benchmark.csv";
+
+// Zones the profiler can hold for each thread, and where its trace is written
+const int         PROFILER_ZONES = 1 << 17;
+const char* const PROFILER_TRACE = "./log/profile.json";
+
+// Frames the frame time statistics are kept over, and the length in ms past which a
+// frame counts as a spike
+const int   FRAME_STATS_WINDOW   = 4096;
+const float FRAME_STATS_SPIKE_MS = 1000.0f / 30.0f;
+
+// Scratch memory the render thread has for each frame, see ASFrameArena.h
+const size_t FRAME_ARENA_BYTES = 1 << 20;
+
+// Frames drawn before the engine counts as warmed up, after which a frame should make
+// no heap allocations on any thread
+const int HEAP_CHECK_WARMUP = 120;
+
+// Frames a headless run draws, the size of the screen it pretends to have, and the time
+// each frame is taken to last so runs are repeatable (0 to use the real time instead)
+const int   HEADLESS_FRAMES   = 1000;
+const int   HEADLESS_WIDTH    = 1280;
+const int   HEADLESS_HEIGHT   = 720;
+const float HEADLESS_FRAME_MS = 1000.0f / 60.0f;
+
+/*
+******************************************************************
+* Headless backends
+******************************************************************
+*/
+
+#ifdef AS_HEADLESS
+typedef ASNullInput    ASInput;
+typedef ASNullGraphics ASGraphics;
+typedef ASNullSound    ASSound;
+
+#ifndef _WIN32
+typedef void*          HINSTANCE;
+typedef void*          HWND;
+typedef const wchar_t* LPCWSTR;
+#endif
+#endif
 
 /*
 ******************************************************************
 * Class declaration
 ******************************************************************
+* Thread ownership: with PIPELINE_THREADED the simulation runs on
+* its own thread, see ASFramePipeline.h.  It alone touches m_input,
+* m_inputLog, m_cameraPath, m_player, m_frameTimer, m_fixedStep,
+* the three camera ticks and the enemy positions below.  The render
+* thread, the one that calls Run(), alone touches the window,
+* m_graphics, m_fpsCounter, m_cpuMonitor, m_frameStats, m_benchmark
+* and the frame arena.  Each frame the simulation copies what is
+* drawn into a snapshot, and the renderer only reads that snapshot.
+* Everything is created in Init() and released in Release() on the
+* render thread while the simulation is not running
+******************************************************************
 */
 
 class ASEngine 
@@ -62,25 +187,52 @@ public:
 	bool Init();
 	void Release();
 	void Run();
+	void SetFrameLimit(int);
+	void SetFrameRateLimit(float);
+	void SetInputLog(ASInputLog::ASMode, const char*);
+	void SetBenchmark(const char*);
+	void SetProfiling(bool);
 
+	ASFrameTimeStats* GetFrameTimeStats();
+
+#ifndef AS_HEADLESS
 	// WINAPI Callback to handle inputs
 	LRESULT CALLBACK MessageHandler(HWND, UINT, WPARAM, LPARAM);
+#endif
 
 private:
 	// Private methoder
-	bool DispatchASEvent();
+	bool DispatchASEvent(const ASFrameSnapshot&);
+	bool Simulate(ASFrameSnapshot&);
+	static bool SimulateFrame(ASFrameSnapshot&, void*);
 	void InitASWindow(int&, int&);
+	void ReadInputFrame(float);
 	bool ProcessInput(float);
+	void InterpolateCamera(float);
 	void CloseASWindow();
+	void ShowError(LPCWSTR);
+	void ReportFrames(int, double, double, double, ASVector3);
 
 private:
 	// Private member variables
 	LPCWSTR     m_appName;
 	HINSTANCE   m_hInstance;
 	HWND        m_hwnd;
-	ASGraphics::ASCameraInfo m_camInfo;
+	int         m_frameLimit;		// frames Run() draws before it returns, 0 for no limit
+	float       m_frameRateLimit;	// frames a second Run() is held to, 0 for no limit
+	ASInputLog::ASMode m_inputLogMode;	// whether Init() starts recording or replaying input
+	string      m_inputLogPath;
+	string      m_benchmarkPath;	// camera path the benchmark flies, empty to play normally
+	bool        m_profiling;		// whether the profiler records this run
+	ASGraphics::ASCameraInfo m_camInfo;		// what is drawn, blended between the two ticks below
+	ASGraphics::ASCameraInfo m_prevTick;
+	ASGraphics::ASCameraInfo m_currTick;
 
 	ASInput*    m_input;
+	ASInputLog* m_inputLog;
+	ASInputLog::ASInputFrame m_inputFrame;	// what the player acts on this frame, read or replayed
+	int         m_mouseX;		// where the mouse was last frame
+	int         m_mouseY;
 	ASGraphics* m_graphics;
 	ASSound*    m_environment;
 	ASPlayer*   m_player;
@@ -89,6 +241,21 @@ private:
 	ASFPSCounter* m_fpsCounter;
 	ASCPUMonitor* m_cpuMonitor;
 	ASFrameTimer* m_frameTimer;
+	ASFixedStep*  m_fixedStep;
+	ASFramePipeline* m_pipeline;
+	ASFramePacer* m_framePacer;
+	ASFrameTimeStats* m_frameStats;	// the length of each frame, pacing included
+	ASCameraPath* m_cameraPath;		// set only when running the benchmark
+	ASBenchmark*  m_benchmark;
+	int           m_benchmarkFrame;	// frames simulated along the camera path
+	int           m_steadyFrames;		// frames drawn after HEAP_CHECK_WARMUP
+	int           m_allocatingFrames;	// those of them that allocated from the heap
+	long long     m_steadyAllocations;	// and how many allocations they made
+
+	// Enemy positions, owned by the simulation
+	vector<float> m_enemyX;
+	vector<float> m_enemyY;
+	vector<float> m_enemyZ;
 };
 
 /*
@@ -101,9 +268,8 @@ private:
 ******************************************************************
 */
 
+#ifndef AS_HEADLESS
 static LRESULT CALLBACK WndProc(HWND, UINT, WPARAM, LPARAM);
-
-// ASEngine instance handle (can only ever be one instance in memory)
-static ASEngine* EngineInstance = 0;
+#endif
 
 #endif
\ No newline at end of file
@@ -26,7 +26,7 @@ ASFPSCounter::ASFPSCounter()
 ******************************************************************
 */
 
-ASFPSCounter::ASFPSCounter(const ASFPSCounter& engine) 
+ASFPSCounter::ASFPSCounter(const ASFPSCounter&) 
 {}
 
 /*
@@ -49,7 +49,7 @@ void ASFPSCounter::Init()
 {
 	m_fps = 0;
 	m_count = 0;
-	m_startTime = timeGetTime();
+	m_startTime = ASClock::GetMilliseconds();
 }
 
 /*
@@ -67,12 +67,12 @@ void ASFPSCounter::IncrementFrameCount()
 	m_count++;
 
 	// Check if we need to reset the timer (1sec passed)
-	if(timeGetTime() >= (m_startTime + 1000))
+	if(ASClock::GetMilliseconds() >= (m_startTime + 1000))
 	{
 		m_fps = m_count;
 		m_count = 0;
 
-		m_startTime = timeGetTime();
+		m_startTime = ASClock::GetMilliseconds();
 	}
 }
 
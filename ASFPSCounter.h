@@ -11,22 +11,13 @@
 #ifndef _ASFPSCOUNTER_H_
 #define _ASFPSCOUNTER_H_
 
-/*
-******************************************************************
-* Pre-processing directives
-******************************************************************
-*/
-
-#pragma comment(lib, "winmm.lib")
-
 /*
 ******************************************************************
 * Includes
 ******************************************************************
 */
 
-#include <windows.h>
-#include <mmsystem.h>
+#include "ASClock.h"
 
 /*
 ******************************************************************
@@ -51,7 +42,7 @@ private:
 	// Private members
 	int m_fps;
 	int m_count;
-	unsigned long m_startTime;
+	double m_startTime;		// ms, from ASClock
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,149 @@
+/*
+******************************************************************
+* ASFileMap.cpp
+*******************************************************************
+* Implements all methods from ASFileMap.h
+*******************************************************************
+*/
+
+#include "ASFileMap.h"
+
+/*
+*******************************************************************
+* Constructor
+*******************************************************************
+* Set all handles to null, Init() will open them
+*/
+
+ASFileMap::ASFileMap()
+{
+	m_file    = INVALID_HANDLE_VALUE;
+	m_mapping = 0;
+	m_data    = 0;
+	m_size    = 0;
+}
+
+/*
+*******************************************************************
+* Empty Constructor
+*******************************************************************
+*/
+
+ASFileMap::ASFileMap(const ASFileMap&)
+{}
+
+/*
+*******************************************************************
+* Destructor
+*******************************************************************
+* The map is released here as well, this allows the map to live
+* on the stack of a loader and be cleaned up on every return path
+*/
+
+ASFileMap::~ASFileMap()
+{
+	Release();
+}
+
+/*
+*******************************************************************
+* METHOD: Init
+*******************************************************************
+* Opens the file for reading and maps a read only view of the
+* whole file.  Empty files are rejected as they cannot be mapped
+*
+* @param const char* - the path of the file to map
+*
+* @return bool - True if the file was mapped, else false
+*/
+
+bool ASFileMap::Init(const char* filename)
+{
+	LARGE_INTEGER size;
+
+	// Open the file, allowing other readers to share it
+	m_file = CreateFileA(filename, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+						 FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+	if(m_file == INVALID_HANDLE_VALUE)
+		return false;
+
+	// Files larger than 4GB are not supported, and empty files have nothing to map
+	if(!GetFileSizeEx(m_file, &size) || size.HighPart != 0 || size.LowPart == 0)
+	{
+		Release();
+		return false;
+	}
+	m_size = size.LowPart;
+
+	// Create the mapping object, then map a view of the entire file
+	m_mapping = CreateFileMapping(m_file, NULL, PAGE_READONLY, 0, 0, NULL);
+	if(!m_mapping)
+	{
+		Release();
+		return false;
+	}
+
+	m_data = (const char*)MapViewOfFile(m_mapping, FILE_MAP_READ, 0, 0, 0);
+	if(!m_data)
+	{
+		Release();
+		return false;
+	}
+
+	return true;
+}
+
+/*
+*******************************************************************
+* METHOD: Get Data
+*******************************************************************
+* @return const char* - pointer to the first byte of the file
+*/
+
+const char* ASFileMap::GetData()
+{
+	return m_data;
+}
+
+/*
+*******************************************************************
+* METHOD: Get Size
+*******************************************************************
+* @return unsigned long - the number of bytes in the mapped file
+*/
+
+unsigned long ASFileMap::GetSize()
+{
+	return m_size;
+}
+
+/*
+*******************************************************************
+* METHOD: Release
+*******************************************************************
+* Unmaps the view and closes both handles
+*/
+
+void ASFileMap::Release()
+{
+	// Unmap the view of the file
+	if(m_data)
+	{
+		UnmapViewOfFile(m_data);
+		m_data = 0;
+	}
+	// Close the mapping object
+	if(m_mapping)
+	{
+		CloseHandle(m_mapping);
+		m_mapping = 0;
+	}
+	// Close the file
+	if(m_file != INVALID_HANDLE_VALUE)
+	{
+		CloseHandle(m_file);
+		m_file = INVALID_HANDLE_VALUE;
+	}
+
+	m_size = 0;
+}
@@ -0,0 +1,51 @@
+/*
+******************************************************************
+* ASFileMap.h
+*******************************************************************
+* Maps a file on disk into the address space of the process so
+* that loaders can read it in place, without copying it through
+* a stream buffer first
+*******************************************************************
+*/
+
+#ifndef _ASFILEMAP_H_
+#define _ASFILEMAP_H_
+
+/*
+*******************************************************************
+* Includes:
+*******************************************************************
+*/
+
+#include <windows.h>
+
+/*
+*******************************************************************
+* Class declaration
+*******************************************************************
+*/
+
+class ASFileMap
+{
+public:
+	// Constructors and destructor
+	ASFileMap();
+	ASFileMap(const ASFileMap&);
+	~ASFileMap();
+
+	// Public methods
+	bool Init(const char*);
+	void Release();
+
+	const char*   GetData();
+	unsigned long GetSize();
+
+private:
+	// Private member variables
+	HANDLE        m_file;
+	HANDLE        m_mapping;
+	const char*   m_data;
+	unsigned long m_size;
+};
+
+#endif
@@ -0,0 +1,217 @@
+/*
+******************************************************************
+* ASFixedStep.cpp
+*******************************************************************
+* Implements all methods from ASFixedStep.h
+*******************************************************************
+*/
+
+#include "ASFixedStep.h"
+
+/*
+*******************************************************************
+* Constructor
+*******************************************************************
+*/
+
+ASFixedStep::ASFixedStep()
+{
+	Init(60.0f, 5, true);
+}
+
+/*
+*******************************************************************
+* Empty Constructor
+*******************************************************************
+*/
+
+ASFixedStep::ASFixedStep(const ASFixedStep&)
+{}
+
+/*
+*******************************************************************
+* Destructor
+*******************************************************************
+*/
+
+ASFixedStep::~ASFixedStep()
+{}
+
+/*
+*******************************************************************
+* METHOD: Init
+*******************************************************************
+* @param float - ticks a second
+* @param int   - the most ticks one frame may run to catch up
+* @param bool  - True to blend rendering between the last two ticks,
+*                false to draw the last tick as it is
+*/
+
+void ASFixedStep::Init(float tickRate, int maxSteps, bool interpolate)
+{
+	m_stepMs      = 1000.0f / tickRate;
+	m_accumulator = 0.0f;
+
+	m_stats.tickRate    = tickRate;
+	m_stats.maxSteps    = maxSteps;
+	m_stats.interpolate = interpolate;
+	m_stats.numFrames   = 0;
+	m_stats.numTicks    = 0;
+	m_stats.numCapped   = 0;
+	m_stats.droppedMs   = 0.0;
+	m_stats.lastSteps   = 0;
+	m_stats.lastAlpha   = 0.0f;
+}
+
+/*
+*******************************************************************
+* METHOD: Advance
+*******************************************************************
+* Adds a frame's time to the accumulator and takes out the ticks
+* it pays for, the caller then runs that many ticks of GetStep()
+*
+* @param float - the frame time in ms
+*
+* @return int - the number of ticks to run this frame
+*/
+
+int ASFixedStep::Advance(float frameTime)
+{
+	int steps = 0;
+
+	if(frameTime > 0.0f)
+		m_accumulator += frameTime;
+
+	while((m_accumulator >= m_stepMs) && (steps < m_stats.maxSteps))
+	{
+		m_accumulator -= m_stepMs;
+		steps++;
+	}
+
+	// Too far behind, drop whole ticks so the next frame starts fresh
+	if(m_accumulator >= m_stepMs)
+	{
+		float dropped = m_accumulator - fmodf(m_accumulator, m_stepMs);
+
+		m_accumulator      -= dropped;
+		m_stats.droppedMs += dropped;
+		m_stats.numCapped++;
+	}
+
+	m_stats.numFrames++;
+	m_stats.numTicks += steps;
+	m_stats.lastSteps = steps;
+	m_stats.lastAlpha = GetAlpha();
+
+	return steps;
+}
+
+/*
+*******************************************************************
+* METHOD: Get Step
+*******************************************************************
+* @return float - the length of one tick in ms
+*/
+
+float ASFixedStep::GetStep()
+{
+	return m_stepMs;
+}
+
+/*
+*******************************************************************
+* METHOD: Get Alpha
+*******************************************************************
+* @return float - how far from the last tick towards the next the
+*                 frame is, 0 to 1, or 1 when interpolation is off
+*                 so the last tick is drawn as it is
+*/
+
+float ASFixedStep::GetAlpha()
+{
+	if(!m_stats.interpolate)
+		return 1.0f;
+
+	return m_accumulator / m_stepMs;
+}
+
+/*
+*******************************************************************
+* METHOD: Get Stats
+*******************************************************************
+* @return const ASStats& - the settings and totals since Init
+*/
+
+const ASFixedStep::ASStats& ASFixedStep::GetStats()
+{
+	return m_stats;
+}
+
+/*
+*******************************************************************
+* METHOD: Report
+*******************************************************************
+* Appends the settings and totals to ./log/fixed-step.txt
+*
+* @param const char* - a label for this report
+*/
+
+void ASFixedStep::Report(const char* label)
+{
+	ofstream fout;
+
+	fout.open("./log/fixed-step.txt", ios::app);
+	if(fout.fail())
+		return;
+
+	double ticksPerFrame = (m_stats.numFrames > 0) ? (double)m_stats.numTicks / (double)m_stats.numFrames : 0.0;
+
+	fout << "Fixed step " << label << ": " << m_stats.tickRate << " ticks/s (" << m_stepMs << " ms), "
+		 << "at most " << m_stats.maxSteps << " a frame, interpolation " << (m_stats.interpolate ? "on" : "off") << ", "
+		 << m_stats.numTicks << " ticks over " << m_stats.numFrames << " frames (" << ticksPerFrame << " a frame), "
+		 << m_stats.numCapped << " frames capped, " << m_stats.droppedMs << " ms dropped" << endl;
+
+	fout.close();
+}
+
+/*
+*******************************************************************
+* METHOD: Lerp
+*******************************************************************
+* @param float - the value at the previous tick
+* @param float - the value at the last tick
+* @param float - the blend, 0 gives the previous tick and 1 the last
+*
+* @return float - the blended value
+*/
+
+float ASFixedStep::Lerp(float from, float to, float alpha)
+{
+	return from + ((to - from) * alpha);
+}
+
+/*
+*******************************************************************
+* METHOD: Lerp Angle
+*******************************************************************
+* Blends two angles in degrees the short way round, so a turn from
+* 359 to 1 passes through 0 rather than back through 180
+*
+* @param float - the angle at the previous tick
+* @param float - the angle at the last tick
+* @param float - the blend, 0 gives the previous tick and 1 the last
+*
+* @return float - the blended angle
+*/
+
+float ASFixedStep::LerpAngle(float from, float to, float alpha)
+{
+	float delta = fmodf(to - from, 360.0f);
+
+	if(delta > 180.0f)
+		delta -= 360.0f;
+	else if(delta < -180.0f)
+		delta += 360.0f;
+
+	return from + (delta * alpha);
+}
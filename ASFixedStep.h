@@ -0,0 +1,80 @@
+/*
+******************************************************************
+* ASFixedStep.h
+*******************************************************************
+* Runs the simulation at a fixed tick rate whatever the frame rate.
+* Each frame the time it took is added to an accumulator and whole
+* ticks are taken out of it, so the player moves the same distance
+* for the same input at 30 or 300 frames a second.  A long frame
+* runs at most a set number of ticks to catch up, the rest of its
+* time is dropped rather than letting the simulation fall further
+* and further behind.
+*
+* What is left in the accumulator is the fraction of a tick the
+* frame sits past the last one, rendering blends the state of the
+* last two ticks by that fraction so motion stays smooth between
+* ticks.  Times are in milliseconds, as ASFrameTimer gives them
+*******************************************************************
+*/
+
+#ifndef _ASFIXEDSTEP_H_
+#define _ASFIXEDSTEP_H_
+
+/*
+*******************************************************************
+* Includes:
+*******************************************************************
+*/
+
+#include <math.h>
+#include <fstream>
+
+using namespace std;
+
+/*
+*******************************************************************
+* Class declaration
+*******************************************************************
+*/
+
+class ASFixedStep
+{
+public:
+	struct ASStats
+	{
+		float              tickRate;		// ticks a second
+		int                maxSteps;		// most ticks one frame may run
+		bool               interpolate;		// whether rendering blends between ticks
+		unsigned long long numFrames;		// totals since Init
+		unsigned long long numTicks;
+		unsigned long long numCapped;		// frames that hit maxSteps
+		double             droppedMs;		// time thrown away by capped frames
+		int                lastSteps;		// ticks run by the last frame
+		float              lastAlpha;		// blend used by the last frame
+	};
+
+public:
+	// Constructors and destructor
+	ASFixedStep();
+	ASFixedStep(const ASFixedStep&);
+	~ASFixedStep();
+
+	// Public methods
+	void  Init(float, int, bool);
+	int   Advance(float);
+	float GetStep();
+	float GetAlpha();
+	const ASStats& GetStats();
+	void  Report(const char*);
+
+	static float Lerp(float, float, float);
+	static float LerpAngle(float, float, float);
+
+private:
+	// Private member variables
+	float   m_stepMs;
+	float   m_accumulator;		// time not yet simulated, always under one tick after Advance()
+	ASStats m_stats;
+};
+
+#endif
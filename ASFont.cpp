@@ -88,7 +88,7 @@ bool ASFont::LoadFont(char* fontFile)
 	char readChar;
 
 	// Create a new ASFontType array with characters equal to the number of elems in the file
-	m_font = new ASFontType[95];
+	m_font = ASNewArray<ASFontType>(95, MEMORY_TEXT);
 	if(!m_font)
 		return false;
 
@@ -257,8 +257,7 @@ void ASFont::ReleaseFont()
 {
 	if(m_font)
 	{
-		delete [] m_font;
-		m_font = 0;
+		ASDeleteArray(m_font);
 	}
 }
 
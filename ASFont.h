@@ -20,6 +20,7 @@
 #include <d3d11.h>
 #include <d3dx10math.h>
 #include <fstream>
+#include "ASMemory.h"
 using namespace std;
 
 /*
@@ -21,6 +21,7 @@
 #include <d3dx10math.h>
 #include <d3dx11async.h>
 #include <fstream>
+#include "ASResourceManager.h"
 using namespace std;
 
 /*
@@ -0,0 +1,221 @@
+/*
+******************************************************************
+* ASFrameArena.cpp
+*******************************************************************
+* Implements all methods from ASFrameArena.h
+*******************************************************************
+*/
+
+#include "ASFrameArena.h"
+
+// Bytes in front of each overflow block, the link to the block before
+static const size_t OVERFLOW_HEADER = 16;
+
+/*
+*******************************************************************
+* Constructor
+*******************************************************************
+*/
+
+ASFrameArena::ASFrameArena()
+{
+	m_buffer         = 0;
+	m_capacity       = 0;
+	m_used           = 0;
+	m_overflowBytes  = 0;
+	m_peak           = 0;
+	m_overflow       = 0;
+	m_numFrames      = 0;
+	m_overflowFrames = 0;
+}
+
+/*
+*******************************************************************
+* Empty Constructor
+*******************************************************************
+*/
+
+ASFrameArena::ASFrameArena(const ASFrameArena&)
+{}
+
+/*
+*******************************************************************
+* Destructor
+*******************************************************************
+*/
+
+ASFrameArena::~ASFrameArena()
+{}
+
+/*
+*******************************************************************
+* METHOD: Get Instance
+*******************************************************************
+* @return ASFrameArena* - the render thread's arena
+*/
+
+ASFrameArena* ASFrameArena::GetInstance()
+{
+	static ASFrameArena arena;
+	return &arena;
+}
+
+/*
+*******************************************************************
+* METHOD: Init
+*******************************************************************
+* @param size_t - the bytes a frame is expected to need at most
+*
+* @return bool - false if the buffer could not be allocated
+*/
+
+bool ASFrameArena::Init(size_t capacity)
+{
+	m_buffer = (char*)ASMemory::Allocate(capacity, MEMORY_FRAME);
+	if(!m_buffer)
+		return false;
+
+	m_capacity = capacity;
+	m_used     = 0;
+
+	return true;
+}
+
+/*
+*******************************************************************
+* METHOD: Release
+*******************************************************************
+*/
+
+void ASFrameArena::Release()
+{
+	Reset();
+
+	ASMemory::Free(m_buffer);
+	m_buffer   = 0;
+	m_capacity = 0;
+}
+
+/*
+*******************************************************************
+* METHOD: Allocate
+*******************************************************************
+* @param size_t - the bytes wanted
+* @param size_t - what their address must be a multiple of, a power
+*                 of two
+*
+* @return void* - memory that lasts until Reset(), or 0 if the
+*                 buffer is full and so is the heap
+*/
+
+void* ASFrameArena::Allocate(size_t size, size_t align)
+{
+	size_t base  = (size_t)m_buffer;
+	size_t start = ((base + m_used + align - 1) & ~(align - 1)) - base;
+
+	if(m_buffer && start + size <= m_capacity)
+	{
+		m_used = start + size;
+		return m_buffer + start;
+	}
+
+	// Out of room, take a block from the heap for this frame only
+	char* block = (char*)ASMemory::Allocate(OVERFLOW_HEADER + size + align, MEMORY_FRAME);
+	if(!block)
+		return 0;
+
+	*(void**)block   = m_overflow;
+	m_overflow       = block;
+	m_overflowBytes += size;
+
+	return (void*)(((size_t)block + OVERFLOW_HEADER + align - 1) & ~(align - 1));
+}
+
+/*
+*******************************************************************
+* METHOD: Reset
+*******************************************************************
+* Called at the end of each frame, everything allocated since the
+* last Reset() is given up
+*/
+
+void ASFrameArena::Reset()
+{
+	if(m_used + m_overflowBytes > m_peak)
+		m_peak = m_used + m_overflowBytes;
+
+	if(m_overflow)
+		m_overflowFrames++;
+
+	while(m_overflow)
+	{
+		void* previous = *(void**)m_overflow;
+		ASMemory::Free(m_overflow);
+		m_overflow = previous;
+	}
+
+	m_used          = 0;
+	m_overflowBytes = 0;
+	m_numFrames++;
+}
+
+/*
+*******************************************************************
+* METHOD: Get Capacity
+*******************************************************************
+* @return size_t - the bytes in the buffer
+*/
+
+size_t ASFrameArena::GetCapacity()
+{
+	return m_capacity;
+}
+
+/*
+*******************************************************************
+* METHOD: Get Used
+*******************************************************************
+* @return size_t - bytes allocated this frame, overflow included
+*/
+
+size_t ASFrameArena::GetUsed()
+{
+	return m_used + m_overflowBytes;
+}
+
+/*
+*******************************************************************
+* METHOD: Get Peak
+*******************************************************************
+* @return size_t - the most bytes a frame has allocated
+*/
+
+size_t ASFrameArena::GetPeak()
+{
+	return m_peak;
+}
+
+/*
+*******************************************************************
+* METHOD: Report
+*******************************************************************
+* Appends how much of the buffer frames used to
+* ./log/frame-arena.txt
+*
+* @param const char* - a label for this report
+*/
+
+void ASFrameArena::Report(const char* label)
+{
+	ofstream fout;
+
+	fout.open("./log/frame-arena.txt", ios::app);
+	if(fout.fail())
+		return;
+
+	fout << "Frame arena " << label << ": " << m_capacity << " bytes, at most " << m_peak
+		 << " used in a frame, " << m_overflowFrames << " of " << m_numFrames
+		 << " frames outgrew it" << endl;
+
+	fout.close();
+}
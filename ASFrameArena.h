@@ -0,0 +1,87 @@
+/*
+******************************************************************
+* ASFrameArena.h
+*******************************************************************
+* Scratch memory for the render thread that lasts until the end of
+* the frame.  Allocating moves a pointer along one buffer taken up
+* front and nothing is freed on its own, the engine calls Reset()
+* once each frame is drawn and the whole buffer is used again:
+*
+*     ASVertex* vertices = ASFrameArena::GetInstance()->AllocateArray<ASVertex>(numVertices);
+*
+* Only types that need no destructor should be put in it.  Should
+* a frame ask for more than the buffer holds the rest comes from
+* the heap until Reset(), it still works but the overflow is counted
+* and Report() shows how big the buffer needs to be.  Only the
+* render thread uses the arena
+*******************************************************************
+*/
+
+#ifndef _ASFRAMEARENA_H_
+#define _ASFRAMEARENA_H_
+
+/*
+*******************************************************************
+* Includes:
+*******************************************************************
+* + ASMemory.h has been included to tag the buffer
+*******************************************************************
+*/
+
+#include <new>
+#include <fstream>
+#include "ASMemory.h"
+
+using namespace std;
+
+/*
+*******************************************************************
+* Class declaration
+*******************************************************************
+*/
+
+class ASFrameArena
+{
+public:
+	// Constructors / Destructor prototype
+	ASFrameArena();
+	ASFrameArena(const ASFrameArena&);
+	~ASFrameArena();
+
+	// Public methods
+	static ASFrameArena* GetInstance();
+
+	bool  Init(size_t);
+	void  Release();
+	void* Allocate(size_t, size_t);
+	void  Reset();
+	size_t GetCapacity();
+	size_t GetUsed();
+	size_t GetPeak();
+	void  Report(const char*);
+
+	template<class T> T* AllocateArray(size_t count)
+	{
+		T* elements = (T*)Allocate(count * sizeof(T), __alignof(T));
+		if(!elements)
+			return 0;
+
+		for(size_t i = 0; i < count; i++)
+			new(elements + i) T;
+
+		return elements;
+	}
+
+private:
+	// Private member variables
+	char*     m_buffer;
+	size_t    m_capacity;
+	size_t    m_used;			// bytes of the buffer handed out this frame
+	size_t    m_overflowBytes;	// bytes that came from the heap this frame
+	size_t    m_peak;			// the most a frame has used, overflow included
+	void*     m_overflow;		// heap blocks taken this frame, each links to the one before
+	long long m_numFrames;		// calls to Reset()
+	long long m_overflowFrames;	// frames that outgrew the buffer
+};
+
+#endif
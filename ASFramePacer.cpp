@@ -0,0 +1,213 @@
+/*
+******************************************************************
+* ASFramePacer.cpp
+*******************************************************************
+* Implements all methods from ASFramePacer.h
+*******************************************************************
+*/
+
+#include "ASFramePacer.h"
+
+/*
+*******************************************************************
+* Constructor
+*******************************************************************
+*/
+
+ASFramePacer::ASFramePacer()
+{
+	m_timerPeriodSet = false;
+	Init(0.0f, 0.0f);
+}
+
+/*
+*******************************************************************
+* Empty Constructor
+*******************************************************************
+*/
+
+ASFramePacer::ASFramePacer(const ASFramePacer&)
+{}
+
+/*
+*******************************************************************
+* Destructor
+*******************************************************************
+*/
+
+ASFramePacer::~ASFramePacer()
+{}
+
+/*
+*******************************************************************
+* METHOD: Init
+*******************************************************************
+* Sets the target rate and starts the schedule from now.  On Windows
+* the system timer is set to 1 ms while pacing, so a sleep wakes
+* close to when it was asked to
+*
+* @param float - frames a second, 0 or less to not cap the rate
+* @param float - ms before each deadline to stop sleeping and spin
+*/
+
+void ASFramePacer::Init(float targetFps, float spinMs)
+{
+	Release();
+
+	m_period     = (targetFps > 0.0f) ? 1.0 / targetFps : 0.0;
+	m_spinWindow = spinMs / 1000.0;
+	m_start      = ASClock::GetSeconds();
+	m_lastFrame  = m_start;
+	m_deadline   = m_start + m_period;
+
+	m_stats.targetFps        = (targetFps > 0.0f) ? targetFps : 0.0f;
+	m_stats.numFrames        = 0;
+	m_stats.numLate          = 0;
+	m_stats.jitterSeconds    = 0.0;
+	m_stats.jitterSquared    = 0.0;
+	m_stats.jitterMaxSeconds = 0.0;
+	m_stats.sleepSeconds     = 0.0;
+	m_stats.spinSeconds      = 0.0;
+	m_stats.wallSeconds      = 0.0;
+
+#ifdef _WIN32
+	if(m_period > 0.0)
+		m_timerPeriodSet = (timeBeginPeriod(1) == TIMERR_NOERROR);
+#endif
+}
+
+/*
+*******************************************************************
+* METHOD: Release
+*******************************************************************
+* Puts the system timer back as it was
+*/
+
+void ASFramePacer::Release()
+{
+#ifdef _WIN32
+	if(m_timerPeriodSet)
+		timeEndPeriod(1);
+#endif
+	m_timerPeriodSet = false;
+}
+
+/*
+*******************************************************************
+* METHOD: Wait
+*******************************************************************
+* Called once at the end of every frame, returns at the frame's
+* deadline, or straight away if the rate is not capped or the frame
+* is already late
+*/
+
+void ASFramePacer::Wait()
+{
+	AS_PROFILE("ASFramePacer::Wait");
+
+	double now = ASClock::GetSeconds();
+
+	if(m_period > 0.0)
+	{
+		if(now < m_deadline)
+		{
+			// Sleep most of the way, then spin
+			double sleepUntil = m_deadline - m_spinWindow;
+			if(now < sleepUntil)
+			{
+				this_thread::sleep_for(chrono::microseconds((long long)((sleepUntil - now) * 1000000.0)));
+				double woke = ASClock::GetSeconds();
+				m_stats.sleepSeconds += woke - now;
+				now = woke;
+			}
+
+			double spinStart = now;
+			while(now < m_deadline)
+			{
+				this_thread::yield();
+				now = ASClock::GetSeconds();
+			}
+			m_stats.spinSeconds += now - spinStart;
+		}
+		else
+			m_stats.numLate++;
+
+		// The next deadline follows on from this one, unless this frame was so late
+		// that catching up would mean running frames back to back
+		m_deadline += m_period;
+		if(m_deadline < now)
+			m_deadline = now + m_period;
+	}
+
+	// How far the frame that just ended was from the period, the first frame is
+	// left out as it was timed from Init
+	if(m_period > 0.0 && m_stats.numFrames > 0)
+	{
+		double jitter = fabs((now - m_lastFrame) - m_period);
+
+		m_stats.jitterSeconds += jitter;
+		m_stats.jitterSquared += jitter * jitter;
+		if(jitter > m_stats.jitterMaxSeconds)
+			m_stats.jitterMaxSeconds = jitter;
+	}
+
+	m_stats.numFrames++;
+	m_stats.wallSeconds = now - m_start;
+	m_lastFrame = now;
+}
+
+/*
+*******************************************************************
+* METHOD: Get Stats
+*******************************************************************
+* @return const ASStats& - the totals since Init
+*/
+
+const ASFramePacer::ASStats& ASFramePacer::GetStats()
+{
+	return m_stats;
+}
+
+/*
+*******************************************************************
+* METHOD: Report
+*******************************************************************
+* Appends the rate reached, how far frames strayed from the period
+* and where the waiting went to ./log/frame-pacer.txt
+*
+* @param const char* - a label for this report
+*/
+
+void ASFramePacer::Report(const char* label)
+{
+	ofstream fout;
+
+	if(m_stats.numFrames == 0)
+		return;
+
+	fout.open("./log/frame-pacer.txt", ios::app);
+	if(fout.fail())
+		return;
+
+	double frames = (double)m_stats.numFrames;
+	double paced  = (m_stats.numFrames > 1) ? (double)(m_stats.numFrames - 1) : 1.0;
+	double mean   = m_stats.jitterSeconds / paced;
+	double spread = sqrt(fabs((m_stats.jitterSquared / paced) - (mean * mean)));
+
+	fout << "Frame pacer " << label << ": target ";
+	if(m_stats.targetFps > 0.0f)
+		fout << m_stats.targetFps << " frames/s";
+	else
+		fout << "none";
+	fout << ", " << m_stats.numFrames << " frames in " << m_stats.wallSeconds << " s, "
+		 << (frames / m_stats.wallSeconds) << " frames/s, " << m_stats.numLate << " late" << endl;
+	if(m_stats.targetFps > 0.0f)
+	{
+		fout << "  jitter " << (mean * 1000.0) << " ms (deviation " << (spread * 1000.0) << " ms, max "
+			 << (m_stats.jitterMaxSeconds * 1000.0) << " ms)" << endl;
+	}
+	fout << "  slept " << (m_stats.sleepSeconds * 1000.0 / frames) << " ms and spun "
+		 << (m_stats.spinSeconds * 1000.0 / frames) << " ms a frame" << endl;
+
+	fout.close();
+}
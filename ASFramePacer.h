@@ -0,0 +1,99 @@
+/*
+******************************************************************
+* ASFramePacer.h
+*******************************************************************
+* Holds the frame loop to a target rate.  Each frame has a deadline
+* one period after the last one, the pacer sleeps until just short
+* of it then spins the rest of the way, since a sleep can overshoot
+* by a millisecond or more but spinning the whole wait would keep a
+* core busy.  Deadlines follow on from each other rather than from
+* when the frame ended, so small overshoots do not add up; a frame
+* that misses its deadline by a whole period starts the schedule
+* again instead of running the next frames back to back.
+*
+* How far each frame's length is from the period is measured, so
+* the report shows how evenly frames were paced as well as the time
+* spent sleeping and spinning
+*******************************************************************
+*/
+
+#ifndef _ASFRAMEPACER_H_
+#define _ASFRAMEPACER_H_
+
+/*
+*******************************************************************
+* Pre-processing directives
+*******************************************************************
+*/
+
+#ifdef _WIN32
+#pragma comment(lib, "winmm.lib")
+#endif
+
+/*
+*******************************************************************
+* Includes:
+*******************************************************************
+*/
+
+#include <math.h>
+#include <fstream>
+#include <thread>
+#include <chrono>
+#include "ASProfiler.h"
+#include "ASClock.h"
+
+#ifdef _WIN32
+#include <mmsystem.h>
+#endif
+
+using namespace std;
+
+/*
+*******************************************************************
+* Class declaration
+*******************************************************************
+*/
+
+class ASFramePacer
+{
+public:
+	struct ASStats
+	{
+		float              targetFps;		// 0 when the rate is not capped
+		unsigned long long numFrames;
+		unsigned long long numLate;			// frames that ended after their deadline
+		double             jitterSeconds;	// total of how far each frame was from the period
+		double             jitterSquared;
+		double             jitterMaxSeconds;
+		double             sleepSeconds;	// time spent sleeping and spinning
+		double             spinSeconds;
+		double             wallSeconds;
+	};
+
+public:
+	// Constructors and destructor
+	ASFramePacer();
+	ASFramePacer(const ASFramePacer&);
+	~ASFramePacer();
+
+	// Public methods
+	void Init(float, float);
+	void Release();
+	void Wait();
+
+	const ASStats& GetStats();
+	void Report(const char*);
+
+private:
+	// Private member variables
+	double  m_period;		// seconds a frame, 0 for no cap
+	double  m_spinWindow;	// seconds before the deadline the pacer stops sleeping
+	double  m_deadline;
+	double  m_lastFrame;	// when the last frame was let go
+	double  m_start;
+	bool    m_timerPeriodSet;
+	ASStats m_stats;
+};
+
+#endif
@@ -0,0 +1,315 @@
+/*
+******************************************************************
+* ASFramePipeline.cpp
+*******************************************************************
+* Implements all methods from ASFramePipeline.h
+*******************************************************************
+*/
+
+#include "ASFramePipeline.h"
+
+/*
+*******************************************************************
+* Constructor
+*******************************************************************
+*/
+
+ASFramePipeline::ASFramePipeline()
+{
+	m_simulate = 0;
+	m_context  = 0;
+	m_running  = false;
+}
+
+/*
+*******************************************************************
+* Empty Constructor
+*******************************************************************
+*/
+
+ASFramePipeline::ASFramePipeline(const ASFramePipeline&)
+{}
+
+/*
+*******************************************************************
+* Destructor
+*******************************************************************
+*/
+
+ASFramePipeline::~ASFramePipeline()
+{}
+
+/*
+*******************************************************************
+* METHOD: Start
+*******************************************************************
+* @param ASSimulate - fills in a snapshot, called once a frame on
+*                     the simulation thread
+* @param void*      - passed to the callback
+* @param bool       - True to simulate on its own thread, false to
+*                     simulate inside Acquire()
+*
+* @return bool - True if the pipeline started, else false
+*/
+
+bool ASFramePipeline::Start(ASSimulate simulate, void* context, bool threaded)
+{
+	m_simulate    = simulate;
+	m_context     = context;
+	m_reading     = -1;
+	m_published   = -1;
+	m_hasNew      = false;
+	m_running     = true;
+	m_nextFrame   = 0;
+	m_renderStart = 0.0;
+	m_firstStart  = 0.0;
+
+	m_stats.threaded          = threaded;
+	m_stats.numFrames         = 0;
+	m_stats.simSeconds        = 0.0;
+	m_stats.simMaxSeconds     = 0.0;
+	m_stats.simWaitSeconds    = 0.0;
+	m_stats.renderSeconds     = 0.0;
+	m_stats.renderWaitSeconds = 0.0;
+	m_stats.latencySeconds    = 0.0;
+	m_stats.latencyMaxSeconds = 0.0;
+	m_stats.wallSeconds       = 0.0;
+
+	for(int i = 0; i < 2; i++)
+	{
+		m_snapshots[i].quit   = false;
+		m_snapshots[i].failed = false;
+	}
+
+	if(threaded)
+		m_thread = thread(&ASFramePipeline::SimulationLoop, this);
+
+	return true;
+}
+
+/*
+*******************************************************************
+* METHOD: Stop
+*******************************************************************
+* Stops the simulation thread once it finishes the frame it is on,
+* safe to call more than once
+*/
+
+void ASFramePipeline::Stop()
+{
+	{
+		lock_guard<mutex> lock(m_mutex);
+		m_running = false;
+	}
+	m_publishSignal.notify_all();
+	m_takeSignal.notify_all();
+
+	if(m_thread.joinable())
+		m_thread.join();
+}
+
+/*
+*******************************************************************
+* METHOD: Acquire
+*******************************************************************
+* Called by the renderer at the start of a frame, waits for the
+* next snapshot and hands it over.  The snapshot from the frame
+* before is given back at the same time, the simulation may now
+* write over it
+*
+* @return const ASFrameSnapshot* - the frame to draw, 0 once the
+*                                  pipeline has been stopped
+*/
+
+const ASFrameSnapshot* ASFramePipeline::Acquire()
+{
+	AS_PROFILE("ASFramePipeline::Acquire");
+
+	double start = ASClock::GetSeconds();
+
+	if(m_stats.threaded)
+	{
+		unique_lock<mutex> lock(m_mutex);
+		while(!m_hasNew && m_running)
+			m_publishSignal.wait(lock);
+		if(!m_hasNew)
+			return 0;
+
+		m_reading = m_published;
+		m_hasNew  = false;
+
+		lock.unlock();
+		m_takeSignal.notify_one();
+	}
+	else
+	{
+		if(!m_running)
+			return 0;
+
+		m_reading = 0;
+		Produce(m_snapshots[0]);
+
+		// Simulating is not waiting
+		start = m_snapshots[0].simEnd;
+	}
+
+	m_renderStart = ASClock::GetSeconds();
+	m_stats.renderWaitSeconds += m_renderStart - start;
+	if(m_stats.numFrames == 0)
+		m_firstStart = m_snapshots[m_reading].simStart;
+
+	return &m_snapshots[m_reading];
+}
+
+/*
+*******************************************************************
+* METHOD: Finish Frame
+*******************************************************************
+* Called by the renderer once the frame from Acquire() has been
+* submitted, records how long it took and how old the snapshot was
+*/
+
+void ASFramePipeline::FinishFrame()
+{
+	double end = ASClock::GetSeconds();
+	double latency = end - m_snapshots[m_reading].simStart;
+
+	m_stats.numFrames++;
+	m_stats.renderSeconds  += end - m_renderStart;
+	m_stats.latencySeconds += latency;
+	if(latency > m_stats.latencyMaxSeconds)
+		m_stats.latencyMaxSeconds = latency;
+	m_stats.wallSeconds = end - m_firstStart;
+}
+
+/*
+*******************************************************************
+* METHOD: Get Stats
+*******************************************************************
+* The simulation's totals are only settled once Stop() returns
+*
+* @return const ASStats& - the totals since Start
+*/
+
+const ASFramePipeline::ASStats& ASFramePipeline::GetStats()
+{
+	return m_stats;
+}
+
+/*
+*******************************************************************
+* METHOD: Report
+*******************************************************************
+* Appends the frame rate, the time each side spent working and
+* waiting, and the latency from simulating a frame to drawing it
+* to ./log/frame-pipeline.txt.  Call after Stop()
+*
+* @param const char* - a label for this report
+*/
+
+void ASFramePipeline::Report(const char* label)
+{
+	ofstream fout;
+
+	if(m_stats.numFrames == 0)
+		return;
+
+	fout.open("./log/frame-pipeline.txt", ios::app);
+	if(fout.fail())
+		return;
+
+	double frames = (double)m_stats.numFrames;
+
+	fout << "Frame pipeline " << label << ", " << (m_stats.threaded ? "simulation on its own thread" : "single thread") << ":" << endl;
+	fout << "  " << m_stats.numFrames << " frames in " << m_stats.wallSeconds << " s, "
+		 << (frames / m_stats.wallSeconds) << " frames/s" << endl;
+	fout << "  simulation " << (m_stats.simSeconds * 1000.0 / frames) << " ms a frame (max "
+		 << (m_stats.simMaxSeconds * 1000.0) << " ms), waiting " << (m_stats.simWaitSeconds * 1000.0 / frames) << " ms" << endl;
+	fout << "  render " << (m_stats.renderSeconds * 1000.0 / frames) << " ms a frame, waiting "
+		 << (m_stats.renderWaitSeconds * 1000.0 / frames) << " ms" << endl;
+	fout << "  latency " << (m_stats.latencySeconds * 1000.0 / frames) << " ms (max "
+		 << (m_stats.latencyMaxSeconds * 1000.0) << " ms)" << endl;
+
+	fout.close();
+}
+
+/*
+*******************************************************************
+* METHOD: Simulation Loop
+*******************************************************************
+* Body of the simulation thread.  Waits until the renderer has taken
+* the last snapshot, fills in the other one and publishes it, until
+* the pipeline is stopped or the callback asks to quit
+*/
+
+void ASFramePipeline::SimulationLoop()
+{
+	bool keepGoing = true;
+
+	ASProfiler::GetInstance()->SetThreadName("Simulation");
+	ASCPUMonitor::RegisterThread("Simulation");
+
+	while(keepGoing)
+	{
+		double start = ASClock::GetSeconds();
+		int slot;
+
+		{
+			unique_lock<mutex> lock(m_mutex);
+			while(m_hasNew && m_running)
+				m_takeSignal.wait(lock);
+			if(!m_running)
+				break;
+
+			// Whichever snapshot the renderer is not holding
+			slot = (m_reading == 0) ? 1 : 0;
+		}
+
+		m_stats.simWaitSeconds += ASClock::GetSeconds() - start;
+
+		keepGoing = Produce(m_snapshots[slot]);
+
+		{
+			lock_guard<mutex> lock(m_mutex);
+			m_published = slot;
+			m_hasNew    = true;
+		}
+		m_publishSignal.notify_one();
+	}
+
+	ASCPUMonitor::UnregisterThread();
+}
+
+/*
+*******************************************************************
+* METHOD: Produce
+*******************************************************************
+* Runs the callback for the next frame and times it
+*
+* @param ASFrameSnapshot& - the snapshot to fill in
+*
+* @return bool - True to carry on, false if the simulation stopped
+*/
+
+bool ASFramePipeline::Produce(ASFrameSnapshot& snapshot)
+{
+	snapshot.frame    = m_nextFrame++;
+	snapshot.quit     = false;
+	snapshot.failed   = false;
+	snapshot.simStart = ASClock::GetSeconds();
+
+	if(!m_simulate(snapshot, m_context))
+	{
+		snapshot.quit   = true;
+		snapshot.failed = true;
+	}
+
+	snapshot.simEnd = ASClock::GetSeconds();
+
+	double seconds = snapshot.simEnd - snapshot.simStart;
+	m_stats.simSeconds += seconds;
+	if(seconds > m_stats.simMaxSeconds)
+		m_stats.simMaxSeconds = seconds;
+
+	return !snapshot.quit;
+}
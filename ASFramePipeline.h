@@ -0,0 +1,142 @@
+/*
+******************************************************************
+* ASFramePipeline.h
+*******************************************************************
+* Runs the simulation on its own thread one frame ahead of the
+* renderer.  The simulation fills a snapshot of everything the
+* renderer needs for a frame, the camera and entity positions, and
+* publishes it; the renderer then culls and draws from that
+* snapshot while the simulation works on the next one.
+*
+* Ownership: there are two snapshots.  The simulation thread only
+* ever writes the one the renderer is not holding, and once it is
+* published it is never touched again until the renderer has moved
+* on to a newer one, so a published snapshot is immutable and needs
+* no locking to read.  The simulation waits for the renderer to take
+* each snapshot before starting the next, so it is never more than
+* one frame ahead.  Everything the simulation callback touches
+* belongs to the simulation thread, everything the renderer touches
+* between Acquire() and FinishFrame() belongs to the render thread,
+* and the snapshot is the only thing passed between them.
+*
+* With threading off the callback runs inside Acquire() on the
+* render thread, which gives the single threaded numbers to compare
+* against in the report
+*******************************************************************
+*/
+
+#ifndef _ASFRAMEPIPELINE_H_
+#define _ASFRAMEPIPELINE_H_
+
+/*
+*******************************************************************
+* Includes:
+*******************************************************************
+* + ASMath.h has been included for the camera's vectors
+* + ASProfiler.h has been included to time the wait for a frame
+* + ASClock.h has been included to time each stage
+* + ASCPUMonitor.h has been included to watch the simulation thread
+*******************************************************************
+*/
+
+#include <vector>
+#include <fstream>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include "ASMath.h"
+#include "ASProfiler.h"
+#include "ASClock.h"
+#include "ASCPUMonitor.h"
+
+using namespace std;
+
+/*
+*******************************************************************
+* Type declarations
+*******************************************************************
+*/
+
+// Everything the renderer needs to draw one frame
+struct ASFrameSnapshot
+{
+	unsigned long long frame;
+	ASVector3          cameraPos;
+	ASVector3          cameraRot;
+	vector<float>      entityX;		// position of every entity, by index
+	vector<float>      entityY;
+	vector<float>      entityZ;
+	bool               quit;		// the simulation has stopped, nothing more will follow
+	bool               failed;		// it stopped because the callback failed
+	double             simStart;	// seconds, when the simulation began and finished this frame
+	double             simEnd;
+};
+
+/*
+*******************************************************************
+* Class declaration
+*******************************************************************
+*/
+
+class ASFramePipeline
+{
+public:
+	// Fills in a snapshot on the simulation thread, returns false on failure
+	typedef bool (*ASSimulate)(ASFrameSnapshot&, void*);
+
+	struct ASStats
+	{
+		bool               threaded;
+		unsigned long long numFrames;		// frames the renderer finished
+		double             simSeconds;		// time spent in the callback
+		double             simMaxSeconds;
+		double             simWaitSeconds;	// time the simulation waited for the renderer
+		double             renderSeconds;	// time between Acquire() and FinishFrame()
+		double             renderWaitSeconds;	// time the renderer waited for a snapshot
+		double             latencySeconds;	// from the start of simulating a frame to it being drawn
+		double             latencyMaxSeconds;
+		double             wallSeconds;		// from simulating the first frame to the last FinishFrame()
+	};
+
+public:
+	// Constructors and destructor
+	ASFramePipeline();
+	ASFramePipeline(const ASFramePipeline&);
+	~ASFramePipeline();
+
+	// Public methods
+	bool Start(ASSimulate, void*, bool);
+	void Stop();
+
+	const ASFrameSnapshot* Acquire();
+	void FinishFrame();
+
+	const ASStats& GetStats();
+	void Report(const char*);
+
+private:
+	// Private methods
+	void SimulationLoop();
+	bool Produce(ASFrameSnapshot&);
+
+	// Private member variables
+	ASSimulate         m_simulate;
+	void*              m_context;
+	ASFrameSnapshot    m_snapshots[2];
+	int                m_reading;		// snapshot the renderer holds, -1 for none
+	int                m_published;		// newest published snapshot
+	bool               m_hasNew;		// m_published has not been taken by the renderer yet
+	bool               m_running;
+	unsigned long long m_nextFrame;
+	double             m_renderStart;
+	double             m_firstStart;
+
+	thread             m_thread;
+	mutex              m_mutex;
+	condition_variable m_publishSignal;	// signalled when a snapshot is published
+	condition_variable m_takeSignal;	// signalled when the renderer takes one
+
+	ASStats            m_stats;
+};
+
+#endif
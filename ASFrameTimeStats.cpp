@@ -0,0 +1,301 @@
+/*
+******************************************************************
+* ASFrameTimeStats.cpp
+*******************************************************************
+* Implements all methods from ASFrameTimeStats.h
+*******************************************************************
+*/
+
+#include "ASFrameTimeStats.h"
+
+const float ASFrameTimeStats::FIRST_BIN_MS = 0.5f;
+
+/*
+*******************************************************************
+* Constructor
+*******************************************************************
+*/
+
+ASFrameTimeStats::ASFrameTimeStats()
+{
+	m_next        = 0;
+	m_count       = 0;
+	m_numSpikes   = 0;
+	m_spikeMs     = 0.0f;
+	m_totalFrames = 0;
+	m_totalSpikes = 0;
+}
+
+/*
+*******************************************************************
+* Empty Constructor
+*******************************************************************
+*/
+
+ASFrameTimeStats::ASFrameTimeStats(const ASFrameTimeStats&)
+{}
+
+/*
+*******************************************************************
+* Destructor
+*******************************************************************
+*/
+
+ASFrameTimeStats::~ASFrameTimeStats()
+{}
+
+/*
+*******************************************************************
+* METHOD: Init
+*******************************************************************
+* Empties the window and makes room for it
+*
+* @param int   - frames the window holds
+* @param float - frames longer than this many ms count as spikes
+*
+* @return bool - True if the window could be made, else false
+*/
+
+bool ASFrameTimeStats::Init(int windowFrames, float spikeMs)
+{
+	if(windowFrames <= 0)
+		return false;
+
+	m_window.assign(windowFrames, 0.0);
+	m_sorted.clear();
+	m_sorted.reserve(windowFrames);
+	m_histogram.assign(NUM_BINS, 0);
+
+	m_next        = 0;
+	m_count       = 0;
+	m_numSpikes   = 0;
+	m_spikeMs     = spikeMs;
+	m_totalFrames = 0;
+	m_totalSpikes = 0;
+
+	return true;
+}
+
+/*
+*******************************************************************
+* METHOD: Add Frame
+*******************************************************************
+* Adds a frame to the window, pushing out the oldest once it is full
+*
+* @param double - how long the frame took in ms
+*/
+
+void ASFrameTimeStats::AddFrame(double ms)
+{
+	if(m_window.empty())
+		return;
+
+	// Take the frame being written over out of the histogram and spike count
+	if(m_count == (int)m_window.size())
+	{
+		double oldest = m_window[m_next];
+
+		m_histogram[GetBin(oldest)]--;
+		if(oldest > m_spikeMs)
+			m_numSpikes--;
+	}
+	else
+		m_count++;
+
+	m_window[m_next] = ms;
+	m_next = (m_next + 1) % (int)m_window.size();
+
+	m_histogram[GetBin(ms)]++;
+	if(ms > m_spikeMs)
+	{
+		m_numSpikes++;
+		m_totalSpikes++;
+	}
+	m_totalFrames++;
+}
+
+/*
+*******************************************************************
+* METHOD: Get Summary
+*******************************************************************
+* Works out the min, mean, max and percentiles of the window, this
+* sorts a copy of it so should not be called every frame
+*
+* @param ASSummary& - filled in, all zero if no frames were added
+*/
+
+void ASFrameTimeStats::GetSummary(ASSummary& summary)
+{
+	double total = 0.0;
+
+	summary.numFrames = m_count;
+	summary.numSpikes = m_numSpikes;
+	summary.minMs     = 0.0;
+	summary.meanMs    = 0.0;
+	summary.maxMs     = 0.0;
+	summary.p50Ms     = 0.0;
+	summary.p95Ms     = 0.0;
+	summary.p99Ms     = 0.0;
+	summary.p999Ms    = 0.0;
+
+	if(m_count == 0)
+		return;
+
+	m_sorted.assign(m_window.begin(), m_window.begin() + m_count);
+	for(int i = 0; i < m_count; i++)
+		total += m_sorted[i];
+	sort(m_sorted.begin(), m_sorted.end());
+
+	summary.minMs  = m_sorted.front();
+	summary.meanMs = total / m_count;
+	summary.maxMs  = m_sorted.back();
+	summary.p50Ms  = ASBenchmark::Percentile(m_sorted, 50.0);
+	summary.p95Ms  = ASBenchmark::Percentile(m_sorted, 95.0);
+	summary.p99Ms  = ASBenchmark::Percentile(m_sorted, 99.0);
+	summary.p999Ms = ASBenchmark::Percentile(m_sorted, 99.9);
+}
+
+/*
+*******************************************************************
+* METHOD: Report
+*******************************************************************
+* Appends the summary of the window and its histogram to
+* ./log/frame-stats.txt, empty bins at either end are left out
+*
+* @param const char* - a label for this report
+*/
+
+void ASFrameTimeStats::Report(const char* label)
+{
+	const int BAR_WIDTH = 50;
+	ASSummary summary;
+	ofstream  fout;
+	int first = 0, last = NUM_BINS - 1, most = 0;
+
+	if(m_count == 0)
+		return;
+
+	fout.open("./log/frame-stats.txt", ios::app);
+	if(fout.fail())
+		return;
+
+	GetSummary(summary);
+	fout << fixed << setprecision(3);
+
+	fout << "Frame times " << label << ": " << m_totalFrames << " frames, " << m_totalSpikes << " over "
+		 << m_spikeMs << " ms" << endl;
+	fout << "  last " << summary.numFrames << " frames ms: min " << summary.minMs << ", mean " << summary.meanMs
+		 << ", max " << summary.maxMs << ", p50 " << summary.p50Ms << ", p95 " << summary.p95Ms << ", p99 "
+		 << summary.p99Ms << ", p99.9 " << summary.p999Ms << ", " << summary.numSpikes << " spikes" << endl;
+
+	while(m_histogram[first] == 0)
+		first++;
+	while(m_histogram[last] == 0)
+		last--;
+	for(int i = first; i <= last; i++)
+		most = max(most, m_histogram[i]);
+
+	for(int i = first; i <= last; i++)
+	{
+		int bar = (int)ceil((double)m_histogram[i] * BAR_WIDTH / most);
+
+		fout << "  ";
+		if(i == 0)
+			fout << "< " << GetBinStart(1);
+		else if(i == NUM_BINS - 1)
+			fout << ">= " << GetBinStart(i);
+		else
+			fout << GetBinStart(i) << " - " << GetBinStart(i + 1);
+		fout << " ms: " << m_histogram[i] << " " << string(bar, '#') << endl;
+	}
+
+	fout.close();
+}
+
+/*
+*******************************************************************
+* METHOD: Get Histogram
+*******************************************************************
+* @return const vector<int>& - frames in the window in each bin,
+*                              see GetBinStart()
+*/
+
+const vector<int>& ASFrameTimeStats::GetHistogram()
+{
+	return m_histogram;
+}
+
+/*
+*******************************************************************
+* METHOD: Get Spike Threshold
+*******************************************************************
+* @return float - frames longer than this many ms are spikes
+*/
+
+float ASFrameTimeStats::GetSpikeThreshold()
+{
+	return m_spikeMs;
+}
+
+/*
+*******************************************************************
+* METHOD: Get Total Frames
+*******************************************************************
+* @return unsigned long long - frames added since Init
+*/
+
+unsigned long long ASFrameTimeStats::GetTotalFrames()
+{
+	return m_totalFrames;
+}
+
+/*
+*******************************************************************
+* METHOD: Get Total Spikes
+*******************************************************************
+* @return unsigned long long - spikes since Init, including those
+*                              that have left the window
+*/
+
+unsigned long long ASFrameTimeStats::GetTotalSpikes()
+{
+	return m_totalSpikes;
+}
+
+/*
+*******************************************************************
+* METHOD: Get Bin
+*******************************************************************
+* @param double - a frame's length in ms
+*
+* @return int - the histogram bin it falls in
+*/
+
+int ASFrameTimeStats::GetBin(double ms)
+{
+	if(ms < FIRST_BIN_MS)
+		return 0;
+
+	int bin = 1 + (int)floor(log(ms / FIRST_BIN_MS) / log(2.0) * BINS_PER_OCTAVE);
+	if(bin >= NUM_BINS)
+		bin = NUM_BINS - 1;
+
+	return bin;
+}
+
+/*
+*******************************************************************
+* METHOD: Get Bin Start
+*******************************************************************
+* @param int - a histogram bin, 1 or more
+*
+* @return double - the shortest frame in ms that falls in it
+*/
+
+double ASFrameTimeStats::GetBinStart(int bin)
+{
+	if(bin <= 0)
+		return 0.0;
+
+	return FIRST_BIN_MS * pow(2.0, (double)(bin - 1) / BINS_PER_OCTAVE);
+}
@@ -0,0 +1,100 @@
+/*
+******************************************************************
+* ASFrameTimeStats.h
+*******************************************************************
+* Keeps the length of the last few thousand frames so stutter can
+* be seen.  A frames a second count over one second windows hides
+* a single 50 ms hitch among sixty quick frames, here every frame
+* is kept and the window is summarised by its min, mean and max,
+* its p50, p95, p99 and p99.9, how many frames ran over the spike
+* threshold and a histogram.
+*
+* The histogram's bins are spaced on a log scale, BINS_PER_OCTAVE
+* to each doubling from FIRST_BIN_MS, so 4 ms and 5 ms frames land
+* in different bins without 100 ms frames needing hundreds of
+* them.  The histogram and spike count are kept up to date as
+* frames come and go, the rest is worked out when GetSummary() is
+* called.  Nothing is allocated once Init() has run
+*******************************************************************
+*/
+
+#ifndef _ASFRAMETIMESTATS_H_
+#define _ASFRAMETIMESTATS_H_
+
+/*
+*******************************************************************
+* Includes:
+*******************************************************************
+* + ASBenchmark.h has been included for its percentile
+*******************************************************************
+*/
+
+#include <math.h>
+#include <vector>
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include "ASBenchmark.h"
+
+using namespace std;
+
+/*
+*******************************************************************
+* Class declaration
+*******************************************************************
+*/
+
+class ASFrameTimeStats
+{
+public:
+	static const int NUM_BINS        = 40;
+	static const int BINS_PER_OCTAVE = 4;
+	static const float FIRST_BIN_MS;	// where the second bin starts, the first takes anything shorter
+
+	struct ASSummary
+	{
+		int    numFrames;		// frames in the window
+		double minMs;
+		double meanMs;
+		double maxMs;
+		double p50Ms;
+		double p95Ms;
+		double p99Ms;
+		double p999Ms;
+		int    numSpikes;		// frames in the window over the spike threshold
+	};
+
+public:
+	// Constructors and destructor
+	ASFrameTimeStats();
+	ASFrameTimeStats(const ASFrameTimeStats&);
+	~ASFrameTimeStats();
+
+	// Public methods
+	bool Init(int, float);
+	void AddFrame(double);
+	void GetSummary(ASSummary&);
+	void Report(const char*);
+
+	const vector<int>& GetHistogram();
+	float              GetSpikeThreshold();
+	unsigned long long GetTotalFrames();
+	unsigned long long GetTotalSpikes();
+
+	static int    GetBin(double);
+	static double GetBinStart(int);
+
+private:
+	// Private member variables
+	vector<double>     m_window;		// ring of the last frames, in ms
+	vector<double>     m_sorted;		// scratch space for GetSummary()
+	vector<int>        m_histogram;		// frames in the window in each bin
+	int                m_next;			// where the next frame is written
+	int                m_count;			// frames in the window
+	int                m_numSpikes;
+	float              m_spikeMs;
+	unsigned long long m_totalFrames;	// since Init
+	unsigned long long m_totalSpikes;
+};
+
+#endif
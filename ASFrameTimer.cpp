@@ -24,7 +24,7 @@ ASFrameTimer::ASFrameTimer()
 ******************************************************************
 */
 
-ASFrameTimer::ASFrameTimer(const ASFrameTimer& cpuMonitor) 
+ASFrameTimer::ASFrameTimer(const ASFrameTimer&) 
 {}
 
 /*
@@ -40,25 +40,14 @@ ASFrameTimer::~ASFrameTimer()
 ******************************************************************
 * METHOD: Init 
 ******************************************************************
-* Initialise the Frame Timer, this will query the system to assertain
-* if it supports high frq timers, if it does the systems frequency 
-* will be used to determine how many ticks occur per ms.  
+* Initialise the Frame Timer, the first frame is timed from here
 * 
-* @return bool - true if highFreq is supported, else false
+* @return bool - true once the timer is running
 */
 
 bool ASFrameTimer::Init()
 {
-	// Check if the system supports high freq timers, if a value is
-	// written to the output param (m_freq), then we have the systems freq
-	QueryPerformanceFrequency((LARGE_INTEGER*)&m_freq);
-	if(m_freq == 0)
-		return false;
-
-	// Determine how many times per ms the counter should tick
-	m_tickPerMs = (float)(m_freq / 1000);
-
-	QueryPerformanceCounter((LARGE_INTEGER*)&m_startTime);
+	m_clock.Reset();
 
 	return true;
 }
@@ -73,24 +62,17 @@ bool ASFrameTimer::Init()
 
 void ASFrameTimer::GetFrame()
 {
-	INT64 currTime;
-	float timeDiff;
-
-	QueryPerformanceCounter((LARGE_INTEGER*)&currTime);
-	timeDiff = (float)(currTime - m_startTime);
-	m_frameTime = timeDiff / m_tickPerMs;
-
-	m_startTime = currTime;
+	m_clock.Tick();
 }
 
 /*
 ******************************************************************
 * METHOD: Get Time
 ******************************************************************
-* Returns the current time
+* Returns the length of the last frame in ms
 */
 
 float ASFrameTimer::GetTime()
 {
-	return m_frameTime;
+	return (float)(m_clock.GetDelta() * 1000.0);
 }
@@ -5,7 +5,9 @@
 *******************************************************************
 * High precision timer to keep track of how many seconds have elapsed
 * between each frame - this is used to synchronise movements of
-* objects in the world regardless of framerate
+* objects in the world regardless of framerate.  The time is read
+* from ASClock in nanoseconds and only the frame's length is made
+* a float
 *******************************************************************
 */
 
@@ -16,10 +18,10 @@
 ******************************************************************
 * Includes
 ******************************************************************
-* + pdh - Win lib to query CPU usage
+* + ASClock.h - the engine's clock
 */
 
-#include <windows.h>
+#include "ASClock.h"
 
 /*
 ******************************************************************
@@ -42,10 +44,7 @@ public:
 
 private:
 	// Private members
-	INT64 m_freq;
-	INT64 m_startTime;
-	float m_tickPerMs;
-	float m_frameTime;
+	ASClock m_clock;
 };
 
 #endif
\ No newline at end of file
@@ -46,9 +46,9 @@ ASFrustrum::~ASFrustrum()
 * items are in the frustrum to be render
 */
 
-void ASFrustrum::ConstructFrustrum(float depth, D3DXMATRIX projection, D3DXMATRIX view)
+void ASFrustrum::ConstructFrustrum(float depth, ASMatrix projection, ASMatrix view)
 {
-	D3DXMATRIX matrix;
+	ASMatrix matrix;
 
 	float zMin = -projection._43 / projection._33;
 	float r = depth / (depth - zMin);
@@ -56,49 +56,76 @@ void ASFrustrum::ConstructFrustrum(float depth, D3DXMATRIX projection, D3DXMATRI
 	projection._43 = -r * zMin;
 
 	// Create the frustrum matrix
-	D3DXMatrixMultiply(&matrix, &view, &projection);
+	ASMatrixMultiply(&matrix, &view, &projection);
+	ConstructFrustrum(matrix);
+}
+
+/*
+*******************************************************************
+* METHOD: Construct Frustrum
+*******************************************************************
+* Builds the planes straight from a view matrix already multiplied
+* by its projection, used for views such as a minimap or a shadow
+* cascade whose orthographic projection has no far plane to adjust
+*
+* @param ASMatrix - the view matrix multiplied by the projection
+*/
 
+void ASFrustrum::ConstructFrustrum(ASMatrix matrix)
+{
 	// Calculate near plane of frustum.
 	m_planes[0].a = matrix._14 + matrix._13;
 	m_planes[0].b = matrix._24 + matrix._23;
 	m_planes[0].c = matrix._34 + matrix._33;
 	m_planes[0].d = matrix._44 + matrix._43;
-	D3DXPlaneNormalize(&m_planes[0], &m_planes[0]);
+	ASPlaneNormalize(&m_planes[0], &m_planes[0]);
 
 	// Calculate far plane of frustum.
 	m_planes[1].a = matrix._14 - matrix._13; 
 	m_planes[1].b = matrix._24 - matrix._23;
 	m_planes[1].c = matrix._34 - matrix._33;
 	m_planes[1].d = matrix._44 - matrix._43;
-	D3DXPlaneNormalize(&m_planes[1], &m_planes[1]);
+	ASPlaneNormalize(&m_planes[1], &m_planes[1]);
 
 	// Calculate left plane of frustum.
 	m_planes[2].a = matrix._14 + matrix._11; 
 	m_planes[2].b = matrix._24 + matrix._21;
 	m_planes[2].c = matrix._34 + matrix._31;
 	m_planes[2].d = matrix._44 + matrix._41;
-	D3DXPlaneNormalize(&m_planes[2], &m_planes[2]);
+	ASPlaneNormalize(&m_planes[2], &m_planes[2]);
 
 	// Calculate right plane of frustum.
 	m_planes[3].a = matrix._14 - matrix._11; 
 	m_planes[3].b = matrix._24 - matrix._21;
 	m_planes[3].c = matrix._34 - matrix._31;
 	m_planes[3].d = matrix._44 - matrix._41;
-	D3DXPlaneNormalize(&m_planes[3], &m_planes[3]);
+	ASPlaneNormalize(&m_planes[3], &m_planes[3]);
 
 	// Calculate top plane of frustum.
 	m_planes[4].a = matrix._14 - matrix._12; 
 	m_planes[4].b = matrix._24 - matrix._22;
 	m_planes[4].c = matrix._34 - matrix._32;
 	m_planes[4].d = matrix._44 - matrix._42;
-	D3DXPlaneNormalize(&m_planes[4], &m_planes[4]);
+	ASPlaneNormalize(&m_planes[4], &m_planes[4]);
 
 	// Calculate bottom plane of frustum.
 	m_planes[5].a = matrix._14 + matrix._12;
 	m_planes[5].b = matrix._24 + matrix._22;
 	m_planes[5].c = matrix._34 + matrix._32;
 	m_planes[5].d = matrix._44 + matrix._42;
-	D3DXPlaneNormalize(&m_planes[5], &m_planes[5]);
+	ASPlaneNormalize(&m_planes[5], &m_planes[5]);
+
+	// Copy the planes out for the batch checks
+	for(int i = 0; i < NUM_PLANES; i++)
+	{
+		m_a[i]    = m_planes[i].a;
+		m_b[i]    = m_planes[i].b;
+		m_c[i]    = m_planes[i].c;
+		m_d[i]    = m_planes[i].d;
+		m_absA[i] = fabsf(m_planes[i].a);
+		m_absB[i] = fabsf(m_planes[i].b);
+		m_absC[i] = fabsf(m_planes[i].c);
+	}
 }
 
 /*
@@ -114,9 +141,9 @@ void ASFrustrum::ConstructFrustrum(float depth, D3DXMATRIX projection, D3DXMATRI
 bool ASFrustrum::CheckPoint(float x, float y, float z)
 {
 	// Check if the point exists in each plane
-	for(unsigned int i = 0; i < 6; i++)
+	for(int i = 0; i < NUM_PLANES; i++)
 	{
-		if(D3DXPlaneDotCoord(&m_planes[i], &D3DXVECTOR3(x,y,z)) < 0.0f)
+		if(GetDistance(i, x, y, z) < 0.0f)
 			return false;
 	}
 
@@ -135,56 +162,7 @@ bool ASFrustrum::CheckPoint(float x, float y, float z)
 
 bool ASFrustrum::CheckCube(float xCenter, float yCenter, float zCenter, float radius)
 {
-	int i;
-
-
-	// Check if any one point of the cube is in the view frustum.
-	for(i=0; i<6; i++) 
-	{
-		if(D3DXPlaneDotCoord(&m_planes[i], &D3DXVECTOR3((xCenter - radius), (yCenter - radius), (zCenter - radius))) >= 0.0f)
-		{
-			continue;
-		}
-		
-		if(D3DXPlaneDotCoord(&m_planes[i], &D3DXVECTOR3((xCenter + radius), (yCenter - radius), (zCenter - radius))) >= 0.0f)
-		{
-			continue;
-		}
-
-		if(D3DXPlaneDotCoord(&m_planes[i], &D3DXVECTOR3((xCenter - radius), (yCenter + radius), (zCenter - radius))) >= 0.0f)
-		{
-			continue;
-		}
-
-		if(D3DXPlaneDotCoord(&m_planes[i], &D3DXVECTOR3((xCenter + radius), (yCenter + radius), (zCenter - radius))) >= 0.0f)
-		{
-			continue;
-		}
-
-		if(D3DXPlaneDotCoord(&m_planes[i], &D3DXVECTOR3((xCenter - radius), (yCenter - radius), (zCenter + radius))) >= 0.0f)
-		{
-			continue;
-		}
-
-		if(D3DXPlaneDotCoord(&m_planes[i], &D3DXVECTOR3((xCenter + radius), (yCenter - radius), (zCenter + radius))) >= 0.0f)
-		{
-			continue;
-		}
-
-		if(D3DXPlaneDotCoord(&m_planes[i], &D3DXVECTOR3((xCenter - radius), (yCenter + radius), (zCenter + radius))) >= 0.0f)
-		{
-			continue;
-		}
-		
-		if(D3DXPlaneDotCoord(&m_planes[i], &D3DXVECTOR3((xCenter + radius), (yCenter + radius), (zCenter + radius))) >= 0.0f)
-		{
-			continue;
-		}
-
-		return false;
-	}
-
-	return true;
+	return CheckRectangle(xCenter, yCenter, zCenter, radius, radius, radius);
 }
 
 /*
@@ -200,12 +178,10 @@ bool ASFrustrum::CheckCube(float xCenter, float yCenter, float zCenter, float ra
 bool ASFrustrum::CheckSphere(float xCenter, float yCenter, float zCenter, float radius)
 {
 	// Check if the radius of the sphere is inside the view frustum.
-	for(unsigned int i=0; i<6; i++) 
+	for(int i = 0; i < NUM_PLANES; i++) 
 	{
-		if(D3DXPlaneDotCoord(&m_planes[i], &D3DXVECTOR3(xCenter, yCenter, zCenter)) < -radius)
-		{
+		if(GetDistance(i, xCenter, yCenter, zCenter) < -radius)
 			return false;
-		}
 	}
 
 	return true;
@@ -215,59 +191,409 @@ bool ASFrustrum::CheckSphere(float xCenter, float yCenter, float zCenter, float
 *******************************************************************
 * METHOD: Check Rectangle
 *******************************************************************
-* Takes a Sphere in space and checks whether it exists in all of 
-* the view planes. 
+* Takes a box in space and checks whether it exists in all of 
+* the view planes.  A box is outside when even its corner furthest
+* along a plane's normal is behind that plane, that corner is found
+* from the signs of the normal so only one distance is worked out
+* per plane rather than one for each of the eight corners
 *
 * @return bool - True if inside plane, else false
 */
 
 bool ASFrustrum::CheckRectangle(float xCenter, float yCenter, float zCenter, float xSize, float ySize, float zSize)
 {
-	// Check if any of the 6 planes of the rectangle are inside the view frustum.
-	for(unsigned int i=0; i<6; i++)
+	for(int i = 0; i < NUM_PLANES; i++)
+	{
+		if(GetBoxDistance(i, xCenter, yCenter, zCenter, xSize, ySize, zSize) < 0.0f)
+			return false;
+	}
+
+	return true;
+}
+
+/*
+*******************************************************************
+* METHOD: Check Spheres
+*******************************************************************
+* Checks a list of spheres against the frustum, the same test as
+* CheckSphere() for each one
+*
+* @param const float*  - the x, y and z of each centre, then each radius
+* @param int           - the number of spheres
+* @param unsigned int* - output bitmask, a set bit means the sphere is visible
+*
+* @return int - the number of visible spheres
+*/
+
+int ASFrustrum::CheckSpheres(const float* x, const float* y, const float* z, const float* radius, int count, unsigned int* visible)
+{
+	int numVisible = 0;
+	int i = 0;
+
+	memset(visible, 0, GetMaskWords(count) * sizeof(unsigned int));
+
+#ifdef AS_MATH_SSE
+	// Four spheres at a time, each plane clears the lanes that fall behind it
+	for(; i + 4 <= count; i += 4)
 	{
-		if(D3DXPlaneDotCoord(&m_planes[i], &D3DXVECTOR3((xCenter - xSize), (yCenter - ySize), (zCenter - zSize))) >= 0.0f)
+		__m128 px     = _mm_loadu_ps(x + i);
+		__m128 py     = _mm_loadu_ps(y + i);
+		__m128 pz     = _mm_loadu_ps(z + i);
+		__m128 limit  = _mm_sub_ps(_mm_setzero_ps(), _mm_loadu_ps(radius + i));
+		__m128 inside = _mm_cmpeq_ps(px, px);
+
+		for(int p = 0; p < NUM_PLANES; p++)
 		{
-			continue;
+			__m128 dist = _mm_add_ps(_mm_add_ps(_mm_mul_ps(px, _mm_set1_ps(m_a[p])), _mm_mul_ps(py, _mm_set1_ps(m_b[p]))),
+									 _mm_add_ps(_mm_mul_ps(pz, _mm_set1_ps(m_c[p])), _mm_set1_ps(m_d[p])));
+			inside = _mm_and_ps(inside, _mm_cmpge_ps(dist, limit));
 		}
 
-		if(D3DXPlaneDotCoord(&m_planes[i], &D3DXVECTOR3((xCenter + xSize), (yCenter - ySize), (zCenter - zSize))) >= 0.0f)
+		unsigned int bits = (unsigned int)_mm_movemask_ps(inside);
+		visible[i >> 5] |= bits << (i & 31);
+		numVisible      += CountBits(bits);
+	}
+#endif
+
+	for(; i < count; i++)
+	{
+		if(CheckSphere(x[i], y[i], z[i], radius[i]))
 		{
-			continue;
+			visible[i >> 5] |= 1u << (i & 31);
+			numVisible++;
 		}
+	}
+
+	return numVisible;
+}
+
+/*
+*******************************************************************
+* METHOD: Check Spheres
+*******************************************************************
+* Checks a list of spheres that all have the same radius and sit
+* at the same offset from each position, such as a crowd drawn with
+* one model.  Moving every sphere by the offset is the same as
+* moving the planes the other way, so the offset costs nothing
+*
+* @param const float*  - the x, y and z of each position
+* @param float         - the radius of every sphere
+* @param ASVector3     - the offset of each sphere's centre from its position
+* @param int           - the number of spheres
+* @param unsigned int* - output bitmask, a set bit means the sphere is visible
+*
+* @return int - the number of visible spheres
+*/
+
+int ASFrustrum::CheckSpheres(const float* x, const float* y, const float* z, float radius, ASVector3 offset, int count, unsigned int* visible)
+{
+	float d[NUM_PLANES];
+	int numVisible = 0;
+	int i = 0;
+	int p;
+
+	memset(visible, 0, GetMaskWords(count) * sizeof(unsigned int));
+
+	for(p = 0; p < NUM_PLANES; p++)
+		d[p] = (m_a[p] * offset.x) + (m_b[p] * offset.y) + (m_c[p] * offset.z) + m_d[p] + radius;
+
+#ifdef AS_MATH_SSE
+	__m128 a[NUM_PLANES], b[NUM_PLANES], c[NUM_PLANES], w[NUM_PLANES];
+	for(p = 0; p < NUM_PLANES; p++)
+	{
+		a[p] = _mm_set1_ps(m_a[p]);
+		b[p] = _mm_set1_ps(m_b[p]);
+		c[p] = _mm_set1_ps(m_c[p]);
+		w[p] = _mm_set1_ps(d[p]);
+	}
 
-		if(D3DXPlaneDotCoord(&m_planes[i], &D3DXVECTOR3((xCenter - xSize), (yCenter + ySize), (zCenter - zSize))) >= 0.0f)
+	for(; i + 4 <= count; i += 4)
+	{
+		__m128 px     = _mm_loadu_ps(x + i);
+		__m128 py     = _mm_loadu_ps(y + i);
+		__m128 pz     = _mm_loadu_ps(z + i);
+		__m128 inside = _mm_cmpeq_ps(px, px);
+
+		for(p = 0; p < NUM_PLANES; p++)
 		{
-			continue;
+			__m128 dist = _mm_add_ps(_mm_add_ps(_mm_mul_ps(px, a[p]), _mm_mul_ps(py, b[p])),
+									 _mm_add_ps(_mm_mul_ps(pz, c[p]), w[p]));
+			inside = _mm_and_ps(inside, _mm_cmpge_ps(dist, _mm_setzero_ps()));
 		}
 
-		if(D3DXPlaneDotCoord(&m_planes[i], &D3DXVECTOR3((xCenter - xSize), (yCenter - ySize), (zCenter + zSize))) >= 0.0f)
+		unsigned int bits = (unsigned int)_mm_movemask_ps(inside);
+		visible[i >> 5] |= bits << (i & 31);
+		numVisible      += CountBits(bits);
+	}
+#endif
+
+	for(; i < count; i++)
+	{
+		for(p = 0; p < NUM_PLANES; p++)
 		{
-			continue;
+			if((m_a[p] * x[i]) + (m_b[p] * y[i]) + (m_c[p] * z[i]) + d[p] < 0.0f)
+				break;
 		}
 
-		if(D3DXPlaneDotCoord(&m_planes[i], &D3DXVECTOR3((xCenter + xSize), (yCenter + ySize), (zCenter - zSize))) >= 0.0f)
+		if(p == NUM_PLANES)
 		{
-			continue;
+			visible[i >> 5] |= 1u << (i & 31);
+			numVisible++;
 		}
+	}
 
-		if(D3DXPlaneDotCoord(&m_planes[i], &D3DXVECTOR3((xCenter + xSize), (yCenter - ySize), (zCenter + zSize))) >= 0.0f)
+	return numVisible;
+}
+
+/*
+*******************************************************************
+* METHOD: Check Boxes
+*******************************************************************
+* Checks a list of axis aligned boxes against the frustum, the same
+* test as CheckRectangle() for each one
+*
+* @param const float*  - the x, y and z of each centre
+* @param const float*  - the half size of each box along x, y and z
+* @param int           - the number of boxes
+* @param unsigned int* - output bitmask, a set bit means the box is visible
+*
+* @return int - the number of visible boxes
+*/
+
+int ASFrustrum::CheckBoxes(const float* x, const float* y, const float* z, const float* xSize, const float* ySize, const float* zSize,
+						   int count, unsigned int* visible)
+{
+	int numVisible = 0;
+	int i = 0;
+
+	memset(visible, 0, GetMaskWords(count) * sizeof(unsigned int));
+
+#ifdef AS_MATH_SSE
+	for(; i + 4 <= count; i += 4)
+	{
+		__m128 px     = _mm_loadu_ps(x + i);
+		__m128 py     = _mm_loadu_ps(y + i);
+		__m128 pz     = _mm_loadu_ps(z + i);
+		__m128 ex     = _mm_loadu_ps(xSize + i);
+		__m128 ey     = _mm_loadu_ps(ySize + i);
+		__m128 ez     = _mm_loadu_ps(zSize + i);
+		__m128 inside = _mm_cmpeq_ps(px, px);
+
+		for(int p = 0; p < NUM_PLANES; p++)
 		{
-			continue;
+			// Distance of the centre plus how far the box reaches towards the plane
+			__m128 dist  = _mm_add_ps(_mm_add_ps(_mm_mul_ps(px, _mm_set1_ps(m_a[p])), _mm_mul_ps(py, _mm_set1_ps(m_b[p]))),
+									  _mm_add_ps(_mm_mul_ps(pz, _mm_set1_ps(m_c[p])), _mm_set1_ps(m_d[p])));
+			__m128 reach = _mm_add_ps(_mm_add_ps(_mm_mul_ps(ex, _mm_set1_ps(m_absA[p])), _mm_mul_ps(ey, _mm_set1_ps(m_absB[p]))),
+									  _mm_mul_ps(ez, _mm_set1_ps(m_absC[p])));
+			inside = _mm_and_ps(inside, _mm_cmpge_ps(_mm_add_ps(dist, reach), _mm_setzero_ps()));
 		}
 
-		if(D3DXPlaneDotCoord(&m_planes[i], &D3DXVECTOR3((xCenter - xSize), (yCenter + ySize), (zCenter + zSize))) >= 0.0f)
+		unsigned int bits = (unsigned int)_mm_movemask_ps(inside);
+		visible[i >> 5] |= bits << (i & 31);
+		numVisible      += CountBits(bits);
+	}
+#endif
+
+	for(; i < count; i++)
+	{
+		if(CheckRectangle(x[i], y[i], z[i], xSize[i], ySize[i], zSize[i]))
 		{
-			continue;
+			visible[i >> 5] |= 1u << (i & 31);
+			numVisible++;
 		}
+	}
+
+	return numVisible;
+}
+
+/*
+*******************************************************************
+* METHOD: Benchmark
+*******************************************************************
+* Times the single and batch checks over the same random spheres
+* and boxes spread around the camera, and appends the rate of each
+* in millions of objects a second to ./log/cull-benchmark.txt.  The
+* frustum must have been constructed first
+*
+* @param int - the number of objects to test
+*/
+
+void ASFrustrum::Benchmark(int count)
+{
+	ofstream fout;
+	double seconds[4];
+	int    visible[4];
+	int    i;
+
+	const int REPEATS = 10;
 
-		if(D3DXPlaneDotCoord(&m_planes[i], &D3DXVECTOR3((xCenter + xSize), (yCenter + ySize), (zCenter + zSize))) >= 0.0f)
+	float* data = new float[count * 7];
+	unsigned int* mask = new unsigned int[GetMaskWords(count)];
+	if(!data || !mask)
+	{
+		delete [] data;
+		delete [] mask;
+		return;
+	}
+
+	float* x      = data;
+	float* y      = data + count;
+	float* z      = data + (count * 2);
+	float* radius = data + (count * 3);
+	float* xSize  = data + (count * 4);
+	float* ySize  = data + (count * 5);
+	float* zSize  = data + (count * 6);
+
+	for(i = 0; i < count; i++)
+	{
+		x[i]      = (((float)rand() / RAND_MAX) - 0.5f) * 400.0f;
+		y[i]      = (((float)rand() / RAND_MAX) - 0.5f) * 100.0f;
+		z[i]      = (((float)rand() / RAND_MAX) - 0.5f) * 400.0f;
+		radius[i] = ((float)rand() / RAND_MAX) * 5.0f;
+		xSize[i]  = ((float)rand() / RAND_MAX) * 5.0f;
+		ySize[i]  = ((float)rand() / RAND_MAX) * 5.0f;
+		zSize[i]  = ((float)rand() / RAND_MAX) * 5.0f;
+	}
+
+	for(int test = 0; test < 4; test++)
+	{
+		double start = ASClock::GetSeconds();
+		for(int r = 0; r < REPEATS; r++)
 		{
-			continue;
+			visible[test] = 0;
+			switch(test)
+			{
+			case 0:
+				for(i = 0; i < count; i++)
+					visible[test] += CheckSphere(x[i], y[i], z[i], radius[i]) ? 1 : 0;
+				break;
+			case 1:
+				visible[test] = CheckSpheres(x, y, z, radius, count, mask);
+				break;
+			case 2:
+				for(i = 0; i < count; i++)
+					visible[test] += CheckRectangle(x[i], y[i], z[i], xSize[i], ySize[i], zSize[i]) ? 1 : 0;
+				break;
+			case 3:
+				visible[test] = CheckBoxes(x, y, z, xSize, ySize, zSize, count, mask);
+				break;
+			}
 		}
-
-		return false;
+		seconds[test] = (ASClock::GetSeconds() - start) / REPEATS;
 	}
 
-	return true;
+	delete [] data;
+	delete [] mask;
+
+	fout.open("./log/cull-benchmark.txt", ios::app);
+	if(fout.fail())
+		return;
+
+	fout << "Frustum culling, " << count << " objects:" << endl;
+	fout << "  spheres one at a time: " << ((count / seconds[0]) / 1000000.0) << " Mobj/s, " << visible[0] << " visible" << endl;
+	fout << "  spheres batched:       " << ((count / seconds[1]) / 1000000.0) << " Mobj/s, " << visible[1] << " visible" << endl;
+	fout << "  boxes one at a time:   " << ((count / seconds[2]) / 1000000.0) << " Mobj/s, " << visible[2] << " visible" << endl;
+	fout << "  boxes batched:         " << ((count / seconds[3]) / 1000000.0) << " Mobj/s, " << visible[3] << " visible" << endl;
+
+	fout.close();
+}
+
+/*
+*******************************************************************
+* METHOD: Get Mask Words
+*******************************************************************
+* @param int - the number of objects
+*
+* @return int - the number of words a visibility bitmask needs
+*/
+
+int ASFrustrum::GetMaskWords(int count)
+{
+	return (count + 31) / 32;
+}
+
+/*
+*******************************************************************
+* METHOD: Is Visible
+*******************************************************************
+* @param const unsigned int* - a bitmask written by a batch check
+* @param int                 - the object to look up
+*
+* @return bool - True if the object was visible, else false
+*/
+
+bool ASFrustrum::IsVisible(const unsigned int* visible, int index)
+{
+	return (visible[index >> 5] & (1u << (index & 31))) != 0;
+}
+
+/*
+*******************************************************************
+* METHOD: Get Lowest Bit
+*******************************************************************
+* Used to walk the set bits of a bitmask word, clearing each one
+* with bits &= bits - 1 once it is handled
+*
+* @param unsigned int - a word of a bitmask, it must not be 0
+*
+* @return int - the index of the lowest set bit
+*/
+
+int ASFrustrum::GetLowestBit(unsigned int bits)
+{
+#ifdef _MSC_VER
+	unsigned long index;
+	_BitScanForward(&index, bits);
+	return (int)index;
+#else
+	return __builtin_ctz(bits);
+#endif
+}
+
+/*
+*******************************************************************
+* METHOD: Get Distance
+*******************************************************************
+* @param int   - the plane
+* @param float - the x, y and z of the point
+*
+* @return float - the signed distance of the point from the plane
+*/
+
+float ASFrustrum::GetDistance(int plane, float x, float y, float z)
+{
+	return (m_a[plane] * x) + (m_b[plane] * y) + (m_c[plane] * z) + m_d[plane];
+}
+
+/*
+*******************************************************************
+* METHOD: Get Box Distance
+*******************************************************************
+* @param int   - the plane
+* @param float - the x, y and z of the box's centre
+* @param float - the half size of the box along x, y and z
+*
+* @return float - the signed distance from the plane of the box's
+*                 corner furthest in front of it
+*/
+
+float ASFrustrum::GetBoxDistance(int plane, float x, float y, float z, float xSize, float ySize, float zSize)
+{
+	return GetDistance(plane, x, y, z) + (m_absA[plane] * xSize) + (m_absB[plane] * ySize) + (m_absC[plane] * zSize);
+}
+
+/*
+*******************************************************************
+* METHOD: Count Bits
+*******************************************************************
+* @param unsigned int - a 4 bit lane mask
+*
+* @return int - the number of set bits
+*/
+
+int ASFrustrum::CountBits(unsigned int bits)
+{
+	static const int COUNTS[16] = { 0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4 };
+	return COUNTS[bits & 15];
 }
@@ -6,6 +6,13 @@
 * Creates a frustrum class to determine what items are in the
 * view to be rendered at any one time.  Without a frustrum, the 
 * performance of the application could significantly dimish
+*
+* Besides the single primitive checks there are batch checks that
+* take whole lists of spheres or boxes laid out as separate x, y
+* and z arrays.  With SSE four objects are tested against a plane
+* at once, the result is a bitmask with one bit per object (bit i
+* of word i / 32) so callers can walk only what is visible.  The
+* class only uses ASMath, so it builds on any platform
 *******************************************************************
 */
 
@@ -16,9 +23,24 @@
 *******************************************************************
 * Includes:
 *******************************************************************
+* + ASMath.h has been included for the planes and matrices, and
+*   for AS_MATH_SSE on targets with SSE
+* + ASClock.h has been included to time the benchmark
+*******************************************************************
 */
 
-#include <d3dx10math.h>
+#include <math.h>
+#include <string.h>
+#include <stdlib.h>
+#include <fstream>
+#include "ASMath.h"
+#include "ASClock.h"
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+using namespace std;
 
 /*
 *******************************************************************
@@ -29,22 +51,47 @@
 class ASFrustrum
 {
 public:
+	static const int NUM_PLANES = 6;
+
 	// Constructors and Destructors
 	ASFrustrum();
 	ASFrustrum(const ASFrustrum&);
 	~ASFrustrum();
 
 	// Public methods
-	void ConstructFrustrum(float, D3DXMATRIX, D3DXMATRIX);
+	void ConstructFrustrum(float, ASMatrix, ASMatrix);
+	void ConstructFrustrum(ASMatrix);
 
 	bool CheckPoint(float, float, float);
 	bool CheckCube(float, float, float, float);
 	bool CheckSphere(float, float, float, float);
 	bool CheckRectangle(float, float, float, float, float, float);
 
+	// Batch checks, each writes a visibility bitmask of (count + 31) / 32 words
+	int  CheckSpheres(const float*, const float*, const float*, const float*, int, unsigned int*);
+	int  CheckSpheres(const float*, const float*, const float*, float, ASVector3, int, unsigned int*);
+	int  CheckBoxes(const float*, const float*, const float*, const float*, const float*, const float*, int, unsigned int*);
+
+	void Benchmark(int);
+
+	static int  GetMaskWords(int);
+	static bool IsVisible(const unsigned int*, int);
+	static int  GetLowestBit(unsigned int);
+
+
 private:
+	// Private methods
+	float GetDistance(int, float, float, float);
+	float GetBoxDistance(int, float, float, float, float, float, float);
+	int   CountBits(unsigned int);
+
 	// Private member variables
-	D3DXPLANE m_planes[6];
+	ASPlane m_planes[NUM_PLANES];
+
+	// The planes again as separate arrays for the batch checks, with the absolute value of
+	// each normal for the box test
+	float m_a[NUM_PLANES], m_b[NUM_PLANES], m_c[NUM_PLANES], m_d[NUM_PLANES];
+	float m_absA[NUM_PLANES], m_absB[NUM_PLANES], m_absC[NUM_PLANES];
 };
 
 #endif
\ No newline at end of file
@@ -35,6 +35,17 @@ ASGraphics::ASGraphics()
 	m_quadTree      = 0;
 	m_skyShader     = 0;
 	m_skyBox        = 0;
+	m_instanceShader = 0;
+	m_textureStreamer = 0;
+	m_enemyTexture  = -1;
+	m_projScale     = 1.0f;
+	m_benchmarking  = false;
+
+	m_frameStats.cullMs         = 0.0f;
+	m_frameStats.nodesVisited   = 0;
+	m_frameStats.leavesDrawn    = 0;
+	m_frameStats.trianglesDrawn = 0;
+	m_frameStats.drawCalls      = 0;
 }
 
 /*
@@ -71,8 +82,10 @@ ASGraphics::~ASGraphics()
 using namespace std;
 bool ASGraphics::Init(int w, int h, HWND hwnd)
 {
+	AS_PROFILE("ASGraphics::Init");
+
 	bool success = false;
-	D3DXMATRIX viewMatrix;
+	ASMatrix viewMatrix;
 
 	// Create a new ASDirect3D object
 	m_D3D = new ASDirect3D;
@@ -105,12 +118,14 @@ bool ASGraphics::Init(int w, int h, HWND hwnd)
 	if(!m_WorldTerrain)
 		return false;
 
-	// Build an array of textures to pass to the terrain
-	vector<WCHAR*> textures;
-	textures.push_back(L"./textures/grass.dds");
-	textures.push_back(L"./textures/rock.dds");
-	textures.push_back(L"./textures/slope.dds");
-	success = m_WorldTerrain->Init(m_D3D->GetDevice(), "./textures/mapC.bmp", "./textures/colorMap.bmp", textures, L"./textures/detail.dds");
+	// Build an array of textures to pass to the terrain, this order is the slice order
+	// the terrain pixel shader samples them in
+	vector<char*> textures;
+	textures.push_back("./textures/detail.dds");
+	textures.push_back("./textures/grass.dds");
+	textures.push_back("./textures/rock.dds");
+	textures.push_back("./textures/slope.dds");
+	success = m_WorldTerrain->Init(m_D3D->GetDevice(), TERRAIN_HEIGHT_MAP, TERRAIN_COLOR_MAP, textures, TERRAIN_LAYERS);
 	if(!success) {
 		MessageBox(hwnd, L"Error when initialising the world terrain in ASGraphics.cpp.", L"Error", MB_OK);
 		return false;
@@ -121,14 +136,45 @@ bool ASGraphics::Init(int w, int h, HWND hwnd)
 	if(!m_Model)
 		return false;
 
-	// Initialise the model, passing the rendering device 
-	/*
-	success = m_Model->Init(m_D3D->GetDevice(), L"./textures/seafloor.dds", "./models/cube.txt");
+	// Initialise the model, passing the rendering device.  Its texture is streamed
+	success = m_Model->Init(m_D3D->GetDevice(), 0, ENEMY_MODEL);
 	if(!success)
 	{
 		MessageBox(hwnd, L"Error when initialising the model in ASGraphics.cpp, please check ASModel.cpp for errors.", L"Error", MB_OK);
 		return false;
-	}*/
+	}
+
+	// Create the texture streamer and open the enemy texture, only its small levels load now
+	m_textureStreamer = new ASTextureStreamer;
+	if(!m_textureStreamer)
+		return false;
+
+	m_textureStreamer->Init(TEXTURE_BUDGET_BYTES, TEXTURE_UPLOAD_BYTES);
+	m_enemyTexture = m_textureStreamer->Load(m_D3D->GetDevice(), ENEMY_TEXTURE);
+	if(m_enemyTexture < 0)
+	{
+		MessageBox(hwnd, L"Could not open the enemy texture for streaming.", L"Error", MB_OK);
+		return false;
+	}
+
+	// Log how many triangles the levels of detail save over a crowded scene, the
+	// projection scale is the number of pixels one unit covers one unit away
+	D3DXMATRIX projection;
+	m_D3D->GetProjectionMatrix(projection);
+	m_projScale = projection._22 * (float)h * 0.5f;
+	m_Model->ReportLodScene(LOD_REPORT_INSTANCES, ENEMY_MODEL_SCALE, m_projScale, SCREEN_DEPTH);
+
+	// Create the shader the enemies are instanced with
+	m_instanceShader = new ASInstanceShader;
+	if(!m_instanceShader)
+		return false;
+
+	success = m_instanceShader->Init(m_D3D->GetDevice(), hwnd);
+	if(!success)
+	{
+		MessageBox(hwnd, L"Error when initialising the instance shader.", L"Error", MB_OK);
+		return false;
+	}
 
 	// Initiase a new terrain shader
 	m_terrainShader = new ASTerrainShader;
@@ -148,12 +194,18 @@ bool ASGraphics::Init(int w, int h, HWND hwnd)
 		return false;
 
 	// Initialise the model list
-	success = m_EnemyList->Init(30);
+	success = m_EnemyList->Init(NUM_ENEMIES);
 	if(!success) {
 		MessageBox(hwnd, L"Could not initialise the enemy list.", L"Error", MB_OK);
 		return false;
 	}
 
+	success = m_EnemyList->InitInstancing(m_D3D->GetDevice(), ENEMY_MODEL_SCALE);
+	if(!success) {
+		MessageBox(hwnd, L"Could not create the enemy instance buffer.", L"Error", MB_OK);
+		return false;
+	}
+
 	// Initialise a new ASLight object to illuminate the world!
 	m_light = new ASLight;
 	if(!m_light)
@@ -162,12 +214,21 @@ bool ASGraphics::Init(int w, int h, HWND hwnd)
 	m_light->SetAmbient(0.45f, 0.45f, 0.45f, 1.0f);
 	m_light->SetDiffuse(1.0f, 1.0f, 1.0f, 1.0f);
 	m_light->SetDirection(-0.5f, -1.0f, 0.0f);
+	m_light->SetSpecular(0.0f, 0.0f, 0.0f, 1.0f);
+	m_light->SetSpecularIntensity(32.0f);
 
 	// Create frustrum
 	m_Frustum = new ASFrustrum;
 	if(!m_Frustum)
 		return false;
 
+	// Log how fast objects are culled, one at a time and in batches, from the spawn point
+	if(m_benchmarking)
+	{
+		m_Frustum->ConstructFrustrum(SCREEN_DEPTH, projection, viewMatrix);
+		m_Frustum->Benchmark(CULL_BENCHMARK_OBJECTS);
+	}
+
 	// Create the quad tree
 	m_quadTree = new ASQuadTree;
 	if(!m_quadTree)
@@ -179,6 +240,21 @@ bool ASGraphics::Init(int w, int h, HWND hwnd)
 		return false;
 	}
 
+	// Log how much culling several views in one walk of the tree saves
+	if(m_benchmarking)
+		BenchmarkViews(projection, viewMatrix);
+
+	// Stand every enemy on the terrain beneath it
+	for(int i = 0; i < m_EnemyList->GetEnemyCount(); i++)
+	{
+		float posX, posY, posZ, height;
+		D3DXVECTOR4 color;
+
+		m_EnemyList->GetData(i, posX, posY, posZ, color);
+		if(m_quadTree->GetTerrainHeightAtPosition(posX, posZ, height))
+			m_EnemyList->SetPosition(i, posX, height, posZ);
+	}
+
 	// Create the new sky box
 	m_skyBox = new ASSkyBox;
 	if(!m_skyBox)
@@ -217,6 +293,9 @@ bool ASGraphics::Init(int w, int h, HWND hwnd)
 	}
 	*/
 
+	// Log what the shared resources cost once everything is loaded
+	ASResourceManager::GetInstance()->Report("after load");
+
 	return true;
 }
 
@@ -238,6 +317,8 @@ bool ASGraphics::Init(int w, int h, HWND hwnd)
 
 bool ASGraphics::RenderScene(ASCameraInfo info)
 {
+	AS_PROFILE("ASGraphics::RenderScene");
+
 	bool success	 = false;
 	bool renderModel = false;
 
@@ -252,10 +333,10 @@ bool ASGraphics::RenderScene(ASCameraInfo info)
 
 	// WVP Matrices
 	D3DXMATRIX world;
-	D3DXMATRIX view;
+	ASMatrix view;
 	D3DXMATRIX projection;
 	D3DXMATRIX ortho;
-	D3DXMATRIX camWorld;
+	ASMatrix camWorld;
 
 	// Retrieve the WVP matrices from the camera to perform any translations
 	m_D3D->GetWorldMatrix(world);
@@ -287,7 +368,7 @@ bool ASGraphics::RenderScene(ASCameraInfo info)
 	m_D3D->DisableZBuffer();
 
 	m_skyBox->Render(m_D3D->GetDeviceContext());
-	m_skyShader->RenderSky(m_D3D->GetDeviceContext(), m_skyBox->GetNumIndices(), world, view, projection, m_skyBox->GetColorA(), m_skyBox->GetColorB());
+	m_skyShader->RenderSky(m_D3D->GetDeviceContext(), m_skyBox->GetNumIndices(), m_skyBox->GetStartIndex(), world, view, projection, m_skyBox->GetColorA(), m_skyBox->GetColorB());
 
 	m_D3D->EnableZBuffer();
 	m_D3D->EnableCulling();
@@ -301,25 +382,194 @@ bool ASGraphics::RenderScene(ASCameraInfo info)
 	// build the frustum
 	m_Frustum->ConstructFrustrum(SCREEN_DEPTH, projection, view);
 
+	// Cull the terrain and the enemies, the enemies that survive are sorted into one
+	// instanced draw per level of detail
+	{
+		AS_PROFILE("ASGraphics::Cull");
+
+		double cullStart = ASClock::GetSeconds();
+		m_quadTree->CullViews(&m_Frustum, 1, &m_terrainLeaves);
+		renderCount = m_EnemyList->PrepareInstances(m_Frustum, m_Model, m_Camera->GetPosition(), m_projScale);
+		m_frameStats.cullMs = (float)((ASClock::GetSeconds() - cullStart) * 1000.0);
+	}
 
 	// Build the terrain
-	vector<ID3D11ShaderResourceView*> res;
-	m_WorldTerrain->GetTextures(res);
 	success = m_terrainShader->SetShaderParameters(m_D3D->GetDeviceContext(), world, view, projection, m_light->GetAmbientColor(), 
-												   m_light->GetDiffuseColor(), m_light->GetLightDirection(), m_WorldTerrain->GetDetailTexture(), res);
+												   m_light->GetDiffuseColor(), m_light->GetLightDirection(), m_WorldTerrain->GetTextureArray());
 
 	if(!success)
 		return false;
 
 	// Render the terrain using the quad tree renderer
-	m_quadTree->Render(m_Frustum, m_terrainShader, m_D3D->GetDeviceContext());
+	m_quadTree->RenderLeaves(m_terrainLeaves, m_terrainShader, m_D3D->GetDeviceContext());
+
+	// Draw the visible enemies
+
+	// Stream in the enemy texture at the detail the closest enemy needs
+	if(renderCount > 0)
+	{
+		m_textureStreamer->RequestDistance(m_enemyTexture, m_Model->GetBoundingRadius() * 2.0f * ENEMY_MODEL_SCALE, 
+										   m_EnemyList->GetNearestDistance(), m_projScale);
+	}
+	m_textureStreamer->Update(m_D3D->GetDevice());
+
+	if(renderCount > 0)
+	{
+		success = m_instanceShader->SetParameters(m_D3D->GetDeviceContext(), view, projection, m_textureStreamer->GetTexture(m_enemyTexture), 
+												  m_light->GetLightDirection(), m_light->GetDiffuseColor(), m_light->GetAmbientColor(), 
+												  m_Camera->GetPosition(), m_light->GetSpecularColor(), m_light->GetSpecularIntensity());
+		if(!success)
+			return false;
+
+		success = m_EnemyList->RenderInstances(m_D3D->GetDeviceContext(), m_Model, m_instanceShader);
+		if(!success)
+			return false;
+	}
 
 	// Present the rendered scene to the screen
-	m_D3D->RenderScene();
+	{
+		AS_PROFILE("ASDirect3D::Present");
+		m_D3D->RenderScene();
+	}
+
+	// The sky, then a draw for every terrain leaf and one for every enemy level of detail
+	m_frameStats.nodesVisited   = m_quadTree->GetNodesVisited();
+	m_frameStats.leavesDrawn    = m_quadTree->GetLeavesDrawn();
+	m_frameStats.trianglesDrawn = (m_skyBox->GetNumIndices() / 3) + m_quadTree->GetPolyCount() + 
+								  m_EnemyList->GetTriangleCount(m_Model);
+	m_frameStats.drawCalls      = 1 + m_frameStats.leavesDrawn + m_EnemyList->GetDrawCallCount();
 
 	return true;
 }
 
+/*
+*******************************************************************
+* Method: BenchmarkViews()
+*******************************************************************
+* Builds the views a frame with a minimap and shadows would cull
+* for, the camera, a top down minimap over the spawn point and a
+* cascade of orthographic views along the light, and has the quad
+* tree time culling them separately and together
+*
+* @param ASMatrix - the camera's projection matrix
+* @param ASMatrix - the camera's view matrix
+*******************************************************************
+*/
+
+void ASGraphics::BenchmarkViews(ASMatrix projection, ASMatrix view)
+{
+	ASFrustrum  frusta[CULL_BENCHMARK_VIEWS];
+	ASFrustrum* views[CULL_BENCHMARK_VIEWS];
+	ASMatrix    lightView, lightProj;
+
+	ASVector3 spawn    = ASVector3(SPAWN_X, SPAWN_Y, SPAWN_Z);
+	ASVector3 lightDir = m_light->GetLightDirection();
+	ASVector3 north    = ASVector3(0.0f, 0.0f, 1.0f);
+	ASVector3 up       = ASVector3(0.0f, 1.0f, 0.0f);
+	ASVector3 eye;
+
+	ASVec3Normalize(&lightDir, &lightDir);
+
+	frusta[0].ConstructFrustrum(SCREEN_DEPTH, projection, view);
+
+	// The minimap looks straight down, so north is up on the map
+	eye = spawn + ASVector3(0.0f, MINIMAP_HEIGHT, 0.0f);
+	ASMatrixLookAtLH(&lightView, &eye, &spawn, &north);
+	ASMatrixOrthoLH(&lightProj, MINIMAP_SIZE, MINIMAP_SIZE, 1.0f, MINIMAP_HEIGHT * 2.0f);
+	frusta[1].ConstructFrustrum(lightView * lightProj);
+
+	// Each cascade is a box along the light centred on the spawn point
+	for(int i = 2; i < CULL_BENCHMARK_VIEWS; i++)
+	{
+		float radius = SHADOW_CASCADES[i - 2];
+
+		eye = spawn - (lightDir * (radius + MINIMAP_HEIGHT));
+		ASMatrixLookAtLH(&lightView, &eye, &spawn, &up);
+		ASMatrixOrthoLH(&lightProj, radius * 2.0f, radius * 2.0f, 1.0f, (radius * 2.0f) + MINIMAP_HEIGHT);
+		frusta[i].ConstructFrustrum(lightView * lightProj);
+	}
+
+	for(int i = 0; i < CULL_BENCHMARK_VIEWS; i++)
+		views[i] = &frusta[i];
+
+	m_quadTree->Benchmark(views, CULL_BENCHMARK_VIEWS, CULL_BENCHMARK_REPEATS);
+}
+
+/*
+*******************************************************************
+* Method: SetBenchmarking()
+*******************************************************************
+* The frustum and quad tree culling benchmarks take a while, so they
+* are only run and logged while loading when the engine is
+* benchmarking
+*
+* @param bool - true to run them
+*******************************************************************
+*/
+
+void ASGraphics::SetBenchmarking(bool benchmarking)
+{
+	m_benchmarking = benchmarking;
+}
+
+/*
+*******************************************************************
+* Method: GetEnemyCount()
+*******************************************************************
+* @return int - the number of enemies in the world
+*******************************************************************
+*/
+
+int ASGraphics::GetEnemyCount()
+{
+	return m_EnemyList->GetEnemyCount();
+}
+
+/*
+*******************************************************************
+* Method: GetEnemyPosition()
+*******************************************************************
+* @param int    - the enemy's index
+* @param float& - set to the enemy's x, y and z position
+*******************************************************************
+*/
+
+void ASGraphics::GetEnemyPosition(int index, float& x, float& y, float& z)
+{
+	D3DXVECTOR4 color;
+
+	m_EnemyList->GetData(index, x, y, z, color);
+}
+
+/*
+*******************************************************************
+* Method: SetEnemyPosition()
+*******************************************************************
+* Moves an enemy, it is drawn at the new position next frame
+*
+* @param int   - the enemy's index
+* @param float - the enemy's new x, y and z position
+*******************************************************************
+*/
+
+void ASGraphics::SetEnemyPosition(int index, float x, float y, float z)
+{
+	m_EnemyList->SetPosition(index, x, y, z);
+}
+
+/*
+*******************************************************************
+* Method: GetFrameStats()
+*******************************************************************
+* @return const ASFrameStats& - what the last frame culled and drew
+*******************************************************************
+*/
+
+const ASGraphics::ASFrameStats& ASGraphics::GetFrameStats()
+{
+	return m_frameStats;
+}
+
 /*
 *******************************************************************
 * Method: Release()
@@ -346,6 +596,21 @@ void ASGraphics::Release()
 		delete m_light;
 		m_light = 0;
 	}
+	// Release the instance shader
+	if(m_instanceShader)
+	{
+		m_instanceShader->Release();
+		delete m_instanceShader;
+		m_instanceShader = 0;
+	}
+	// Release the texture streamer, logging how it coped with the budget
+	if(m_textureStreamer)
+	{
+		m_textureStreamer->Report("at exit");
+		m_textureStreamer->Release();
+		delete m_textureStreamer;
+		m_textureStreamer = 0;
+	}
 	// Release the Model Object
 	if(m_Model)
 	{
@@ -428,6 +693,8 @@ void ASGraphics::Release()
 		delete m_skyBox;
 		m_skyBox = 0;
 	}
+	// Every object has dropped its handles, drop the manager's references to the shared resources
+	ASResourceManager::GetInstance()->Release();
 
 	return;
 }
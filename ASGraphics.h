@@ -19,13 +19,18 @@
 * + ASCamera.h has been included so we can view the world around a camera
 * + ASModel.h has been included to load meshes to be rendered to scene
 * + ASColorShader.h has been included to apply color to loaded objects through VS and PS
+* + ASSettings.h has been included for the settings shared with the null backend
+* + ASProfiler.h has been included to time the frame
 *******************************************************************
 */
 
+#include "ASSettings.h"
+
 #include "ASDirect3D.h"
 #include "ASCamera.h"
 #include "ASModel.h"
 #include "ASLightShader.h"
+#include "ASInstanceShader.h"
 #include "ASLight.h"
 #include "ASText.h"
 #include "ASEnemies.h"
@@ -34,6 +39,8 @@
 #include "ASQuadTree.h"
 #include "ASSkyShader.h"
 #include "ASSkyBox.h"
+#include "ASTextureStreamer.h"
+#include "ASProfiler.h"
 #include <vector>
 
 /*
@@ -42,15 +49,31 @@
 *******************************************************************
 */
 
-const bool  FULL_SCREEN   = false;
-const bool  VSYNC_ENABLED = true;
-const float SCREEN_DEPTH  = 1000.0f;
-const float SCREEN_NEAR   = 1.25f;
+// Model used for the enemies, the scale it is drawn at and its streamed texture
+const char* const ENEMY_MODEL       = "./models/horse.obj";
+const float       ENEMY_MODEL_SCALE = 10.0f;
+const char* const ENEMY_TEXTURE     = "./textures/seafloor.dds";
+
+// Texture array the terrain layers are baked into, rebuilt when a layer changes
+const char* const TERRAIN_LAYERS = "./textures/terrain-layers.dds";
+
+// Video memory streamed textures may use, and the most uploaded in one frame
+const unsigned long long TEXTURE_BUDGET_BYTES = 32 * 1024 * 1024;
+const unsigned long long TEXTURE_UPLOAD_BYTES = 4 * 1024 * 1024;
 
-// Spawn coordinates for the player in the world
-const float SPAWN_X = 20.0f;
-const float SPAWN_Y = 2.0f;
-const float SPAWN_Z = 0.0f;
+// Number of instances in the level of detail report written at start up
+const int LOD_REPORT_INSTANCES = 500;
+
+// Number of objects in the frustum culling benchmark written at start up with -benchmark
+const int CULL_BENCHMARK_OBJECTS = 100000;
+
+// Views in the multi-view culling benchmark, the camera, a minimap and the shadow cascades,
+// it is written at start up with -benchmark
+const int   CULL_BENCHMARK_VIEWS   = 5;
+const int   CULL_BENCHMARK_REPEATS = 1000;
+const float MINIMAP_SIZE           = 128.0f;
+const float MINIMAP_HEIGHT         = 100.0f;
+const float SHADOW_CASCADES[3]     = { 32.0f, 96.0f, 256.0f };	// radius each cascade covers
 
 /*
 *******************************************************************
@@ -67,6 +90,15 @@ public:
 		D3DXVECTOR3 pos;
 		D3DXVECTOR3 rot;
 	};
+	// What the last RenderScene() culled and submitted
+	struct ASFrameStats
+	{
+		float cullMs;			// culling the terrain and the enemies
+		int   nodesVisited;		// quad tree nodes tested against the view
+		int   leavesDrawn;		// quad tree leaves drawn
+		int   trianglesDrawn;	// sky, terrain and enemies
+		int   drawCalls;
+	};
 	// Constructors and Destructors
 	ASGraphics();
 	ASGraphics(const ASGraphics&);
@@ -77,10 +109,24 @@ public:
 	bool RenderScene(ASCameraInfo);
 	void Release();
 
+	// Enemy positions, the simulation owns them and hands them over each frame
+	int  GetEnemyCount();
+	void GetEnemyPosition(int, float&, float&, float&);
+	void SetEnemyPosition(int, float, float, float);
+
+	const ASFrameStats& GetFrameStats();
+
+	// Run the start up benchmarks, call before Init()
+	void SetBenchmarking(bool);
+
 private:
+	// Private methods
+	void BenchmarkViews(ASMatrix, ASMatrix);
+
 	// Private member variables
 	ASColorShader*   m_colorShader;
 	ASLightShader*   m_lightShader;
+	ASInstanceShader* m_instanceShader;
 	ASTerrainShader* m_terrainShader;
 	ASLight*         m_light;
 	ASDirect3D*      m_D3D;
@@ -94,6 +140,12 @@ private:
 	ASQuadTree*      m_quadTree;
 	ASSkyBox*        m_skyBox;
 	ASSkyShader*     m_skyShader;
+	ASTextureStreamer* m_textureStreamer;
+	int              m_enemyTexture;
+	float            m_projScale;		// pixels one unit covers one unit from the camera
+	vector<int>      m_terrainLeaves;	// quad tree leaves in view, kept to reuse its memory
+	ASFrameStats     m_frameStats;
+	bool             m_benchmarking;		// log the culling benchmarks while loading
 };
 
 #endif
\ No newline at end of file
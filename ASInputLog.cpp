@@ -0,0 +1,271 @@
+/*
+******************************************************************
+* ASInputLog.cpp
+*******************************************************************
+* Implements all methods from ASInputLog.h
+*******************************************************************
+*/
+
+#include "ASInputLog.h"
+
+// What every log starts with, and the size of a header and a record in bytes
+static const char         LOG_MAGIC[4]  = { 'A', 'S', 'I', 'N' };
+static const unsigned int LOG_VERSION   = 1;
+static const int          HEADER_BYTES  = 8;
+static const int          RECORD_BYTES  = 9;
+
+/*
+*******************************************************************
+* Constructor
+*******************************************************************
+*/
+
+ASInputLog::ASInputLog()
+{
+	m_mode      = MODE_OFF;
+	m_path[0]   = 0;
+	m_numFrames = 0;
+}
+
+/*
+*******************************************************************
+* Empty Constructor
+*******************************************************************
+*/
+
+ASInputLog::ASInputLog(const ASInputLog&)
+{}
+
+/*
+*******************************************************************
+* Destructor
+*******************************************************************
+*/
+
+ASInputLog::~ASInputLog()
+{}
+
+/*
+*******************************************************************
+* METHOD: Init
+*******************************************************************
+* Starts a new log to record to, or reads a whole log to replay
+*
+* @param ASMode      - whether to record, replay or do neither
+* @param const char* - the log's path
+*
+* @return bool - True if the log could be opened and, to replay,
+*                was a log of this version, else false
+*/
+
+bool ASInputLog::Init(ASMode mode, const char* path)
+{
+	unsigned char header[HEADER_BYTES];
+	unsigned char record[RECORD_BYTES];
+	ASInputFrame  frame;
+
+	Release();
+
+	m_mode      = MODE_OFF;
+	m_numFrames = 0;
+	m_frames.clear();
+
+	if(mode == MODE_OFF)
+		return true;
+
+	strncpy(m_path, path, sizeof(m_path) - 1);
+	m_path[sizeof(m_path) - 1] = 0;
+
+	if(mode == MODE_RECORD)
+	{
+		m_out.open(m_path, ios::out | ios::binary | ios::trunc);
+		if(m_out.fail())
+			return false;
+
+		memcpy(header, LOG_MAGIC, 4);
+		header[4] = (unsigned char)(LOG_VERSION);
+		header[5] = (unsigned char)(LOG_VERSION >> 8);
+		header[6] = (unsigned char)(LOG_VERSION >> 16);
+		header[7] = (unsigned char)(LOG_VERSION >> 24);
+		m_out.write((const char*)header, HEADER_BYTES);
+	}
+	else
+	{
+		ifstream fin;
+
+		fin.open(m_path, ios::in | ios::binary);
+		if(fin.fail())
+			return false;
+
+		fin.read((char*)header, HEADER_BYTES);
+		if(fin.gcount() != HEADER_BYTES || memcmp(header, LOG_MAGIC, 4) != 0)
+			return false;
+		if((header[4] | (header[5] << 8) | (header[6] << 16) | ((unsigned int)header[7] << 24)) != LOG_VERSION)
+			return false;
+
+		// A record cut short at the end, from a run that did not exit cleanly, is dropped
+		while(fin.read((char*)record, RECORD_BYTES))
+		{
+			ReadFrame(record, frame);
+			m_frames.push_back(frame);
+		}
+		fin.close();
+	}
+
+	m_mode = mode;
+	return true;
+}
+
+/*
+*******************************************************************
+* METHOD: Release
+*******************************************************************
+* Closes a log being recorded, everything recorded is on disk
+* once this returns
+*/
+
+void ASInputLog::Release()
+{
+	if(m_out.is_open())
+		m_out.close();
+}
+
+/*
+*******************************************************************
+* METHOD: Record
+*******************************************************************
+* Appends a frame to the log, does nothing unless recording
+*
+* @param ASInputFrame - this frame's input
+*/
+
+void ASInputLog::Record(const ASInputFrame& frame)
+{
+	if(m_mode != MODE_RECORD)
+		return;
+
+	WriteFrame(frame);
+	m_numFrames++;
+}
+
+/*
+*******************************************************************
+* METHOD: Replay
+*******************************************************************
+* Gives the next frame of the log being replayed
+*
+* @param ASInputFrame - set to the next frame's input
+*
+* @return bool - True if there was another frame, false once the
+*                log has run out or when not replaying
+*/
+
+bool ASInputLog::Replay(ASInputFrame& frame)
+{
+	if(m_mode != MODE_REPLAY || m_numFrames >= (int)m_frames.size())
+		return false;
+
+	frame = m_frames[m_numFrames];
+	m_numFrames++;
+
+	return true;
+}
+
+/*
+*******************************************************************
+* METHOD: Getters
+*******************************************************************
+*/
+
+ASInputLog::ASMode ASInputLog::GetMode()
+{
+	return m_mode;
+}
+
+int ASInputLog::GetFrameCount()
+{
+	return m_numFrames;
+}
+
+/*
+*******************************************************************
+* METHOD: Report
+*******************************************************************
+* Appends which log was recorded or replayed, and how much of it,
+* to ./log/input-log.txt
+*
+* @param const char* - a label for this report
+*/
+
+void ASInputLog::Report(const char* label)
+{
+	ofstream fout;
+
+	if(m_mode == MODE_OFF)
+		return;
+
+	fout.open("./log/input-log.txt", ios::app);
+	if(fout.fail())
+		return;
+
+	if(m_mode == MODE_RECORD)
+	{
+		fout << "Input log " << label << ": recorded " << m_numFrames << " frames to " << m_path << ", "
+			 << (HEADER_BYTES + m_numFrames * RECORD_BYTES) << " bytes" << endl;
+	}
+	else
+	{
+		fout << "Input log " << label << ": replayed " << m_numFrames << " of " << m_frames.size()
+			 << " frames from " << m_path << endl;
+	}
+
+	fout.close();
+}
+
+/*
+*******************************************************************
+* METHOD: Write Frame
+*******************************************************************
+* Writes one record, byte by byte so the log is little endian
+* whichever machine wrote it
+*
+* @param ASInputFrame - the frame to write
+*/
+
+void ASInputLog::WriteFrame(const ASInputFrame& frame)
+{
+	unsigned char record[RECORD_BYTES];
+	unsigned int  time;
+
+	memcpy(&time, &frame.frameTime, 4);
+
+	record[0] = (unsigned char)(time);
+	record[1] = (unsigned char)(time >> 8);
+	record[2] = (unsigned char)(time >> 16);
+	record[3] = (unsigned char)(time >> 24);
+	record[4] = frame.keys;
+	record[5] = (unsigned char)(frame.mouseX);
+	record[6] = (unsigned char)(frame.mouseX >> 8);
+	record[7] = (unsigned char)(frame.mouseY);
+	record[8] = (unsigned char)(frame.mouseY >> 8);
+
+	m_out.write((const char*)record, RECORD_BYTES);
+}
+
+/*
+*******************************************************************
+* METHOD: Read Frame
+*******************************************************************
+* @param const unsigned char* - a record as WriteFrame() wrote it
+* @param ASInputFrame         - set to the frame it holds
+*/
+
+void ASInputLog::ReadFrame(const unsigned char* record, ASInputFrame& frame)
+{
+	unsigned int time = record[0] | (record[1] << 8) | (record[2] << 16) | ((unsigned int)record[3] << 24);
+
+	memcpy(&frame.frameTime, &time, 4);
+	frame.keys   = record[4];
+	frame.mouseX = (short)(record[5] | (record[6] << 8));
+	frame.mouseY = (short)(record[7] | (record[8] << 8));
+}
@@ -0,0 +1,98 @@
+/*
+******************************************************************
+* ASInputLog.h
+*******************************************************************
+* Records the input of every simulated frame to a binary log, or
+* plays a log back in place of the keyboard and mouse.  A frame is
+* the keys the player uses, how far the mouse moved and how long
+* the frame took, the last of which decides how many fixed ticks the
+* frame runs, so a replay moves the player along exactly the path
+* it took when it was recorded whatever the speed of the machine.
+*
+* A log starts with a short header, then holds one 9 byte record a
+* frame: the frame time as a 32 bit float, a byte of key bits and
+* the mouse movement as two 16 bit integers, all little endian so a
+* log can be replayed by any build
+*******************************************************************
+*/
+
+#ifndef _ASINPUTLOG_H_
+#define _ASINPUTLOG_H_
+
+/*
+*******************************************************************
+* Includes:
+*******************************************************************
+*/
+
+#include <string.h>
+#include <vector>
+#include <fstream>
+
+using namespace std;
+
+/*
+*******************************************************************
+* Class declaration
+*******************************************************************
+*/
+
+class ASInputLog
+{
+public:
+	enum ASMode
+	{
+		MODE_OFF,
+		MODE_RECORD,
+		MODE_REPLAY
+	};
+
+	// Bits of ASInputFrame::keys
+	enum ASKeyBit
+	{
+		KEY_BIT_ESCAPE = 1 << 0,
+		KEY_BIT_LEFT   = 1 << 1,
+		KEY_BIT_RIGHT  = 1 << 2,
+		KEY_BIT_UP     = 1 << 3,
+		KEY_BIT_DOWN   = 1 << 4,
+		KEY_BIT_SPACE  = 1 << 5,
+		KEY_BIT_MOUSE  = 1 << 6
+	};
+
+	struct ASInputFrame
+	{
+		float         frameTime;	// ms, as ASFrameTimer gives it
+		unsigned char keys;			// ASKeyBit flags held this frame
+		short         mouseX;		// mouse movement since the last frame
+		short         mouseY;
+	};
+
+public:
+	// Constructors and destructor
+	ASInputLog();
+	ASInputLog(const ASInputLog&);
+	~ASInputLog();
+
+	// Public methods
+	bool Init(ASMode, const char*);
+	void Release();
+	void Record(const ASInputFrame&);
+	bool Replay(ASInputFrame&);
+
+	ASMode GetMode();
+	int    GetFrameCount();
+	void   Report(const char*);
+
+private:
+	void WriteFrame(const ASInputFrame&);
+	static void ReadFrame(const unsigned char*, ASInputFrame&);
+
+	// Private member variables
+	ASMode               m_mode;
+	char                 m_path[260];
+	ofstream             m_out;			// the log being recorded
+	vector<ASInputFrame> m_frames;		// the log being replayed, read whole at Init
+	int                  m_numFrames;	// frames recorded or replayed so far
+};
+
+#endif
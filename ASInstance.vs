@@ -0,0 +1,93 @@
+
+/*
+******************************************************************
+* ASInstance.vs
+******************************************************************
+* Vertex shader for instanced models, every instance brings its
+* own world matrix and colour through the second vertex stream so
+* that a whole crowd is drawn with a single draw call
+*
+* The pixel shader recieves its input from the output of the
+* vertex shader
+******************************************************************
+*/
+
+// The world matrix is unused, each instance supplies its own
+cbuffer ContstantBuffer
+{
+	matrix world;
+	matrix view;
+	matrix projection;
+};
+
+// Describe the X, Y, Z position of the camera in the world this is sent to the PS
+// to describe specular lighting
+cbuffer CameraBuffer 
+{
+	float3 cameraPosition;
+	float  padding;
+};
+
+// TYPE DEFS 
+struct VertexInputType
+{
+	float4 position : POSITION;
+	float2 texCoord : TEXCOORD0;
+	float3 normal   : NORMAL;
+
+	// Per instance data, the rows of the world matrix then the colour
+	float4 world0   : WORLD0;
+	float4 world1   : WORLD1;
+	float4 world2   : WORLD2;
+	float4 world3   : WORLD3;
+	float4 color    : COLOR;
+};
+
+struct PixelInputType
+{
+	float4 position : SV_POSITION;
+	float2 texCoord : TEXCOORD0;
+	float3 normal   : NORMAL;
+	float3 viewDir  : TEXCOORD1;	// used for specular lighting calcs in the pixel shader
+	float4 color    : COLOR;
+};
+
+/*
+******************************************************************
+* VERTEX SHADER
+******************************************************************
+* @parapm VertexInputType - The input vertex and its instance data
+* @return PixelInputType - The output pixel to be sent to shader
+*/
+
+PixelInputType InstanceVertexShader(VertexInputType inputVertex) 
+{
+	PixelInputType outputPixel;
+	float4 worldPos;
+
+	// Build the instance's world matrix from its rows
+	float4x4 instanceWorld = float4x4(inputVertex.world0, inputVertex.world1, inputVertex.world2, inputVertex.world3);
+
+	// Modify the vertex
+	inputVertex.position.w = 1.0f;
+
+	// Calculate the position of the vertex
+	worldPos = mul(inputVertex.position, instanceWorld);
+	outputPixel.position = mul(worldPos, view);
+	outputPixel.position = mul(outputPixel.position, projection);
+
+	// Store the texture coords and the instance colour
+	outputPixel.texCoord = inputVertex.texCoord;
+	outputPixel.color    = inputVertex.color;
+
+	// Calculate the VN of the vertex against the world matrix, the instances are uniformly
+	// scaled so normalising is enough to undo the scale
+	outputPixel.normal = mul(inputVertex.normal, (float3x3)instanceWorld);
+	outputPixel.normal = normalize(outputPixel.normal);
+
+	// Set the cameras view direction and then send it to the Pixel Shader
+	outputPixel.viewDir = cameraPosition.xyz - worldPos.xyz;
+	outputPixel.viewDir = normalize(outputPixel.viewDir);
+
+	return outputPixel;
+}
@@ -0,0 +1,292 @@
+/*
+******************************************************************
+* ASInstanceShader.cpp
+******************************************************************
+* Implement all function prototype in ASInstanceShader.h
+******************************************************************
+*/
+
+#include "ASInstanceShader.h"
+
+/*
+******************************************************************
+* Consturctor
+******************************************************************
+* The base class sets all D3D pointers to null
+*/
+
+ASInstanceShader::ASInstanceShader()
+{}
+
+/*
+******************************************************************
+* Empty constructor
+******************************************************************
+*/
+
+ASInstanceShader::ASInstanceShader(const ASInstanceShader& shader)
+{}
+
+/*
+******************************************************************
+* Destructor
+******************************************************************
+*/
+
+ASInstanceShader::~ASInstanceShader()
+{}
+
+/*
+******************************************************************
+* METHOD: Init
+******************************************************************
+* Calls the private InitShader method to initialise the shader
+*
+* @param ID3D11Device* - The device we are rendering with
+* @param HWND - The handle to application window
+*
+* @return bool - True if the shader initialised successfully, else false
+*/
+
+bool ASInstanceShader::Init(ID3D11Device* device, HWND handle)
+{
+	bool success = InitShader(device, handle, L"./ASInstance.vs", L"./ASInstance.ps");
+	if(!success)
+		return false;
+	else
+		return true;
+}
+
+/*
+******************************************************************
+* METHOD: Set Parameters
+******************************************************************
+* Fills the constant buffers shared by every instance, the world
+* matrix is left as identity as each instance brings its own
+*
+* @param ID3D11DeviceContext* - the device we are using to render
+* @param D3DXMATRIX - The View Matrix
+* @param D3DXMATRIX - The Projection Matrix
+* @param ID3D11ShaderResourceView* - Pointer to the texture resource we're using
+* @param D3DXVECTOR3 - A vector describing the direction light is poiting
+* @param D3DXVECTOR4 - The diffuse color of the light
+* @param D3DXVECTOR4 - The ambient color of the light
+* @param D3DXVECTOR3 - The position of the camera
+* @param D3DXVECTOR4 - A vector describing the specular color
+* @param float       - Float describing the intensity of the specular
+*
+* @return bool - True if the parameters were set, else false
+*/
+
+bool ASInstanceShader::SetParameters(ID3D11DeviceContext* deviceContext, D3DXMATRIX view, D3DXMATRIX projection, 
+									 ID3D11ShaderResourceView* texture, D3DXVECTOR3 lightDir, D3DXVECTOR4 diffuse, 
+									 D3DXVECTOR4 ambient, D3DXVECTOR3 cameraPos, D3DXVECTOR4 specular, float specularIntensity)
+{
+	D3DXMATRIX world;
+	D3DXMatrixIdentity(&world);
+
+	return SetShaderParameters(deviceContext, world, view, projection, texture, lightDir, diffuse, 
+							   ambient, cameraPos, specular, specularIntensity);
+}
+
+/*
+******************************************************************
+* METHOD: Render Instances
+******************************************************************
+* Sets the shaders on the device and draws a range of instances
+* with a range of the bound index buffer.  The model's buffers and
+* the instance buffer must already be bound
+*
+* @param ID3D11DeviceContext* - The device we are using
+* @param int - the number of indices to draw for each instance
+* @param int - the first index to draw
+* @param int - the number of instances to draw
+* @param int - the first instance in the instance buffer
+*/
+
+void ASInstanceShader::RenderInstances(ID3D11DeviceContext* deviceContext, int numIndices, int startIndex, 
+									   int numInstances, int startInstance)
+{
+	// Set the input layout, vertex shader and pixel shader
+	deviceContext->IASetInputLayout(m_iLayout);
+	deviceContext->VSSetShader(m_vShader, NULL, 0);
+	deviceContext->PSSetShader(m_pShader, NULL, 0);
+	deviceContext->PSSetSamplers(0, 1, &m_sampleState);
+
+	// Draw every instance in the range with one call
+	deviceContext->DrawIndexedInstanced(numIndices, numInstances, startIndex, 0, startInstance);
+
+	return;
+}
+
+/*
+******************************************************************
+* METHOD: Init Shader
+******************************************************************
+* Loads the shader files and passes them to the GPU.  The input
+* layout reads the model's vertices from slot 0 and one world
+* matrix (as four rows) and colour per instance from slot 1
+*
+* @param ID3D11Device* - The device we are rendering with
+* @param HWND - Handle to the application window we are using 
+* @param WCHAR* - The vertex shader path appended with filename
+* @param WCHAR* - The pixel shader path appended with filename
+*
+* @return bool - True if shader init successfully, else false
+*/
+
+bool ASInstanceShader::InitShader(ID3D11Device* device, HWND handle, WCHAR* vsFile, WCHAR* psFile)
+{
+	HRESULT hr;
+
+	// Init pointers to null
+	ID3D10Blob* err = 0;
+	ID3D10Blob* vsBuffer = 0;
+
+	// Other descriptors for buffer
+	D3D11_INPUT_ELEMENT_DESC polyLayout[8];
+
+	D3D11_BUFFER_DESC  cBufferDesc;
+	D3D11_BUFFER_DESC  lightBufferDesc;
+	D3D11_BUFFER_DESC  camBufferDesc;
+	D3D11_SAMPLER_DESC samplerDesc;
+
+	unsigned int numElements;
+
+	// Compile shaders into buffers - any errors are caught and pushed to an error stack, if the 
+	// file is not found user is alerted by a popup message
+	hr = ASResourceManager::GetInstance()->AcquireVertexShader(device, vsFile, "InstanceVertexShader", &m_vShader, &vsBuffer, &err);
+	if(FAILED(hr))
+	{
+		if(err)
+			RaiseShaderError(err, handle, vsFile);
+		else 
+			MessageBox(handle, vsFile, L"Could not find the vertex shader file, please check to see if it exists.", MB_OK);
+
+		return false;
+	}
+
+	// Compile the pixel shader
+	hr = ASResourceManager::GetInstance()->AcquirePixelShader(device, psFile, "InstancePixelShader", &m_pShader, &err);
+	if(FAILED(hr))
+	{
+		if(err)
+			RaiseShaderError(err, handle, psFile);
+		else
+			MessageBox(handle, psFile, L"Could not find the pixel shader file, please check to see if it exists.", MB_OK);
+		return false;
+	}
+
+	// Per vertex data, this matches ASModel's vertex and is read from slot 0
+	polyLayout[0].SemanticName  = "POSITION";
+	polyLayout[0].SemanticIndex = 0;
+	polyLayout[0].Format = DXGI_FORMAT_R32G32B32_FLOAT;
+	polyLayout[0].InputSlot = 0;
+	polyLayout[0].AlignedByteOffset = 0;
+	polyLayout[0].InputSlotClass = D3D11_INPUT_PER_VERTEX_DATA;
+	polyLayout[0].InstanceDataStepRate = 0;
+
+	polyLayout[1].SemanticName  = "TEXCOORD";
+	polyLayout[1].SemanticIndex = 0;
+	polyLayout[1].Format = DXGI_FORMAT_R32G32_FLOAT;
+	polyLayout[1].InputSlot = 0;
+	polyLayout[1].AlignedByteOffset = D3D11_APPEND_ALIGNED_ELEMENT;
+	polyLayout[1].InputSlotClass = D3D11_INPUT_PER_VERTEX_DATA;
+	polyLayout[1].InstanceDataStepRate = 0;
+
+	polyLayout[2].SemanticName = "NORMAL";
+	polyLayout[2].SemanticIndex = 0;
+	polyLayout[2].Format = DXGI_FORMAT_R32G32B32_FLOAT;
+	polyLayout[2].InputSlot = 0;
+	polyLayout[2].AlignedByteOffset = D3D11_APPEND_ALIGNED_ELEMENT;
+	polyLayout[2].InputSlotClass = D3D11_INPUT_PER_VERTEX_DATA;
+	polyLayout[2].InstanceDataStepRate = 0;
+
+	// Per instance data from slot 1, the four rows of the world matrix, this matches
+	// ASEnemies::ASInstance
+	for(unsigned int i = 0; i < 4; i++)
+	{
+		polyLayout[3 + i].SemanticName = "WORLD";
+		polyLayout[3 + i].SemanticIndex = i;
+		polyLayout[3 + i].Format = DXGI_FORMAT_R32G32B32A32_FLOAT;
+		polyLayout[3 + i].InputSlot = 1;
+		polyLayout[3 + i].AlignedByteOffset = (i == 0) ? 0 : D3D11_APPEND_ALIGNED_ELEMENT;
+		polyLayout[3 + i].InputSlotClass = D3D11_INPUT_PER_INSTANCE_DATA;
+		polyLayout[3 + i].InstanceDataStepRate = 1;
+	}
+
+	// Followed by the colour of the instance
+	polyLayout[7].SemanticName = "COLOR";
+	polyLayout[7].SemanticIndex = 0;
+	polyLayout[7].Format = DXGI_FORMAT_R32G32B32A32_FLOAT;
+	polyLayout[7].InputSlot = 1;
+	polyLayout[7].AlignedByteOffset = D3D11_APPEND_ALIGNED_ELEMENT;
+	polyLayout[7].InputSlotClass = D3D11_INPUT_PER_INSTANCE_DATA;
+	polyLayout[7].InstanceDataStepRate = 1;
+
+	// Create the input layout ont he device using our rendering device.
+	numElements = sizeof(polyLayout) / sizeof(polyLayout[0]);
+	hr = device->CreateInputLayout(polyLayout, numElements, vsBuffer->GetBufferPointer(),
+								   vsBuffer->GetBufferSize(), &m_iLayout);
+	if(FAILED(hr))
+		return false;
+
+	// Release the buffers and set null pointers to them as we have loaded the data into pointers
+	vsBuffer->Release();
+	vsBuffer = 0;
+
+	// Create a texture sampler to map the texture to the object
+	samplerDesc.Filter = D3D11_FILTER_MIN_MAG_MIP_LINEAR;
+	samplerDesc.AddressU = D3D11_TEXTURE_ADDRESS_WRAP;
+	samplerDesc.AddressV = D3D11_TEXTURE_ADDRESS_WRAP;
+	samplerDesc.AddressW = D3D11_TEXTURE_ADDRESS_WRAP;
+	samplerDesc.MipLODBias = 0.0f;
+	samplerDesc.MaxAnisotropy = 1;
+	samplerDesc.ComparisonFunc = D3D11_COMPARISON_ALWAYS;
+	samplerDesc.BorderColor[0] = 0;
+	samplerDesc.BorderColor[1] = 0;
+	samplerDesc.BorderColor[2] = 0;
+	samplerDesc.BorderColor[3] = 0;
+	samplerDesc.MinLOD = 0;
+	samplerDesc.MaxLOD = D3D11_FLOAT32_MAX;
+
+	hr = device->CreateSamplerState(&samplerDesc, &m_sampleState);
+	if(FAILED(hr))
+		return false;
+
+	// The constant buffers are the same as ASLightShader's, so its SetShaderParameters can fill them
+	cBufferDesc.Usage = D3D11_USAGE_DYNAMIC;
+	cBufferDesc.ByteWidth = sizeof(ASConstantBuffer);
+	cBufferDesc.BindFlags = D3D11_BIND_CONSTANT_BUFFER;
+	cBufferDesc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+	cBufferDesc.MiscFlags = 0;
+	cBufferDesc.StructureByteStride = 0;
+
+	hr = device->CreateBuffer(&cBufferDesc, NULL, &m_cBuffer);
+	if(FAILED(hr))
+		return false;
+
+	camBufferDesc.Usage = D3D11_USAGE_DYNAMIC;
+	camBufferDesc.ByteWidth = sizeof(ASCameraBuffer);
+	camBufferDesc.BindFlags = D3D11_BIND_CONSTANT_BUFFER;
+	camBufferDesc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+	camBufferDesc.MiscFlags = 0;
+	camBufferDesc.StructureByteStride = 0;
+
+	hr = device->CreateBuffer(&camBufferDesc, NULL, &m_camBuffer);
+	if(FAILED(hr))
+		return false;
+
+	lightBufferDesc.Usage = D3D11_USAGE_DYNAMIC;
+	lightBufferDesc.ByteWidth = sizeof(ASLightBuffer);
+	lightBufferDesc.BindFlags = D3D11_BIND_CONSTANT_BUFFER;
+	lightBufferDesc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+	lightBufferDesc.MiscFlags = 0;
+	lightBufferDesc.StructureByteStride = 0;
+
+	hr = device->CreateBuffer(&lightBufferDesc, NULL, &m_lBuffer);
+	if(FAILED(hr))
+		return false;
+
+	return true;
+}
@@ -0,0 +1,53 @@
+/*
+******************************************************************
+* ASInstanceShader.h
+******************************************************************
+* Draws many copies of a model in one call, the world matrix and
+* colour of each copy come from an instance buffer bound to the
+* second vertex stream.  Lighting matches ASLightShader
+******************************************************************
+*/
+
+#ifndef _ASINSTANCESHADER_H_
+#define _ASINSTANCESHADER_H_
+
+/*
+******************************************************************
+* Includes
+******************************************************************
+*/
+
+#include <d3d11.h>
+#include <d3dx10math.h>
+#include <d3dx11async.h>
+#include <fstream>
+#include "ASLightShader.h"
+
+using namespace std;
+
+/*
+******************************************************************
+* Class Declaration
+******************************************************************
+*/
+
+class ASInstanceShader : public ASLightShader
+{
+public:
+	// Constructors and Destructors
+	ASInstanceShader();
+	ASInstanceShader(const ASInstanceShader&);
+	~ASInstanceShader();
+
+	// Public methods
+	bool Init(ID3D11Device*, HWND);
+	bool SetParameters(ID3D11DeviceContext*, D3DXMATRIX, D3DXMATRIX, ID3D11ShaderResourceView*, 
+					   D3DXVECTOR3, D3DXVECTOR4, D3DXVECTOR4, D3DXVECTOR3, D3DXVECTOR4, float);
+	void RenderInstances(ID3D11DeviceContext*, int, int, int, int);
+
+private:
+	// Private methods
+	bool InitShader(ID3D11Device*, HWND, WCHAR*, WCHAR*);
+};
+
+#endif
@@ -0,0 +1,790 @@
+/*
+******************************************************************
+* ASJobSystem.cpp
+*******************************************************************
+* Implements all methods from ASJobSystem.h
+*******************************************************************
+*/
+
+#include "ASJobSystem.h"
+
+/*
+*******************************************************************
+* Thread local state
+*******************************************************************
+*/
+
+#ifdef _MSC_VER
+#define AS_THREAD_LOCAL __declspec(thread)
+#else
+#define AS_THREAD_LOCAL __thread
+#endif
+
+// Queue the calling thread pushes to and takes from first, 0 for any thread outside the pool
+static AS_THREAD_LOCAL int s_queueIndex = 0;
+
+/*
+*******************************************************************
+* Counter
+*******************************************************************
+*/
+
+ASJobSystem::ASCounter::ASCounter()
+{
+	m_count = 0;
+}
+
+bool ASJobSystem::ASCounter::IsDone()
+{
+	return m_count == 0;
+}
+
+int ASJobSystem::ASCounter::GetCount()
+{
+	return m_count;
+}
+
+/*
+*******************************************************************
+* Constructor
+*******************************************************************
+*/
+
+ASJobSystem::ASJobSystem()
+{
+	m_numWorkers = 0;
+	m_queues     = 0;
+	m_running    = false;
+	m_pending    = 0;
+	m_sleeping   = 0;
+	m_numJobs    = 0;
+	m_numStolen  = 0;
+	m_numHelped  = 0;
+	m_numSleeps  = 0;
+}
+
+/*
+*******************************************************************
+* Empty Constructor
+*******************************************************************
+*/
+
+ASJobSystem::ASJobSystem(const ASJobSystem&)
+{}
+
+/*
+*******************************************************************
+* Destructor
+*******************************************************************
+*/
+
+ASJobSystem::~ASJobSystem()
+{}
+
+/*
+*******************************************************************
+* METHOD: Get Instance
+*******************************************************************
+* Every subsystem shares the one pool, so there is never more than
+* one worker thread per core however many use it
+*
+* @return ASJobSystem* - the job system
+*/
+
+ASJobSystem* ASJobSystem::GetInstance()
+{
+	static ASJobSystem jobSystem;
+	return &jobSystem;
+}
+
+/*
+*******************************************************************
+* METHOD: Init
+*******************************************************************
+* Starts the worker threads
+*
+* @param int - the number of workers, 0 or less for one per core
+*              besides the calling thread
+*
+* @return bool - True if the workers started, else false
+*/
+
+bool ASJobSystem::Init(int numWorkers)
+{
+	if(m_running)
+		return true;
+
+	if(numWorkers <= 0)
+		numWorkers = (int)thread::hardware_concurrency() - 1;
+	if(numWorkers < 0)
+		numWorkers = 0;
+
+	m_numWorkers = numWorkers;
+	m_queues = new ASQueue[m_numWorkers + 1];
+	if(!m_queues)
+		return false;
+
+	m_running = true;
+	for(int i = 0; i < m_numWorkers; i++)
+		m_workers.push_back(thread(&ASJobSystem::WorkerLoop, this, i + 1));
+
+	return true;
+}
+
+/*
+*******************************************************************
+* METHOD: Release
+*******************************************************************
+* Stops the workers, every job run must have been waited on first
+*/
+
+void ASJobSystem::Release()
+{
+	if(!m_running)
+		return;
+
+	{
+		lock_guard<mutex> lock(m_sleepLock);
+		m_running = false;
+	}
+	m_wake.notify_all();
+
+	for(unsigned int i = 0; i < m_workers.size(); i++)
+		m_workers[i].join();
+	m_workers.clear();
+
+	if(m_queues)
+	{
+		delete [] m_queues;
+		m_queues = 0;
+	}
+	m_numWorkers = 0;
+	m_pending    = 0;
+}
+
+/*
+*******************************************************************
+* METHOD: Run
+*******************************************************************
+* Queues a job
+*
+* @param ASJobFunc  - the job
+* @param void*      - passed to the job
+* @param ASCounter* - counts the job until it finishes, may be 0
+*/
+
+void ASJobSystem::Run(ASJobFunc func, void* data, ASCounter* counter)
+{
+	ASJob job;
+
+	job.func    = func;
+	job.range   = 0;
+	job.begin   = 0;
+	job.end     = 0;
+	job.data    = data;
+	job.counter = counter;
+
+	if(counter)
+		counter->m_count++;
+
+	Submit(&job, 1);
+}
+
+/*
+*******************************************************************
+* METHOD: Run After
+*******************************************************************
+* Queues a job once every job on another counter has finished.  The
+* job is counted straight away, so waiting on its counter also waits
+* for what it depends on
+*
+* @param ASCounter* - the counter to wait for
+* @param ASJobFunc  - the job
+* @param void*      - passed to the job
+* @param ASCounter* - counts the job until it finishes, may be 0
+*/
+
+void ASJobSystem::RunAfter(ASCounter* dependency, ASJobFunc func, void* data, ASCounter* counter)
+{
+	ASJob job;
+
+	job.func    = func;
+	job.range   = 0;
+	job.begin   = 0;
+	job.end     = 0;
+	job.data    = data;
+	job.counter = counter;
+
+	if(counter)
+		counter->m_count++;
+
+	// Finish() takes the dependents under the same lock once the count reaches
+	// zero, so the job is either held here or queued now, never lost
+	{
+		lock_guard<mutex> lock(dependency->m_lock);
+		if(dependency->m_count > 0)
+		{
+			dependency->m_dependents.push_back(job);
+			return;
+		}
+	}
+
+	Submit(&job, 1);
+}
+
+/*
+*******************************************************************
+* METHOD: Parallel For
+*******************************************************************
+* Splits the items 0 to count - 1 into batches and queues a job for
+* each batch
+*
+* @param int         - the number of items
+* @param int         - items in a batch, 0 or less to split them into
+*                      a few batches for every thread
+* @param ASRangeFunc - runs one batch, given its first item and one
+*                      past its last
+* @param void*       - passed to each batch
+* @param ASCounter*  - counts the batches until they finish, may be 0
+*/
+
+void ASJobSystem::ParallelFor(int count, int batchSize, ASRangeFunc func, void* data, ASCounter* counter)
+{
+	ASJob batches[64];
+	int numBatches = 0;
+
+	if(count <= 0)
+		return;
+
+	if(batchSize <= 0)
+		batchSize = count / ((m_numWorkers + 1) * 4);
+	if(batchSize < 1)
+		batchSize = 1;
+
+	// Count every batch up front, so the count cannot reach zero between groups
+	if(counter)
+		counter->m_count += (count + batchSize - 1) / batchSize;
+
+	// Queue them in groups, so each group only takes the queue's lock once
+	for(int begin = 0; begin < count; begin += batchSize)
+	{
+		ASJob& job = batches[numBatches++];
+
+		job.func    = 0;
+		job.range   = func;
+		job.begin   = begin;
+		job.end     = (begin + batchSize < count) ? begin + batchSize : count;
+		job.data    = data;
+		job.counter = counter;
+
+		if(numBatches == 64)
+		{
+			Submit(batches, numBatches);
+			numBatches = 0;
+		}
+	}
+
+	if(numBatches > 0)
+		Submit(batches, numBatches);
+}
+
+/*
+*******************************************************************
+* METHOD: Wait
+*******************************************************************
+* Returns once every job on a counter has finished, running queued
+* jobs on the calling thread in the mean time.  Only once this has
+* returned may the counter be destroyed
+*
+* @param ASCounter* - the counter to wait for
+*/
+
+void ASJobSystem::Wait(ASCounter* counter)
+{
+	ASJob job;
+
+	while(counter->m_count > 0)
+	{
+		if(FindJob(job))
+		{
+			m_numHelped++;
+			Execute(job);
+		}
+		else
+			this_thread::yield();
+	}
+
+	// Let the job that finished the count let go of it
+	lock_guard<mutex> lock(counter->m_lock);
+}
+
+/*
+*******************************************************************
+* METHOD: Get Worker Count
+*******************************************************************
+* @return int - the number of worker threads, not counting the
+*               threads that help out in Wait()
+*/
+
+int ASJobSystem::GetWorkerCount()
+{
+	return m_numWorkers;
+}
+
+/*
+*******************************************************************
+* METHOD: Get Stats
+*******************************************************************
+* @return ASStats - the totals since Init
+*/
+
+ASJobSystem::ASStats ASJobSystem::GetStats()
+{
+	ASStats stats;
+
+	stats.numWorkers = m_numWorkers;
+	stats.numJobs    = m_numJobs;
+	stats.numStolen  = m_numStolen;
+	stats.numHelped  = m_numHelped;
+	stats.numSleeps  = m_numSleeps;
+
+	return stats;
+}
+
+/*
+*******************************************************************
+* METHOD: Report
+*******************************************************************
+* Appends how many jobs ran and how they were shared out to
+* ./log/job-system.txt
+*
+* @param const char* - a label for this report
+*/
+
+void ASJobSystem::Report(const char* label)
+{
+	ofstream fout;
+	ASStats stats = GetStats();
+
+	fout.open("./log/job-system.txt", ios::app);
+	if(fout.fail())
+		return;
+
+	fout << "Job system " << label << ": " << stats.numWorkers << " workers, " << stats.numJobs << " jobs, "
+		 << stats.numStolen << " stolen, " << stats.numHelped << " run while waiting, "
+		 << stats.numSleeps << " times a worker slept" << endl;
+
+	fout.close();
+}
+
+/*
+*******************************************************************
+* Benchmark and stress test jobs
+*******************************************************************
+*/
+
+static void EmptyJob(void*)
+{}
+
+// Enough work for one item that batching it is worth it
+static void SumItems(int begin, int end, void* data)
+{
+	float* results = (float*)data;
+
+	for(int i = begin; i < end; i++)
+	{
+		float sum = 0.0f;
+		for(int j = 1; j <= 64; j++)
+			sum += sqrtf((float)(i + j));
+		results[i] = sum;
+	}
+}
+
+/*
+*******************************************************************
+* METHOD: Benchmark
+*******************************************************************
+* Times what scheduling costs and appends it to ./log/job-system.txt,
+* a job run and waited on alone, jobs run together and waited on
+* once, and a parallel for against the same loop on one thread
+*
+* @param int - the number of jobs to time
+*
+* @return bool - True if the parallel for gave the same results as
+*                the loop, else false
+*/
+
+bool ASJobSystem::Benchmark(int numJobs)
+{
+	ofstream fout;
+	ASCounter counter;
+	double start, single, batched, serial, parallel;
+	bool match = true;
+
+	if(numJobs <= 0)
+		return true;
+
+	// One at a time, the round trip through a queue and back
+	start = ASClock::GetSeconds();
+	for(int i = 0; i < numJobs; i++)
+	{
+		Run(EmptyJob, 0, &counter);
+		Wait(&counter);
+	}
+	single = ASClock::GetSeconds() - start;
+
+	// All at once, what each job costs when the workers are kept busy
+	start = ASClock::GetSeconds();
+	for(int i = 0; i < numJobs; i++)
+		Run(EmptyJob, 0, &counter);
+	Wait(&counter);
+	batched = ASClock::GetSeconds() - start;
+
+	// A loop with some work in it, on this thread and spread over the pool
+	vector<float> serialResults(numJobs);
+	vector<float> parallelResults(numJobs);
+
+	start = ASClock::GetSeconds();
+	SumItems(0, numJobs, &serialResults[0]);
+	serial = ASClock::GetSeconds() - start;
+
+	start = ASClock::GetSeconds();
+	ParallelFor(numJobs, 0, SumItems, &parallelResults[0], &counter);
+	Wait(&counter);
+	parallel = ASClock::GetSeconds() - start;
+
+	for(int i = 0; i < numJobs; i++)
+	{
+		if(serialResults[i] != parallelResults[i])
+			match = false;
+	}
+
+	fout.open("./log/job-system.txt", ios::app);
+	if(fout.fail())
+		return match;
+
+	fout << "Job system benchmark, " << m_numWorkers << " workers, " << numJobs << " jobs:" << endl;
+	fout << "  run and wait one at a time " << (single * 1000000.0 / numJobs) << " us a job" << endl;
+	fout << "  run all then wait          " << (batched * 1000000.0 / numJobs) << " us a job" << endl;
+	fout << "  loop " << (serial * 1000.0) << " ms, parallel for " << (parallel * 1000.0) << " ms, "
+		 << (serial / parallel) << "x" << (match ? "" : ", RESULTS DIFFER") << endl;
+
+	fout.close();
+
+	return match;
+}
+
+/*
+*******************************************************************
+* Stress test state
+*******************************************************************
+*/
+
+struct ASStressRound
+{
+	ASJobSystem*             jobs;
+	ASJobSystem::ASCounter*  counter;
+	atomic<int>              hits;		// jobs that have run
+	atomic<int>              expected;	// jobs that have been run
+	atomic<int>              children;	// children each spawner still may spawn
+	atomic<bool>             early;		// the dependent job ran before everything it waited on
+	vector<int>              touched;	// times each item of the parallel for was run
+};
+
+static void StressLeaf(void* data)
+{
+	ASStressRound* round = (ASStressRound*)data;
+	round->hits++;
+}
+
+// Runs more jobs from inside a job, onto the worker's own queue
+static void StressSpawner(void* data)
+{
+	ASStressRound* round = (ASStressRound*)data;
+
+	while(round->children-- > 0)
+	{
+		round->expected++;
+		round->jobs->Run(StressLeaf, round, round->counter);
+	}
+	round->hits++;
+}
+
+static void StressCheck(void* data)
+{
+	ASStressRound* round = (ASStressRound*)data;
+
+	if(round->hits != round->expected)
+		round->early = true;
+}
+
+// Own generator, so the test leaves the rand() sequence the world is placed with alone
+static int StressRandom(unsigned int& seed)
+{
+	seed = seed * 1103515245 + 12345;
+	return (int)((seed >> 16) & 0x7fff);
+}
+
+static void StressTouch(int begin, int end, void* data)
+{
+	ASStressRound* round = (ASStressRound*)data;
+
+	for(int i = begin; i < end; i++)
+		round->touched[i]++;
+}
+
+/*
+*******************************************************************
+* METHOD: Stress Test
+*******************************************************************
+* Runs rounds of random work and checks nothing ran twice, early or
+* not at all: jobs that run more jobs, a job that waits on all of
+* them and parallel fors of odd sizes.  Appends the result to
+* ./log/job-system.txt
+*
+* @param int - the number of rounds
+*
+* @return bool - True if every round passed, else false
+*/
+
+bool ASJobSystem::StressTest(int rounds)
+{
+	ofstream fout;
+	int failures = 0;
+	double start = ASClock::GetSeconds();
+	unsigned long long stolen = m_numStolen;
+
+	unsigned int seed = 40;
+
+	for(int r = 0; r < rounds; r++)
+	{
+		ASStressRound round;
+		ASCounter work, check, items;
+		int numJobs  = 1 + StressRandom(seed) % 500;
+		int numItems = 1 + StressRandom(seed) % 5000;
+
+		round.jobs     = this;
+		round.counter  = &work;
+		round.hits     = 0;
+		round.expected = numJobs;
+		round.children = StressRandom(seed) % 1000;
+		round.early    = false;
+		round.touched.assign(numItems, 0);
+
+		for(int i = 0; i < numJobs; i++)
+			Run((i % 8 == 0) ? StressSpawner : StressLeaf, &round, &work);
+
+		RunAfter(&work, StressCheck, &round, &check);
+		ParallelFor(numItems, StressRandom(seed) % 100, StressTouch, &round, &items);
+
+		Wait(&check);
+		Wait(&items);
+
+		bool passed = work.IsDone() && !round.early && (round.hits == round.expected);
+		for(int i = 0; i < numItems; i++)
+		{
+			if(round.touched[i] != 1)
+				passed = false;
+		}
+
+		if(!passed)
+			failures++;
+	}
+
+	fout.open("./log/job-system.txt", ios::app);
+	if(!fout.fail())
+	{
+		fout << "Job system stress test, " << rounds << " rounds in " << ((ASClock::GetSeconds() - start) * 1000.0) << " ms, "
+			 << (m_numStolen - stolen) << " jobs stolen: " << (failures == 0 ? "passed" : "FAILED") << " ("
+			 << failures << " rounds failed)" << endl;
+		fout.close();
+	}
+
+	return failures == 0;
+}
+
+/*
+*******************************************************************
+* METHOD: Worker Loop
+*******************************************************************
+* Body of each worker thread, runs jobs until there are none left
+* anywhere then sleeps until more are queued
+*
+* @param int - the worker's queue
+*/
+
+void ASJobSystem::WorkerLoop(int queueIndex)
+{
+	ASJob job;
+
+	s_queueIndex = queueIndex;
+	ASProfiler::GetInstance()->SetThreadName("Job worker");
+	ASCPUMonitor::RegisterThread("Job worker");
+
+	while(m_running)
+	{
+		if(FindJob(job))
+		{
+			Execute(job);
+			continue;
+		}
+
+		// Submit() bumps m_pending before it looks at m_sleeping, and this bumps
+		// m_sleeping before it looks at m_pending, so one of them always sees the other
+		unique_lock<mutex> lock(m_sleepLock);
+		m_sleeping++;
+		if(m_pending == 0 && m_running)
+		{
+			m_numSleeps++;
+			while(m_pending == 0 && m_running)
+				m_wake.wait(lock);
+		}
+		m_sleeping--;
+	}
+
+	ASCPUMonitor::UnregisterThread();
+}
+
+/*
+*******************************************************************
+* METHOD: Submit
+*******************************************************************
+* Puts jobs on the back of the calling thread's queue and wakes
+* workers to take them
+*
+* @param const ASJob* - the jobs
+* @param int          - the number of jobs
+*/
+
+void ASJobSystem::Submit(const ASJob* jobs, int numJobs)
+{
+	// Without a pool there is nobody to hand the jobs to
+	if(!m_running)
+	{
+		for(int i = 0; i < numJobs; i++)
+			Execute(jobs[i]);
+		return;
+	}
+
+	ASQueue& queue = m_queues[s_queueIndex];
+	{
+		lock_guard<mutex> lock(queue.lock);
+		for(int i = 0; i < numJobs; i++)
+			queue.jobs.push_back(jobs[i]);
+	}
+	m_pending += numJobs;
+
+	if(m_sleeping > 0)
+	{
+		lock_guard<mutex> lock(m_sleepLock);
+		if(numJobs > 1)
+			m_wake.notify_all();
+		else
+			m_wake.notify_one();
+	}
+}
+
+/*
+*******************************************************************
+* METHOD: Find Job
+*******************************************************************
+* Takes the newest job from the calling thread's own queue, or else
+* steals the oldest from one of the others
+*
+* @param ASJob& - set to the job
+*
+* @return bool - True if a job was found, else false
+*/
+
+bool ASJobSystem::FindJob(ASJob& job)
+{
+	if(m_pending == 0 || !m_queues)
+		return false;
+
+	int numQueues = m_numWorkers + 1;
+	int self      = s_queueIndex;
+
+	{
+		ASQueue& queue = m_queues[self];
+		lock_guard<mutex> lock(queue.lock);
+		if(!queue.jobs.empty())
+		{
+			job = queue.jobs.back();
+			queue.jobs.pop_back();
+			m_pending--;
+			return true;
+		}
+	}
+
+	for(int i = 1; i < numQueues; i++)
+	{
+		ASQueue& queue = m_queues[(self + i) % numQueues];
+		lock_guard<mutex> lock(queue.lock);
+		if(!queue.jobs.empty())
+		{
+			job = queue.jobs.front();
+			queue.jobs.pop_front();
+			m_pending--;
+			m_numStolen++;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/*
+*******************************************************************
+* METHOD: Execute
+*******************************************************************
+* Runs a job and counts it off
+*
+* @param const ASJob& - the job
+*/
+
+void ASJobSystem::Execute(const ASJob& job)
+{
+	if(job.range)
+		job.range(job.begin, job.end, job.data);
+	else
+		job.func(job.data);
+
+	m_numJobs++;
+
+	if(job.counter)
+		Finish(job.counter);
+}
+
+/*
+*******************************************************************
+* METHOD: Finish
+*******************************************************************
+* Counts a job off a counter, once it reaches zero the jobs held
+* back until then are queued
+*
+* @param ASCounter* - the counter
+*/
+
+void ASJobSystem::Finish(ASCounter* counter)
+{
+	vector<ASJob> ready;
+	int count = counter->m_count;
+
+	// While other jobs are left the count cannot reach zero, nobody is done with it
+	while(count > 1)
+	{
+		if(counter->m_count.compare_exchange_weak(count, count - 1))
+			return;
+	}
+
+	// The last job counts off under the lock, Wait() takes the same lock before it
+	// returns so the counter is not destroyed while this still holds it
+	{
+		lock_guard<mutex> lock(counter->m_lock);
+		if(--counter->m_count == 0)
+			ready.swap(counter->m_dependents);
+	}
+
+	if(!ready.empty())
+		Submit(&ready[0], (int)ready.size());
+}
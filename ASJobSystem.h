@@ -0,0 +1,152 @@
+/*
+******************************************************************
+* ASJobSystem.h
+*******************************************************************
+* Runs small pieces of work on a pool of worker threads so every
+* subsystem can spread its expensive steps over the cores without
+* starting threads of its own.
+*
+* Each worker has its own queue.  A job run from a worker goes on
+* the back of that worker's queue and the worker takes its newest
+* job first, while idle workers steal the oldest jobs from the
+* front of the others'.  Jobs run from any other thread, the main
+* thread or the simulation, share one queue the workers steal from.
+*
+* Jobs report to a counter, which counts the jobs still to finish.
+* Wait() does not block on a counter, the waiting thread runs queued
+* jobs itself until the counter reaches zero, so it is safe to call
+* from the main thread and from inside a job.  A job may also be held
+* back until another counter reaches zero with RunAfter()
+*******************************************************************
+*/
+
+#ifndef _ASJOBSYSTEM_H_
+#define _ASJOBSYSTEM_H_
+
+/*
+*******************************************************************
+* Includes:
+*******************************************************************
+*/
+
+#include <vector>
+#include <deque>
+#include <fstream>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <math.h>
+#include "ASProfiler.h"
+#include "ASClock.h"
+#include "ASCPUMonitor.h"
+
+using namespace std;
+
+/*
+*******************************************************************
+* Class declaration
+*******************************************************************
+*/
+
+class ASJobSystem
+{
+public:
+	typedef void (*ASJobFunc)(void*);
+	typedef void (*ASRangeFunc)(int, int, void*);	// runs items [begin, end)
+
+	class ASCounter;
+
+private:
+	struct ASJob
+	{
+		ASJobFunc     func;
+		ASRangeFunc   range;		// set instead of func for a batch of a parallel for
+		int           begin;
+		int           end;
+		void*         data;
+		ASCounter*    counter;
+	};
+
+	struct ASQueue
+	{
+		mutex         lock;
+		deque<ASJob>  jobs;
+	};
+
+public:
+	// Counts the jobs still to finish, and holds the jobs waiting on it
+	class ASCounter
+	{
+	public:
+		ASCounter();
+
+		bool IsDone();
+		int  GetCount();
+
+	private:
+		friend class ASJobSystem;
+
+		atomic<int>   m_count;
+		mutex         m_lock;
+		vector<ASJob> m_dependents;
+	};
+
+	struct ASStats
+	{
+		int                numWorkers;
+		unsigned long long numJobs;		// jobs finished since Init
+		unsigned long long numStolen;	// taken from another thread's queue
+		unsigned long long numHelped;	// run by a thread inside Wait()
+		unsigned long long numSleeps;	// times a worker ran out of work and slept
+	};
+
+public:
+	// Constructors and destructor
+	ASJobSystem();
+	ASJobSystem(const ASJobSystem&);
+	~ASJobSystem();
+
+	static ASJobSystem* GetInstance();
+
+	// Public methods
+	bool Init(int);
+	void Release();
+
+	void Run(ASJobFunc, void*, ASCounter*);
+	void RunAfter(ASCounter*, ASJobFunc, void*, ASCounter*);
+	void ParallelFor(int, int, ASRangeFunc, void*, ASCounter*);
+	void Wait(ASCounter*);
+
+	int  GetWorkerCount();
+	ASStats GetStats();
+	void Report(const char*);
+
+	bool Benchmark(int);
+	bool StressTest(int);
+
+private:
+	// Private methods
+	void WorkerLoop(int);
+	void Submit(const ASJob*, int);
+	bool FindJob(ASJob&);
+	void Execute(const ASJob&);
+	void Finish(ASCounter*);
+
+	// Private member variables
+	int                m_numWorkers;
+	ASQueue*           m_queues;		// [0] is shared by threads outside the pool, [1..] one per worker
+	vector<thread>     m_workers;
+	atomic<bool>       m_running;
+	atomic<int>        m_pending;		// jobs sitting in a queue
+	atomic<int>        m_sleeping;		// workers waiting on m_wake
+	mutex              m_sleepLock;
+	condition_variable m_wake;
+
+	atomic<unsigned long long> m_numJobs;
+	atomic<unsigned long long> m_numStolen;
+	atomic<unsigned long long> m_numHelped;
+	atomic<unsigned long long> m_numSleeps;
+};
+
+#endif
@@ -142,7 +142,6 @@ bool ASLightShader::InitShader(ID3D11Device* device, HWND handle, WCHAR* vsFile,
 	// Init pointers to null
 	ID3D10Blob* err = 0;
 	ID3D10Blob* vsBuffer = 0;
-	ID3D10Blob* psBuffer = 0;
 
 	// Other descriptors for buffer
 	D3D11_INPUT_ELEMENT_DESC polyLayout[3];	// mapped to the vector in ASLight.h to be passed to shader
@@ -156,8 +155,7 @@ bool ASLightShader::InitShader(ID3D11Device* device, HWND handle, WCHAR* vsFile,
 
 	// Compile shaders into buffers - any errors are caught and pushed to an error stack, if the 
 	// file is not found user is alerted by a popup message
-	hr = D3DX11CompileFromFile(vsFile, NULL, NULL, "LightVertexShader", "vs_5_0", D3D10_SHADER_ENABLE_STRICTNESS, 
-							   0, NULL, &vsBuffer, &err, NULL);
+	hr = ASResourceManager::GetInstance()->AcquireVertexShader(device, vsFile, "LightVertexShader", &m_vShader, &vsBuffer, &err);
 	if(FAILED(hr))
 	{
 		if(err)
@@ -169,8 +167,7 @@ bool ASLightShader::InitShader(ID3D11Device* device, HWND handle, WCHAR* vsFile,
 	}
 
 	// Compile the pixel shader
-	hr = D3DX11CompileFromFile(psFile, NULL, NULL, "LightPixelShader", "ps_5_0", D3D10_SHADER_ENABLE_STRICTNESS,
-							  0, NULL, &psBuffer, &err, NULL);
+	hr = ASResourceManager::GetInstance()->AcquirePixelShader(device, psFile, "LightPixelShader", &m_pShader, &err);
 	if(FAILED(hr))
 	{
 		if(err)
@@ -180,15 +177,6 @@ bool ASLightShader::InitShader(ID3D11Device* device, HWND handle, WCHAR* vsFile,
 		return false;
 	}
 
-	// Create shader objects from the pixel and vertex buffers. These pointers will be used to interact with the 
-	// vertex and pixel shaders
-	hr = device->CreateVertexShader(vsBuffer->GetBufferPointer(), vsBuffer->GetBufferSize(), NULL, &m_vShader);
-	if(FAILED(hr))
-		return false;
-	hr = device->CreatePixelShader(psBuffer->GetBufferPointer(), psBuffer->GetBufferSize(), NULL, &m_pShader);
-	if(FAILED(hr))
-		return false;
-
 	// Create the input layout of the vertex data. We define how far apart in memory vertex and pixel data sit,
 	// in this case every 12 bytes are position and every 16 bytes after that will be color - this tells the GPU
 	// the structure of the input, so it knows to process vertex information for 12 byes and then color information 
@@ -227,9 +215,7 @@ bool ASLightShader::InitShader(ID3D11Device* device, HWND handle, WCHAR* vsFile,
 
 	// Release the buffers and set null pointers to them as we have loaded the data into pointers
 	vsBuffer->Release();
-	psBuffer->Release();
 	vsBuffer = 0;
-	psBuffer = 0;
 
 	// Create a texture sampler to map the texture to the object
     samplerDesc.Filter = D3D11_FILTER_MIN_MAG_MIP_LINEAR;
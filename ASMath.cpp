@@ -0,0 +1,425 @@
+/*
+******************************************************************
+* ASMath.cpp
+*******************************************************************
+* Implements all functions from ASMath.h
+*******************************************************************
+*/
+
+#include "ASMath.h"
+
+/*
+*******************************************************************
+* Constructor
+*******************************************************************
+* Builds a matrix from its elements, row by row
+*/
+
+ASMatrix::ASMatrix(float m11, float m12, float m13, float m14,
+				   float m21, float m22, float m23, float m24,
+				   float m31, float m32, float m33, float m34,
+				   float m41, float m42, float m43, float m44)
+{
+	_11 = m11; _12 = m12; _13 = m13; _14 = m14;
+	_21 = m21; _22 = m22; _23 = m23; _24 = m24;
+	_31 = m31; _32 = m32; _33 = m33; _34 = m34;
+	_41 = m41; _42 = m42; _43 = m43; _44 = m44;
+}
+
+/*
+*******************************************************************
+* METHOD: Multiply
+*******************************************************************
+* @param const ASMatrix& - the matrix applied after this one
+*
+* @return ASMatrix - this * matrix
+*/
+
+ASMatrix ASMatrix::operator*(const ASMatrix& matrix) const
+{
+	ASMatrix out;
+	ASMatrixMultiply(&out, this, &matrix);
+	return out;
+}
+
+/*
+*******************************************************************
+* FUNCTION: Vec3 Cross
+*******************************************************************
+* @param ASVector3*       - output for a x b, may be a or b
+* @param const ASVector3* - the first vector
+* @param const ASVector3* - the second vector
+*
+* @return ASVector3* - the output
+*/
+
+ASVector3* ASVec3Cross(ASVector3* out, const ASVector3* a, const ASVector3* b)
+{
+	ASVector3 cross((a->y * b->z) - (a->z * b->y),
+					(a->z * b->x) - (a->x * b->z),
+					(a->x * b->y) - (a->y * b->x));
+
+	*out = cross;
+	return out;
+}
+
+/*
+*******************************************************************
+* FUNCTION: Vec3 Normalize
+*******************************************************************
+* Scales a vector to unit length, a zero vector stays zero as it
+* does in D3DX
+*
+* @param ASVector3*       - output, may be the input
+* @param const ASVector3* - the vector
+*
+* @return ASVector3* - the output
+*/
+
+ASVector3* ASVec3Normalize(ASVector3* out, const ASVector3* v)
+{
+	float length = ASVec3Length(v);
+
+	if(length > 0.0f)
+		*out = *v / length;
+	else
+		*out = ASVector3(0.0f, 0.0f, 0.0f);
+
+	return out;
+}
+
+/*
+*******************************************************************
+* FUNCTION: Vec3 Transform Coord
+*******************************************************************
+* Transforms the point (x, y, z, 1) and projects the result back
+* to w = 1
+*
+* @param ASVector3*       - output, may be the input
+* @param const ASVector3* - the point
+* @param const ASMatrix*  - the transform
+*
+* @return ASVector3* - the output
+*/
+
+ASVector3* ASVec3TransformCoord(ASVector3* out, const ASVector3* v, const ASMatrix* m)
+{
+#ifdef AS_MATH_SSE
+	__m128 result = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(v->x), _mm_loadu_ps(m->m[0])),
+										  _mm_mul_ps(_mm_set1_ps(v->y), _mm_loadu_ps(m->m[1]))),
+							   _mm_add_ps(_mm_mul_ps(_mm_set1_ps(v->z), _mm_loadu_ps(m->m[2])),
+										  _mm_loadu_ps(m->m[3])));
+	float row[4];
+	_mm_storeu_ps(row, result);
+#else
+	float row[4];
+	for(int i = 0; i < 4; i++)
+		row[i] = (v->x * m->m[0][i]) + (v->y * m->m[1][i]) + (v->z * m->m[2][i]) + m->m[3][i];
+#endif
+
+	float invW = (row[3] != 0.0f) ? 1.0f / row[3] : 0.0f;
+	*out = ASVector3(row[0] * invW, row[1] * invW, row[2] * invW);
+
+	return out;
+}
+
+/*
+*******************************************************************
+* FUNCTION: Vec3 Transform Normal
+*******************************************************************
+* Transforms the direction (x, y, z, 0), the translation is ignored
+*
+* @param ASVector3*       - output, may be the input
+* @param const ASVector3* - the direction
+* @param const ASMatrix*  - the transform
+*
+* @return ASVector3* - the output
+*/
+
+ASVector3* ASVec3TransformNormal(ASVector3* out, const ASVector3* v, const ASMatrix* m)
+{
+	ASVector3 result((v->x * m->_11) + (v->y * m->_21) + (v->z * m->_31),
+					 (v->x * m->_12) + (v->y * m->_22) + (v->z * m->_32),
+					 (v->x * m->_13) + (v->y * m->_23) + (v->z * m->_33));
+
+	*out = result;
+	return out;
+}
+
+/*
+*******************************************************************
+* FUNCTION: Matrix Identity
+*******************************************************************
+*/
+
+ASMatrix* ASMatrixIdentity(ASMatrix* out)
+{
+	*out = ASMatrix(1.0f, 0.0f, 0.0f, 0.0f,
+					0.0f, 1.0f, 0.0f, 0.0f,
+					0.0f, 0.0f, 1.0f, 0.0f,
+					0.0f, 0.0f, 0.0f, 1.0f);
+	return out;
+}
+
+/*
+*******************************************************************
+* FUNCTION: Matrix Multiply
+*******************************************************************
+* With row vectors the result applies a first and then b.  Each
+* row of the result is the matching row of a times b, with SSE
+* that is four multiplies and adds of b's rows
+*
+* @param ASMatrix*       - output for a * b, may be a or b
+* @param const ASMatrix* - the first transform
+* @param const ASMatrix* - the second transform
+*
+* @return ASMatrix* - the output
+*/
+
+ASMatrix* ASMatrixMultiply(ASMatrix* out, const ASMatrix* a, const ASMatrix* b)
+{
+	ASMatrix result;
+
+#ifdef AS_MATH_SSE
+	__m128 row0 = _mm_loadu_ps(b->m[0]);
+	__m128 row1 = _mm_loadu_ps(b->m[1]);
+	__m128 row2 = _mm_loadu_ps(b->m[2]);
+	__m128 row3 = _mm_loadu_ps(b->m[3]);
+
+	for(int i = 0; i < 4; i++)
+	{
+		__m128 r = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(a->m[i][0]), row0), _mm_mul_ps(_mm_set1_ps(a->m[i][1]), row1)),
+							  _mm_add_ps(_mm_mul_ps(_mm_set1_ps(a->m[i][2]), row2), _mm_mul_ps(_mm_set1_ps(a->m[i][3]), row3)));
+		_mm_storeu_ps(result.m[i], r);
+	}
+#else
+	for(int i = 0; i < 4; i++)
+	{
+		for(int j = 0; j < 4; j++)
+		{
+			result.m[i][j] = (a->m[i][0] * b->m[0][j]) + (a->m[i][1] * b->m[1][j]) +
+							 (a->m[i][2] * b->m[2][j]) + (a->m[i][3] * b->m[3][j]);
+		}
+	}
+#endif
+
+	*out = result;
+	return out;
+}
+
+/*
+*******************************************************************
+* FUNCTION: Matrix Transpose
+*******************************************************************
+*/
+
+ASMatrix* ASMatrixTranspose(ASMatrix* out, const ASMatrix* m)
+{
+	ASMatrix result;
+
+	for(int i = 0; i < 4; i++)
+	{
+		for(int j = 0; j < 4; j++)
+			result.m[i][j] = m->m[j][i];
+	}
+
+	*out = result;
+	return out;
+}
+
+/*
+*******************************************************************
+* Translation, scaling and rotation matrices, angles in radians.
+* A positive angle turns clockwise looking down the axis towards
+* the origin, as D3DX does
+*******************************************************************
+*/
+
+ASMatrix* ASMatrixTranslation(ASMatrix* out, float x, float y, float z)
+{
+	ASMatrixIdentity(out);
+	out->_41 = x;
+	out->_42 = y;
+	out->_43 = z;
+	return out;
+}
+
+ASMatrix* ASMatrixScaling(ASMatrix* out, float x, float y, float z)
+{
+	ASMatrixIdentity(out);
+	out->_11 = x;
+	out->_22 = y;
+	out->_33 = z;
+	return out;
+}
+
+ASMatrix* ASMatrixRotationX(ASMatrix* out, float angle)
+{
+	float s = sinf(angle);
+	float c = cosf(angle);
+
+	ASMatrixIdentity(out);
+	out->_22 = c;
+	out->_23 = s;
+	out->_32 = -s;
+	out->_33 = c;
+	return out;
+}
+
+ASMatrix* ASMatrixRotationY(ASMatrix* out, float angle)
+{
+	float s = sinf(angle);
+	float c = cosf(angle);
+
+	ASMatrixIdentity(out);
+	out->_11 = c;
+	out->_13 = -s;
+	out->_31 = s;
+	out->_33 = c;
+	return out;
+}
+
+ASMatrix* ASMatrixRotationZ(ASMatrix* out, float angle)
+{
+	float s = sinf(angle);
+	float c = cosf(angle);
+
+	ASMatrixIdentity(out);
+	out->_11 = c;
+	out->_12 = s;
+	out->_21 = -s;
+	out->_22 = c;
+	return out;
+}
+
+/*
+*******************************************************************
+* FUNCTION: Matrix Rotation Yaw Pitch Roll
+*******************************************************************
+* Rolls about z, then pitches about x, then yaws about y
+*
+* @param ASMatrix* - output
+* @param float     - yaw, about the y axis
+* @param float     - pitch, about the x axis
+* @param float     - roll, about the z axis
+*
+* @return ASMatrix* - the output
+*/
+
+ASMatrix* ASMatrixRotationYawPitchRoll(ASMatrix* out, float yaw, float pitch, float roll)
+{
+	ASMatrix rollMatrix, pitchMatrix, yawMatrix;
+
+	ASMatrixRotationZ(&rollMatrix, roll);
+	ASMatrixRotationX(&pitchMatrix, pitch);
+	ASMatrixRotationY(&yawMatrix, yaw);
+
+	ASMatrixMultiply(out, &rollMatrix, &pitchMatrix);
+	return ASMatrixMultiply(out, out, &yawMatrix);
+}
+
+/*
+*******************************************************************
+* FUNCTION: Matrix Look At LH
+*******************************************************************
+* Builds a view matrix for an eye looking at a point
+*
+* @param ASMatrix*        - output
+* @param const ASVector3* - the position of the eye
+* @param const ASVector3* - the point being looked at
+* @param const ASVector3* - the direction of up in the world
+*
+* @return ASMatrix* - the output
+*/
+
+ASMatrix* ASMatrixLookAtLH(ASMatrix* out, const ASVector3* eye, const ASVector3* at, const ASVector3* up)
+{
+	ASVector3 xAxis, yAxis, zAxis;
+
+	zAxis = *at - *eye;
+	ASVec3Normalize(&zAxis, &zAxis);
+	ASVec3Cross(&xAxis, up, &zAxis);
+	ASVec3Normalize(&xAxis, &xAxis);
+	ASVec3Cross(&yAxis, &zAxis, &xAxis);
+
+	*out = ASMatrix(xAxis.x, yAxis.x, zAxis.x, 0.0f,
+					xAxis.y, yAxis.y, zAxis.y, 0.0f,
+					xAxis.z, yAxis.z, zAxis.z, 0.0f,
+					-ASVec3Dot(&xAxis, eye), -ASVec3Dot(&yAxis, eye), -ASVec3Dot(&zAxis, eye), 1.0f);
+	return out;
+}
+
+/*
+*******************************************************************
+* FUNCTION: Matrix Perspective Fov LH
+*******************************************************************
+* Builds a projection that maps depths between the near and far
+* planes onto 0 to 1
+*
+* @param ASMatrix* - output
+* @param float     - the vertical field of view in radians
+* @param float     - the aspect ratio, width / height
+* @param float     - the distance to the near plane
+* @param float     - the distance to the far plane
+*
+* @return ASMatrix* - the output
+*/
+
+ASMatrix* ASMatrixPerspectiveFovLH(ASMatrix* out, float fovY, float aspect, float zNear, float zFar)
+{
+	float yScale = 1.0f / tanf(fovY / 2.0f);
+	float xScale = yScale / aspect;
+	float range  = zFar / (zFar - zNear);
+
+	*out = ASMatrix(xScale, 0.0f,   0.0f,            0.0f,
+					0.0f,   yScale, 0.0f,            0.0f,
+					0.0f,   0.0f,   range,           1.0f,
+					0.0f,   0.0f,   -zNear * range,  0.0f);
+	return out;
+}
+
+/*
+*******************************************************************
+* FUNCTION: Matrix Ortho LH
+*******************************************************************
+* @param ASMatrix* - output
+* @param float     - the width of the view
+* @param float     - the height of the view
+* @param float     - the distance to the near plane
+* @param float     - the distance to the far plane
+*
+* @return ASMatrix* - the output
+*/
+
+ASMatrix* ASMatrixOrthoLH(ASMatrix* out, float width, float height, float zNear, float zFar)
+{
+	float range = 1.0f / (zFar - zNear);
+
+	*out = ASMatrix(2.0f / width, 0.0f,          0.0f,            0.0f,
+					0.0f,         2.0f / height, 0.0f,            0.0f,
+					0.0f,         0.0f,          range,           0.0f,
+					0.0f,         0.0f,          -zNear * range,  1.0f);
+	return out;
+}
+
+/*
+*******************************************************************
+* FUNCTION: Plane Normalize
+*******************************************************************
+* Scales a plane so its normal has unit length, the distances it
+* gives are then true distances
+*
+* @param ASPlane*       - output, may be the input
+* @param const ASPlane* - the plane
+*
+* @return ASPlane* - the output
+*/
+
+ASPlane* ASPlaneNormalize(ASPlane* out, const ASPlane* p)
+{
+	float length = sqrtf((p->a * p->a) + (p->b * p->b) + (p->c * p->c));
+	float scale  = (length > 0.0f) ? 1.0f / length : 0.0f;
+
+	*out = ASPlane(p->a * scale, p->b * scale, p->c * scale, p->d * scale);
+	return out;
+}
@@ -0,0 +1,199 @@
+/*
+******************************************************************
+* ASMath.h
+*******************************************************************
+* The engine's own vector, matrix and plane types, so the CPU side
+* of the simulation and culling does not depend on D3DX and builds
+* on any platform.  Conventions follow D3DX: left handed, row
+* vectors that are multiplied on the left of a matrix (v * M), and
+* matrices stored row by row with the translation in _41, _42, _43.
+* The functions are named after their D3DX counterparts, take the
+* same arguments and return the output pointer the same way.
+*
+* The matrix product and transforms use SSE on x86 and x64, any
+* other target takes the scalar path.  Under Windows each type
+* converts to and from its D3DX type, the memory layout is the
+* same, so they can be handed straight to the shaders
+*******************************************************************
+*/
+
+#ifndef _ASMATH_H_
+#define _ASMATH_H_
+
+/*
+*******************************************************************
+* Includes:
+*******************************************************************
+* + d3dx10math.h is only included under Windows, for the
+*   conversions to the D3DX types
+*******************************************************************
+*/
+
+#include <math.h>
+#include <string.h>
+
+// SSE is part of every x86 and x64 target, anything else takes the scalar path.
+// Defining AS_MATH_NO_SSE forces the scalar path to check one against the other
+#if (defined(_M_IX86) || defined(_M_X64) || defined(__SSE__)) && !defined(AS_MATH_NO_SSE)
+#define AS_MATH_SSE
+#include <xmmintrin.h>
+#endif
+
+#if defined(_WIN32) && !defined(AS_MATH_NO_D3DX)
+#define AS_MATH_D3DX
+#include <d3dx10math.h>
+#endif
+
+const float AS_PI = 3.141592654f;
+
+/*
+*******************************************************************
+* Type declarations
+*******************************************************************
+*/
+
+struct ASVector2
+{
+	float x, y;
+
+	ASVector2() {}
+	ASVector2(float vx, float vy) : x(vx), y(vy) {}
+
+#ifdef AS_MATH_D3DX
+	ASVector2(const D3DXVECTOR2& v) : x(v.x), y(v.y) {}
+	operator D3DXVECTOR2() const { return D3DXVECTOR2(x, y); }
+#endif
+};
+
+struct ASVector3
+{
+	float x, y, z;
+
+	ASVector3() {}
+	ASVector3(float vx, float vy, float vz) : x(vx), y(vy), z(vz) {}
+
+	ASVector3 operator+(const ASVector3& v) const { return ASVector3(x + v.x, y + v.y, z + v.z); }
+	ASVector3 operator-(const ASVector3& v) const { return ASVector3(x - v.x, y - v.y, z - v.z); }
+	ASVector3 operator*(float s) const            { return ASVector3(x * s, y * s, z * s); }
+	ASVector3 operator/(float s) const            { return ASVector3(x / s, y / s, z / s); }
+	ASVector3 operator-() const                   { return ASVector3(-x, -y, -z); }
+
+	ASVector3& operator+=(const ASVector3& v) { x += v.x; y += v.y; z += v.z; return *this; }
+	ASVector3& operator-=(const ASVector3& v) { x -= v.x; y -= v.y; z -= v.z; return *this; }
+	ASVector3& operator*=(float s)            { x *= s; y *= s; z *= s; return *this; }
+
+#ifdef AS_MATH_D3DX
+	ASVector3(const D3DXVECTOR3& v) : x(v.x), y(v.y), z(v.z) {}
+	operator D3DXVECTOR3() const { return D3DXVECTOR3(x, y, z); }
+#endif
+};
+
+struct ASVector4
+{
+	float x, y, z, w;
+
+	ASVector4() {}
+	ASVector4(float vx, float vy, float vz, float vw) : x(vx), y(vy), z(vz), w(vw) {}
+
+#ifdef AS_MATH_D3DX
+	ASVector4(const D3DXVECTOR4& v) : x(v.x), y(v.y), z(v.z), w(v.w) {}
+	operator D3DXVECTOR4() const { return D3DXVECTOR4(x, y, z, w); }
+#endif
+};
+
+// The plane a*x + b*y + c*z + d = 0, (a, b, c) is its normal
+struct ASPlane
+{
+	float a, b, c, d;
+
+	ASPlane() {}
+	ASPlane(float pa, float pb, float pc, float pd) : a(pa), b(pb), c(pc), d(pd) {}
+};
+
+struct ASMatrix
+{
+	union
+	{
+		struct
+		{
+			float _11, _12, _13, _14;
+			float _21, _22, _23, _24;
+			float _31, _32, _33, _34;
+			float _41, _42, _43, _44;
+		};
+		float m[4][4];
+	};
+
+	ASMatrix() {}
+	ASMatrix(float m11, float m12, float m13, float m14,
+			 float m21, float m22, float m23, float m24,
+			 float m31, float m32, float m33, float m34,
+			 float m41, float m42, float m43, float m44);
+
+	ASMatrix operator*(const ASMatrix&) const;
+
+#ifdef AS_MATH_D3DX
+	ASMatrix(const D3DXMATRIX& matrix) { memcpy(m, &matrix._11, sizeof(m)); }
+	operator D3DXMATRIX() const { return D3DXMATRIX(&_11); }
+#endif
+};
+
+/*
+*******************************************************************
+* Vector functions
+*******************************************************************
+*/
+
+inline float ASVec3Dot(const ASVector3* a, const ASVector3* b)
+{
+	return (a->x * b->x) + (a->y * b->y) + (a->z * b->z);
+}
+
+inline float ASVec3Length(const ASVector3* v)
+{
+	return sqrtf(ASVec3Dot(v, v));
+}
+
+ASVector3* ASVec3Cross(ASVector3*, const ASVector3*, const ASVector3*);
+ASVector3* ASVec3Normalize(ASVector3*, const ASVector3*);
+ASVector3* ASVec3TransformCoord(ASVector3*, const ASVector3*, const ASMatrix*);
+ASVector3* ASVec3TransformNormal(ASVector3*, const ASVector3*, const ASMatrix*);
+
+/*
+*******************************************************************
+* Matrix functions
+*******************************************************************
+*/
+
+ASMatrix* ASMatrixIdentity(ASMatrix*);
+ASMatrix* ASMatrixMultiply(ASMatrix*, const ASMatrix*, const ASMatrix*);
+ASMatrix* ASMatrixTranspose(ASMatrix*, const ASMatrix*);
+ASMatrix* ASMatrixTranslation(ASMatrix*, float, float, float);
+ASMatrix* ASMatrixScaling(ASMatrix*, float, float, float);
+ASMatrix* ASMatrixRotationX(ASMatrix*, float);
+ASMatrix* ASMatrixRotationY(ASMatrix*, float);
+ASMatrix* ASMatrixRotationZ(ASMatrix*, float);
+ASMatrix* ASMatrixRotationYawPitchRoll(ASMatrix*, float, float, float);
+ASMatrix* ASMatrixLookAtLH(ASMatrix*, const ASVector3*, const ASVector3*, const ASVector3*);
+ASMatrix* ASMatrixPerspectiveFovLH(ASMatrix*, float, float, float, float);
+ASMatrix* ASMatrixOrthoLH(ASMatrix*, float, float, float, float);
+
+/*
+*******************************************************************
+* Plane functions
+*******************************************************************
+*/
+
+inline float ASPlaneDotCoord(const ASPlane* p, const ASVector3* v)
+{
+	return (p->a * v->x) + (p->b * v->y) + (p->c * v->z) + p->d;
+}
+
+inline float ASPlaneDotNormal(const ASPlane* p, const ASVector3* v)
+{
+	return (p->a * v->x) + (p->b * v->y) + (p->c * v->z);
+}
+
+ASPlane* ASPlaneNormalize(ASPlane*, const ASPlane*);
+
+#endif
@@ -0,0 +1,258 @@
+/*
+******************************************************************
+* ASMemory.cpp
+*******************************************************************
+* Implements all methods from ASMemory.h
+*******************************************************************
+*/
+
+#include "ASMemory.h"
+
+/*
+*******************************************************************
+* Block header
+*******************************************************************
+* Put in front of every tagged block, padded to 16 bytes so the
+* block after it is aligned as malloc() would align it
+*/
+
+union ASBlockHeader
+{
+	struct
+	{
+		size_t size;
+		int    tag;
+	} block;
+	char padding[16];
+};
+
+atomic<long long> ASMemory::s_currentBytes[MEMORY_TAG_COUNT];
+atomic<long long> ASMemory::s_peakBytes[MEMORY_TAG_COUNT];
+atomic<long long> ASMemory::s_numAllocations[MEMORY_TAG_COUNT];
+atomic<long long> ASMemory::s_numFrees[MEMORY_TAG_COUNT];
+atomic<long long> ASMemory::s_heapAllocations;
+
+/*
+*******************************************************************
+* METHOD: Allocate
+*******************************************************************
+* @param size_t      - the bytes wanted
+* @param ASMemoryTag - the subsystem they are for
+*
+* @return void* - the memory, or 0 if there is not enough
+*/
+
+void* ASMemory::Allocate(size_t size, ASMemoryTag tag)
+{
+#ifdef AS_NO_MEMORY_TAGS
+	return malloc(size);
+#else
+	ASBlockHeader* header = (ASBlockHeader*)malloc(sizeof(ASBlockHeader) + size);
+	if(!header)
+		return 0;
+
+	header->block.size = size;
+	header->block.tag  = tag;
+
+	// Raise the peak if this took the tag past it, another thread may raise it
+	// further in between so keep trying until the peak is at least what we saw
+	long long current = s_currentBytes[tag].fetch_add((long long)size, memory_order_relaxed) + (long long)size;
+	long long peak    = s_peakBytes[tag].load(memory_order_relaxed);
+	while(current > peak && !s_peakBytes[tag].compare_exchange_weak(peak, current, memory_order_relaxed))
+	{}
+	s_numAllocations[tag].fetch_add(1, memory_order_relaxed);
+	CountHeapAllocation();
+
+	return header + 1;
+#endif
+}
+
+/*
+*******************************************************************
+* METHOD: Free
+*******************************************************************
+* @param void* - memory from Allocate(), or 0
+*/
+
+void ASMemory::Free(void* memory)
+{
+#ifdef AS_NO_MEMORY_TAGS
+	free(memory);
+#else
+	if(!memory)
+		return;
+
+	ASBlockHeader* header = (ASBlockHeader*)memory - 1;
+	int tag = header->block.tag;
+
+	s_currentBytes[tag].fetch_sub((long long)header->block.size, memory_order_relaxed);
+	s_numFrees[tag].fetch_add(1, memory_order_relaxed);
+
+	free(header);
+#endif
+}
+
+/*
+*******************************************************************
+* METHOD: Get Stats
+*******************************************************************
+* @param ASMemoryTag - the tag
+* @param ASTagStats& - filled in with its counters
+*/
+
+void ASMemory::GetStats(ASMemoryTag tag, ASTagStats& stats)
+{
+	stats.currentBytes   = s_currentBytes[tag].load(memory_order_relaxed);
+	stats.peakBytes      = s_peakBytes[tag].load(memory_order_relaxed);
+	stats.numAllocations = s_numAllocations[tag].load(memory_order_relaxed);
+	stats.numFrees       = s_numFrees[tag].load(memory_order_relaxed);
+}
+
+/*
+*******************************************************************
+* METHOD: Get Heap Allocations
+*******************************************************************
+* @return long long - heap allocations made on any thread since the
+*                     program started, 0 with AS_NO_MEMORY_TAGS
+*/
+
+long long ASMemory::GetHeapAllocations()
+{
+	return s_heapAllocations.load(memory_order_relaxed);
+}
+
+/*
+*******************************************************************
+* METHOD: Count Heap Allocation
+*******************************************************************
+* Called by Allocate() and the global operator new below
+*/
+
+void ASMemory::CountHeapAllocation()
+{
+	s_heapAllocations.fetch_add(1, memory_order_relaxed);
+}
+
+/*
+*******************************************************************
+* METHOD: Get Tag Name
+*******************************************************************
+* @param ASMemoryTag - the tag
+*
+* @return const char* - its name in reports
+*/
+
+const char* ASMemory::GetTagName(ASMemoryTag tag)
+{
+	switch(tag)
+	{
+	case MEMORY_TERRAIN:  return "Terrain";
+	case MEMORY_QUADTREE: return "QuadTree";
+	case MEMORY_MODEL:    return "Model";
+	case MEMORY_TEXT:     return "Text";
+	case MEMORY_AUDIO:    return "Audio";
+	case MEMORY_FRAME:    return "Frame";
+	default:              return "Unknown";
+	}
+}
+
+/*
+*******************************************************************
+* METHOD: Report
+*******************************************************************
+* Appends what every tag holds now and has held at most to
+* ./log/memory.txt, what is still held at shutdown was leaked
+*
+* @param const char* - a label for this report
+*/
+
+void ASMemory::Report(const char* label)
+{
+	ofstream fout;
+
+	fout.open("./log/memory.txt", ios::app);
+	if(fout.fail())
+		return;
+
+#ifdef AS_NO_MEMORY_TAGS
+	fout << "Memory " << label << ": not counted, built with AS_NO_MEMORY_TAGS" << endl;
+#else
+	long long totalCurrent = 0, totalPeak = 0;
+
+	fout << "Memory " << label << ":" << endl;
+	for(int i = 0; i < MEMORY_TAG_COUNT; i++)
+	{
+		ASTagStats stats;
+		GetStats((ASMemoryTag)i, stats);
+
+		fout << "  " << GetTagName((ASMemoryTag)i) << ": " << (stats.currentBytes / 1024) << " KB held, "
+			 << (stats.peakBytes / 1024) << " KB at most, " << stats.numAllocations << " allocations, "
+			 << stats.numFrees << " frees" << endl;
+
+		totalCurrent += stats.currentBytes;
+		totalPeak    += stats.peakBytes;
+	}
+	fout << "  all tags: " << (totalCurrent / 1024) << " KB held, " << (totalPeak / 1024)
+		 << " KB at most (the sum of each tag's peak)" << endl;
+#endif
+
+	fout.close();
+}
+
+/*
+*******************************************************************
+* Global operator new and delete
+*******************************************************************
+* Replaced so every allocation made with new is counted as well,
+* otherwise they behave as the library's do
+*/
+
+#ifndef AS_NO_MEMORY_TAGS
+void* operator new(size_t size)
+{
+	void* memory = malloc(size ? size : 1);
+	if(!memory)
+		throw bad_alloc();
+
+	ASMemory::CountHeapAllocation();
+	return memory;
+}
+
+void* operator new[](size_t size)
+{
+	return operator new(size);
+}
+
+void* operator new(size_t size, const nothrow_t&) throw()
+{
+	void* memory = malloc(size ? size : 1);
+	if(memory)
+		ASMemory::CountHeapAllocation();
+	return memory;
+}
+
+void* operator new[](size_t size, const nothrow_t& nothrow) throw()
+{
+	return operator new(size, nothrow);
+}
+
+void operator delete(void* memory) throw()
+{
+	free(memory);
+}
+
+void operator delete[](void* memory) throw()
+{
+	free(memory);
+}
+
+void operator delete(void* memory, const nothrow_t&) throw()
+{
+	free(memory);
+}
+
+void operator delete[](void* memory, const nothrow_t&) throw()
+{
+	free(memory);
+}
+#endif
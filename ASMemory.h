@@ -0,0 +1,163 @@
+/*
+******************************************************************
+* ASMemory.h
+*******************************************************************
+* Tagged allocations.  Memory a subsystem holds for any length of
+* time is allocated with a tag naming the subsystem, and for each
+* tag the bytes held now, the most ever held at once and the number
+* of allocations and frees are counted:
+*
+*     m_vertices = ASNewArray<ASVertex>(numVertices, MEMORY_TERRAIN);
+*     ...
+*     ASDeleteArray(m_vertices);
+*
+* Each block carries a small header with its size and tag, so it
+* must be freed with ASDeleteArray() or ASDelete(), never delete.
+* The counters are atomics updated without ordering, an allocation
+* costs a few of them on top of the heap.  Building with
+* AS_NO_MEMORY_TAGS defined drops the header and the counting.
+* Report() writes the counters for every tag.
+*
+* Every heap allocation, tagged or made with new, is also counted
+* so the engine can check a frame in the steady state makes none
+*******************************************************************
+*/
+
+#ifndef _ASMEMORY_H_
+#define _ASMEMORY_H_
+
+/*
+*******************************************************************
+* Includes:
+*******************************************************************
+*/
+
+#include <stdlib.h>
+#include <new>
+#include <fstream>
+#include <atomic>
+
+using namespace std;
+
+/*
+*******************************************************************
+* Tags
+*******************************************************************
+*/
+
+enum ASMemoryTag
+{
+	MEMORY_TERRAIN,
+	MEMORY_QUADTREE,
+	MEMORY_MODEL,
+	MEMORY_TEXT,
+	MEMORY_AUDIO,
+	MEMORY_FRAME,
+	MEMORY_TAG_COUNT
+};
+
+/*
+*******************************************************************
+* Class declaration
+*******************************************************************
+*/
+
+class ASMemory
+{
+public:
+	struct ASTagStats
+	{
+		long long currentBytes;
+		long long peakBytes;
+		long long numAllocations;
+		long long numFrees;
+	};
+
+public:
+	// Public methods
+	static void* Allocate(size_t, ASMemoryTag);
+	static void  Free(void*);
+
+	static void GetStats(ASMemoryTag, ASTagStats&);
+	static long long GetHeapAllocations();
+	static void CountHeapAllocation();
+	static const char* GetTagName(ASMemoryTag);
+	static void Report(const char*);
+
+private:
+	// Not made, everything is static
+	ASMemory();
+	ASMemory(const ASMemory&);
+	~ASMemory();
+
+	// Private member variables
+	static atomic<long long> s_currentBytes[MEMORY_TAG_COUNT];
+	static atomic<long long> s_peakBytes[MEMORY_TAG_COUNT];
+	static atomic<long long> s_numAllocations[MEMORY_TAG_COUNT];
+	static atomic<long long> s_numFrees[MEMORY_TAG_COUNT];
+	static atomic<long long> s_heapAllocations;
+};
+
+/*
+*******************************************************************
+* Typed allocation
+*******************************************************************
+* The objects are constructed and destroyed as new and delete would,
+* the delete functions set the pointer to 0 and accept 0
+*/
+
+template<class T> T* ASNew(ASMemoryTag tag)
+{
+	void* memory = ASMemory::Allocate(sizeof(T), tag);
+	if(!memory)
+		return 0;
+
+	return new(memory) T;
+}
+
+template<class T> void ASDelete(T*& object)
+{
+	if(!object)
+		return;
+
+	object->~T();
+	ASMemory::Free(object);
+	object = 0;
+}
+
+// Arrays keep their length in front of the first element so the
+// elements can be destroyed
+template<class T> T* ASNewArray(size_t count, ASMemoryTag tag)
+{
+	const size_t front = (sizeof(size_t) + __alignof(T) - 1) / __alignof(T) * __alignof(T);
+
+	char* memory = (char*)ASMemory::Allocate(front + (count * sizeof(T)), tag);
+	if(!memory)
+		return 0;
+
+	*(size_t*)(memory + front - sizeof(size_t)) = count;
+
+	T* elements = (T*)(memory + front);
+	for(size_t i = 0; i < count; i++)
+		new(elements + i) T;
+
+	return elements;
+}
+
+template<class T> void ASDeleteArray(T*& elements)
+{
+	const size_t front = (sizeof(size_t) + __alignof(T) - 1) / __alignof(T) * __alignof(T);
+
+	if(!elements)
+		return;
+
+	char*  memory = (char*)elements - front;
+	size_t count  = *(size_t*)(memory + front - sizeof(size_t));
+	for(size_t i = 0; i < count; i++)
+		elements[i].~T();
+
+	ASMemory::Free(memory);
+	elements = 0;
+}
+
+#endif
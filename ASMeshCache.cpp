@@ -0,0 +1,394 @@
+/*
+******************************************************************
+* ASMeshCache.cpp
+*******************************************************************
+* Implements all methods from ASMeshCache.h
+*******************************************************************
+*/
+
+#include "ASMeshCache.h"
+
+/*
+*******************************************************************
+* Constructor
+*******************************************************************
+*/
+
+ASMeshCache::ASMeshCache()
+{
+	m_header = 0;
+}
+
+/*
+*******************************************************************
+* Empty Constructor
+*******************************************************************
+*/
+
+ASMeshCache::ASMeshCache(const ASMeshCache&)
+{}
+
+/*
+*******************************************************************
+* Destructor
+*******************************************************************
+* The mapped file is released by ASFileMap's destructor
+*/
+
+ASMeshCache::~ASMeshCache()
+{}
+
+/*
+*******************************************************************
+* METHOD: Open
+*******************************************************************
+* Maps a cache file and checks that it can be used as it is: the
+* header must match this version of the format, the streams must
+* lie inside the file and the source file must not have changed
+* since the cache was built.  If the source file is missing the
+* cache is trusted, so a build can ship the caches on their own
+*
+* @param const char*  - the cache file to open
+* @param const char*  - the text or .obj file the cache was built from
+* @param unsigned int - the smallest vertex stride the caller can use
+*
+* @return bool - True if the cache is valid and mapped, else false
+*/
+
+bool ASMeshCache::Open(const char* cacheFile, const char* sourceFile, unsigned int minStride)
+{
+	unsigned long long sourceSize;
+	unsigned long long sourceTime;
+
+	if(!m_file.Init(cacheFile))
+		return false;
+
+	// The file must at least hold a header
+	if(m_file.GetSize() < sizeof(ASHeader))
+	{
+		Release();
+		return false;
+	}
+	m_header = (const ASHeader*)m_file.GetData();
+
+	// Check the magic number and the version of the format
+	if(memcmp(m_header->magic, "ASMH", 4) != 0 || m_header->version != VERSION)
+	{
+		Release();
+		return false;
+	}
+
+	// Check the streams fit the caller's vertex layout and lie inside the file
+	unsigned long long vertexEnd = (unsigned long long)m_header->vertexOffset +
+								   (unsigned long long)m_header->vertexStride * m_header->numVertices;
+	unsigned long long indexEnd  = (unsigned long long)m_header->indexOffset +
+								   (unsigned long long)m_header->indexSize * m_header->numIndices;
+
+	if(m_header->vertexStride < minStride || m_header->numVertices == 0 || m_header->numIndices == 0 ||
+	   (m_header->indexSize != 2 && m_header->indexSize != 4) ||
+	   vertexEnd > m_file.GetSize() || indexEnd > m_file.GetSize() ||
+	   m_header->numLods == 0 || m_header->numLods > (unsigned int)MAX_LODS)
+	{
+		Release();
+		return false;
+	}
+
+	// Every level of detail must lie inside the index stream
+	for(unsigned int i = 0; i < m_header->numLods; i++)
+	{
+		if(m_header->lods[i].startIndex + m_header->lods[i].numIndices > m_header->numIndices)
+		{
+			Release();
+			return false;
+		}
+	}
+
+	// Finally check the source file has not been edited since the cache was built
+	if(GetSourceStamp(sourceFile, sourceSize, sourceTime))
+	{
+		if(sourceSize != m_header->sourceSize || sourceTime != m_header->sourceTime)
+		{
+			Release();
+			return false;
+		}
+	}
+
+	return true;
+}
+
+/*
+*******************************************************************
+* METHOD: Write
+*******************************************************************
+* Builds a cache file from a mesh held in memory.  The position
+* must be the first three floats of each vertex, this is used to
+* calculate the bounds.  16 bit indices are written whenever every
+* vertex can be addressed with them.  Without a LOD table the whole
+* index list is stored as a single full detail level
+*
+* @param const char*          - the cache file to write
+* @param const char*          - the file the mesh was loaded from
+* @param const void*          - the vertex data
+* @param unsigned int         - bytes per vertex
+* @param int                  - the number of vertices
+* @param const unsigned long* - the index data, 0 for a non indexed mesh
+* @param int                  - the number of indices
+* @param const ASLod*         - the levels of detail, 0 if there are none
+* @param int                  - the number of levels of detail
+*
+* @return bool - True if the cache was written, else false
+*/
+
+bool ASMeshCache::Write(const char* cacheFile, const char* sourceFile, const void* vertices, unsigned int stride,
+						int numVertices, const unsigned long* indices, int numIndices,
+						const ASLod* lods, int numLods)
+{
+	ofstream fout;
+	ASHeader header;
+	char     padding[STREAM_ALIGNMENT] = { 0 };
+
+	if(!vertices || numVertices <= 0 || numIndices <= 0 || stride < 3 * sizeof(float) || numLods > MAX_LODS)
+		return false;
+
+	memset(&header, 0, sizeof(header));
+	memcpy(header.magic, "ASMH", 4);
+
+	// Stamp the cache with the source file, without a source it could never be checked
+	if(!GetSourceStamp(sourceFile, header.sourceSize, header.sourceTime))
+		return false;
+
+	header.version      = VERSION;
+	header.vertexStride = stride;
+	header.numVertices  = numVertices;
+	header.numIndices   = numIndices;
+	header.indexSize    = (numVertices <= MAX_SHORT_INDEX_VERTICES) ? 2 : 4;
+
+	// Lay out the streams one after the other, each on an aligned boundary
+	unsigned int vertexBytes = stride * numVertices;
+	header.vertexOffset = (sizeof(ASHeader) + STREAM_ALIGNMENT - 1) & ~(STREAM_ALIGNMENT - 1);
+	header.indexOffset  = (header.vertexOffset + vertexBytes + STREAM_ALIGNMENT - 1) & ~(STREAM_ALIGNMENT - 1);
+
+	CalculateBounds(vertices, stride, numVertices, header.boundsMin, header.boundsMax, header.center, header.radius);
+
+	if(lods && numLods > 0)
+	{
+		header.numLods = numLods;
+		memcpy(header.lods, lods, numLods * sizeof(ASLod));
+	}
+	else
+	{
+		header.numLods            = 1;
+		header.lods[0].numIndices = numIndices;
+	}
+
+	fout.open(cacheFile, ios::out | ios::binary | ios::trunc);
+	if(fout.fail())
+		return false;
+
+	fout.write((const char*)&header, sizeof(header));
+	fout.write(padding, header.vertexOffset - sizeof(header));
+	fout.write((const char*)vertices, vertexBytes);
+	fout.write(padding, header.indexOffset - (header.vertexOffset + vertexBytes));
+
+	// Write the indices at the chosen width, a missing index list means every vertex is
+	// its own triangle corner
+	for(int i = 0; i < numIndices; i++)
+	{
+		unsigned long index = indices ? indices[i] : i;
+
+		if(header.indexSize == 2)
+		{
+			unsigned short shortIndex = (unsigned short)index;
+			fout.write((const char*)&shortIndex, sizeof(shortIndex));
+		}
+		else
+		{
+			unsigned int longIndex = (unsigned int)index;
+			fout.write((const char*)&longIndex, sizeof(longIndex));
+		}
+	}
+
+	bool success = !fout.fail();
+	fout.close();
+
+	// Never leave a half written cache behind
+	if(!success)
+		DeleteFileA(cacheFile);
+
+	return success;
+}
+
+/*
+*******************************************************************
+* METHOD: Release
+*******************************************************************
+* Unmaps the cache, the pointers returned by GetVertices() and
+* GetIndices() are no longer valid after this
+*/
+
+void ASMeshCache::Release()
+{
+	m_file.Release();
+	m_header = 0;
+}
+
+/*
+*******************************************************************
+* METHOD: Get Header
+*******************************************************************
+* @return const ASHeader* - the header of the open cache
+*/
+
+const ASMeshCache::ASHeader* ASMeshCache::GetHeader()
+{
+	return m_header;
+}
+
+/*
+*******************************************************************
+* METHOD: Get Vertices
+*******************************************************************
+* @return const void* - the vertex stream, ready for CreateBuffer
+*/
+
+const void* ASMeshCache::GetVertices()
+{
+	return m_file.GetData() + m_header->vertexOffset;
+}
+
+/*
+*******************************************************************
+* METHOD: Get Indices
+*******************************************************************
+* @return const void* - the index stream, ready for CreateBuffer
+*/
+
+const void* ASMeshCache::GetIndices()
+{
+	return m_file.GetData() + m_header->indexOffset;
+}
+
+/*
+*******************************************************************
+* METHOD: Get Index Format
+*******************************************************************
+* @return DXGI_FORMAT - the format to bind the index buffer with
+*/
+
+DXGI_FORMAT ASMeshCache::GetIndexFormat()
+{
+	if(m_header->indexSize == 2)
+		return DXGI_FORMAT_R16_UINT;
+
+	return DXGI_FORMAT_R32_UINT;
+}
+
+/*
+*******************************************************************
+* METHOD: Get Cache Path
+*******************************************************************
+* Builds the name of the cache for a source file, the cache sits
+* next to the source with .asmesh added on the end
+* (./models/cube.txt is cached in ./models/cube.txt.asmesh)
+*
+* @param const char* - the source file
+* @param char* - output buffer for the cache file name
+* @param int   - the size of the output buffer
+*/
+
+void ASMeshCache::GetCachePath(const char* sourceFile, char* cacheFile, int size)
+{
+	cacheFile[0] = 0;
+
+	if((int)(strlen(sourceFile) + strlen(".asmesh")) >= size)
+		return;
+
+	strcpy(cacheFile, sourceFile);
+	strcat(cacheFile, ".asmesh");
+}
+
+/*
+*******************************************************************
+* METHOD: Get Source Stamp
+*******************************************************************
+* Reads the size and last write time of a source file
+*
+* @param const char*         - the source file
+* @param unsigned long long& - output parameter for the size in bytes
+* @param unsigned long long& - output parameter for the write time
+*
+* @return bool - True if the file exists, else false
+*/
+
+bool ASMeshCache::GetSourceStamp(const char* sourceFile, unsigned long long& size, unsigned long long& time)
+{
+	WIN32_FILE_ATTRIBUTE_DATA data;
+
+	if(!GetFileAttributesExA(sourceFile, GetFileExInfoStandard, &data))
+		return false;
+
+	size = ((unsigned long long)data.nFileSizeHigh << 32) | data.nFileSizeLow;
+	time = ((unsigned long long)data.ftLastWriteTime.dwHighDateTime << 32) | data.ftLastWriteTime.dwLowDateTime;
+
+	return true;
+}
+
+/*
+*******************************************************************
+* METHOD: Calculate Bounds
+*******************************************************************
+* Finds the bounding box of the vertex positions and a bounding
+* sphere centred on the middle of that box
+*
+* @param const void*  - the vertex data
+* @param unsigned int - bytes per vertex
+* @param int          - the number of vertices
+* @param float*       - output for the minimum corner of the box (3 floats)
+* @param float*       - output for the maximum corner of the box (3 floats)
+* @param float*       - output for the centre of the sphere (3 floats)
+* @param float&       - output parameter for the radius of the sphere
+*/
+
+void ASMeshCache::CalculateBounds(const void* vertices, unsigned int stride, int numVertices,
+								  float* boundsMin, float* boundsMax, float* center, float& radius)
+{
+	const char* curr = (const char*)vertices;
+	int i, j;
+
+	for(j = 0; j < 3; j++)
+	{
+		boundsMin[j] = ((const float*)curr)[j];
+		boundsMax[j] = ((const float*)curr)[j];
+	}
+
+	// Grow the box to fit every position
+	for(i = 0; i < numVertices; i++, curr += stride)
+	{
+		const float* pos = (const float*)curr;
+		for(j = 0; j < 3; j++)
+		{
+			if(pos[j] < boundsMin[j]) boundsMin[j] = pos[j];
+			if(pos[j] > boundsMax[j]) boundsMax[j] = pos[j];
+		}
+	}
+
+	for(j = 0; j < 3; j++)
+		center[j] = (boundsMin[j] + boundsMax[j]) * 0.5f;
+
+	// The radius is the furthest any position lies from the centre
+	float radiusSq = 0.0f;
+	curr = (const char*)vertices;
+	for(i = 0; i < numVertices; i++, curr += stride)
+	{
+		const float* pos = (const float*)curr;
+		float dx = pos[0] - center[0];
+		float dy = pos[1] - center[1];
+		float dz = pos[2] - center[2];
+
+		float distSq = (dx * dx) + (dy * dy) + (dz * dz);
+		if(distSq > radiusSq)
+			radiusSq = distSq;
+	}
+
+	radius = sqrtf(radiusSq);
+}
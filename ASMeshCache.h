@@ -0,0 +1,113 @@
+/*
+******************************************************************
+* ASMeshCache.h
+*******************************************************************
+* Reads and writes .asmesh files, a binary cache of a mesh that
+* has already been imported from a text or .obj model.  The vertex
+* and index streams are stored exactly as the GPU wants them, so a
+* cached mesh is mapped into memory and handed straight to
+* CreateBuffer with no parsing at all.
+*
+* Each cache records the size and write time of the file it was
+* built from, if the source changes (or the format version moves
+* on) the cache is reported as stale and the caller falls back to
+* the text loader
+*******************************************************************
+*/
+
+#ifndef _ASMESHCACHE_H_
+#define _ASMESHCACHE_H_
+
+/*
+*******************************************************************
+* Includes:
+*******************************************************************
+*/
+
+#include <d3d11.h>
+#include <fstream>
+#include <math.h>
+#include <string.h>
+#include "ASFileMap.h"
+
+using namespace std;
+
+/*
+*******************************************************************
+* Class declaration
+*******************************************************************
+*/
+
+class ASMeshCache
+{
+public:
+	// Bump this whenever the layout of the file or the import pipeline changes, older
+	// caches are then rebuilt (2 - meshes are vertex cache optimised, 3 - LOD table)
+	static const unsigned int VERSION = 3;
+
+	// Streams are placed on 16 byte boundaries within the file
+	static const unsigned int STREAM_ALIGNMENT = 16;
+
+	// Largest vertex count that can still be addressed with 16 bit indices
+	static const int MAX_SHORT_INDEX_VERTICES = 65536;
+
+	// Most levels of detail a mesh can carry
+	static const int MAX_LODS = 4;
+
+	// One level of detail, a range of the index stream drawn with the shared vertex stream
+	struct ASLod
+	{
+		unsigned int startIndex;
+		unsigned int numIndices;
+		float        error;			// largest distance the simplified surface moved, in model units
+	};
+	// File header, this is followed by the vertex stream and then the index stream
+	struct ASHeader
+	{
+		char               magic[4];		// "ASMH"
+		unsigned int       version;
+		unsigned int       vertexStride;	// bytes per vertex
+		unsigned int       numVertices;
+		unsigned int       numIndices;
+		unsigned int       indexSize;		// 2 or 4 bytes per index
+		unsigned int       vertexOffset;	// byte offset of the vertex stream from the start of the file
+		unsigned int       indexOffset;		// byte offset of the index stream
+		float              boundsMin[3];	// axis aligned bounding box
+		float              boundsMax[3];
+		float              center[3];		// bounding sphere
+		float              radius;
+		unsigned int       numLods;			// LOD 0 is full detail
+		ASLod              lods[MAX_LODS];
+		unsigned long long sourceSize;		// size and write time of the source file, used to spot stale caches
+		unsigned long long sourceTime;
+	};
+
+public:
+	// Constructors and destructor
+	ASMeshCache();
+	ASMeshCache(const ASMeshCache&);
+	~ASMeshCache();
+
+	// Public methods
+	bool Open(const char*, const char*, unsigned int);
+	bool Write(const char*, const char*, const void*, unsigned int, int, const unsigned long*, int, const ASLod*, int);
+	void Release();
+
+	const ASHeader* GetHeader();
+	const void*     GetVertices();
+	const void*     GetIndices();
+	DXGI_FORMAT     GetIndexFormat();
+
+	static void GetCachePath(const char*, char*, int);
+	static void CalculateBounds(const void*, unsigned int, int, float*, float*, float*, float&);
+
+private:
+	// Private methods
+	bool GetSourceStamp(const char*, unsigned long long&, unsigned long long&);
+
+	// Private member variables
+	ASFileMap       m_file;
+	const ASHeader* m_header;
+};
+
+#endif
@@ -0,0 +1,486 @@
+/*
+******************************************************************
+* ASMeshOptimizer.cpp
+*******************************************************************
+* Implements all methods from ASMeshOptimizer.h
+*******************************************************************
+*/
+
+#include "ASMeshOptimizer.h"
+
+/*
+*******************************************************************
+* Forsyth scoring constants, these are the values from the
+* original paper ("Linear-Speed Vertex Cache Optimisation")
+*******************************************************************
+*/
+
+static const float CACHE_DECAY_POWER   = 1.5f;
+static const float LAST_TRI_SCORE      = 0.75f;
+static const float VALENCE_BOOST_SCALE = 2.0f;
+static const float VALENCE_BOOST_POWER = 0.5f;
+
+/*
+*******************************************************************
+* Constructor
+*******************************************************************
+*/
+
+ASMeshOptimizer::ASMeshOptimizer()
+{}
+
+/*
+*******************************************************************
+* Empty Constructor
+*******************************************************************
+*/
+
+ASMeshOptimizer::ASMeshOptimizer(const ASMeshOptimizer&)
+{}
+
+/*
+*******************************************************************
+* Destructor
+*******************************************************************
+*/
+
+ASMeshOptimizer::~ASMeshOptimizer()
+{}
+
+/*
+*******************************************************************
+* METHOD: Optimize Vertex Cache
+*******************************************************************
+* Reorders the triangles of a mesh for the post transform cache.
+* A simulated LRU cache is kept while triangles are emitted, every
+* vertex is scored by how recently it was used and how few of its
+* triangles are left, and the next triangle emitted is always the
+* highest scoring one touching the cache.  When no triangle touches
+* the cache the next unemitted triangle in the list is taken
+*
+* @param unsigned long* - the index list, rewritten in place
+* @param int            - the number of indices
+* @param int            - the number of vertices the indices refer to
+*/
+
+void ASMeshOptimizer::OptimizeVertexCache(unsigned long* indices, int numIndices, int numVertices)
+{
+	int numTris = numIndices / 3;
+	int i, j, k;
+
+	if(numTris == 0 || numVertices == 0)
+		return;
+
+	// Count how many triangles use each vertex
+	ASVertexState empty = { 0.0f, -1, 0, 0 };
+	m_vertices.assign(numVertices, empty);
+	for(i = 0; i < numTris * 3; i++)
+		m_vertices[indices[i]].numActive++;
+
+	// Give each vertex its own block of the triangle list, numActive is reset
+	// and used as the fill cursor
+	int offset = 0;
+	for(i = 0; i < numVertices; i++)
+	{
+		m_vertices[i].firstTri = offset;
+		offset += m_vertices[i].numActive;
+		m_vertices[i].numActive = 0;
+	}
+
+	m_vertexTris.resize(offset);
+	for(i = 0; i < numTris; i++)
+	{
+		for(j = 0; j < 3; j++)
+		{
+			ASVertexState& vert = m_vertices[indices[(i * 3) + j]];
+			m_vertexTris[vert.firstTri + vert.numActive] = i;
+			vert.numActive++;
+		}
+	}
+
+	// Score every vertex and triangle, remembering the best triangle to start from
+	for(i = 0; i < numVertices; i++)
+		m_vertices[i].score = CalculateVertexScore(m_vertices[i]);
+
+	int   bestTri   = -1;
+	float bestScore = -1.0f;
+
+	m_triScores.resize(numTris);
+	m_triEmitted.assign(numTris, false);
+	for(i = 0; i < numTris; i++)
+	{
+		m_triScores[i] = m_vertices[indices[i * 3]].score +
+						 m_vertices[indices[(i * 3) + 1]].score +
+						 m_vertices[indices[(i * 3) + 2]].score;
+
+		if(m_triScores[i] > bestScore)
+		{
+			bestScore = m_triScores[i];
+			bestTri   = i;
+		}
+	}
+
+	vector<unsigned long> output(numTris * 3);
+	int cache[FORSYTH_CACHE_SIZE + 3];
+	int newCache[FORSYTH_CACHE_SIZE + 3];
+	int cacheSize = 0;
+	int nextTri   = 0;	// where to look when the cache has no triangles left
+
+	for(int emitted = 0; emitted < numTris; emitted++)
+	{
+		// Nothing in the cache is usable, take the next triangle that has not been drawn
+		if(bestTri < 0)
+		{
+			while(m_triEmitted[nextTri])
+				nextTri++;
+			bestTri = nextTri;
+		}
+
+		// Emit the triangle and remove it from each of its vertices' lists
+		int triVerts[3];
+		for(j = 0; j < 3; j++)
+		{
+			triVerts[j] = indices[(bestTri * 3) + j];
+			output[(emitted * 3) + j] = triVerts[j];
+
+			ASVertexState& vert = m_vertices[triVerts[j]];
+			int* tris = &m_vertexTris[vert.firstTri];
+			for(k = 0; k < vert.numActive; k++)
+			{
+				if(tris[k] == bestTri)
+				{
+					tris[k] = tris[vert.numActive - 1];
+					break;
+				}
+			}
+			vert.numActive--;
+		}
+		m_triEmitted[bestTri] = true;
+
+		// The triangle's vertices move to the front of the cache, everything else moves back
+		int newSize = 0;
+		for(j = 0; j < 3; j++)
+			newCache[newSize++] = triVerts[j];
+		for(j = 0; j < cacheSize; j++)
+		{
+			if(cache[j] != triVerts[0] && cache[j] != triVerts[1] && cache[j] != triVerts[2])
+				newCache[newSize++] = cache[j];
+		}
+
+		// Rescore every vertex that moved, those pushed off the end leave the cache
+		for(j = 0; j < newSize; j++)
+		{
+			ASVertexState& vert = m_vertices[newCache[j]];
+			vert.cachePos = (j < FORSYTH_CACHE_SIZE) ? j : -1;
+			vert.score    = CalculateVertexScore(vert);
+		}
+
+		// Rescore the triangles around those vertices and pick the best one still in the cache
+		bestTri   = -1;
+		bestScore = -1.0f;
+		for(j = 0; j < newSize; j++)
+		{
+			ASVertexState& vert = m_vertices[newCache[j]];
+			int* tris = &m_vertexTris[vert.firstTri];
+			for(k = 0; k < vert.numActive; k++)
+			{
+				int tri = tris[k];
+				m_triScores[tri] = m_vertices[indices[tri * 3]].score +
+								   m_vertices[indices[(tri * 3) + 1]].score +
+								   m_vertices[indices[(tri * 3) + 2]].score;
+
+				if(j < FORSYTH_CACHE_SIZE && m_triScores[tri] > bestScore)
+				{
+					bestScore = m_triScores[tri];
+					bestTri   = tri;
+				}
+			}
+		}
+
+		cacheSize = (newSize < FORSYTH_CACHE_SIZE) ? newSize : FORSYTH_CACHE_SIZE;
+		memcpy(cache, newCache, cacheSize * sizeof(int));
+	}
+
+	memcpy(indices, &output[0], numTris * 3 * sizeof(unsigned long));
+	Release();
+}
+
+/*
+*******************************************************************
+* METHOD: Optimize Overdraw
+*******************************************************************
+* Splits a cache optimised index list into clusters wherever a
+* triangle misses the cache on all three vertices (so moving the
+* clusters around costs almost nothing in cache efficiency), then
+* sorts the clusters so those facing furthest out from the centre
+* of the mesh are drawn first.  Outward facing clusters tend to be
+* in front, so the ones drawn after them fail the depth test
+* instead of being shaded and then overwritten
+*
+* The position must be the first three floats of each vertex and
+* front faces are wound clockwise
+*
+* @param unsigned long* - the index list, rewritten in place
+* @param int            - the number of indices
+* @param const void*    - the vertex data
+* @param unsigned int   - bytes per vertex
+* @param int            - the number of vertices
+*/
+
+void ASMeshOptimizer::OptimizeOverdraw(unsigned long* indices, int numIndices, const void* vertices,
+									   unsigned int stride, int numVertices)
+{
+	int numTris = numIndices / 3;
+	int i, j;
+
+	if(numTris == 0 || numVertices == 0)
+		return;
+
+	// Find the cluster boundaries by replaying the index list through a FIFO cache
+	vector<ASCluster> clusters;
+	vector<unsigned int> timestamps(numVertices, 0);
+	unsigned int time = FIFO_CACHE_SIZE + 1;
+
+	for(i = 0; i < numTris; i++)
+	{
+		int misses = 0;
+		for(j = 0; j < 3; j++)
+		{
+			unsigned long v = indices[(i * 3) + j];
+			if(time - timestamps[v] > (unsigned int)FIFO_CACHE_SIZE)
+			{
+				timestamps[v] = time++;
+				misses++;
+			}
+		}
+
+		if(i == 0 || misses == 3)
+		{
+			ASCluster cluster = { i * 3, 0, 0.0f };
+			clusters.push_back(cluster);
+		}
+		clusters.back().count += 3;
+	}
+
+	// Work out the area weighted centroid and normal of each cluster, and of the whole mesh
+	const char* base = (const char*)vertices;
+	vector<float> clusterData(clusters.size() * 6, 0.0f);
+	float meshCenter[3] = { 0.0f, 0.0f, 0.0f };
+	float meshArea = 0.0f;
+
+	for(unsigned int c = 0; c < clusters.size(); c++)
+	{
+		float* centroid = &clusterData[c * 6];
+		float* normal   = &clusterData[(c * 6) + 3];
+		float  area     = 0.0f;
+
+		for(i = clusters[c].start; i < clusters[c].start + clusters[c].count; i += 3)
+		{
+			const float* a = (const float*)(base + (indices[i] * stride));
+			const float* b = (const float*)(base + (indices[i + 1] * stride));
+			const float* d = (const float*)(base + (indices[i + 2] * stride));
+
+			float e1[3] = { b[0] - a[0], b[1] - a[1], b[2] - a[2] };
+			float e2[3] = { d[0] - a[0], d[1] - a[1], d[2] - a[2] };
+
+			// The cross product is twice the area of the triangle, so summing it weights
+			// the normal by area for free
+			float n[3] = { (e1[1] * e2[2]) - (e1[2] * e2[1]),
+						   (e1[2] * e2[0]) - (e1[0] * e2[2]),
+						   (e1[0] * e2[1]) - (e1[1] * e2[0]) };
+			float triArea = sqrtf((n[0] * n[0]) + (n[1] * n[1]) + (n[2] * n[2]));
+
+			for(j = 0; j < 3; j++)
+			{
+				centroid[j] += ((a[j] + b[j] + d[j]) / 3.0f) * triArea;
+				normal[j]   += n[j];
+			}
+			area += triArea;
+		}
+
+		for(j = 0; j < 3; j++)
+			meshCenter[j] += centroid[j];
+		meshArea += area;
+
+		if(area > 0.0f)
+		{
+			for(j = 0; j < 3; j++)
+				centroid[j] /= area;
+		}
+	}
+
+	if(meshArea > 0.0f)
+	{
+		for(j = 0; j < 3; j++)
+			meshCenter[j] /= meshArea;
+	}
+
+	// The sort key is how far the cluster sits out along its own normal
+	for(unsigned int c = 0; c < clusters.size(); c++)
+	{
+		float* centroid = &clusterData[c * 6];
+		float* normal   = &clusterData[(c * 6) + 3];
+		float  length   = sqrtf((normal[0] * normal[0]) + (normal[1] * normal[1]) + (normal[2] * normal[2]));
+
+		if(length > 0.0f)
+		{
+			clusters[c].sortKey = (((centroid[0] - meshCenter[0]) * normal[0]) +
+								   ((centroid[1] - meshCenter[1]) * normal[1]) +
+								   ((centroid[2] - meshCenter[2]) * normal[2])) / length;
+		}
+	}
+
+	// Sort the clusters and write them back out, the sort is stable so the result is the
+	// same on every import
+	stable_sort(clusters.begin(), clusters.end(), ASClusterCompare());
+
+	vector<unsigned long> output(indices, indices + (numTris * 3));
+	int offset = 0;
+	for(unsigned int c = 0; c < clusters.size(); c++)
+	{
+		memcpy(indices + offset, &output[clusters[c].start], clusters[c].count * sizeof(unsigned long));
+		offset += clusters[c].count;
+	}
+}
+
+/*
+*******************************************************************
+* METHOD: Optimize Vertex Fetch
+*******************************************************************
+* Renumbers the vertices in the order the index list first uses
+* them and moves the vertex data to match, so the GPU reads the
+* vertex buffer in one forward sweep.  Vertices that no triangle
+* uses are dropped
+*
+* @param void*          - the vertex data, rewritten in place
+* @param unsigned int   - bytes per vertex
+* @param int            - the number of vertices
+* @param unsigned long* - the index list, rewritten in place
+* @param int            - the number of indices
+*
+* @return int - the number of vertices left
+*/
+
+int ASMeshOptimizer::OptimizeVertexFetch(void* vertices, unsigned int stride, int numVertices,
+										 unsigned long* indices, int numIndices)
+{
+	vector<int> remap(numVertices, -1);
+	int numUsed = 0;
+	int i;
+
+	// Give each vertex a new number the first time it is used
+	for(i = 0; i < numIndices; i++)
+	{
+		if(remap[indices[i]] < 0)
+			remap[indices[i]] = numUsed++;
+
+		indices[i] = remap[indices[i]];
+	}
+
+	if(numUsed == 0)
+		return 0;
+
+	// Move the vertex data into the new order
+	char* data = (char*)vertices;
+	vector<char> reordered(numUsed * stride);
+	for(i = 0; i < numVertices; i++)
+	{
+		if(remap[i] >= 0)
+			memcpy(&reordered[remap[i] * stride], data + (i * stride), stride);
+	}
+	memcpy(data, &reordered[0], numUsed * stride);
+
+	return numUsed;
+}
+
+/*
+*******************************************************************
+* METHOD: Analyze Vertex Cache
+*******************************************************************
+* Replays an index list through a FIFO cache and measures it:
+*
+* ACMR - average cache miss ratio, vertices transformed per triangle
+*        (3.0 is no reuse at all, ~0.5 is the best a closed mesh can do)
+* ATVR - average transform to vertex ratio, vertices transformed per
+*        vertex in the mesh (1.0 is perfect)
+*
+* @param const unsigned long* - the index list
+* @param int                  - the number of indices
+* @param int                  - the number of vertices
+* @param int                  - the number of entries in the cache
+* @param float&               - output parameter for the ACMR
+* @param float&               - output parameter for the ATVR
+*/
+
+void ASMeshOptimizer::AnalyzeVertexCache(const unsigned long* indices, int numIndices, int numVertices,
+										 int cacheSize, float& acmr, float& atvr)
+{
+	vector<unsigned int> timestamps(numVertices, 0);
+	unsigned int time   = cacheSize + 1;
+	unsigned int misses = 0;
+
+	for(int i = 0; i < numIndices; i++)
+	{
+		if(time - timestamps[indices[i]] > (unsigned int)cacheSize)
+		{
+			timestamps[indices[i]] = time++;
+			misses++;
+		}
+	}
+
+	acmr = (numIndices >= 3) ? (float)misses / (float)(numIndices / 3) : 0.0f;
+	atvr = (numVertices > 0) ? (float)misses / (float)numVertices : 0.0f;
+}
+
+/*
+*******************************************************************
+* METHOD: Calculate Vertex Score
+*******************************************************************
+* Scores a vertex by its position in the simulated cache and by the
+* number of triangles still using it, vertices with few triangles
+* left are boosted so that they get finished off and do not leave
+* lone triangles behind
+*
+* @param const ASVertexState& - the vertex to score
+*
+* @return float - the score, higher is better
+*/
+
+float ASMeshOptimizer::CalculateVertexScore(const ASVertexState& vert)
+{
+	// A vertex with no triangles left will never be used again
+	if(vert.numActive == 0)
+		return -1.0f;
+
+	float score = 0.0f;
+	if(vert.cachePos >= 0)
+	{
+		// The three vertices of the last triangle get a fixed score, so that the next
+		// triangle does not simply reuse the same edge
+		if(vert.cachePos < 3)
+			score = LAST_TRI_SCORE;
+		else
+		{
+			float scale = 1.0f / (FORSYTH_CACHE_SIZE - 3);
+			score = powf(1.0f - ((vert.cachePos - 3) * scale), CACHE_DECAY_POWER);
+		}
+	}
+
+	score += VALENCE_BOOST_SCALE * powf((float)vert.numActive, -VALENCE_BOOST_POWER);
+	return score;
+}
+
+/*
+*******************************************************************
+* METHOD: Release
+*******************************************************************
+* Frees the working memory used by OptimizeVertexCache()
+*/
+
+void ASMeshOptimizer::Release()
+{
+	vector<ASVertexState>().swap(m_vertices);
+	vector<int>().swap(m_vertexTris);
+	vector<float>().swap(m_triScores);
+	vector<bool>().swap(m_triEmitted);
+}
@@ -0,0 +1,104 @@
+/*
+******************************************************************
+* ASMeshOptimizer.h
+*******************************************************************
+* Reorders the triangles and vertices of an indexed mesh so that it
+* renders faster, this runs once when a model is imported:
+*
+* + OptimizeVertexCache - Tom Forsyth's linear speed algorithm,
+*   triangles are emitted greedily so vertices are reused while
+*   they are still in the GPU's post transform cache
+* + OptimizeOverdraw - splits the cache optimised order into
+*   clusters and draws the outward facing clusters first, so more
+*   pixels are rejected by the depth test
+* + OptimizeVertexFetch - renumbers vertices in the order they are
+*   first used so the vertex buffer is read front to back
+*
+* Nothing here touches the GPU, a mesh is just a vertex array with
+* a stride and a list of 32 bit indices
+*******************************************************************
+*/
+
+#ifndef _ASMESHOPTIMIZER_H_
+#define _ASMESHOPTIMIZER_H_
+
+/*
+*******************************************************************
+* Includes:
+*******************************************************************
+*/
+
+#include <vector>
+#include <algorithm>
+#include <math.h>
+#include <string.h>
+
+using namespace std;
+
+/*
+*******************************************************************
+* Class declaration
+*******************************************************************
+*/
+
+class ASMeshOptimizer
+{
+public:
+	// Size of the LRU cache the Forsyth scores are tuned for
+	static const int FORSYTH_CACHE_SIZE = 32;
+
+	// Size of the FIFO cache used to measure a mesh and to find cluster boundaries,
+	// this is a conservative match for the post transform cache of current GPUs
+	static const int FIFO_CACHE_SIZE = 16;
+
+private:
+	// Per vertex state used while the Forsyth algorithm runs
+	struct ASVertexState
+	{
+		float score;
+		int   cachePos;		// position in the simulated cache, -1 if not in it
+		int   numActive;	// number of triangles using this vertex that are yet to be emitted
+		int   firstTri;		// offset of this vertex's triangle list in m_vertexTris
+	};
+	// A run of triangles that is drawn as one unit when ordering for overdraw
+	struct ASCluster
+	{
+		int   start;		// first index of the cluster
+		int   count;		// number of indices in the cluster
+		float sortKey;		// how far the cluster faces away from the centre of the mesh
+	};
+	// Orders clusters so the outward facing ones are drawn first
+	struct ASClusterCompare
+	{
+		bool operator()(const ASCluster& a, const ASCluster& b) const
+		{
+			return a.sortKey > b.sortKey;
+		}
+	};
+
+public:
+	// Constructors and destructor
+	ASMeshOptimizer();
+	ASMeshOptimizer(const ASMeshOptimizer&);
+	~ASMeshOptimizer();
+
+	// Public methods
+	void OptimizeVertexCache(unsigned long*, int, int);
+	void OptimizeOverdraw(unsigned long*, int, const void*, unsigned int, int);
+	int  OptimizeVertexFetch(void*, unsigned int, int, unsigned long*, int);
+
+	static void AnalyzeVertexCache(const unsigned long*, int, int, int, float&, float&);
+
+private:
+	// Private methods
+	float CalculateVertexScore(const ASVertexState&);
+	void  Release();
+
+	// Private member variables
+	vector<ASVertexState> m_vertices;
+	vector<int>           m_vertexTris;		// triangles using each vertex, indexed by ASVertexState::firstTri
+	vector<float>         m_triScores;
+	vector<bool>          m_triEmitted;
+};
+
+#endif
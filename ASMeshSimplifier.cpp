@@ -0,0 +1,479 @@
+/*
+******************************************************************
+* ASMeshSimplifier.cpp
+*******************************************************************
+* Implements all methods from ASMeshSimplifier.h
+*******************************************************************
+*/
+
+#include "ASMeshSimplifier.h"
+
+/*
+*******************************************************************
+* Constructor
+*******************************************************************
+*/
+
+ASMeshSimplifier::ASMeshSimplifier()
+{
+	m_numVertices = 0;
+}
+
+/*
+*******************************************************************
+* Empty Constructor
+*******************************************************************
+*/
+
+ASMeshSimplifier::ASMeshSimplifier(const ASMeshSimplifier&)
+{}
+
+/*
+*******************************************************************
+* Destructor
+*******************************************************************
+*/
+
+ASMeshSimplifier::~ASMeshSimplifier()
+{}
+
+/*
+*******************************************************************
+* METHOD: Init
+*******************************************************************
+* Takes a copy of the mesh and prepares it for simplification, the
+* locked vertices and the quadrics are worked out once here so that
+* Simplify() can then be called for each level of detail
+*
+* The position must be the first three floats of each vertex
+*
+* @param const void*          - the vertex data
+* @param unsigned int         - bytes per vertex
+* @param int                  - the number of vertices
+* @param const unsigned long* - the full detail index list
+* @param int                  - the number of indices
+*
+* @return bool - True if the mesh can be simplified, else false
+*/
+
+bool ASMeshSimplifier::Init(const void* vertices, unsigned int stride, int numVertices,
+							const unsigned long* indices, int numIndices)
+{
+	if(!vertices || !indices || numVertices <= 0 || numIndices < 3)
+		return false;
+
+	m_numVertices = numVertices;
+
+	// Pull the positions out into a tightly packed array
+	const char* curr = (const char*)vertices;
+	m_positions.resize(numVertices * 3);
+	for(int i = 0; i < numVertices; i++, curr += stride)
+	{
+		m_positions[(i * 3)]     = ((const float*)curr)[0];
+		m_positions[(i * 3) + 1] = ((const float*)curr)[1];
+		m_positions[(i * 3) + 2] = ((const float*)curr)[2];
+	}
+
+	m_indices.assign(indices, indices + ((numIndices / 3) * 3));
+
+	FindLockedVertices();
+	BuildQuadrics();
+
+	return true;
+}
+
+/*
+*******************************************************************
+* METHOD: Simplify
+*******************************************************************
+* Collapses edges of the full detail mesh until the index count
+* reaches the target, or until the next collapse would cost more
+* than the maximum error.  The collapses are made in passes: every
+* pass scores each edge, sorts them cheapest first and applies as
+* many as it can without two collapses touching the same triangles
+*
+* @param int            - the target number of indices
+* @param float          - the largest error allowed, in model units
+* @param unsigned long* - output buffer for the simplified indices, must
+*                         hold as many indices as the full detail mesh
+* @param float&         - output parameter for the largest error made
+*
+* @return int - the number of indices written
+*/
+
+int ASMeshSimplifier::Simplify(int targetIndices, float maxError, unsigned long* output, float& resultError)
+{
+	vector<unsigned long> current(m_indices);
+	vector<ASQuadric>     quadrics(m_quadrics);
+	vector<ASCollapse>    collapses;
+	vector<unsigned long> remap(m_numVertices);
+	vector<bool>          touched(m_numVertices);
+	unsigned int i;
+	int j, k;
+
+	resultError = 0.0f;
+
+	while((int)current.size() > targetIndices)
+	{
+		int numTris = current.size() / 3;
+		BuildAdjacency(current);
+
+		// Score every edge in both directions, skipping collapses that would move a locked
+		// vertex or land on a seam vertex
+		collapses.clear();
+		for(i = 0; i < current.size(); i += 3)
+		{
+			for(j = 0; j < 3; j++)
+			{
+				unsigned long a = current[i + j];
+				unsigned long b = current[i + ((j + 1) % 3)];
+
+				for(k = 0; k < 2; k++)
+				{
+					unsigned long from = k ? b : a;
+					unsigned long to   = k ? a : b;
+
+					if(m_locked[from] || m_shared[to])
+						continue;
+
+					ASQuadric merged = quadrics[from];
+					AddQuadric(merged, quadrics[to]);
+
+					ASCollapse collapse = { from, to, CalculateError(merged, to) };
+					collapses.push_back(collapse);
+				}
+			}
+		}
+
+		sort(collapses.begin(), collapses.end(), ASCollapseCompare());
+
+		// Each collapse removes about two triangles, so stop once enough have been made
+		int needed = ((numTris - (targetIndices / 3)) + 1) / 2;
+		int made   = 0;
+
+		for(j = 0; j < m_numVertices; j++)
+		{
+			remap[j]   = j;
+			touched[j] = false;
+		}
+
+		for(i = 0; i < collapses.size() && made < needed; i++)
+		{
+			const ASCollapse& collapse = collapses[i];
+
+			if(collapse.error > maxError)
+				break;
+			if(touched[collapse.from] || touched[collapse.to])
+				continue;
+			if(FlipsTriangle(collapse.from, collapse.to, current))
+				continue;
+
+			// Move the vertex and merge its quadric into the one it moved onto
+			remap[collapse.from] = collapse.to;
+			AddQuadric(quadrics[collapse.to], quadrics[collapse.from]);
+
+			// Nothing around this collapse may change again until the next pass
+			for(j = m_adjacencyStart[collapse.from]; j < m_adjacencyStart[collapse.from + 1]; j++)
+			{
+				int tri = m_adjacency[j];
+				touched[current[tri * 3]]       = true;
+				touched[current[(tri * 3) + 1]] = true;
+				touched[current[(tri * 3) + 2]] = true;
+			}
+			touched[collapse.to] = true;
+
+			if(collapse.error > resultError)
+				resultError = collapse.error;
+			made++;
+		}
+
+		if(made == 0)
+			break;
+
+		// Rewrite the index list, dropping the triangles that collapsed to a line
+		unsigned int numKept = 0;
+		for(i = 0; i < current.size(); i += 3)
+		{
+			unsigned long a = remap[current[i]];
+			unsigned long b = remap[current[i + 1]];
+			unsigned long c = remap[current[i + 2]];
+
+			if(a == b || b == c || a == c)
+				continue;
+
+			current[numKept++] = a;
+			current[numKept++] = b;
+			current[numKept++] = c;
+		}
+		current.resize(numKept);
+	}
+
+	if(!current.empty())
+		memcpy(output, &current[0], current.size() * sizeof(unsigned long));
+
+	return current.size();
+}
+
+/*
+*******************************************************************
+* METHOD: Release
+*******************************************************************
+* Frees the copy of the mesh and the working memory
+*/
+
+void ASMeshSimplifier::Release()
+{
+	vector<float>().swap(m_positions);
+	vector<unsigned long>().swap(m_indices);
+	vector<ASQuadric>().swap(m_quadrics);
+	vector<bool>().swap(m_locked);
+	vector<bool>().swap(m_shared);
+	vector<int>().swap(m_adjacencyStart);
+	vector<int>().swap(m_adjacency);
+
+	m_numVertices = 0;
+}
+
+/*
+*******************************************************************
+* METHOD: Find Locked Vertices
+*******************************************************************
+* Vertices which share a position are seams (the texture coordinate
+* or normal is different on each side), edges used by only one
+* triangle are open borders and edges used by more than two are not
+* manifold.  Edges are matched by position rather than vertex number
+* so that a seam is not mistaken for a border.  Seam, border and non
+* manifold vertices are locked so they never move
+*/
+
+void ASMeshSimplifier::FindLockedVertices()
+{
+	vector<unsigned long> order(m_numVertices);
+	vector<unsigned long> positionId(m_numVertices);
+	unsigned int i, j;
+
+	m_locked.assign(m_numVertices, false);
+	m_shared.assign(m_numVertices, false);
+
+	// Sort the vertices by position and give every matching position the same id
+	for(i = 0; i < (unsigned int)m_numVertices; i++)
+		order[i] = i;
+
+	ASPositionCompare compare;
+	compare.positions = &m_positions[0];
+	sort(order.begin(), order.end(), compare);
+
+	for(i = 0; i < order.size(); i = j)
+	{
+		for(j = i + 1; j < order.size() && !compare(order[i], order[j]); j++)
+		{
+			m_shared[order[i]] = true;
+			m_shared[order[j]] = true;
+		}
+
+		for(unsigned int k = i; k < j; k++)
+			positionId[order[k]] = order[i];
+	}
+
+	// List every edge by position id, smallest id first, then count how many
+	// triangles use each one
+	vector<unsigned long long> edges;
+	edges.reserve(m_indices.size());
+	for(i = 0; i < m_indices.size(); i += 3)
+	{
+		for(j = 0; j < 3; j++)
+		{
+			unsigned long long a = positionId[m_indices[i + j]];
+			unsigned long long b = positionId[m_indices[i + ((j + 1) % 3)]];
+			edges.push_back(a < b ? ((a << 32) | b) : ((b << 32) | a));
+		}
+	}
+	sort(edges.begin(), edges.end());
+
+	vector<bool> lockedPosition(m_numVertices, false);
+	for(i = 0; i < edges.size(); i = j)
+	{
+		for(j = i + 1; j < edges.size() && edges[j] == edges[i]; j++);
+
+		if(j - i != 2)
+		{
+			lockedPosition[(unsigned long)(edges[i] >> 32)]        = true;
+			lockedPosition[(unsigned long)(edges[i] & 0xFFFFFFFF)] = true;
+		}
+	}
+
+	for(i = 0; i < (unsigned int)m_numVertices; i++)
+		m_locked[i] = m_shared[i] || lockedPosition[positionId[i]];
+}
+
+/*
+*******************************************************************
+* METHOD: Build Quadrics
+*******************************************************************
+* Gives every vertex the sum of the plane quadrics of the triangles
+* around it, each weighted by the area of its triangle
+*/
+
+void ASMeshSimplifier::BuildQuadrics()
+{
+	ASQuadric empty = ASQuadric();
+	m_quadrics.assign(m_numVertices, empty);
+
+	for(unsigned int i = 0; i < m_indices.size(); i += 3)
+	{
+		const float* p0 = &m_positions[m_indices[i] * 3];
+		const float* p1 = &m_positions[m_indices[i + 1] * 3];
+		const float* p2 = &m_positions[m_indices[i + 2] * 3];
+
+		double e1[3] = { p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2] };
+		double e2[3] = { p2[0] - p0[0], p2[1] - p0[1], p2[2] - p0[2] };
+		double n[3]  = { (e1[1] * e2[2]) - (e1[2] * e2[1]),
+						 (e1[2] * e2[0]) - (e1[0] * e2[2]),
+						 (e1[0] * e2[1]) - (e1[1] * e2[0]) };
+
+		double length = sqrt((n[0] * n[0]) + (n[1] * n[1]) + (n[2] * n[2]));
+		if(length <= 0.0)
+			continue;
+
+		n[0] /= length;
+		n[1] /= length;
+		n[2] /= length;
+
+		double d    = -((n[0] * p0[0]) + (n[1] * p0[1]) + (n[2] * p0[2]));
+		double area = length * 0.5;
+
+		ASQuadric plane;
+		plane.a2 = n[0] * n[0] * area; plane.ab = n[0] * n[1] * area; plane.ac = n[0] * n[2] * area; plane.ad = n[0] * d * area;
+		plane.b2 = n[1] * n[1] * area; plane.bc = n[1] * n[2] * area; plane.bd = n[1] * d * area;
+		plane.c2 = n[2] * n[2] * area; plane.cd = n[2] * d * area;
+		plane.d2 = d * d * area;
+		plane.weight = area;
+
+		AddQuadric(m_quadrics[m_indices[i]], plane);
+		AddQuadric(m_quadrics[m_indices[i + 1]], plane);
+		AddQuadric(m_quadrics[m_indices[i + 2]], plane);
+	}
+}
+
+/*
+*******************************************************************
+* METHOD: Build Adjacency
+*******************************************************************
+* Lists the triangles around every vertex of the current index list
+*
+* @param const vector<unsigned long>& - the current index list
+*/
+
+void ASMeshSimplifier::BuildAdjacency(const vector<unsigned long>& indices)
+{
+	unsigned int i;
+
+	m_adjacencyStart.assign(m_numVertices + 1, 0);
+	for(i = 0; i < indices.size(); i++)
+		m_adjacencyStart[indices[i] + 1]++;
+	for(i = 1; i < m_adjacencyStart.size(); i++)
+		m_adjacencyStart[i] += m_adjacencyStart[i - 1];
+
+	vector<int> fill(m_adjacencyStart.begin(), m_adjacencyStart.end() - 1);
+	m_adjacency.resize(indices.size());
+	for(i = 0; i < indices.size(); i++)
+		m_adjacency[fill[indices[i]]++] = i / 3;
+}
+
+/*
+*******************************************************************
+* METHOD: Flips Triangle
+*******************************************************************
+* Checks whether moving a vertex would turn any of its triangles
+* over (or fold it far enough to be nearly edge on), the triangles
+* that contain both vertices are skipped as they disappear
+*
+* @param unsigned long                - the vertex being moved
+* @param unsigned long                - the vertex it moves onto
+* @param const vector<unsigned long>& - the current index list
+*
+* @return bool - True if the collapse would flip a triangle
+*/
+
+bool ASMeshSimplifier::FlipsTriangle(unsigned long from, unsigned long to, const vector<unsigned long>& indices)
+{
+	const float* target = &m_positions[to * 3];
+
+	for(int i = m_adjacencyStart[from]; i < m_adjacencyStart[from + 1]; i++)
+	{
+		const unsigned long* tri = &indices[m_adjacency[i] * 3];
+		if(tri[0] == to || tri[1] == to || tri[2] == to)
+			continue;
+
+		// Rotate the triangle so that the moving vertex is first
+		int first = (tri[0] == from) ? 0 : ((tri[1] == from) ? 1 : 2);
+		const float* p0 = &m_positions[from * 3];
+		const float* p1 = &m_positions[tri[(first + 1) % 3] * 3];
+		const float* p2 = &m_positions[tri[(first + 2) % 3] * 3];
+
+		float e2[3] = { p2[0] - p1[0], p2[1] - p1[1], p2[2] - p1[2] };
+		float a[3]  = { p0[0] - p1[0], p0[1] - p1[1], p0[2] - p1[2] };
+		float b[3]  = { target[0] - p1[0], target[1] - p1[1], target[2] - p1[2] };
+
+		// Normals before and after the move, both taken around the fixed edge p1-p2
+		float before[3] = { (e2[1] * a[2]) - (e2[2] * a[1]), (e2[2] * a[0]) - (e2[0] * a[2]), (e2[0] * a[1]) - (e2[1] * a[0]) };
+		float after[3]  = { (e2[1] * b[2]) - (e2[2] * b[1]), (e2[2] * b[0]) - (e2[0] * b[2]), (e2[0] * b[1]) - (e2[1] * b[0]) };
+
+		float dot       = (before[0] * after[0]) + (before[1] * after[1]) + (before[2] * after[2]);
+		float lenBefore = sqrtf((before[0] * before[0]) + (before[1] * before[1]) + (before[2] * before[2]));
+		float lenAfter  = sqrtf((after[0] * after[0]) + (after[1] * after[1]) + (after[2] * after[2]));
+
+		// Anything that turns by more than about 75 degrees is treated as a flip
+		if(dot < 0.25f * lenBefore * lenAfter)
+			return true;
+	}
+
+	return false;
+}
+
+/*
+*******************************************************************
+* METHOD: Calculate Error
+*******************************************************************
+* Evaluates a quadric at a vertex position
+*
+* @param const ASQuadric& - the quadric
+* @param unsigned long    - the vertex to evaluate it at
+*
+* @return float - the root mean squared distance of the position from
+*                 the planes in the quadric, in model units
+*/
+
+float ASMeshSimplifier::CalculateError(const ASQuadric& q, unsigned long vertex)
+{
+	const float* p = &m_positions[vertex * 3];
+	double x = p[0];
+	double y = p[1];
+	double z = p[2];
+
+	double error = (q.a2 * x * x) + (2.0 * q.ab * x * y) + (2.0 * q.ac * x * z) + (2.0 * q.ad * x) +
+				   (q.b2 * y * y) + (2.0 * q.bc * y * z) + (2.0 * q.bd * y) +
+				   (q.c2 * z * z) + (2.0 * q.cd * z) + q.d2;
+
+	if(error <= 0.0 || q.weight <= 0.0)
+		return 0.0f;
+
+	return (float)sqrt(error / q.weight);
+}
+
+/*
+*******************************************************************
+* METHOD: Add Quadric
+*******************************************************************
+* @param ASQuadric&       - the quadric to add to
+* @param const ASQuadric& - the quadric to add
+*/
+
+void ASMeshSimplifier::AddQuadric(ASQuadric& q, const ASQuadric& other)
+{
+	q.a2 += other.a2; q.ab += other.ab; q.ac += other.ac; q.ad += other.ad;
+	q.b2 += other.b2; q.bc += other.bc; q.bd += other.bd;
+	q.c2 += other.c2; q.cd += other.cd;
+	q.d2 += other.d2;
+	q.weight += other.weight;
+}
@@ -0,0 +1,116 @@
+/*
+******************************************************************
+* ASMeshSimplifier.h
+*******************************************************************
+* Reduces the triangle count of an indexed mesh with quadric error
+* edge collapses (Garland & Heckbert).  Every vertex carries a
+* quadric built from the planes of the triangles around it, the
+* cheapest edges are collapsed first and their quadrics merged, so
+* the error of a collapse is the mean squared distance of the new
+* vertex from all of the original surface it now stands in for.
+*
+* Edges are only collapsed onto one of their existing vertices, so
+* the simplified index list refers to the same vertex buffer as the
+* full detail mesh and a chain of LODs costs nothing but indices.
+* Vertices on open borders and on texture/normal seams are never
+* moved, which keeps the outline of the mesh and stops cracks
+* opening along seams
+*******************************************************************
+*/
+
+#ifndef _ASMESHSIMPLIFIER_H_
+#define _ASMESHSIMPLIFIER_H_
+
+/*
+*******************************************************************
+* Includes:
+*******************************************************************
+*/
+
+#include <vector>
+#include <algorithm>
+#include <math.h>
+#include <string.h>
+
+using namespace std;
+
+/*
+*******************************************************************
+* Class declaration
+*******************************************************************
+*/
+
+class ASMeshSimplifier
+{
+private:
+	// Symmetric 4x4 matrix, only the upper triangle is stored
+	struct ASQuadric
+	{
+		double a2, ab, ac, ad;
+		double     b2, bc, bd;
+		double         c2, cd;
+		double             d2;
+		double weight;		// total triangle area that went into the quadric
+	};
+	// A candidate collapse, the vertex "from" is moved onto the vertex "to"
+	struct ASCollapse
+	{
+		unsigned long from;
+		unsigned long to;
+		float         error;
+	};
+	// Orders collapses cheapest first
+	struct ASCollapseCompare
+	{
+		bool operator()(const ASCollapse& a, const ASCollapse& b) const
+		{
+			return a.error < b.error;
+		}
+	};
+	// Sorts vertex numbers by position so that matching positions end up together
+	struct ASPositionCompare
+	{
+		const float* positions;
+		bool operator()(unsigned long a, unsigned long b) const
+		{
+			const float* pa = positions + (a * 3);
+			const float* pb = positions + (b * 3);
+			if(pa[0] != pb[0]) return pa[0] < pb[0];
+			if(pa[1] != pb[1]) return pa[1] < pb[1];
+			return pa[2] < pb[2];
+		}
+	};
+
+public:
+	// Constructors and destructor
+	ASMeshSimplifier();
+	ASMeshSimplifier(const ASMeshSimplifier&);
+	~ASMeshSimplifier();
+
+	// Public methods
+	bool Init(const void*, unsigned int, int, const unsigned long*, int);
+	int  Simplify(int, float, unsigned long*, float&);
+	void Release();
+
+private:
+	// Private methods
+	void FindLockedVertices();
+	void BuildQuadrics();
+	void BuildAdjacency(const vector<unsigned long>&);
+	bool FlipsTriangle(unsigned long, unsigned long, const vector<unsigned long>&);
+	float CalculateError(const ASQuadric&, unsigned long);
+
+	static void AddQuadric(ASQuadric&, const ASQuadric&);
+
+	// Private member variables
+	int                   m_numVertices;
+	vector<float>         m_positions;		// x,y,z of every vertex
+	vector<unsigned long> m_indices;		// the full detail index list
+	vector<ASQuadric>     m_quadrics;
+	vector<bool>          m_locked;			// vertices that may not be moved
+	vector<bool>          m_shared;			// vertices that share their position with another vertex
+	vector<int>           m_adjacencyStart;	// triangles around each vertex, indexed into m_adjacency
+	vector<int>           m_adjacency;
+};
+
+#endif
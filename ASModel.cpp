@@ -9,6 +9,16 @@
 
 #include "ASModel.h"
 
+/*
+******************************************************************
+* Level of detail tuning
+******************************************************************
+*/
+
+const float ASModel::LOD_MIN_SAVING  = 0.8f;
+const float ASModel::LOD_MAX_ERROR   = 0.05f;
+const float ASModel::LOD_PIXEL_ERROR = 1.0f;
+
 /*
 ******************************************************************
 * Constructor
@@ -22,6 +32,12 @@ ASModel::ASModel()
 	m_indexBuffer  = 0;
 	m_texture      = 0;
 	m_mesh         = 0;
+	m_indices      = 0;
+	m_indexFormat  = DXGI_FORMAT_R32_UINT;
+	m_vertexStride = sizeof(ASVertex);
+	m_numLods      = 0;
+	m_radius       = 0.0f;
+	m_center       = D3DXVECTOR3(0.0f, 0.0f, 0.0f);
 }
 
 /*
@@ -49,27 +65,56 @@ ASModel::~ASModel()
 * Creates a new instance of ASModel, initialises the vertex and
 * index buffers and then captures the result.
 *
+* When another model has already loaded the same file its buffers
+* are shared.  Otherwise the buffers are created straight from the
+* model's .asmesh cache when it is up to date, or the model file is
+* parsed and the cache is rebuilt so the next launch can skip the
+* parse
+*
 * @param ID3D11Device* - The rendering device D3D is using
-* @param WCHAR*        - Pointer to the texture file the model uses
-* @param char*         - Pointer to the model file the model is loaded from
+* @param WCHAR*        - Pointer to the texture file the model uses, 0 for none
+* @param const char*   - Pointer to the model file the model is loaded from
 *
 * @return bool - True if initialisation succeeded, else false
 ******************************************************************
 */
 
-bool ASModel::Init(ID3D11Device* device, WCHAR* textureFile, char* modelFile)
+bool ASModel::Init(ID3D11Device* device, WCHAR* textureFile, const char* modelFile)
 {
-	// Load model data into constant buffer
-	bool success = LoadModel(modelFile);
-	if(!success)
-		return false;
+	AS_PROFILE("ASModel::Init");
 
-	// Initialise the buffers to begin rendering
-	success = InitBuffers(device);
-	if(!success)
-		return false;
+	char cacheFile[MAX_PATH];
+	bool success;
+
+	ASMeshCache::GetCachePath(modelFile, cacheFile, MAX_PATH);
+
+	// A mesh that is already resident needs no loading at all
+	if(!AcquireSharedMesh(modelFile))
+	{
+		// Try the binary cache first, this needs no parsing at all
+		if(!LoadCachedModel(device, cacheFile, modelFile))
+		{
+			// Load model data into constant buffer
+			success = LoadModel(modelFile);
+			if(!success)
+				return false;
+
+			// Initialise the buffers to begin rendering
+			success = InitBuffers(device);
+			if(!success)
+				return false;
+
+			// Rebuild the cache, the model still works if this fails so the result is ignored
+			WriteCache(cacheFile, modelFile);
+		}
+
+		ShareMesh(modelFile);
+	}
+
+	// Load the texture for the model, a model whose texture is streamed passes none
+	if(!textureFile)
+		return true;
 
-	// Load the texture for the model
 	success = LoadTexture(device, textureFile);
 	if(!success)
 		return false;
@@ -77,6 +122,33 @@ bool ASModel::Init(ID3D11Device* device, WCHAR* textureFile, char* modelFile)
 		return true;
 }
 
+/*
+******************************************************************
+* METHOD: Bake
+******************************************************************
+* Converts a model file into its .asmesh cache without creating any
+* GPU resources, this is used by the -bake command line tool
+*
+* @param const char* - Pointer to the model file to convert
+*
+* @return bool - True if the cache was written, else false
+******************************************************************
+*/
+
+bool ASModel::Bake(const char* modelFile)
+{
+	char cacheFile[MAX_PATH];
+
+	ASMeshCache::GetCachePath(modelFile, cacheFile, MAX_PATH);
+
+	bool success = LoadModel(modelFile);
+	if(success)
+		success = WriteCache(cacheFile, modelFile);
+
+	ReleaseModel();
+	return success;
+}
+
 /*
 ******************************************************************
 * METHOD: Release
@@ -115,13 +187,184 @@ void ASModel::Render(ID3D11DeviceContext* deviceCtx)
 ******************************************************************
 * METHOD: Get Index Count
 ******************************************************************
+* The count is for the full detail mesh, the lower levels of detail
+* follow it in the index buffer
 * @return int - the number of index in this model
 ******************************************************************
 */
 
 int ASModel::GetIndexCount()
 {
-	return m_numIndices;
+	return m_lods[0].numIndices;
+}
+
+/*
+******************************************************************
+* METHOD: Get Lod Count
+******************************************************************
+* @return int - the number of levels of detail, at least 1
+******************************************************************
+*/
+
+int ASModel::GetLodCount()
+{
+	return m_numLods;
+}
+
+/*
+******************************************************************
+* METHOD: Get Lod Index Count
+******************************************************************
+* @param int  - the level of detail
+* @return int - the number of indices to draw for that level
+******************************************************************
+*/
+
+int ASModel::GetLodIndexCount(int lod)
+{
+	return m_lods[lod].numIndices;
+}
+
+/*
+******************************************************************
+* METHOD: Get Lod Start Index
+******************************************************************
+* @param int  - the level of detail
+* @return int - the first index of that level in the index buffer
+******************************************************************
+*/
+
+int ASModel::GetLodStartIndex(int lod)
+{
+	return m_lods[lod].startIndex;
+}
+
+/*
+******************************************************************
+* METHOD: Get Bounding Radius
+******************************************************************
+* @return float - the radius of the model's bounding sphere
+******************************************************************
+*/
+
+float ASModel::GetBoundingRadius()
+{
+	return m_radius;
+}
+
+/*
+******************************************************************
+* METHOD: Get Bounding Center
+******************************************************************
+* @return D3DXVECTOR3 - the centre of the bounding sphere in model space
+******************************************************************
+*/
+
+D3DXVECTOR3 ASModel::GetBoundingCenter()
+{
+	return m_center;
+}
+
+/*
+******************************************************************
+* METHOD: Get Projected Radius
+******************************************************************
+* Works out how large an instance of the model appears on screen
+*
+* @param float - the distance from the camera to the instance
+* @param float - the scale the instance is drawn at
+* @param float - pixels covered by one unit at a distance of one unit,
+*                this is projection._22 * screen height / 2
+*
+* @return float - the radius of the bounding sphere in pixels
+******************************************************************
+*/
+
+float ASModel::GetProjectedRadius(float distance, float scale, float projScale)
+{
+	if(distance <= 0.0f)
+		return FLT_MAX;
+
+	return (m_radius * scale * projScale) / distance;
+}
+
+/*
+******************************************************************
+* METHOD: Select Lod
+******************************************************************
+* Picks the coarsest level of detail that still looks right at a
+* given screen size.  Each level knows how far its surface moved
+* from the original, as a fraction of the bounding radius that
+* error scales with the projected radius, a level is used once its
+* error covers no more than LOD_PIXEL_ERROR pixels
+*
+* @param float - the projected radius of the instance in pixels
+*
+* @return int - the level of detail to draw
+******************************************************************
+*/
+
+int ASModel::SelectLod(float projectedRadius)
+{
+	for(int i = m_numLods - 1; i > 0; i--)
+	{
+		if(m_lods[i].error * projectedRadius <= LOD_PIXEL_ERROR * m_radius)
+			return i;
+	}
+
+	return 0;
+}
+
+/*
+******************************************************************
+* METHOD: Report Lod Scene
+******************************************************************
+* Measures the effect of the levels of detail on a scene full of
+* instances of this model, the instances are spread evenly over a
+* disc around the camera (so most are far away, as in the game) and
+* the triangles submitted with and without LOD selection are
+* appended to ./log/lod-report.txt
+*
+* @param int   - the number of instances
+* @param float - the scale the instances are drawn at
+* @param float - pixels per unit at a distance of one unit
+* @param float - the furthest an instance can be from the camera
+******************************************************************
+*/
+
+void ASModel::ReportLodScene(int numInstances, float scale, float projScale, float maxDistance)
+{
+	ofstream fout;
+	int lodInstances[ASMeshCache::MAX_LODS] = { 0 };
+	long long fullTris = 0;
+	long long lodTris  = 0;
+
+	for(int i = 0; i < numInstances; i++)
+	{
+		// Spread by area, the distance grows with the square root of the instance number
+		float distance = maxDistance * sqrtf(((float)i + 0.5f) / (float)numInstances);
+		int   lod      = SelectLod(GetProjectedRadius(distance, scale, projScale));
+
+		lodInstances[lod]++;
+		fullTris += m_lods[0].numIndices / 3;
+		lodTris  += m_lods[lod].numIndices / 3;
+	}
+
+	fout.open("./log/lod-report.txt", ios::app);
+	if(fout.fail())
+		return;
+
+	fout << numInstances << " instances (scale " << scale << ", out to " << maxDistance << " units): "
+		 << fullTris << " triangles at full detail, " << lodTris << " with LOD ("
+		 << (fullTris > 0 ? (100.0 * (double)lodTris / (double)fullTris) : 0.0) << "%)" << endl;
+
+	for(int i = 0; i < m_numLods; i++)
+	{
+		fout << "  LOD " << i << ": " << (m_lods[i].numIndices / 3) << " triangles, error "
+			 << m_lods[i].error << ", " << lodInstances[i] << " instances" << endl;
+	}
+
+	fout.close();
 }
 
 /*
@@ -134,6 +377,9 @@ int ASModel::GetIndexCount()
 
 ID3D11ShaderResourceView* ASModel::GetTexture()
 {
+	if(!m_texture)
+		return 0;
+
 	return m_texture->GetTexture();
 }
 
@@ -153,8 +399,10 @@ bool ASModel::InitBuffers(ID3D11Device* device)
 {
 	HRESULT hr;
 
-	ASVertex*      vertices;
-	unsigned long* indices;
+	ASVertex*       vertices;
+	unsigned short* shortIndices = 0;
+	void*           indices;
+	unsigned int    indexSize;
 
 	D3D11_BUFFER_DESC vBufferDesc;
 	D3D11_BUFFER_DESC iBufferDesc;
@@ -163,26 +411,39 @@ bool ASModel::InitBuffers(ID3D11Device* device)
 	D3D11_SUBRESOURCE_DATA iData;
 
 	// Create an array to hold the vertices
-	vertices = new ASVertex[m_numVertices];
+	vertices = ASNewArray<ASVertex>(m_numVertices, MEMORY_MODEL);
 	if(!vertices)
 		return false;
 
-	// Create an array to hold the indices
-	indices = new unsigned long[m_numIndices];
-	if(!indices)
-		return false;
-
-	// Populate the indice and vertice arrays with data from the model
-	for(unsigned int i = 0; i < m_numVertices; i++)
+	// Populate the vertice array with data from the model
+	for(int i = 0; i < m_numVertices; i++)
 	{
 		// Set all information for this vertice, reading data from the mesh
 		vertices[i].position = D3DXVECTOR3(m_mesh[i].posX, m_mesh[i].posY, m_mesh[i].posZ);
 		vertices[i].texture  = D3DXVECTOR2(m_mesh[i].texU, m_mesh[i].texV);
 		vertices[i].normal   = D3DXVECTOR3(m_mesh[i].normX, m_mesh[i].normY, m_mesh[i].normZ);
+	}
+
+	// Use 16 bit indices whenever every vertex can be addressed with them, this halves
+	// the size of the index buffer and the bandwidth used to fetch it
+	if(m_numVertices <= ASMeshCache::MAX_SHORT_INDEX_VERTICES)
+	{
+		shortIndices = ASNewArray<unsigned short>(m_numIndices, MEMORY_MODEL);
+		if(!shortIndices)
+			return false;
 
-		// Set the index for this vertice in the index buffer - this is used for fast computation
-		// when querying for vertices later in the rendering pipeline
-		indices[i] = i;
+		for(int i = 0; i < m_numIndices; i++)
+			shortIndices[i] = (unsigned short)m_indices[i];
+
+		indices       = shortIndices;
+		indexSize     = sizeof(unsigned short);
+		m_indexFormat = DXGI_FORMAT_R16_UINT;
+	}
+	else
+	{
+		indices       = m_indices;
+		indexSize     = sizeof(unsigned long);
+		m_indexFormat = DXGI_FORMAT_R32_UINT;
 	}
 
 	// Describe the vertex buffer, then call CreateBuffer on the device, this
@@ -206,7 +467,7 @@ bool ASModel::InitBuffers(ID3D11Device* device)
 	// Describe the index buffer, then call CreateBuffer on the device, this
 	// will return a pointer to the buffer
 	iBufferDesc.Usage				= D3D11_USAGE_DEFAULT;
-	iBufferDesc.ByteWidth			= sizeof(unsigned long) * m_numIndices;
+	iBufferDesc.ByteWidth			= indexSize * m_numIndices;
 	iBufferDesc.BindFlags			= D3D11_BIND_INDEX_BUFFER;
 	iBufferDesc.CPUAccessFlags		= 0;
 	iBufferDesc.MiscFlags			= 0;
@@ -221,12 +482,13 @@ bool ASModel::InitBuffers(ID3D11Device* device)
 	if(FAILED(hr))
 		return false;
 
-	// Delete index and vertex arrays as the data has been sent to the buffers
-	delete [] vertices;
-	delete [] indices;
+	// Delete the temporary arrays as the data has been sent to the buffers
+	ASDeleteArray(vertices);
 
-	vertices = 0;
-	indices  = 0;
+	if(shortIndices)
+	{
+		ASDeleteArray(shortIndices);
+	}
 
 	return true;
 }
@@ -315,12 +577,12 @@ void ASModel::ReleaseBuffers()
 void ASModel::RenderBuffers(ID3D11DeviceContext* deviceContext)
 {
 	// Set the stride and offset in memory of the vertex buffer
-	unsigned int stride = sizeof(ASVertex);
+	unsigned int stride = m_vertexStride;
 	unsigned int offset = 0;
 
 	// Flag the vertex and index buffers as active in the assembler, allowing rendering to commence
 	deviceContext->IASetVertexBuffers(0, 1, &m_vertexBuffer, &stride, &offset);
-	deviceContext->IASetIndexBuffer(m_indexBuffer, DXGI_FORMAT_R32_UINT, 0);
+	deviceContext->IASetIndexBuffer(m_indexBuffer, m_indexFormat, 0);
 
 	// Set the type of primitive that should be rendered for the Vertex buffer
 	deviceContext->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
@@ -332,62 +594,534 @@ void ASModel::RenderBuffers(ID3D11DeviceContext* deviceContext)
 ******************************************************************
 * METHOD: Load Model
 ******************************************************************
-* Reads all vertice information from a model file (.obj), this 
+* Loads the model file into the mesh and index list, Wavefront .obj
+* files go through ASObjLoader and anything else is read as the
+* engine's text format.  The loaded mesh is then optimised and its
+* levels of detail are built
+*
+* @param const char* - a pointer to the model file to read from
+******************************************************************
+*/
+
+bool ASModel::LoadModel(const char* modelFile)
+{
+	bool success;
+
+	// Check the file extension
+	int len = strlen(modelFile);
+	if(len > 4 && _stricmp(modelFile + len - 4, ".obj") == 0)
+		success = LoadObjModel(modelFile);
+	else
+		success = LoadTextModel(modelFile);
+
+	if(!success)
+		return false;
+
+	// Reorder the mesh for the GPU while it is still in memory and build the levels
+	// of detail, the result is what ends up in the .asmesh cache so this only runs
+	// on import
+	OptimizeMesh(modelFile);
+
+	return BuildLods(modelFile);
+}
+
+/*
+******************************************************************
+* METHOD: Load Text Model
+******************************************************************
+* Reads all vertice information from a model file (.txt), this 
 * operation gets the total number of vertices and indices in the file and 
 * then populates the Mesh struct with vertex information, this information
-* is then used in the InitBuffers method
+* is then used in the InitBuffers method.  Every vertex in this format
+* is its own triangle corner, so the indices simply count upward
 *
-* @param char* - a pointer to the object file to read from
+* The file is mapped into memory and parsed in place by ASTextReader,
+* each float is written straight into the mesh so nothing is copied
+* or allocated other than the mesh itself.  The time taken and the
+* throughput are appended to ./log/model-load.txt
+*
+* @param const char* - a pointer to the object file to read from
 ******************************************************************
 */
 
-bool ASModel::LoadModel(char* objectFile)
+bool ASModel::LoadTextModel(const char* objectFile)
 {
-	ifstream fileIn;
-	char readChar;
-	
-	// Open the file and check if we opened it without error, else kill program
-	fileIn.open(objectFile);
-	if(fileIn.fail())
+	ASFileMap file;
+	double startTime;
+	double endTime;
+
+	startTime = ASClock::GetMilliseconds();
+
+	// Map the file and check if we opened it without error, else kill program
+	if(!file.Init(objectFile))
 		return false;
 
-	// Keep reading from the file until we encounter ":" (eof), this will tell the number of vertices
-	fileIn.get(readChar);
-	while(readChar != ':')
-		fileIn.get(readChar);
+	ASTextReader reader(file.GetData(), file.GetSize());
 
-	// Read the total number of vertices into global vertex count - total indices will be the same
-	// as the number of vertices, so set that here too
-	fileIn >> m_numVertices;
+	// Keep reading from the file until we encounter ":", this will tell the number of vertices
+	// the total indices will be the same as the number of vertices, so set that here too
+	if(!reader.SkipPast(':') || !reader.ReadInt(m_numVertices) || m_numVertices <= 0)
+		return false;
 	m_numIndices = m_numVertices;
 
-	// Create the mesh
-	m_mesh = new ASMesh[m_numVertices];
-	if(!m_mesh)
+	// Create the mesh and the index list
+	m_mesh    = ASNewArray<ASMesh>(m_numVertices, MEMORY_MODEL);
+	m_indices = ASNewArray<unsigned long>(m_numIndices, MEMORY_MODEL);
+	if(!m_mesh || !m_indices)
 		return false;
 
-	// 
-	fileIn.get(readChar);
-	while(readChar != ':')
-		fileIn.get(readChar);
-	fileIn.get(readChar);
-	fileIn.get(readChar);
+	for(int i = 0; i < m_numIndices; i++)
+		m_indices[i] = i;
+
+	// Move to the start of the vertex data
+	if(!reader.SkipPast(':'))
+		return false;
 	
 	// Read in vertex data from model - each cycle will build one triangle, a triangle is composed
 	// of three sets of coordinates (pos, tex, norm) - these are passed to shaders for loading mesh
-	for(unsigned int i = 0; i < m_numVertices; i++)
+	for(int i = 0; i < m_numVertices; i++)
 	{
-		fileIn >> m_mesh[i].posX >> m_mesh[i].posY >> m_mesh[i].posZ;			// read next three floats into x,y,z
-		fileIn >> m_mesh[i].texU >> m_mesh[i].texV;								// read next two floats into u,v
-		fileIn >> m_mesh[i].normX >> m_mesh[i].normY >> m_mesh[i].normZ;		// read next three float into x,y,z
+		ASMesh& v = m_mesh[i];
+		bool success = reader.ReadFloat(v.posX)  && reader.ReadFloat(v.posY) && reader.ReadFloat(v.posZ) &&	// read next three floats into x,y,z
+					   reader.ReadFloat(v.texU)  && reader.ReadFloat(v.texV) &&								// read next two floats into u,v
+					   reader.ReadFloat(v.normX) && reader.ReadFloat(v.normY) && reader.ReadFloat(v.normZ);	// read next three float into x,y,z
+		if(!success)
+			return false;
 	}
 
-	// Close the file
-	fileIn.close();
+	endTime = ASClock::GetMilliseconds();
+
+	// Report how quickly the model was parsed
+	double ms = endTime - startTime;
+	ReportLoad(objectFile, file.GetSize(), ms);
+
+	// Unmap the file
+	file.Release();
 
 	return true;
 }
 
+/*
+******************************************************************
+* METHOD: Load Obj Model
+******************************************************************
+* Imports a Wavefront .obj file, the loader deduplicates the face
+* corners into an indexed mesh which is copied into m_mesh and
+* m_indices ready for InitBuffers
+*
+* @param const char* - a pointer to the .obj file to read from
+******************************************************************
+*/
+
+bool ASModel::LoadObjModel(const char* objectFile)
+{
+	ASObjLoader loader;
+	double startTime;
+	double endTime;
+
+	startTime = ASClock::GetMilliseconds();
+
+	if(!loader.Load(objectFile))
+		return false;
+
+	m_numVertices = loader.GetNumVertices();
+	m_numIndices  = loader.GetNumIndices();
+
+	// Create the mesh and the index list
+	m_mesh    = ASNewArray<ASMesh>(m_numVertices, MEMORY_MODEL);
+	m_indices = ASNewArray<unsigned long>(m_numIndices, MEMORY_MODEL);
+	if(!m_mesh || !m_indices)
+		return false;
+
+	// The loader vertex has the same layout as ASMesh
+	ASObjLoader::ASVertex* vertices = loader.GetVertices();
+	for(int i = 0; i < m_numVertices; i++)
+	{
+		m_mesh[i].posX  = vertices[i].posX;
+		m_mesh[i].posY  = vertices[i].posY;
+		m_mesh[i].posZ  = vertices[i].posZ;
+		m_mesh[i].texU  = vertices[i].texU;
+		m_mesh[i].texV  = vertices[i].texV;
+		m_mesh[i].normX = vertices[i].normX;
+		m_mesh[i].normY = vertices[i].normY;
+		m_mesh[i].normZ = vertices[i].normZ;
+	}
+	memcpy(m_indices, loader.GetIndices(), sizeof(unsigned long) * m_numIndices);
+
+	unsigned long bytes = loader.GetFileSize();
+	loader.Release();
+
+	endTime = ASClock::GetMilliseconds();
+
+	// Report the load time and how many vertices were saved by indexing
+	double ms = endTime - startTime;
+	ReportLoad(objectFile, bytes, ms);
+
+	return true;
+}
+
+/*
+******************************************************************
+* METHOD: Optimize Mesh
+******************************************************************
+* Runs the mesh through ASMeshOptimizer, reordering triangles for
+* the vertex cache and for overdraw and then reordering vertices
+* to match.  The ACMR/ATVR before and after are appended to
+* ./log/model-load.txt.  Meshes where no vertex is shared (the text
+* format) gain nothing from this and are left as they are
+*
+* @param const char* - the model file the mesh was loaded from
+******************************************************************
+*/
+
+void ASModel::OptimizeMesh(const char* modelFile)
+{
+	ASMeshOptimizer optimizer;
+	ofstream fout;
+	double startTime;
+	double endTime;
+	float acmrBefore, atvrBefore;
+	float acmrAfter, atvrAfter;
+
+	if(m_numVertices >= m_numIndices)
+		return;
+
+	ASMeshOptimizer::AnalyzeVertexCache(m_indices, m_numIndices, m_numVertices, ASMeshOptimizer::FIFO_CACHE_SIZE,
+										acmrBefore, atvrBefore);
+
+	startTime = ASClock::GetMilliseconds();
+
+	optimizer.OptimizeVertexCache(m_indices, m_numIndices, m_numVertices);
+	optimizer.OptimizeOverdraw(m_indices, m_numIndices, m_mesh, sizeof(ASMesh), m_numVertices);
+	m_numVertices = optimizer.OptimizeVertexFetch(m_mesh, sizeof(ASMesh), m_numVertices, m_indices, m_numIndices);
+
+	endTime = ASClock::GetMilliseconds();
+
+	ASMeshOptimizer::AnalyzeVertexCache(m_indices, m_numIndices, m_numVertices, ASMeshOptimizer::FIFO_CACHE_SIZE,
+										acmrAfter, atvrAfter);
+
+	double ms = endTime - startTime;
+
+	fout.open("./log/model-load.txt", ios::app);
+	if(fout.fail())
+		return;
+
+	fout << modelFile << ": optimised in " << ms << " ms, ACMR " << acmrBefore << " -> " << acmrAfter
+		 << ", ATVR " << atvrBefore << " -> " << atvrAfter << " (" << ASMeshOptimizer::FIFO_CACHE_SIZE
+		 << " entry FIFO)" << endl;
+
+	fout.close();
+}
+
+/*
+******************************************************************
+* METHOD: Build Lods
+******************************************************************
+* Simplifies the full detail mesh into a chain of levels of detail,
+* each with half the triangles of the one before.  The simplified
+* index lists reuse the full detail vertices so they are appended to
+* m_indices and drawn from the same vertex buffer.  The chain stops
+* early when the simplifier can no longer make a real saving without
+* going past LOD_MAX_ERROR (text meshes share no vertices, so they
+* always end up with just the one level)
+*
+* @param const char* - the model file the mesh was loaded from
+*
+* @return bool - True if the chain was built, else false
+******************************************************************
+*/
+
+bool ASModel::BuildLods(const char* modelFile)
+{
+	ASMeshSimplifier simplifier;
+	ASMeshOptimizer  optimizer;
+	ofstream fout;
+	float boundsMin[3];
+	float boundsMax[3];
+	float center[3];
+
+	ASMeshCache::CalculateBounds(m_mesh, sizeof(ASMesh), m_numVertices, boundsMin, boundsMax, center, m_radius);
+	m_center = D3DXVECTOR3(center[0], center[1], center[2]);
+
+	// The full detail mesh is always the first level
+	m_numLods = 1;
+	m_lods[0].startIndex = 0;
+	m_lods[0].numIndices = m_numIndices;
+	m_lods[0].error      = 0.0f;
+
+	if(!simplifier.Init(m_mesh, sizeof(ASMesh), m_numVertices, m_indices, m_numIndices))
+		return true;
+
+	// Simplify every level from the full detail mesh so the errors do not stack up
+	vector<unsigned long> indices(m_indices, m_indices + m_numIndices);
+	vector<unsigned long> simplified(m_numIndices);
+
+	for(int lod = 1; lod < ASMeshCache::MAX_LODS; lod++)
+	{
+		ASMeshCache::ASLod& prev = m_lods[lod - 1];
+		float error;
+
+		int target     = (prev.numIndices / LOD_REDUCTION / 3) * 3;
+		int numIndices = simplifier.Simplify(target, m_radius * LOD_MAX_ERROR, &simplified[0], error);
+
+		if(numIndices == 0 || numIndices > prev.numIndices * LOD_MIN_SAVING)
+			break;
+
+		// The collapses leave the triangles in their old order, put them back in cache order
+		optimizer.OptimizeVertexCache(&simplified[0], numIndices, m_numVertices);
+
+		m_lods[lod].startIndex = indices.size();
+		m_lods[lod].numIndices = numIndices;
+		m_lods[lod].error      = error;
+		indices.insert(indices.end(), simplified.begin(), simplified.begin() + numIndices);
+		m_numLods++;
+	}
+
+	simplifier.Release();
+
+	// Swap in the index list holding every level
+	unsigned long* allIndices = ASNewArray<unsigned long>(indices.size(), MEMORY_MODEL);
+	if(!allIndices)
+		return false;
+
+	memcpy(allIndices, &indices[0], indices.size() * sizeof(unsigned long));
+	ASDeleteArray(m_indices);
+	m_indices    = allIndices;
+	m_numIndices = indices.size();
+
+	fout.open("./log/model-load.txt", ios::app);
+	if(fout.fail())
+		return true;
+
+	fout << modelFile << ": " << m_numLods << " levels of detail, radius " << m_radius << endl;
+	for(int i = 0; i < m_numLods; i++)
+		fout << "  LOD " << i << ": " << (m_lods[i].numIndices / 3) << " triangles, error " << m_lods[i].error << endl;
+
+	fout.close();
+	return true;
+}
+
+/*
+******************************************************************
+* METHOD: Load Cached Model
+******************************************************************
+* Maps the model's .asmesh cache and creates the vertex and index
+* buffers directly from the mapped streams, the cache is unmapped
+* again once the data has been copied to the GPU
+*
+* @param ID3D11Device* - The device we are rendering with
+* @param const char*   - the cache file
+* @param const char*   - the model file the cache was built from
+*
+* @return bool - True if the buffers were created from the cache,
+*                false if the cache is missing or stale
+******************************************************************
+*/
+
+bool ASModel::LoadCachedModel(ID3D11Device* device, const char* cacheFile, const char* modelFile)
+{
+	ASMeshCache cache;
+	HRESULT hr;
+	double startTime;
+	double endTime;
+
+	D3D11_BUFFER_DESC vBufferDesc;
+	D3D11_BUFFER_DESC iBufferDesc;
+
+	D3D11_SUBRESOURCE_DATA vData;
+	D3D11_SUBRESOURCE_DATA iData;
+
+	startTime = ASClock::GetMilliseconds();
+
+	if(!cache.Open(cacheFile, modelFile, sizeof(ASVertex)))
+		return false;
+
+	const ASMeshCache::ASHeader* header = cache.GetHeader();
+
+	m_numVertices  = header->numVertices;
+	m_numIndices   = header->numIndices;
+	m_vertexStride = header->vertexStride;
+	m_indexFormat  = cache.GetIndexFormat();
+	m_numLods      = header->numLods;
+	m_radius       = header->radius;
+	m_center       = D3DXVECTOR3(header->center[0], header->center[1], header->center[2]);
+	memcpy(m_lods, header->lods, sizeof(m_lods));
+
+	// Describe the vertex buffer, the data is read straight out of the mapped file
+	vBufferDesc.Usage				= D3D11_USAGE_DEFAULT;
+	vBufferDesc.ByteWidth			= header->vertexStride * header->numVertices;
+	vBufferDesc.BindFlags			= D3D11_BIND_VERTEX_BUFFER;
+	vBufferDesc.CPUAccessFlags		= 0;
+	vBufferDesc.MiscFlags			= 0;
+	vBufferDesc.StructureByteStride = 0;
+
+	vData.pSysMem					= cache.GetVertices();
+	vData.SysMemPitch				= 0;
+	vData.SysMemSlicePitch			= 0;
+
+	hr = device->CreateBuffer(&vBufferDesc, &vData, &m_vertexBuffer);
+	if(FAILED(hr))
+		return false;
+
+	// Describe the index buffer in the same way
+	iBufferDesc.Usage				= D3D11_USAGE_DEFAULT;
+	iBufferDesc.ByteWidth			= header->indexSize * header->numIndices;
+	iBufferDesc.BindFlags			= D3D11_BIND_INDEX_BUFFER;
+	iBufferDesc.CPUAccessFlags		= 0;
+	iBufferDesc.MiscFlags			= 0;
+	iBufferDesc.StructureByteStride = 0;
+
+	iData.pSysMem					= cache.GetIndices();
+	iData.SysMemPitch				= 0;
+	iData.SysMemSlicePitch			= 0;
+
+	hr = device->CreateBuffer(&iBufferDesc, &iData, &m_indexBuffer);
+	if(FAILED(hr))
+	{
+		ReleaseBuffers();
+		return false;
+	}
+
+	cache.Release();
+
+	endTime = ASClock::GetMilliseconds();
+
+	double ms = endTime - startTime;
+	ReportLoad(cacheFile, vBufferDesc.ByteWidth + iBufferDesc.ByteWidth, ms);
+
+	return true;
+}
+
+/*
+******************************************************************
+* METHOD: Acquire Shared Mesh
+******************************************************************
+* Takes the buffers and level of detail table of a mesh another
+* model has already loaded from the same file
+*
+* @param const char* - Pointer to the model file
+*
+* @return bool - True if the mesh was shared, else false
+******************************************************************
+*/
+
+bool ASModel::AcquireSharedMesh(const char* modelFile)
+{
+	ASResourceManager::ASMeshData mesh;
+
+	if(!ASResourceManager::GetInstance()->AcquireMesh(modelFile, mesh))
+		return false;
+
+	m_vertexBuffer = mesh.vertexBuffer;
+	m_indexBuffer  = mesh.indexBuffer;
+	m_indexFormat  = mesh.indexFormat;
+	m_vertexStride = mesh.vertexStride;
+	m_numVertices  = mesh.numVertices;
+	m_numIndices   = mesh.numIndices;
+	m_numLods      = mesh.numLods;
+	m_radius       = mesh.radius;
+	m_center       = D3DXVECTOR3(mesh.center[0], mesh.center[1], mesh.center[2]);
+	memcpy(m_lods, mesh.lods, sizeof(m_lods));
+
+	return true;
+}
+
+/*
+******************************************************************
+* METHOD: Share Mesh
+******************************************************************
+* Registers the buffers this model has just created so that other
+* models loading the same file can use them
+*
+* @param const char* - Pointer to the model file
+******************************************************************
+*/
+
+void ASModel::ShareMesh(const char* modelFile)
+{
+	ASResourceManager::ASMeshData mesh;
+
+	mesh.vertexBuffer = m_vertexBuffer;
+	mesh.indexBuffer  = m_indexBuffer;
+	mesh.indexFormat  = m_indexFormat;
+	mesh.vertexStride = m_vertexStride;
+	mesh.numVertices  = m_numVertices;
+	mesh.numIndices   = m_numIndices;
+	mesh.numLods      = m_numLods;
+	mesh.radius       = m_radius;
+	mesh.center[0]    = m_center.x;
+	mesh.center[1]    = m_center.y;
+	mesh.center[2]    = m_center.z;
+	memcpy(mesh.lods, m_lods, sizeof(mesh.lods));
+
+	ASResourceManager::GetInstance()->AddMesh(modelFile, mesh);
+}
+
+/*
+******************************************************************
+* METHOD: Write Cache
+******************************************************************
+* Writes the loaded mesh and index list out as an .asmesh cache
+*
+* @param const char* - the cache file to write
+* @param const char* - the model file the mesh was loaded from
+*
+* @return bool - True if the cache was written, else false
+******************************************************************
+*/
+
+bool ASModel::WriteCache(const char* cacheFile, const char* modelFile)
+{
+	ASMeshCache cache;
+
+	// The mesh is written as it is, so it must match the layout of the vertex buffer
+	static_assert(sizeof(ASMesh) == sizeof(ASVertex), "ASMesh must match the ASVertex layout");
+
+	return cache.Write(cacheFile, modelFile, m_mesh, sizeof(ASMesh), m_numVertices, m_indices, m_numIndices,
+					   m_lods, m_numLods);
+}
+
+/*
+******************************************************************
+* METHOD: Report Load
+******************************************************************
+* Appends the time taken to load a model, the throughput of the
+* parser and the vertex saving from indexing to ./log/model-load.txt
+* (a non-indexed mesh needs one vertex for every index)
+*
+* @param const char*   - the model file that was loaded
+* @param unsigned long - the size of the file in bytes, 0 if not known
+* @param double        - the time taken to load the file in ms
+******************************************************************
+*/
+
+void ASModel::ReportLoad(const char* objectFile, unsigned long bytes, double ms)
+{
+	ofstream fout;
+	double mbPerSec  = 0.0;
+	double reduction = 0.0;
+
+	// Only the full detail level counts, the other levels reuse its vertices
+	int numCorners = (m_numLods > 0) ? m_lods[0].numIndices : m_numIndices;
+
+	if(ms > 0.0)
+		mbPerSec = ((double)bytes / (1024.0 * 1024.0)) / (ms / 1000.0);
+	if(numCorners > 0)
+		reduction = 100.0 * (1.0 - ((double)m_numVertices / (double)numCorners));
+
+	fout.open("./log/model-load.txt", ios::app);
+	if(fout.fail())
+		return;
+
+	fout << objectFile << ": " << numCorners << " corners -> " << m_numVertices << " vertices ("
+		 << reduction << "% fewer), " << ms << " ms";
+	if(bytes > 0)
+		fout << ", " << bytes << " bytes (" << mbPerSec << " MB/s)";
+	fout << endl;
+
+	fout.close();
+}
+
 /*
 ******************************************************************
 * METHOD: Release Model
@@ -400,9 +1134,14 @@ void ASModel::ReleaseModel()
 {
 	if(m_mesh)
 	{
-		delete [] m_mesh;
-		m_mesh = 0;
+		ASDeleteArray(m_mesh);
 	}
+	if(m_indices)
+	{
+		ASDeleteArray(m_indices);
+	}
+
+	m_numLods = 0;
 
 	return;
 }
\ No newline at end of file
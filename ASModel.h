@@ -15,13 +15,35 @@
 * Includes
 ******************************************************************
 * + ASTextureShader.h - Supports texturing of models
-* + fstream - allows us to read files (for OBJ model loading)
+* + ASFileMap.h - maps model files into memory for loading
+* + ASTextReader.h - parses the numbers out of a mapped model file
+* + ASObjLoader.h - imports Wavefront .obj files as indexed meshes
+* + ASMeshCache.h - binary .asmesh cache of a loaded model
+* + ASMeshOptimizer.h - reorders imported meshes for the vertex cache
+* + ASMeshSimplifier.h - builds the levels of detail of an imported mesh
+* + ASResourceManager.h - shares the buffers of a model file between models
+* + ASProfiler.h - times loading
+* + ASClock.h - the load times written to the log
+* + ASMemory.h - tags the mesh and index arrays
+* + fstream - used to write load statistics to the log
+* + float.h - FLT_MAX
 */
 
 #include <d3d11.h>
 #include <d3dx10math.h>
 #include "ASTexture.h"
+#include "ASFileMap.h"
+#include "ASTextReader.h"
+#include "ASObjLoader.h"
+#include "ASMeshCache.h"
+#include "ASMeshOptimizer.h"
+#include "ASMeshSimplifier.h"
+#include "ASResourceManager.h"
+#include "ASProfiler.h"
+#include "ASClock.h"
+#include "ASMemory.h"
 #include <fstream>
+#include <float.h>
 
 // Use the std namespace to make our life easier calling funcs from the namespace
 using namespace std;
@@ -35,6 +57,18 @@ using namespace std;
 class ASModel
 {
 private:
+	// Each level of detail aims for half the triangles of the one before it
+	static const int LOD_REDUCTION = 2;
+
+	// A level is only kept if it is at most this fraction of the previous level's size
+	static const float LOD_MIN_SAVING;
+
+	// Largest simplification error allowed, as a fraction of the bounding radius
+	static const float LOD_MAX_ERROR;
+
+	// A level of detail is used once its error covers no more than this many pixels
+	static const float LOD_PIXEL_ERROR;
+
 	// Struct mapped to the struct found in ASLight.vs
 	struct ASVertex
 	{
@@ -80,12 +114,24 @@ public:
 	~ASModel();
 
 	// Methods to manage the models buffers
-	bool Init(ID3D11Device*, WCHAR*, char*);
+	bool Init(ID3D11Device*, WCHAR*, const char*);
+	bool Bake(const char*);
 	void Release();
 	void Render(ID3D11DeviceContext*);
 
 	int GetIndexCount();
 
+	// Levels of detail, 0 is full detail and every level shares the vertex buffer
+	int   GetLodCount();
+	int   GetLodIndexCount(int);
+	int   GetLodStartIndex(int);
+	float GetBoundingRadius();
+	D3DXVECTOR3 GetBoundingCenter();
+
+	float GetProjectedRadius(float, float, float);
+	int   SelectLod(float);
+	void  ReportLodScene(int, float, float, float);
+
 	// Used to pass the models texture resource to the shader
 	ID3D11ShaderResourceView* GetTexture();
 
@@ -100,8 +146,17 @@ private:
 	void ReleaseTexture();
 
 	// Functions to handle the loading and disposal of a model
-	bool LoadModel(char*);
+	bool LoadModel(const char*);
+	bool LoadTextModel(const char*);
+	bool LoadObjModel(const char*);
+	bool LoadCachedModel(ID3D11Device*, const char*, const char*);
+	bool AcquireSharedMesh(const char*);
+	void ShareMesh(const char*);
+	bool WriteCache(const char*, const char*);
+	void OptimizeMesh(const char*);
+	bool BuildLods(const char*);
 	void ReleaseModel();
+	void ReportLoad(const char*, unsigned long, double);
 
 	// Private member variables
 	ID3D11Buffer* m_vertexBuffer;
@@ -111,8 +166,16 @@ private:
 	int m_numVertices;
 	int m_numIndices;
 
-	ASTexture* m_texture;
-	ASMesh*    m_mesh;
+	ASTexture*     m_texture;
+	ASMesh*        m_mesh;
+	unsigned long* m_indices;
+	DXGI_FORMAT    m_indexFormat;
+	unsigned int   m_vertexStride;
+
+	ASMeshCache::ASLod m_lods[ASMeshCache::MAX_LODS];
+	int                m_numLods;
+	float              m_radius;
+	D3DXVECTOR3        m_center;
 
 };
 
@@ -0,0 +1,405 @@
+/*
+******************************************************************
+* ASNullGraphics.cpp
+*******************************************************************
+* Implements all methods from ASNullGraphics.h
+*******************************************************************
+*/
+
+#include "ASNullGraphics.h"
+
+/*
+*******************************************************************
+* Constructor
+*******************************************************************
+*/
+
+ASNullGraphics::ASNullGraphics()
+{
+	m_Camera   = 0;
+	m_Frustum  = 0;
+	m_Terrain  = 0;
+	m_QuadTree = 0;
+}
+
+/*
+*******************************************************************
+* Empty Constructor
+*******************************************************************
+*/
+
+ASNullGraphics::ASNullGraphics(const ASNullGraphics&)
+{}
+
+/*
+*******************************************************************
+* Destructor
+*******************************************************************
+*/
+
+ASNullGraphics::~ASNullGraphics()
+{}
+
+/*
+*******************************************************************
+* METHOD: Init
+*******************************************************************
+* Builds the projection the device would have, builds the terrain
+* and its quad tree and places the enemies where ASEnemies places
+* them
+*
+* @param int   - the screen width
+* @param int   - the screen height
+* @param void* - the window, unused
+*
+* @return bool - True if everything was created, else false
+*/
+
+bool ASNullGraphics::Init(int w, int h, void*)
+{
+	float spread = 10.0f * sqrtf((float)NUM_ENEMIES / 30.0f);
+
+	m_stats.numFrames   = 0;
+	m_stats.numDraws    = 0;
+	m_stats.numIndices  = 0;
+	m_stats.numVisible  = 0;
+	m_stats.numCulled   = 0;
+	m_stats.bufferBytes = 0;
+
+	m_frameStats.cullMs         = 0.0f;
+	m_frameStats.nodesVisited   = 0;
+	m_frameStats.leavesDrawn    = 0;
+	m_frameStats.trianglesDrawn = 0;
+	m_frameStats.drawCalls      = 0;
+
+	m_Camera = new ASCamera;
+	if(!m_Camera)
+		return false;
+	m_Camera->SetPosition(SPAWN_X, SPAWN_Y, SPAWN_Z);
+
+	m_Frustum = new ASFrustrum;
+	if(!m_Frustum)
+		return false;
+
+	ASMatrixPerspectiveFovLH(&m_projection, AS_PI / 4.0f, (float)w / (float)h, SCREEN_NEAR, SCREEN_DEPTH);
+
+	// Same draws from rand() as ASEnemies::Init, colour then position, so both
+	// backends put the enemies in the same places
+	m_posX.resize(NUM_ENEMIES);
+	m_posY.resize(NUM_ENEMIES);
+	m_posZ.resize(NUM_ENEMIES);
+
+	for(int i = 0; i < NUM_ENEMIES; i++)
+	{
+		rand();
+		rand();
+		rand();
+
+		m_posX[i] = (((float)rand()-(float)rand())/RAND_MAX) * spread;
+		m_posY[i] = (((float)rand()-(float)rand())/RAND_MAX) * 10.0f;
+		m_posZ[i] = ((((float)rand()-(float)rand())/RAND_MAX) * spread) + 5.0f;
+	}
+
+	// The terrain and the quad tree, built as ASGraphics builds them but without their buffers
+	m_Terrain = new ASTerrain;
+	if(!m_Terrain)
+		return false;
+	if(!m_Terrain->Build(TERRAIN_HEIGHT_MAP, TERRAIN_COLOR_MAP))
+		return false;
+
+	m_QuadTree = new ASQuadTree;
+	if(!m_QuadTree)
+		return false;
+	if(!m_QuadTree->Build(m_Terrain))
+		return false;
+	m_QuadTree->ReleaseMesh();
+
+	// Stand every enemy on the terrain beneath it
+	for(int i = 0; i < NUM_ENEMIES; i++)
+	{
+		float height;
+		if(m_QuadTree->GetTerrainHeightAtPosition(m_posX[i], m_posZ[i], height))
+			m_posY[i] = height;
+	}
+
+	// The buffers ASGraphics would create, a cube of positions and indices and a
+	// world matrix and colour for every enemy
+	m_cubeVertices = CreateBuffer("cube vertices", 8 * sizeof(ASVector3));
+	m_cubeIndices  = CreateBuffer("cube indices", 36 * sizeof(unsigned int));
+	m_instances    = CreateBuffer("enemy instances", NUM_ENEMIES * (sizeof(ASMatrix) + sizeof(ASVector4)));
+
+	// And the vertex and index buffer of every leaf, a vertex is a position, texture
+	// coordinate, normal and colour
+	int numLeaves = m_QuadTree->GetLeafCount();
+	for(int leaf = 0; leaf < numLeaves; leaf++)
+		CreateBuffer("terrain leaf vertices", m_QuadTree->GetLeafTriangles(leaf) * 3 * (sizeof(ASVector3) * 2 + sizeof(ASVector4) * 2));
+
+	m_leafIndices = (int)m_buffers.size();
+	for(int leaf = 0; leaf < numLeaves; leaf++)
+		CreateBuffer("terrain leaf indices", m_QuadTree->GetLeafTriangles(leaf) * 3 * sizeof(unsigned int));
+
+	// A frame draws the sky, every leaf at most and the enemies, room is made for them
+	// all now so recording a frame does not allocate
+	m_draws.reserve(numLeaves + 2);
+	m_terrainLeaves.reserve(numLeaves);
+
+	return true;
+}
+
+/*
+*******************************************************************
+* METHOD: Render Scene
+*******************************************************************
+* Builds the view from the camera, culls the quad tree and the
+* enemies against it and records the draws ASGraphics would make
+*
+* @param ASCameraInfo - the current camera infomation
+*
+* @return bool - True if the frame was recorded, else false
+*/
+
+bool ASNullGraphics::RenderScene(ASCameraInfo info)
+{
+	AS_PROFILE("ASNullGraphics::RenderScene");
+
+	ASMatrix view;
+	unsigned int* visible;
+	int numVisible;
+	double cullStart;
+	float camHeight = 0.0f;
+
+	m_draws.clear();
+
+	// The camera stands on the terrain beneath it, as it does in ASGraphics
+	m_Camera->SetPosition(info.pos.x, info.pos.y, info.pos.z);
+	m_Camera->SetRotation(info.rot.x, info.rot.y, info.rot.z);
+	if(m_QuadTree->GetTerrainHeightAtPosition(info.pos.x, info.pos.z, camHeight))
+		m_Camera->SetPosition(info.pos.x, camHeight + 2.5f, info.pos.z);
+	m_Camera->RenderCameraView();
+	m_Camera->GetViewMatrix(view);
+
+	m_Frustum->ConstructFrustrum(SCREEN_DEPTH, m_projection, view);
+
+	// The sky
+	Draw(m_cubeIndices, 36, 1);
+
+	// Cull the terrain and the enemies, the enemies' mask only lasts the frame
+	visible = ASFrameArena::GetInstance()->AllocateArray<unsigned int>(ASFrustrum::GetMaskWords(NUM_ENEMIES));
+	if(!visible)
+		return false;
+
+	cullStart  = ASClock::GetSeconds();
+	m_QuadTree->CullViews(&m_Frustum, 1, &m_terrainLeaves);
+	numVisible = m_Frustum->CheckSpheres(&m_posX[0], &m_posY[0], &m_posZ[0], NULL_ENEMY_RADIUS, ASVector3(0.0f, 0.0f, 0.0f),
+										 NUM_ENEMIES, visible);
+	m_frameStats.cullMs = (float)((ASClock::GetSeconds() - cullStart) * 1000.0);
+
+	// Draw each visible leaf, then the visible enemies in one instanced draw
+	for(unsigned int i = 0; i < m_terrainLeaves.size(); i++)
+	{
+		int leaf = m_terrainLeaves[i];
+		Draw(m_leafIndices + leaf, m_QuadTree->GetLeafTriangles(leaf) * 3, 1);
+	}
+	if(numVisible > 0)
+		Draw(m_cubeIndices, 36, numVisible);
+
+	m_frameStats.nodesVisited = m_QuadTree->GetNodesVisited();
+	m_frameStats.leavesDrawn  = (int)m_terrainLeaves.size();
+
+	m_frameStats.trianglesDrawn = 0;
+	for(unsigned int i = 0; i < m_draws.size(); i++)
+		m_frameStats.trianglesDrawn += (m_draws[i].numIndices / 3) * m_draws[i].numInstances;
+	m_frameStats.drawCalls = (int)m_draws.size();
+
+	m_stats.numFrames++;
+	m_stats.numVisible += numVisible;
+	m_stats.numCulled  += NUM_ENEMIES - numVisible;
+
+	return true;
+}
+
+/*
+*******************************************************************
+* METHOD: Release
+*******************************************************************
+*/
+
+void ASNullGraphics::Release()
+{
+	if(m_QuadTree)
+	{
+		m_QuadTree->Release();
+		delete m_QuadTree;
+		m_QuadTree = 0;
+	}
+	if(m_Terrain)
+	{
+		m_Terrain->Release();
+		delete m_Terrain;
+		m_Terrain = 0;
+	}
+	if(m_Frustum)
+	{
+		delete m_Frustum;
+		m_Frustum = 0;
+	}
+	if(m_Camera)
+	{
+		delete m_Camera;
+		m_Camera = 0;
+	}
+
+	m_buffers.clear();
+	m_draws.clear();
+	m_terrainLeaves.clear();
+}
+
+/*
+*******************************************************************
+* METHOD: Enemy positions
+*******************************************************************
+* As ASGraphics
+*/
+
+int ASNullGraphics::GetEnemyCount()
+{
+	return NUM_ENEMIES;
+}
+
+void ASNullGraphics::GetEnemyPosition(int index, float& x, float& y, float& z)
+{
+	x = m_posX[index];
+	y = m_posY[index];
+	z = m_posZ[index];
+}
+
+void ASNullGraphics::SetEnemyPosition(int index, float x, float y, float z)
+{
+	m_posX[index] = x;
+	m_posY[index] = y;
+	m_posZ[index] = z;
+}
+
+/*
+*******************************************************************
+* METHOD: Get Frame Stats
+*******************************************************************
+* @return const ASFrameStats& - what the last frame culled and drew
+*/
+
+const ASNullGraphics::ASFrameStats& ASNullGraphics::GetFrameStats()
+{
+	return m_frameStats;
+}
+
+/*
+*******************************************************************
+* METHOD: Set Benchmarking
+*******************************************************************
+* As ASGraphics, but there are no culling benchmarks to run while
+* loading headless
+*/
+
+void ASNullGraphics::SetBenchmarking(bool)
+{}
+
+/*
+*******************************************************************
+* METHOD: Create Buffer
+*******************************************************************
+* Records a buffer
+*
+* @param const char*        - what the buffer holds
+* @param unsigned long long - its size in bytes
+*
+* @return int - the buffer, to be drawn with Draw()
+*/
+
+int ASNullGraphics::CreateBuffer(const char* name, unsigned long long bytes)
+{
+	ASBuffer buffer;
+
+	buffer.name  = name;
+	buffer.bytes = bytes;
+	m_buffers.push_back(buffer);
+
+	m_stats.bufferBytes += bytes;
+
+	return (int)m_buffers.size() - 1;
+}
+
+/*
+*******************************************************************
+* METHOD: Draw
+*******************************************************************
+* Records a draw for this frame
+*
+* @param int - the index buffer drawn from
+* @param int - the number of indices
+* @param int - the number of instances
+*/
+
+void ASNullGraphics::Draw(int buffer, int numIndices, int numInstances)
+{
+	ASDraw draw;
+
+	draw.buffer       = buffer;
+	draw.numIndices   = numIndices;
+	draw.numInstances = numInstances;
+	m_draws.push_back(draw);
+
+	m_stats.numDraws++;
+	m_stats.numIndices += (unsigned long long)numIndices * numInstances;
+}
+
+/*
+*******************************************************************
+* METHOD: Getters
+*******************************************************************
+*/
+
+const vector<ASNullGraphics::ASBuffer>& ASNullGraphics::GetBuffers()
+{
+	return m_buffers;
+}
+
+const vector<ASNullGraphics::ASDraw>& ASNullGraphics::GetDraws()
+{
+	return m_draws;
+}
+
+const ASNullGraphics::ASStats& ASNullGraphics::GetStats()
+{
+	return m_stats;
+}
+
+/*
+*******************************************************************
+* METHOD: Report
+*******************************************************************
+* Appends the buffers created and the draws recorded to
+* ./log/null-graphics.txt
+*
+* @param const char* - a label for this report
+*/
+
+void ASNullGraphics::Report(const char* label)
+{
+	ofstream fout;
+
+	fout.open("./log/null-graphics.txt", ios::app);
+	if(fout.fail())
+		return;
+
+	double frames = (m_stats.numFrames > 0) ? (double)m_stats.numFrames : 1.0;
+
+	fout << "Null graphics " << label << ": " << m_buffers.size() << " buffers, " << m_stats.bufferBytes << " bytes" << endl;
+	for(unsigned int i = 0; i < m_buffers.size(); i++)
+		fout << "  " << m_buffers[i].name << ", " << m_buffers[i].bytes << " bytes" << endl;
+	fout << "  " << m_stats.numFrames << " frames, " << (m_stats.numDraws / frames) << " draws and "
+		 << (m_stats.numIndices / frames) << " indices a frame" << endl;
+	fout << "  " << (m_stats.numVisible / frames) << " enemies drawn and " << (m_stats.numCulled / frames)
+		 << " culled a frame" << endl;
+
+	fout.close();
+}
@@ -0,0 +1,157 @@
+/*
+******************************************************************
+* ASNullGraphics.h
+*******************************************************************
+* Stands in for ASGraphics in a headless build.  There is no device,
+* buffers and draws are recorded instead of being sent anywhere, but
+* everything a frame does on the CPU up to the draw calls still runs:
+* the camera's view, the frustum, culling the quad tree and culling
+* the enemies.
+*
+* The terrain and its quad tree are built from the same maps as
+* ASGraphics builds them, only their buffers are recorded rather
+* than created.  A unit cube stands in for the sky box and for each
+* enemy's mesh
+*******************************************************************
+*/
+
+#ifndef _ASNULLGRAPHICS_H_
+#define _ASNULLGRAPHICS_H_
+
+/*
+*******************************************************************
+* Includes:
+*******************************************************************
+* + ASCamera.h has been included to build the view each frame
+* + ASFrustrum.h has been included to cull the enemies
+* + ASQuadTree.h has been included to build and cull the terrain
+* + ASSettings.h has been included for the settings shared with ASGraphics
+* + ASProfiler.h has been included to time the frame
+* + ASFrameArena.h has been included for the enemy mask, as ASEnemies
+*******************************************************************
+*/
+
+#include <stdlib.h>
+#include <math.h>
+#include <vector>
+#include <fstream>
+#include "ASCamera.h"
+#include "ASFrustrum.h"
+#include "ASTerrain.h"
+#include "ASQuadTree.h"
+#include "ASSettings.h"
+#include "ASProfiler.h"
+#include "ASFrameArena.h"
+
+using namespace std;
+
+/*
+*******************************************************************
+* Global configuration constants
+*******************************************************************
+*/
+
+// Bounding radius of an enemy, the horse model at the scale ASGraphics draws it
+const float NULL_ENEMY_RADIUS = 10.0f;
+
+/*
+*******************************************************************
+* Class declaration
+*******************************************************************
+*/
+
+class ASNullGraphics
+{
+public:
+	// As ASGraphics::ASCameraInfo
+	struct ASCameraInfo
+	{
+		ASVector3 pos;
+		ASVector3 rot;
+	};
+
+	// As ASGraphics::ASFrameStats
+	struct ASFrameStats
+	{
+		float cullMs;
+		int   nodesVisited;
+		int   leavesDrawn;
+		int   trianglesDrawn;
+		int   drawCalls;
+	};
+
+	struct ASBuffer
+	{
+		const char*        name;
+		unsigned long long bytes;
+	};
+
+	struct ASDraw
+	{
+		int buffer;
+		int numIndices;
+		int numInstances;
+	};
+
+	struct ASStats
+	{
+		unsigned long long numFrames;
+		unsigned long long numDraws;		// totals since Init
+		unsigned long long numIndices;		// indices drawn, counted once per instance
+		unsigned long long numVisible;		// enemies that survived culling
+		unsigned long long numCulled;
+		unsigned long long bufferBytes;		// size of every buffer created
+	};
+
+public:
+	// Constructors and destructor
+	ASNullGraphics();
+	ASNullGraphics(const ASNullGraphics&);
+	~ASNullGraphics();
+
+	// Public methods, as ASGraphics
+	bool Init(int, int, void*);
+	bool RenderScene(ASCameraInfo);
+	void Release();
+
+	int  GetEnemyCount();
+	void GetEnemyPosition(int, float&, float&, float&);
+	void SetEnemyPosition(int, float, float, float);
+
+	const ASFrameStats& GetFrameStats();
+	void SetBenchmarking(bool);
+
+	// Recording
+	int  CreateBuffer(const char*, unsigned long long);
+	void Draw(int, int, int);
+
+	const vector<ASBuffer>& GetBuffers();
+	const vector<ASDraw>&   GetDraws();
+	const ASStats&          GetStats();
+	void Report(const char*);
+
+private:
+	// Private member variables
+	ASCamera*            m_Camera;
+	ASFrustrum*          m_Frustum;
+	ASMatrix             m_projection;
+	ASTerrain*           m_Terrain;
+	ASQuadTree*          m_QuadTree;
+	vector<int>          m_terrainLeaves;	// leaves the view can see, kept to reuse its memory
+
+	vector<float>        m_posX;		// enemy positions
+	vector<float>        m_posY;
+	vector<float>        m_posZ;
+
+	vector<ASBuffer>     m_buffers;
+	vector<ASDraw>       m_draws;		// the last frame's draws
+	int                  m_cubeVertices;
+	int                  m_cubeIndices;
+	int                  m_instances;
+	int                  m_leafIndices;		// each leaf's index buffer, in leaf order
+
+	ASStats              m_stats;
+	ASFrameStats         m_frameStats;
+};
+
+#endif
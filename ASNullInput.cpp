@@ -0,0 +1,159 @@
+/*
+******************************************************************
+* ASNullInput.cpp
+*******************************************************************
+* Implements all methods from ASNullInput.h
+*******************************************************************
+*/
+
+#include "ASNullInput.h"
+
+/*
+*******************************************************************
+* Constructor
+*******************************************************************
+*/
+
+ASNullInput::ASNullInput()
+{
+	for(int i = 0; i < NUM_KEYS; i++)
+		m_keys[i] = false;
+
+	m_screenWidth  = 0;
+	m_screenHeight = 0;
+}
+
+/*
+*******************************************************************
+* Empty Constructor
+*******************************************************************
+*/
+
+ASNullInput::ASNullInput(const ASNullInput&)
+{}
+
+/*
+*******************************************************************
+* Destructor
+*******************************************************************
+*/
+
+ASNullInput::~ASNullInput()
+{}
+
+/*
+*******************************************************************
+* METHOD: Init
+*******************************************************************
+* @param void* - the application instance, unused
+* @param void* - the window, unused
+* @param int   - the screen width
+* @param int   - the screen height
+*
+* @return bool - always true
+*/
+
+bool ASNullInput::Init(void*, void*, int width, int height)
+{
+	m_screenWidth  = width;
+	m_screenHeight = height;
+
+	return true;
+}
+
+/*
+*******************************************************************
+* METHOD: Release
+*******************************************************************
+*/
+
+void ASNullInput::Release()
+{}
+
+/*
+*******************************************************************
+* METHOD: Process Frame
+*******************************************************************
+* Nothing to read, the keys stay as they were set
+*
+* @return bool - always true
+*/
+
+bool ASNullInput::ProcessFrame()
+{
+	return true;
+}
+
+/*
+*******************************************************************
+* METHOD: Key queries
+*******************************************************************
+* @return bool - True if the key has been set down, else false
+*/
+
+bool ASNullInput::IsEscapeDown()
+{
+	return m_keys[KEY_ESCAPE];
+}
+
+bool ASNullInput::IsLeftArrowDown()
+{
+	return m_keys[KEY_LEFT];
+}
+
+bool ASNullInput::IsRightArrowDown()
+{
+	return m_keys[KEY_RIGHT];
+}
+
+bool ASNullInput::IsUpArrowDown()
+{
+	return m_keys[KEY_UP];
+}
+
+bool ASNullInput::IsDownArrowDown()
+{
+	return m_keys[KEY_DOWN];
+}
+
+bool ASNullInput::IsSpaceBarDown()
+{
+	return m_keys[KEY_SPACE];
+}
+
+/*
+*******************************************************************
+* METHOD: Mouse queries
+*******************************************************************
+* There is no mouse, it never clicks and sits in the middle of
+* the screen
+*/
+
+bool ASNullInput::LeftMouseClicked()
+{
+	return false;
+}
+
+bool ASNullInput::RightMouseClicked()
+{
+	return false;
+}
+
+void ASNullInput::GetMouseLocation(int& x, int& y)
+{
+	x = m_screenWidth / 2;
+	y = m_screenHeight / 2;
+}
+
+/*
+*******************************************************************
+* METHOD: Set Key Down
+*******************************************************************
+* @param ASKey - the key
+* @param bool  - True to hold it down, false to let it go
+*/
+
+void ASNullInput::SetKeyDown(ASKey key, bool down)
+{
+	m_keys[key] = down;
+}
@@ -0,0 +1,64 @@
+/*
+******************************************************************
+* ASNullInput.h
+*******************************************************************
+* Stands in for ASInput in a headless build.  There is no keyboard
+* or mouse, every key is up until it is set down with SetKeyDown(),
+* which lets a headless run drive the player with a fixed script
+*******************************************************************
+*/
+
+#ifndef _ASNULLINPUT_H_
+#define _ASNULLINPUT_H_
+
+/*
+*******************************************************************
+* Class declaration
+*******************************************************************
+*/
+
+class ASNullInput
+{
+public:
+	enum ASKey
+	{
+		KEY_ESCAPE,
+		KEY_LEFT,
+		KEY_RIGHT,
+		KEY_UP,
+		KEY_DOWN,
+		KEY_SPACE,
+		NUM_KEYS
+	};
+
+public:
+	// Constructors and destructor
+	ASNullInput();
+	ASNullInput(const ASNullInput&);
+	~ASNullInput();
+
+	// Public methods, as ASInput
+	bool Init(void*, void*, int, int);
+	void Release();
+	bool ProcessFrame();
+	bool IsEscapeDown();
+	bool IsLeftArrowDown();
+	bool IsRightArrowDown();
+	bool IsUpArrowDown();
+	bool IsDownArrowDown();
+	bool IsSpaceBarDown();
+	bool LeftMouseClicked();
+	bool RightMouseClicked();
+	void GetMouseLocation(int&, int&);
+
+	// Scripted input
+	void SetKeyDown(ASKey, bool);
+
+private:
+	// Private member variables
+	bool m_keys[NUM_KEYS];
+	int  m_screenWidth;
+	int  m_screenHeight;
+};
+
+#endif
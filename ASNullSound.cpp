@@ -0,0 +1,47 @@
+/*
+******************************************************************
+* ASNullSound.cpp
+*******************************************************************
+* Implements all methods from ASNullSound.h
+*******************************************************************
+*/
+
+#include "ASNullSound.h"
+
+/*
+*******************************************************************
+* Constructors and destructor
+*******************************************************************
+*/
+
+ASNullSound::ASNullSound()
+{}
+
+ASNullSound::ASNullSound(const ASNullSound&)
+{}
+
+ASNullSound::~ASNullSound()
+{}
+
+/*
+*******************************************************************
+* METHOD: Init
+*******************************************************************
+* @param void* - the window, unused
+*
+* @return bool - always true
+*/
+
+bool ASNullSound::Init(void*)
+{
+	return true;
+}
+
+/*
+*******************************************************************
+* METHOD: Release
+*******************************************************************
+*/
+
+void ASNullSound::Release()
+{}
@@ -0,0 +1,32 @@
+/*
+******************************************************************
+* ASNullSound.h
+*******************************************************************
+* Stands in for ASSound in a headless build, there is no sound
+* device so nothing is loaded or played
+*******************************************************************
+*/
+
+#ifndef _ASNULLSOUND_H_
+#define _ASNULLSOUND_H_
+
+/*
+*******************************************************************
+* Class declaration
+*******************************************************************
+*/
+
+class ASNullSound
+{
+public:
+	// Constructors and destructor
+	ASNullSound();
+	ASNullSound(const ASNullSound&);
+	~ASNullSound();
+
+	// Public methods, as ASSound
+	bool Init(void*);
+	void Release();
+};
+
+#endif
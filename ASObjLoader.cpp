@@ -0,0 +1,506 @@
+/*
+******************************************************************
+* ASObjLoader.cpp
+*******************************************************************
+* Implements all methods from ASObjLoader.h
+*******************************************************************
+*/
+
+#include "ASObjLoader.h"
+#include <math.h>
+
+/*
+*******************************************************************
+* Constructor
+*******************************************************************
+*/
+
+ASObjLoader::ASObjLoader()
+{
+	m_hashMask = 0;
+	m_fileSize = 0;
+}
+
+/*
+*******************************************************************
+* Empty Constructor
+*******************************************************************
+*/
+
+ASObjLoader::ASObjLoader(const ASObjLoader&)
+{}
+
+/*
+*******************************************************************
+* Destructor
+*******************************************************************
+*/
+
+ASObjLoader::~ASObjLoader()
+{}
+
+/*
+*******************************************************************
+* METHOD: Load
+*******************************************************************
+* Maps the .obj file and reads every v, vt, vn and f statement,
+* anything else (groups, materials, smoothing) is skipped.  Faces
+* with more than three corners are triangulated as a fan.
+*
+* .obj files are right handed with counter clockwise faces, so the
+* z axis, the v texture axis and the winding are all flipped as the
+* data is read to match the left handed space D3D renders in.  Any
+* corner without a normal index is given one generated from the faces
+*
+* @param const char* - the .obj file to load
+*
+* @return bool - True if the mesh was loaded, else false
+*/
+
+bool ASObjLoader::Load(const char* filename)
+{
+	AS_PROFILE("ASObjLoader::Load");
+
+	ASFileMap file;
+	bool success = true;
+
+	if(!file.Init(filename))
+		return false;
+
+	ASTextReader reader(file.GetData(), file.GetSize());
+
+	// Size the containers from the file size so they rarely have to grow, a vertex
+	// line is roughly 30 bytes and a face line roughly 20 bytes
+	unsigned long size = file.GetSize();
+	m_fileSize = size;
+	m_positions.reserve(size / 64);
+	m_indices.reserve(size / 16);
+	m_vertices.reserve(size / 64);
+	m_vertexKeys.reserve(size / 64);
+
+	unsigned int tableSize = 1024;
+	while(tableSize < (size / 16))
+		tableSize <<= 1;
+	m_hashTable.assign(tableSize, -1);
+	m_hashMask = tableSize - 1;
+
+	while(success)
+	{
+		reader.SkipWhitespace();
+		if(reader.AtEnd())
+			break;
+
+		char c = reader.Peek();
+		reader.Advance();
+
+		if(c == 'v')
+		{
+			// Vertex statements, the character after the v tells us which kind
+			c = reader.Peek();
+			if(c == ' ' || c == '\t')
+				success = ReadVector(reader, 3, m_positions);
+			else if(c == 't')
+			{
+				reader.Advance();
+				success = ReadVector(reader, 2, m_texCoords);
+			}
+			else if(c == 'n')
+			{
+				reader.Advance();
+				success = ReadVector(reader, 3, m_normals);
+			}
+			else
+				reader.SkipLine();
+		}
+		else if(c == 'f')
+			success = ReadFace(reader);
+		else
+			reader.SkipLine();
+	}
+
+	file.Release();
+
+	if(!success || m_indices.empty())
+	{
+		Release();
+		return false;
+	}
+
+	// Build smooth normals for the corners the file gave none
+	CalculateNormals();
+
+	// The source streams and lookup table are no longer needed
+	vector<ASVector>().swap(m_positions);
+	vector<ASVector>().swap(m_texCoords);
+	vector<ASVector>().swap(m_normals);
+	vector<ASCorner>().swap(m_faceCorners);
+	vector<ASCorner>().swap(m_vertexKeys);
+	vector<int>().swap(m_hashTable);
+
+	return true;
+}
+
+/*
+*******************************************************************
+* METHOD: Read Vector
+*******************************************************************
+* Reads a v, vt or vn statement into the given list, any optional
+* trailing components (such as w) are ignored
+*
+* @param ASTextReader&     - the reader positioned after the keyword
+* @param int               - the number of components to read
+* @param vector<ASVector>& - the list to append the vector to
+*
+* @return bool - True if the statement was read, else false
+*/
+
+bool ASObjLoader::ReadVector(ASTextReader& reader, int numComponents, vector<ASVector>& list)
+{
+	ASVector v;
+	v.x = 0.0f;
+	v.y = 0.0f;
+	v.z = 0.0f;
+
+	if(!reader.ReadFloat(v.x) || !reader.ReadFloat(v.y))
+		return false;
+	if(numComponents == 3 && !reader.ReadFloat(v.z))
+		return false;
+
+	list.push_back(v);
+
+	if(!reader.AtEndOfLine())
+		reader.SkipLine();
+
+	return true;
+}
+
+/*
+*******************************************************************
+* METHOD: Read Face
+*******************************************************************
+* Reads every corner of an f statement and triangulates it as a fan
+* around the first corner.  Triangles are emitted in reverse order
+* to turn the counter clockwise .obj winding into clockwise
+*
+* @param ASTextReader& - the reader positioned after the keyword
+*
+* @return bool - True if the face was read, else false
+*/
+
+bool ASObjLoader::ReadFace(ASTextReader& reader)
+{
+	ASCorner corner;
+
+	m_faceCorners.clear();
+	while(!reader.AtEndOfLine())
+	{
+		if(!ReadCorner(reader, corner))
+			return false;
+		m_faceCorners.push_back(corner);
+	}
+
+	// Need at least a triangle
+	int numCorners = (int)m_faceCorners.size();
+	if(numCorners < 3)
+		return false;
+
+	unsigned long first = AddCorner(m_faceCorners[0]);
+	unsigned long prev  = AddCorner(m_faceCorners[1]);
+
+	for(int i = 2; i < numCorners; i++)
+	{
+		unsigned long curr = AddCorner(m_faceCorners[i]);
+
+		m_indices.push_back(first);
+		m_indices.push_back(curr);
+		m_indices.push_back(prev);
+
+		prev = curr;
+	}
+
+	return true;
+}
+
+/*
+*******************************************************************
+* METHOD: Read Corner
+*******************************************************************
+* Reads one corner of a face in any of the forms v, v/t, v//n or
+* v/t/n.  Indices are 1 based, negative indices count back from the
+* most recent element, both are converted to 0 based here
+*
+* @param ASTextReader& - the reader positioned at the corner
+* @param ASCorner&     - output parameter for the corner
+*
+* @return bool - True if the corner was valid, else false
+*/
+
+bool ASObjLoader::ReadCorner(ASTextReader& reader, ASCorner& corner)
+{
+	int pos  = 0;
+	int tex  = 0;
+	int norm = 0;
+
+	if(!reader.ReadInt(pos))
+		return false;
+
+	if(reader.Peek() == '/')
+	{
+		reader.Advance();
+
+		// v//n has no texture coordinate
+		if(reader.Peek() != '/')
+		{
+			if(!reader.ReadInt(tex))
+				return false;
+		}
+
+		if(reader.Peek() == '/')
+		{
+			reader.Advance();
+			if(!reader.ReadInt(norm))
+				return false;
+		}
+	}
+
+	// Convert to 0 based indices, 0 means the element was not given
+	corner.pos  = (pos  < 0) ? ((int)m_positions.size() + pos)  : (pos  - 1);
+	corner.tex  = (tex  < 0) ? ((int)m_texCoords.size() + tex)  : (tex  - 1);
+	corner.norm = (norm < 0) ? ((int)m_normals.size()   + norm) : (norm - 1);
+
+	// Validate the indices against what has been read so far
+	if(corner.pos < 0 || corner.pos >= (int)m_positions.size())
+		return false;
+	if(corner.tex >= (int)m_texCoords.size() || corner.norm >= (int)m_normals.size())
+		return false;
+	if(corner.tex < 0)
+		corner.tex = -1;
+	if(corner.norm < 0)
+		corner.norm = -1;
+
+	return true;
+}
+
+/*
+*******************************************************************
+* METHOD: Add Corner
+*******************************************************************
+* Looks the corner up in the hash table, returning the index of the
+* vertex already created for it, or creating a new vertex if this
+* is the first time the triple has been seen
+*
+* @param const ASCorner& - the corner to add
+*
+* @return unsigned long - the index of the vertex for the corner
+*/
+
+unsigned long ASObjLoader::AddCorner(const ASCorner& corner)
+{
+	unsigned int hash = ((unsigned int)corner.pos * 73856093u) ^
+						((unsigned int)corner.tex * 19349663u) ^
+						((unsigned int)corner.norm * 83492791u);
+
+	// Linear probe until the corner or an empty slot is found
+	unsigned int slot = hash & m_hashMask;
+	while(m_hashTable[slot] != -1)
+	{
+		const ASCorner& key = m_vertexKeys[m_hashTable[slot]];
+		if(key.pos == corner.pos && key.tex == corner.tex && key.norm == corner.norm)
+			return (unsigned long)m_hashTable[slot];
+
+		slot = (slot + 1) & m_hashMask;
+	}
+
+	// New vertex, flip it into left handed space as it is created
+	ASVertex v;
+	const ASVector& p = m_positions[corner.pos];
+	v.posX = p.x;
+	v.posY = p.y;
+	v.posZ = -p.z;
+
+	if(corner.tex >= 0)
+	{
+		v.texU = m_texCoords[corner.tex].x;
+		v.texV = 1.0f - m_texCoords[corner.tex].y;
+	}
+	else
+	{
+		v.texU = 0.0f;
+		v.texV = 0.0f;
+	}
+
+	if(corner.norm >= 0)
+	{
+		v.normX = m_normals[corner.norm].x;
+		v.normY = m_normals[corner.norm].y;
+		v.normZ = -m_normals[corner.norm].z;
+	}
+	else
+	{
+		v.normX = 0.0f;
+		v.normY = 0.0f;
+		v.normZ = 0.0f;
+	}
+
+	int index = (int)m_vertices.size();
+	m_vertices.push_back(v);
+	m_vertexKeys.push_back(corner);
+	m_hashTable[slot] = index;
+
+	// Keep the table at most half full so probes stay short
+	if((unsigned int)m_vertices.size() * 2 > m_hashMask)
+		Rehash((m_hashMask + 1) * 2);
+
+	return (unsigned long)index;
+}
+
+/*
+*******************************************************************
+* METHOD: Rehash
+*******************************************************************
+* Grows the hash table and re-inserts every vertex key
+*
+* @param unsigned int - the new table size (a power of two)
+*/
+
+void ASObjLoader::Rehash(unsigned int tableSize)
+{
+	m_hashTable.assign(tableSize, -1);
+	m_hashMask = tableSize - 1;
+
+	for(int i = 0; i < (int)m_vertexKeys.size(); i++)
+	{
+		const ASCorner& corner = m_vertexKeys[i];
+		unsigned int hash = ((unsigned int)corner.pos * 73856093u) ^
+							((unsigned int)corner.tex * 19349663u) ^
+							((unsigned int)corner.norm * 83492791u);
+
+		unsigned int slot = hash & m_hashMask;
+		while(m_hashTable[slot] != -1)
+			slot = (slot + 1) & m_hashMask;
+
+		m_hashTable[slot] = i;
+	}
+}
+
+/*
+*******************************************************************
+* METHOD: Calculate Normals
+*******************************************************************
+* Generates smooth normals for the vertices whose corner had no
+* normal index.  The (area weighted) normal of every face is summed
+* onto each position it touches, so vertices that share a position
+* but not a texture coordinate are still smoothed together, and the
+* sum is normalised.  Vertices the file gave a normal are kept
+*/
+
+void ASObjLoader::CalculateNormals()
+{
+	int numVertices = (int)m_vertices.size();
+	int numIndices  = (int)m_indices.size();
+	int i;
+
+	for(i = 0; i < numVertices; i++)
+	{
+		if(m_vertexKeys[i].norm < 0)
+			break;
+	}
+	if(i == numVertices)
+		return;
+
+	ASVector zero;
+	zero.x = 0.0f;
+	zero.y = 0.0f;
+	zero.z = 0.0f;
+	vector<ASVector> sums(m_positions.size(), zero);
+
+	for(i = 0; i < numIndices; i += 3)
+	{
+		const ASVertex& a = m_vertices[m_indices[i]];
+		const ASVertex& b = m_vertices[m_indices[i+1]];
+		const ASVertex& c = m_vertices[m_indices[i+2]];
+
+		// Calculate the two edges of the face
+		float e1x = b.posX - a.posX, e1y = b.posY - a.posY, e1z = b.posZ - a.posZ;
+		float e2x = c.posX - a.posX, e2y = c.posY - a.posY, e2z = c.posZ - a.posZ;
+
+		// Cross product, its length is twice the area of the face
+		float nx = (e1y * e2z) - (e1z * e2y);
+		float ny = (e1z * e2x) - (e1x * e2z);
+		float nz = (e1x * e2y) - (e1y * e2x);
+
+		for(int j = 0; j < 3; j++)
+		{
+			ASVector& sum = sums[m_vertexKeys[m_indices[i+j]].pos];
+			sum.x += nx; sum.y += ny; sum.z += nz;
+		}
+	}
+
+	for(i = 0; i < numVertices; i++)
+	{
+		if(m_vertexKeys[i].norm >= 0)
+			continue;
+
+		const ASVector& sum = sums[m_vertexKeys[i].pos];
+		ASVertex& v = m_vertices[i];
+		float len = sqrtf((sum.x * sum.x) + (sum.y * sum.y) + (sum.z * sum.z));
+		if(len > 0.0f)
+		{
+			v.normX = sum.x / len;
+			v.normY = sum.y / len;
+			v.normZ = sum.z / len;
+		}
+	}
+}
+
+/*
+*******************************************************************
+* METHOD: Getters
+*******************************************************************
+*/
+
+ASObjLoader::ASVertex* ASObjLoader::GetVertices()
+{
+	return m_vertices.empty() ? 0 : &m_vertices[0];
+}
+
+unsigned long* ASObjLoader::GetIndices()
+{
+	return m_indices.empty() ? 0 : &m_indices[0];
+}
+
+int ASObjLoader::GetNumVertices()
+{
+	return (int)m_vertices.size();
+}
+
+int ASObjLoader::GetNumIndices()
+{
+	return (int)m_indices.size();
+}
+
+unsigned long ASObjLoader::GetFileSize()
+{
+	return m_fileSize;
+}
+
+/*
+*******************************************************************
+* METHOD: Release
+*******************************************************************
+* Frees every list held by the loader
+*/
+
+void ASObjLoader::Release()
+{
+	vector<ASVector>().swap(m_positions);
+	vector<ASVector>().swap(m_texCoords);
+	vector<ASVector>().swap(m_normals);
+	vector<ASCorner>().swap(m_faceCorners);
+	vector<ASVertex>().swap(m_vertices);
+	vector<ASCorner>().swap(m_vertexKeys);
+	vector<unsigned long>().swap(m_indices);
+	vector<int>().swap(m_hashTable);
+	m_hashMask = 0;
+	m_fileSize = 0;
+}
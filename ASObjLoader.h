@@ -0,0 +1,103 @@
+/*
+******************************************************************
+* ASObjLoader.h
+*******************************************************************
+* Imports Wavefront .obj meshes.  Every face corner in an .obj file
+* references its own position, texture coordinate and normal, the
+* loader hashes each of those triples so that corners which share
+* all three become a single vertex, producing an indexed mesh
+* that is ready to be sent to the vertex and index buffers
+*******************************************************************
+*/
+
+#ifndef _ASOBJLOADER_H_
+#define _ASOBJLOADER_H_
+
+/*
+*******************************************************************
+* Includes:
+*******************************************************************
+*/
+
+#include "ASFileMap.h"
+#include "ASTextReader.h"
+#include "ASProfiler.h"
+#include <vector>
+
+using namespace std;
+
+/*
+*******************************************************************
+* Class declaration
+*******************************************************************
+*/
+
+class ASObjLoader
+{
+public:
+	// Vertex layout produced by the loader, this matches the layout
+	// of ASModel's mesh so the data can be copied straight across
+	struct ASVertex
+	{
+		float posX, posY, posZ;
+		float texU, texV;
+		float normX, normY, normZ;
+	};
+
+private:
+	// Holds x,y,z coordinates
+	struct ASVector
+	{
+		float x;
+		float y;
+		float z;
+	};
+	// One face corner, a position/texture/normal index triple from an "f" line,
+	// -1 marks a missing texture or normal index
+	struct ASCorner
+	{
+		int pos;
+		int tex;
+		int norm;
+	};
+
+public:
+	// Constructors and destructor
+	ASObjLoader();
+	ASObjLoader(const ASObjLoader&);
+	~ASObjLoader();
+
+	// Public methods
+	bool Load(const char*);
+	void Release();
+
+	ASVertex*      GetVertices();
+	unsigned long* GetIndices();
+	int            GetNumVertices();
+	int            GetNumIndices();
+	unsigned long  GetFileSize();
+
+private:
+	// Private methods
+	bool ReadVector(ASTextReader&, int, vector<ASVector>&);
+	bool ReadFace(ASTextReader&);
+	bool ReadCorner(ASTextReader&, ASCorner&);
+	unsigned long AddCorner(const ASCorner&);
+	void Rehash(unsigned int);
+	void CalculateNormals();
+
+	// Private member variables
+	vector<ASVector>      m_positions;
+	vector<ASVector>      m_texCoords;
+	vector<ASVector>      m_normals;
+	vector<ASCorner>      m_faceCorners;	// scratch list for the face currently being read
+
+	vector<ASVertex>      m_vertices;
+	vector<ASCorner>      m_vertexKeys;		// the corner each vertex was created from
+	vector<unsigned long> m_indices;
+	vector<int>           m_hashTable;		// open addressed, -1 marks an empty slot
+	unsigned int          m_hashMask;
+	unsigned long         m_fileSize;		// bytes in the .obj file that was read
+};
+
+#endif
@@ -0,0 +1,272 @@
+/*
+******************************************************************
+* ASPool.h
+*******************************************************************
+* A pool of objects of one type.  Memory is taken from the heap a
+* chunk of objects at a time and freed objects go on a free list to
+* be handed out again, so once the pool has grown to fit allocating
+* and freeing never touch the heap:
+*
+*     m_nodePool.Init(NODE_POOL_CHUNK, MEMORY_QUADTREE);
+*     ASNode* node = m_nodePool.Allocate();
+*     ...
+*     m_nodePool.Free(node);
+*
+* The chunks are tagged allocations, see ASMemory.h.  Objects are
+* constructed and destroyed as new and delete would, but the memory
+* only goes back to the heap in Release(), which expects every
+* object to have been freed.  A pool is used from one thread
+*******************************************************************
+*/
+
+#ifndef _ASPOOL_H_
+#define _ASPOOL_H_
+
+/*
+*******************************************************************
+* Includes:
+*******************************************************************
+* + ASMemory.h has been included to tag the chunks
+*******************************************************************
+*/
+
+#include <new>
+#include "ASMemory.h"
+
+using namespace std;
+
+/*
+*******************************************************************
+* Class declaration
+*******************************************************************
+*/
+
+template<class T> class ASPool
+{
+private:
+	// An object, or the next free slot while it is on the free list.  The
+	// first slot of each chunk links the chunks instead
+	union ASSlot
+	{
+		ASSlot*   next;
+		char      object[sizeof(T)];
+		double    alignDouble;
+		long long alignLong;
+	};
+
+public:
+	// Constructors / Destructor prototype
+	ASPool();
+	ASPool(const ASPool&);
+	~ASPool();
+
+	// Public methods
+	void Init(int, ASMemoryTag);
+	void Release();
+	T*   Allocate();
+	void Free(T*&);
+	int  GetLiveCount();
+	int  GetPeakCount();
+	int  GetChunkCount();
+
+private:
+	// Private methods
+	bool AddChunk();
+
+	// Private member variables
+	ASSlot*     m_chunks;		// chunks taken so far, linked through their first slot
+	ASSlot*     m_free;			// slots handed back or not handed out yet
+	int         m_chunkSize;	// objects in each chunk
+	ASMemoryTag m_tag;
+	int         m_numChunks;
+	int         m_numLive;
+	int         m_peakLive;
+};
+
+/*
+*******************************************************************
+* Constructor
+*******************************************************************
+*/
+
+template<class T> ASPool<T>::ASPool()
+{
+	m_chunks    = 0;
+	m_free      = 0;
+	m_chunkSize = 0;
+	m_tag       = MEMORY_TAG_COUNT;
+	m_numChunks = 0;
+	m_numLive   = 0;
+	m_peakLive  = 0;
+}
+
+/*
+*******************************************************************
+* Empty Constructor
+*******************************************************************
+*/
+
+template<class T> ASPool<T>::ASPool(const ASPool&)
+{}
+
+/*
+*******************************************************************
+* Destructor
+*******************************************************************
+*/
+
+template<class T> ASPool<T>::~ASPool()
+{}
+
+/*
+*******************************************************************
+* METHOD: Init
+*******************************************************************
+* No memory is taken until the first Allocate()
+*
+* @param int         - objects to take from the heap at a time
+* @param ASMemoryTag - the subsystem the objects belong to
+*/
+
+template<class T> void ASPool<T>::Init(int chunkSize, ASMemoryTag tag)
+{
+	m_chunkSize = chunkSize > 0 ? chunkSize : 1;
+	m_tag       = tag;
+}
+
+/*
+*******************************************************************
+* METHOD: Release
+*******************************************************************
+* Gives every chunk back to the heap, objects still allocated are
+* not destroyed
+*/
+
+template<class T> void ASPool<T>::Release()
+{
+	while(m_chunks)
+	{
+		ASSlot* next = m_chunks->next;
+		ASMemory::Free(m_chunks);
+		m_chunks = next;
+	}
+
+	m_free      = 0;
+	m_numChunks = 0;
+	m_numLive   = 0;
+}
+
+/*
+*******************************************************************
+* METHOD: Allocate
+*******************************************************************
+* @return T* - a new object, or 0 if the pool had to grow and the
+*              heap is out of memory
+*/
+
+template<class T> T* ASPool<T>::Allocate()
+{
+	if(!m_free && !AddChunk())
+		return 0;
+
+	ASSlot* slot = m_free;
+	m_free = slot->next;
+
+	m_numLive++;
+	if(m_numLive > m_peakLive)
+		m_peakLive = m_numLive;
+
+	return new(slot->object) T;
+}
+
+/*
+*******************************************************************
+* METHOD: Free
+*******************************************************************
+* @param T*& - an object from Allocate(), or 0, set to 0
+*/
+
+template<class T> void ASPool<T>::Free(T*& object)
+{
+	if(!object)
+		return;
+
+	object->~T();
+
+	ASSlot* slot = (ASSlot*)object;
+	slot->next = m_free;
+	m_free     = slot;
+
+	m_numLive--;
+	object = 0;
+}
+
+/*
+*******************************************************************
+* METHOD: Get Live Count
+*******************************************************************
+* @return int - objects allocated and not yet freed
+*/
+
+template<class T> int ASPool<T>::GetLiveCount()
+{
+	return m_numLive;
+}
+
+/*
+*******************************************************************
+* METHOD: Get Peak Count
+*******************************************************************
+* @return int - the most objects allocated at once
+*/
+
+template<class T> int ASPool<T>::GetPeakCount()
+{
+	return m_peakLive;
+}
+
+/*
+*******************************************************************
+* METHOD: Get Chunk Count
+*******************************************************************
+* @return int - chunks taken from the heap
+*/
+
+template<class T> int ASPool<T>::GetChunkCount()
+{
+	return m_numChunks;
+}
+
+/*
+*******************************************************************
+* METHOD: Add Chunk
+*******************************************************************
+* Takes another chunk from the heap and puts its slots on the free
+* list, in order so objects allocated together sit together
+*
+* @return bool - false if the heap is out of memory, or before Init()
+*/
+
+template<class T> bool ASPool<T>::AddChunk()
+{
+	if(m_chunkSize <= 0)
+		return false;
+
+	ASSlot* chunk = (ASSlot*)ASMemory::Allocate((m_chunkSize + 1) * sizeof(ASSlot), m_tag);
+	if(!chunk)
+		return false;
+
+	chunk->next = m_chunks;
+	m_chunks    = chunk;
+	m_numChunks++;
+
+	for(int i = m_chunkSize; i >= 1; i--)
+	{
+		chunk[i].next = m_free;
+		m_free        = chunk + i;
+	}
+
+	return true;
+}
+
+#endif
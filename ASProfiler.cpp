@@ -0,0 +1,402 @@
+/*
+******************************************************************
+* ASProfiler.cpp
+*******************************************************************
+* Implements all methods from ASProfiler.h
+*******************************************************************
+*/
+
+#include "ASProfiler.h"
+#include <algorithm>
+#include <iomanip>
+
+/*
+*******************************************************************
+* Thread local state
+*******************************************************************
+*/
+
+#ifdef _MSC_VER
+#define AS_THREAD_LOCAL __declspec(thread)
+#else
+#define AS_THREAD_LOCAL __thread
+#endif
+
+// The calling thread's buffer, and the generation of the profiler it was made for
+static AS_THREAD_LOCAL ASProfiler::ASThreadBuffer* s_buffer = 0;
+static AS_THREAD_LOCAL int s_bufferGeneration = -1;
+
+atomic<bool> ASProfiler::s_enabled(false);
+
+// Time spent in one zone name, summed over every thread
+struct ASZoneTotals
+{
+	string    name;
+	long long calls;
+	long long ticks;
+	long long selfTicks;	// less the zones inside it
+	long long maxTicks;
+};
+
+static bool CompareTotals(const ASZoneTotals& a, const ASZoneTotals& b)
+{
+	return a.ticks > b.ticks;
+}
+
+/*
+*******************************************************************
+* Constructor
+*******************************************************************
+*/
+
+ASProfiler::ASProfiler()
+{
+	m_capacity   = 0;
+	m_generation = 0;
+	m_startTicks = 0;
+}
+
+/*
+*******************************************************************
+* Empty Constructor
+*******************************************************************
+*/
+
+ASProfiler::ASProfiler(const ASProfiler&)
+{}
+
+/*
+*******************************************************************
+* Destructor
+*******************************************************************
+*/
+
+ASProfiler::~ASProfiler()
+{}
+
+/*
+*******************************************************************
+* METHOD: Get Instance
+*******************************************************************
+* @return ASProfiler* - the one profiler every thread records to
+*/
+
+ASProfiler* ASProfiler::GetInstance()
+{
+	static ASProfiler profiler;
+	return &profiler;
+}
+
+/*
+*******************************************************************
+* METHOD: Init
+*******************************************************************
+* Sets how many zones each thread can record and starts the clock
+* the trace is timed from, the profiler stays disabled until
+* SetEnabled() is called
+*
+* @param int - zones each thread's buffer holds
+*
+* @return bool - True if the profiler is ready, else false
+*/
+
+bool ASProfiler::Init(int zonesPerThread)
+{
+	Release();
+
+	if(zonesPerThread <= 0)
+		return false;
+
+	lock_guard<mutex> guard(m_lock);
+	m_capacity   = zonesPerThread;
+	m_startTicks = ASClock::GetNanoseconds();
+
+	return true;
+}
+
+/*
+*******************************************************************
+* METHOD: Release
+*******************************************************************
+* Disables the profiler and frees every thread's buffer, no other
+* thread may be inside a zone while this runs
+*/
+
+void ASProfiler::Release()
+{
+	SetEnabled(false);
+
+	lock_guard<mutex> guard(m_lock);
+	for(unsigned int i = 0; i < m_buffers.size(); i++)
+	{
+		delete [] m_buffers[i]->zones;
+		delete m_buffers[i];
+	}
+	m_buffers.clear();
+	m_capacity = 0;
+	m_generation++;
+}
+
+/*
+*******************************************************************
+* METHOD: Set Enabled
+*******************************************************************
+* @param bool - whether zones are recorded from now on
+*/
+
+void ASProfiler::SetEnabled(bool enabled)
+{
+	s_enabled.store(enabled, memory_order_relaxed);
+}
+
+/*
+*******************************************************************
+* METHOD: Set Thread Name
+*******************************************************************
+* Names the calling thread in the trace
+*
+* @param const char* - the name, a string literal
+*/
+
+void ASProfiler::SetThreadName(const char* name)
+{
+	ASThreadBuffer* buffer = GetThreadBuffer();
+
+	if(buffer)
+		buffer->name = name;
+}
+
+/*
+*******************************************************************
+* METHOD: Begin Zone
+*******************************************************************
+* Called by ASProfileZone as a zone opens
+*
+* @return int - the zones already open on this thread, or -1 if the
+*               profiler has not been started
+*/
+
+int ASProfiler::BeginZone()
+{
+	ASThreadBuffer* buffer = GetInstance()->GetThreadBuffer();
+
+	if(!buffer)
+		return -1;
+
+	return buffer->depth++;
+}
+
+/*
+*******************************************************************
+* METHOD: End Zone
+*******************************************************************
+* Called by ASProfileZone as a zone closes, writes it to the
+* thread's buffer and publishes it
+*
+* @param const char* - the zone's name
+* @param long long   - when it opened, in ns
+* @param int         - the depth BeginZone() gave it
+*/
+
+void ASProfiler::EndZone(const char* name, long long start, int depth)
+{
+	long long end = ASClock::GetNanoseconds();
+	ASThreadBuffer* buffer = GetInstance()->GetThreadBuffer();
+
+	if(!buffer)
+		return;
+
+	buffer->depth = depth;
+
+	int count = buffer->count.load(memory_order_relaxed);
+	if(count >= buffer->capacity)
+	{
+		buffer->dropped.fetch_add(1, memory_order_relaxed);
+		return;
+	}
+
+	ASZone& zone = buffer->zones[count];
+	zone.name  = name;
+	zone.start = start;
+	zone.end   = end;
+	zone.depth = depth;
+
+	buffer->count.store(count + 1, memory_order_release);
+}
+
+/*
+*******************************************************************
+* METHOD: Write Chrome Trace
+*******************************************************************
+* Writes every zone recorded so far as a complete event in the
+* Chrome trace event format, times are in microseconds from Init()
+*
+* @param const char* - the file to write
+*
+* @return bool - True if the file was written, else false
+*/
+
+bool ASProfiler::WriteChromeTrace(const char* filename)
+{
+	ofstream fout;
+	bool     first  = true;
+	double   toMicro = 0.001;
+
+	fout.open(filename, ios::out | ios::trunc);
+	if(fout.fail())
+		return false;
+
+	lock_guard<mutex> guard(m_lock);
+
+	fout << fixed << setprecision(3);
+	fout << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[" << endl;
+
+	for(unsigned int t = 0; t < m_buffers.size(); t++)
+	{
+		ASThreadBuffer* buffer = m_buffers[t];
+		int count = buffer->count.load(memory_order_acquire);
+
+		if(buffer->name)
+		{
+			fout << (first ? "" : ",\n") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer->threadId
+				 << ",\"args\":{\"name\":\"" << buffer->name << "\"}}";
+			first = false;
+		}
+
+		for(int i = 0; i < count; i++)
+		{
+			const ASZone& zone = buffer->zones[i];
+
+			fout << (first ? "" : ",\n") << "{\"name\":\"" << zone.name << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << buffer->threadId
+				 << ",\"ts\":" << ((zone.start - m_startTicks) * toMicro) << ",\"dur\":" << ((zone.end - zone.start) * toMicro) << "}";
+			first = false;
+		}
+	}
+
+	fout << "\n]}" << endl;
+	fout.close();
+
+	return !fout.fail();
+}
+
+/*
+*******************************************************************
+* METHOD: Report
+*******************************************************************
+* Appends the time spent in each zone to ./log/profiler.txt, most
+* first.  Self time leaves out the zones opened inside a zone.
+* Zones are written as they close, so those inside a zone are
+* always written before it, and the time of the zones one level
+* down is summed until the zone they sit in comes along
+*
+* @param const char* - a label for this report
+*/
+
+void ASProfiler::Report(const char* label)
+{
+	map<string, ASZoneTotals> totals;
+	vector<ASZoneTotals>      sorted;
+	vector<long long>         childTicks;
+	double toMs = 0.000001;
+	long long numZones = 0, numDropped = 0;
+	ofstream fout;
+
+	{
+		lock_guard<mutex> guard(m_lock);
+
+		for(unsigned int t = 0; t < m_buffers.size(); t++)
+		{
+			ASThreadBuffer* buffer = m_buffers[t];
+			int count = buffer->count.load(memory_order_acquire);
+
+			childTicks.assign(1, 0);
+			for(int i = 0; i < count; i++)
+			{
+				const ASZone& zone = buffer->zones[i];
+				long long ticks = zone.end - zone.start;
+
+				if((int)childTicks.size() < zone.depth + 2)
+					childTicks.resize(zone.depth + 2, 0);
+
+				ASZoneTotals& total = totals[zone.name];
+				if(total.name.empty())
+				{
+					total.name      = zone.name;
+					total.calls     = 0;
+					total.ticks     = 0;
+					total.selfTicks = 0;
+					total.maxTicks  = 0;
+				}
+				total.calls++;
+				total.ticks     += ticks;
+				total.selfTicks += ticks - childTicks[zone.depth + 1];
+				total.maxTicks   = max(total.maxTicks, ticks);
+
+				childTicks[zone.depth + 1] = 0;
+				childTicks[zone.depth]    += ticks;
+			}
+
+			numZones   += count;
+			numDropped += buffer->dropped.load(memory_order_relaxed);
+		}
+	}
+
+	if(numZones == 0)
+		return;
+
+	fout.open("./log/profiler.txt", ios::app);
+	if(fout.fail())
+		return;
+
+	for(map<string, ASZoneTotals>::iterator i = totals.begin(); i != totals.end(); i++)
+		sorted.push_back(i->second);
+	sort(sorted.begin(), sorted.end(), CompareTotals);
+
+	fout << "Profiler " << label << ": " << numZones << " zones on " << m_buffers.size() << " threads, "
+		 << numDropped << " dropped as a buffer was full" << endl;
+	for(unsigned int i = 0; i < sorted.size(); i++)
+	{
+		fout << "  " << sorted[i].name << ": " << sorted[i].calls << " calls, " << (sorted[i].ticks * toMs) << " ms ("
+			 << (sorted[i].selfTicks * toMs) << " ms self), " << ((sorted[i].ticks * toMs) / sorted[i].calls)
+			 << " ms a call, " << (sorted[i].maxTicks * toMs) << " ms max" << endl;
+	}
+
+	fout.close();
+}
+
+/*
+*******************************************************************
+* METHOD: Get Thread Buffer
+*******************************************************************
+* Finds the calling thread's buffer, making one the first time the
+* thread records
+*
+* @return ASThreadBuffer* - the thread's buffer, or 0 if the
+*                           profiler has not been started
+*/
+
+ASProfiler::ASThreadBuffer* ASProfiler::GetThreadBuffer()
+{
+	if(s_buffer && s_bufferGeneration == m_generation.load(memory_order_relaxed))
+		return s_buffer;
+
+	lock_guard<mutex> guard(m_lock);
+
+	if(m_capacity <= 0)
+		return 0;
+
+	ASThreadBuffer* buffer = new ASThreadBuffer;
+	buffer->zones    = new ASZone[m_capacity];
+	buffer->capacity = m_capacity;
+	buffer->count    = 0;
+	buffer->dropped  = 0;
+	buffer->depth    = 0;
+	buffer->threadId = (int)m_buffers.size() + 1;
+	buffer->name     = 0;
+	m_buffers.push_back(buffer);
+
+	s_buffer           = buffer;
+	s_bufferGeneration = m_generation;
+
+	return buffer;
+}
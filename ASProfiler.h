@@ -0,0 +1,170 @@
+/*
+******************************************************************
+* ASProfiler.h
+*******************************************************************
+* Hierarchical CPU profiler.  A zone is marked by putting
+*
+*     AS_PROFILE("ASGraphics::RenderScene");
+*
+* at the top of a block, it is timed from there to the end of the
+* block.  Names must be string literals, only the pointer is kept.
+*
+* Each thread writes the zones it closes to its own buffer, only
+* that thread writes to it so recording takes no lock; the count is
+* published with a release store so the buffers can be read while
+* threads are still recording.  A buffer is made the first time a
+* thread records and holds a set number of zones, zones that do not
+* fit are counted and dropped rather than stalling the thread.
+*
+* The profiler starts disabled, a zone then costs one test of a
+* flag.  Building with AS_NO_PROFILER defined removes the zones
+* altogether.  WriteChromeTrace() writes what was recorded in the
+* trace event format chrome://tracing and Perfetto load, Report()
+* totals the time spent in each zone
+*******************************************************************
+*/
+
+#ifndef _ASPROFILER_H_
+#define _ASPROFILER_H_
+
+/*
+*******************************************************************
+* Includes:
+*******************************************************************
+*/
+
+#include <vector>
+#include <map>
+#include <string>
+#include <fstream>
+#include <mutex>
+#include <atomic>
+#include "ASClock.h"
+
+using namespace std;
+
+/*
+*******************************************************************
+* Zone markers
+*******************************************************************
+*/
+
+#define AS_PROFILE_JOIN2(a, b) a##b
+#define AS_PROFILE_JOIN(a, b)  AS_PROFILE_JOIN2(a, b)
+
+#ifdef AS_NO_PROFILER
+#define AS_PROFILE(name)
+#else
+#define AS_PROFILE(name) ASProfileZone AS_PROFILE_JOIN(profileZone, __LINE__)(name)
+#endif
+
+/*
+*******************************************************************
+* Class declaration
+*******************************************************************
+*/
+
+class ASProfiler
+{
+public:
+	struct ASZone
+	{
+		const char* name;
+		long long   start;		// ns, from ASClock
+		long long   end;
+		int         depth;		// zones open around it on its thread
+	};
+
+	struct ASThreadBuffer
+	{
+		ASZone*     zones;
+		int         capacity;
+		atomic<int> count;		// zones written, only the owning thread adds to it
+		atomic<int> dropped;	// zones that did not fit
+		int         depth;		// zones open on the thread
+		int         threadId;
+		const char* name;
+	};
+
+public:
+	// Constructors and destructor
+	ASProfiler();
+	ASProfiler(const ASProfiler&);
+	~ASProfiler();
+
+	static ASProfiler* GetInstance();
+
+	// Public methods
+	bool Init(int);
+	void Release();
+	void SetEnabled(bool);
+	void SetThreadName(const char*);
+
+	bool WriteChromeTrace(const char*);
+	void Report(const char*);
+
+	static bool IsEnabled();
+	static int  BeginZone();
+	static void EndZone(const char*, long long, int);
+
+private:
+	ASThreadBuffer* GetThreadBuffer();
+
+	// Private member variables
+	static atomic<bool>      s_enabled;
+	mutex                    m_lock;		// guards adding a thread's buffer
+	vector<ASThreadBuffer*>  m_buffers;
+	int                      m_capacity;	// zones each thread's buffer holds
+	atomic<int>              m_generation;	// bumped by Release() so threads make new buffers
+	long long                m_startTicks;	// ns when Init() was called
+};
+
+/*
+*******************************************************************
+* METHOD: Is Enabled
+*******************************************************************
+* Inline as every zone asks, the flag is only a hint so no ordering
+* is needed
+*/
+
+inline bool ASProfiler::IsEnabled()
+{
+	return s_enabled.load(memory_order_relaxed);
+}
+
+/*
+*******************************************************************
+* Scoped zone, made by AS_PROFILE
+*******************************************************************
+*/
+
+class ASProfileZone
+{
+public:
+	ASProfileZone(const char* name)
+	{
+		m_name  = name;
+		m_start = 0;
+		m_depth = -1;
+		if(ASProfiler::IsEnabled())
+		{
+			m_depth = ASProfiler::BeginZone();
+			m_start = ASClock::GetNanoseconds();
+		}
+	}
+
+	~ASProfileZone()
+	{
+		if(m_depth >= 0)
+			ASProfiler::EndZone(m_name, m_start, m_depth);
+	}
+
+private:
+	ASProfileZone(const ASProfileZone&);
+
+	const char* m_name;
+	long long   m_start;
+	int         m_depth;	// -1 when the profiler was disabled as the zone opened
+};
+
+#endif
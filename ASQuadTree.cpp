@@ -20,6 +20,9 @@ ASQuadTree::ASQuadTree()
 {
 	m_vertices   = 0;
 	m_parentNode = 0;
+	m_numPolys   = 0;
+	m_numNodesVisited = 0;
+	m_numLeavesDrawn  = 0;
 }
 
 /*
@@ -28,7 +31,7 @@ ASQuadTree::ASQuadTree()
 ******************************************************************
 */
 
-ASQuadTree::ASQuadTree(const ASQuadTree& tree)
+ASQuadTree::ASQuadTree(const ASQuadTree&)
 {}
 
 /*
@@ -40,11 +43,14 @@ ASQuadTree::ASQuadTree(const ASQuadTree& tree)
 ASQuadTree::~ASQuadTree()
 {}
 
+#ifndef AS_HEADLESS
 /*
 ******************************************************************
 * METHOD: Init
 ******************************************************************
-* Initialises the quad tree to be drawn in the rendering pipeline
+* Initialises the quad tree to be drawn in the rendering pipeline,
+* the tree is built from the terrain and then each leaf is given
+* its buffers
 *
 * @param ID3D11Device* - The device we are rendering with
 * @param ASTerrain* - pointer to the terrain object we are rendering
@@ -54,6 +60,37 @@ ASQuadTree::~ASQuadTree()
 
 bool ASQuadTree::Init(ID3D11Device* device, ASTerrain* terrain)
 {
+	AS_PROFILE("ASQuadTree::Init");
+
+	bool success = Build(terrain);
+	if(success)
+		success = CreateBuffers(device);
+
+	// Dispose of the vertex list as it has been populated and no longer serves purpose
+	ReleaseMesh();
+
+	return success;
+}
+#endif
+
+/*
+******************************************************************
+* METHOD: Build
+******************************************************************
+* Builds the tree from the terrain on the CPU, every node is given
+* its bounds and every leaf its number and the positions used to
+* find the height of the terrain.  The mesh is kept so buffers can
+* be made from it, ReleaseMesh() disposes of it
+*
+* @param ASTerrain* - pointer to the terrain object we are rendering
+*
+* @return bool - True if the tree was built, else false
+*/
+
+bool ASQuadTree::Build(ASTerrain* terrain)
+{
+	AS_PROFILE("ASQuadTree::Build");
+
 	// Output parameters for the quad
 	float quadWidth;
 	float centerX;
@@ -64,7 +101,7 @@ bool ASQuadTree::Init(ID3D11Device* device, ASTerrain* terrain)
 	// Calculate the number of faces in the mesh and initialise the vertex array which will
 	// hold all data on this class
 	m_numTriangles  = numVertices / 3;
-	m_vertices = new ASVertex[numVertices];
+	m_vertices = ASNewArray<ASVertex>(numVertices, MEMORY_QUADTREE);
 	if(!m_vertices)
 		return false;
 
@@ -75,30 +112,42 @@ bool ASQuadTree::Init(ID3D11Device* device, ASTerrain* terrain)
 	GetMeshDimensions(numVertices, centerX, centerZ, quadWidth); 
 
 	// Create the parent node for the tree structure, then build the tree recursively
-	// based on the parent node and data passed back from output parameters
-	m_parentNode = new ASNode;
+	// based on the parent node and data passed back from output parameters.  Nodes come
+	// from a pool a chunk at a time rather than one heap allocation each
+	m_nodePool.Init(NODE_POOL_CHUNK, MEMORY_QUADTREE);
+	m_parentNode = m_nodePool.Allocate();
 	if(!m_parentNode)
 		return false;
 
 	// Recursive function to build the tree with vert data
-	AppendNode(m_parentNode, centerX, centerZ, quadWidth, device);
+	AppendNode(m_parentNode, centerX, centerZ, quadWidth);
 
-	// Dispose of the vertex list as it has been populated and no longer serves purpose
+	return true;
+}
+
+/*
+******************************************************************
+* METHOD: Release Mesh
+******************************************************************
+* Disposes of the terrain mesh Build() copied, once the buffers
+* have been made the tree only needs its nodes
+*/
+
+void ASQuadTree::ReleaseMesh()
+{
 	if(m_vertices)
 	{
-		delete [] m_vertices;
-		m_vertices = 0;
+		ASDeleteArray(m_vertices);
 	}
-
-	return true;
 }
 
+#ifndef AS_HEADLESS
 /*
 ******************************************************************
 * METHOD: Render
 ******************************************************************
-* Calls render node to recursively build nodes from the tree using
-* the frustum which will determine what polys can be seen in the view.
+* Culls the tree using the frustum which will determine what polys
+* can be seen in the view, and then draws the nodes that are left.
 *
 * @param ASFrustum* - Pointer to the frustum class we use for rendering
 * @param ID3D11DeviceContext* - The rendering device
@@ -107,9 +156,161 @@ bool ASQuadTree::Init(ID3D11Device* device, ASTerrain* terrain)
 
 void ASQuadTree::Render(ASFrustrum* frustum, ASTerrainShader* shader, ID3D11DeviceContext* deviceCtxt)
 {
-	m_numPolys = 0;
-	// Traverse through the tree, rendering each node
-	RenderNode(m_parentNode, frustum, deviceCtxt, shader);
+	AS_PROFILE("ASQuadTree::Render");
+
+	CullViews(&frustum, 1, &m_visibleLeaves);
+	RenderLeaves(m_visibleLeaves, shader, deviceCtxt);
+}
+#endif
+
+/*
+******************************************************************
+* METHOD: Cull Views
+******************************************************************
+* Walks the tree once for several views, writing the leaves each
+* one can see to its own list.  The lists keep their memory from
+* one call to the next, so reusing them avoids allocating
+*
+* @param ASFrustrum** - the frustum of each view
+* @param int          - the number of views, at most MAX_VIEWS
+* @param vector<int>* - output, one list of visible leaves per view
+*/
+
+void ASQuadTree::CullViews(ASFrustrum** frusta, int numViews, vector<int>* leaves)
+{
+	AS_PROFILE("ASQuadTree::CullViews");
+
+	unsigned int viewMask = 0;
+
+	m_numNodesVisited = 1;
+
+	// The root is checked on its own, below it each node checks its children together
+	for(int v = 0; v < numViews; v++)
+	{
+		leaves[v].clear();
+
+		if(frusta[v]->CheckCube(m_parentNode->posX, 0.0f, m_parentNode->posZ, (m_parentNode->width / 2.0f)))
+			viewMask |= 1u << v;
+	}
+
+	if(viewMask != 0)
+		CullNode(m_parentNode, viewMask, frusta, leaves);
+}
+
+#ifndef AS_HEADLESS
+/*
+******************************************************************
+* METHOD: Render Leaves
+******************************************************************
+* Draws a list of leaves found by CullViews(), with whichever
+* shader has been set up for that view
+*
+* @param const vector<int>& - the leaves to draw
+* @param ASTerrainShader* - Pointer to the terrain shader
+* @param ID3D11DeviceContext* - Pointer to the rendering device
+*/
+
+void ASQuadTree::RenderLeaves(const vector<int>& leaves, ASTerrainShader* shader, ID3D11DeviceContext* deviceCtx)
+{
+	AS_PROFILE("ASQuadTree::RenderLeaves");
+
+	unsigned int stride = sizeof(ASVertex);
+	unsigned int offset = 0;
+
+	m_numPolys       = 0;
+	m_numLeavesDrawn = (int)leaves.size();
+
+	deviceCtx->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+
+	for(unsigned int i = 0; i < leaves.size(); i++)
+	{
+		ASNode* node = m_leaves[leaves[i]];
+
+		deviceCtx->IASetVertexBuffers(0, 1, &node->vBuffer, &stride, &offset);
+		deviceCtx->IASetIndexBuffer(node->iBuffer, DXGI_FORMAT_R32_UINT, 0);
+
+		// Render the polygons for this node in the shader with the amount of indices 
+		// calculated from total polygons * 3 (for each point in triangle)
+		shader->RenderShader(deviceCtx, (node->numTriangles * 3));
+
+		// Set the amount of polys that have been rendered for the frame
+		m_numPolys += node->numTriangles;
+	}
+}
+#endif
+
+/*
+******************************************************************
+* METHOD: Benchmark
+******************************************************************
+* Times culling the same views with one traversal each and with a
+* single shared traversal, checks both give the same leaves and
+* appends the results to ./log/cull-benchmark.txt
+*
+* @param ASFrustrum** - the frustum of each view
+* @param int          - the number of views, at most MAX_VIEWS
+* @param int          - how many times each method is run
+*/
+
+void ASQuadTree::Benchmark(ASFrustrum** frusta, int numViews, int repeats)
+{
+	vector<int> separate[MAX_VIEWS];
+	vector<int> shared[MAX_VIEWS];
+	double start;
+	double seconds[2];
+	ofstream fout;
+
+	start = ASClock::GetSeconds();
+	for(int r = 0; r < repeats; r++)
+	{
+		for(int v = 0; v < numViews; v++)
+			CullViews(&frusta[v], 1, &separate[v]);
+	}
+	seconds[0] = (ASClock::GetSeconds() - start) / repeats;
+
+	start = ASClock::GetSeconds();
+	for(int r = 0; r < repeats; r++)
+		CullViews(frusta, numViews, shared);
+	seconds[1] = (ASClock::GetSeconds() - start) / repeats;
+
+	fout.open("./log/cull-benchmark.txt", ios::app);
+	if(fout.fail())
+		return;
+
+	fout << "Quad tree culling, " << numViews << " views, " << m_leaves.size() << " leaves:" << endl;
+	fout << "  one traversal per view: " << (seconds[0] * 1000000.0) << " us" << endl;
+	fout << "  one shared traversal:   " << (seconds[1] * 1000000.0) << " us" << endl;
+	fout << "  visible leaves per view:";
+	for(int v = 0; v < numViews; v++)
+		fout << " " << shared[v].size() << ((shared[v] == separate[v]) ? "" : " (MISMATCH)");
+	fout << endl;
+
+	fout.close();
+}
+
+/*
+******************************************************************
+* METHOD: Get Leaf Count
+******************************************************************
+* @return int - the number of nodes that hold triangles
+*/
+
+int ASQuadTree::GetLeafCount()
+{
+	return (int)m_leaves.size();
+}
+
+/*
+******************************************************************
+* METHOD: Get Leaf Triangles
+******************************************************************
+* @param int - the leaf, as numbered in the lists CullViews() fills
+* @return int - the number of triangles the leaf draws
+*/
+
+int ASQuadTree::GetLeafTriangles(int leaf)
+{
+	return m_leaves[leaf]->numTriangles;
 }
 
 /*
@@ -125,20 +326,10 @@ void ASQuadTree::Render(ASFrustrum* frustum, ASTerrainShader* shader, ID3D11Devi
 * @param float   - nodes x coordinate 
 * @param float   - nodes y coordinate
 * @param float   - width of the quadtree
-* @param ID3D11Device* - pointer to the rendering device
 */
 
-void ASQuadTree::AppendNode(ASNode* node, float posX, float posZ, float width, ID3D11Device* device)
+void ASQuadTree::AppendNode(ASNode* node, float posX, float posZ, float width)
 {
-	// list of vertices and indices
-	ASVertex*      vertices;
-	unsigned long* indices;
-	// Buffer descriptors
-	D3D11_BUFFER_DESC vBufferDesc;
-	D3D11_BUFFER_DESC iBufferDesc;
-	D3D11_SUBRESOURCE_DATA vData;
-	D3D11_SUBRESOURCE_DATA iData;
-
 	// Set the initial structure of the node, set all unkown parameters to null pointers
 	node->posX = posX;
 	node->posZ = posZ;
@@ -146,13 +337,16 @@ void ASQuadTree::AppendNode(ASNode* node, float posX, float posZ, float width, I
 	// Set buffers and triangle total to null for now
 	node->numTriangles = 0;
 	node->vertices = 0;
+#ifndef AS_HEADLESS
 	node->vBuffer = 0;
 	node->iBuffer = 0;
+#endif
 	// Set all child nodes to null pointers for now
 	node->nodes[0] = 0;
 	node->nodes[1] = 0; 
 	node->nodes[2] = 0;
 	node->nodes[3] = 0;
+	node->leaf = -1;
 
 	// Get the number of triangles for this node from the terrain class, this
 	// method call queries the ASTerrain object for its total number of triangles and writes the
@@ -179,8 +373,8 @@ void ASQuadTree::AppendNode(ASNode* node, float posX, float posZ, float width, I
 			{
 				// The new node has triangles, create a child node at the current index and call the
 				// CreateTreeNode method to create the new child node
-				node->nodes[i] = new ASNode;
-				AppendNode(node->nodes[i], (posX + offsetX), (posZ + offsetZ), (width / 2.0f), device);
+				node->nodes[i] = m_nodePool.Allocate();
+				AppendNode(node->nodes[i], (posX + offsetX), (posZ + offsetZ), (width / 2.0f));
 			}
 		}
 		// Computed this node, restart loop
@@ -189,178 +383,211 @@ void ASQuadTree::AppendNode(ASNode* node, float posX, float posZ, float width, I
 	// There is no need to create a child node as the number of triangles in this section of the tree are within
 	// the threshold, thereofre this node is at the bottom of the tree
 	node->numTriangles = numTriangles;
-	int numVertices    = numTriangles * 3;
 
-	// Create an indice and vertice list to send to the shader, the node vertice list
-	// keeps track of all vertices inside the current node, for quick line intersection
-	// processing
-	vertices       = new ASVertex[numVertices];
-	indices        = new unsigned long[numVertices];
-	node->vertices = new ASVector[numVertices];
+	// Leaves are numbered in the order they are reached, which is the order they are drawn in
+	node->leaf = (int)m_leaves.size();
+	m_leaves.push_back(node);
+
+	// The node vertice list keeps track of all vertices inside the current node, for
+	// quick line intersection processing
+	node->vertices = ASNewArray<ASVector>(numTriangles * 3, MEMORY_QUADTREE);
 
-	// Use a tracker variable to populate the indice array, if we used the
+	// Use a tracker variable to populate the vertice array, if we used the
 	// i iterator, then if a successful triangle wasn't in the view we would have
-	// gaps in the indice count (which makes no sense...it would also pull back redundant 
-	// data from the global vertice array)
+	// gaps in the list
 	int currIndex = 0;
 
 	for(int i = 0; i < m_numTriangles; i++)
 	{
-		// Check if the triangle is in the frustum, if it is, then add it to the vertex array
 		if(IsTriangleInQuad(i, posX, posZ, width))
 		{
-			// Get the next three vertices for this triangle from the vertex list, we multiply
-			// by three as each iteration of the loop will extract three vertices for each face
-			// (extract corresponding 3 vertices from global array dependent on
-			// the current position of this array (tracked by external currIndex var, instead of i)
-			// * Also, the nodes vertice list is populated as well as the global vertice list, this
-			// is so each node can keep track of its own vertices for line intersection checking later
-			int vertIndex = i * 3;
-			vertices[currIndex].pos      = m_vertices[vertIndex].pos;
-			vertices[currIndex].texCoord = m_vertices[vertIndex].texCoord;
-			vertices[currIndex].norm     = m_vertices[vertIndex].norm;
-			vertices[currIndex].color    = m_vertices[vertIndex].color;
-			// Set nodes vertice buffer
-			node->vertices[currIndex].x  = m_vertices[vertIndex].pos.x;
-			node->vertices[currIndex].y  = m_vertices[vertIndex].pos.y;
-			node->vertices[currIndex].z  = m_vertices[vertIndex].pos.z;
-			// Set indice buffer
-			indices[currIndex] = currIndex;
-			currIndex++;
-
-			// Get the next vertex for this face
-			vertIndex++;
-			vertices[currIndex].pos      = m_vertices[vertIndex].pos;
-			vertices[currIndex].texCoord = m_vertices[vertIndex].texCoord;
-			vertices[currIndex].norm     = m_vertices[vertIndex].norm;
-			vertices[currIndex].color    = m_vertices[vertIndex].color;
-			// Set nodes vertice buffer
-			node->vertices[currIndex].x  = m_vertices[vertIndex].pos.x;
-			node->vertices[currIndex].y  = m_vertices[vertIndex].pos.y;
-			node->vertices[currIndex].z  = m_vertices[vertIndex].pos.z;
-			// Set indice buffer
-			indices[currIndex] = currIndex;
-			currIndex++;
-
-			// Get the last vertex for this face
-			vertIndex++;
-			vertices[currIndex].pos      = m_vertices[vertIndex].pos;
-			vertices[currIndex].texCoord = m_vertices[vertIndex].texCoord;
-			vertices[currIndex].norm     = m_vertices[vertIndex].norm;
-			vertices[currIndex].color    = m_vertices[vertIndex].color;
-			// Set nodes vertice buffer
-			node->vertices[currIndex].x  = m_vertices[vertIndex].pos.x;
-			node->vertices[currIndex].y  = m_vertices[vertIndex].pos.y;
-			node->vertices[currIndex].z  = m_vertices[vertIndex].pos.z;
-			// Set indice buffer
-			indices[currIndex] = currIndex;
-			currIndex++;
+			// Copy the three corners of this face from the global vertex list
+			for(int v = 0; v < 3; v++)
+			{
+				int vertIndex = (i * 3) + v;
+				node->vertices[currIndex].x = m_vertices[vertIndex].pos.x;
+				node->vertices[currIndex].y = m_vertices[vertIndex].pos.y;
+				node->vertices[currIndex].z = m_vertices[vertIndex].pos.z;
+				currIndex++;
+			}
+		}
+	}
+}
+
+#ifndef AS_HEADLESS
+/*
+******************************************************************
+* METHOD: Create Buffers
+******************************************************************
+* Creates the vertex and index buffers for every leaf Build()
+* found, from the mesh it kept.  The triangles of a leaf are the
+* ones inside its quad, in the order they are in the mesh
+*
+* @param ID3D11Device* - pointer to the rendering device
+*
+* @return bool - True if every buffer was created, else false
+*/
+
+bool ASQuadTree::CreateBuffers(ID3D11Device* device)
+{
+	AS_PROFILE("ASQuadTree::CreateBuffers");
+
+	// Buffer descriptors
+	D3D11_BUFFER_DESC vBufferDesc;
+	D3D11_BUFFER_DESC iBufferDesc;
+	D3D11_SUBRESOURCE_DATA vData;
+	D3D11_SUBRESOURCE_DATA iData;
+	HRESULT hr;
+
+	if(!m_vertices)
+		return false;
+
+	for(unsigned int leaf = 0; leaf < m_leaves.size(); leaf++)
+	{
+		ASNode* node    = m_leaves[leaf];
+		int numVertices = node->numTriangles * 3;
+
+		// Create an indice and vertice list to send to the shader
+		ASVertex*      vertices = ASNewArray<ASVertex>(numVertices, MEMORY_QUADTREE);
+		unsigned long* indices  = ASNewArray<unsigned long>(numVertices, MEMORY_QUADTREE);
+
+		int currIndex = 0;
+
+		for(int i = 0; i < m_numTriangles; i++)
+		{
+			// Check if the triangle is in the quad, if it is, then add it to the vertex array
+			if(IsTriangleInQuad(i, node->posX, node->posZ, node->width))
+			{
+				for(int v = 0; v < 3; v++)
+				{
+					vertices[currIndex] = m_vertices[(i * 3) + v];
+					indices[currIndex]  = currIndex;
+					currIndex++;
+				}
+			}
 		}
+
+		/*
+		* VERTEX BUFFER DESC
+		*/
+
+		vBufferDesc.Usage = D3D11_USAGE_DEFAULT;
+		vBufferDesc.ByteWidth = sizeof(ASVertex) * numVertices;
+		vBufferDesc.BindFlags = D3D11_BIND_VERTEX_BUFFER;
+		vBufferDesc.CPUAccessFlags = 0;
+		vBufferDesc.MiscFlags = 0;
+		vBufferDesc.StructureByteStride = 0;
+
+		// Give the subresource structure a pointer to the vertex data.
+		vData.pSysMem = vertices;
+		vData.SysMemPitch = 0;
+		vData.SysMemSlicePitch = 0;
+
+		hr = device->CreateBuffer(&vBufferDesc, &vData, &node->vBuffer);
+
+		/*
+		* INDEX BUFFER DESC
+		*/
+
+		iBufferDesc.Usage = D3D11_USAGE_DEFAULT;
+		iBufferDesc.ByteWidth = sizeof(unsigned long) * numVertices;
+		iBufferDesc.BindFlags = D3D11_BIND_INDEX_BUFFER;
+		iBufferDesc.CPUAccessFlags = 0;
+		iBufferDesc.MiscFlags = 0;
+		iBufferDesc.StructureByteStride = 0;
+
+		// Give the subresource structure a pointer to the vertex data.
+		iData.pSysMem = indices;
+		iData.SysMemPitch = 0;
+		iData.SysMemSlicePitch = 0;
+
+		// Create the buffers on the nodes buffer to be rendered
+		if(SUCCEEDED(hr))
+			hr = device->CreateBuffer(&iBufferDesc, &iData, &node->iBuffer);
+
+		// Clean up local resources as we no longer need them
+		ASDeleteArray(vertices);
+		ASDeleteArray(indices);
+
+		if(FAILED(hr))
+			return false;
 	}
 
-	/*
-	* VERTEX BUFFER DESC
-	*/
-
-	vBufferDesc.Usage = D3D11_USAGE_DEFAULT;
-	vBufferDesc.ByteWidth = sizeof(ASVertex) * numVertices;
-	vBufferDesc.BindFlags = D3D11_BIND_VERTEX_BUFFER;
-	vBufferDesc.CPUAccessFlags = 0;
-	vBufferDesc.MiscFlags = 0;
-	vBufferDesc.StructureByteStride = 0;
-
-	// Give the subresource structure a pointer to the vertex data.
-	vData.pSysMem = vertices;
-	vData.SysMemPitch = 0;
-	vData.SysMemSlicePitch = 0;
-
-	device->CreateBuffer(&vBufferDesc, &vData, &node->vBuffer);
-
-	/*
-	* INDEX BUFFER DESC
-	*/
-
-	iBufferDesc.Usage = D3D11_USAGE_DEFAULT;
-	iBufferDesc.ByteWidth = sizeof(unsigned long) * numVertices;
-	iBufferDesc.BindFlags = D3D11_BIND_INDEX_BUFFER;
-	iBufferDesc.CPUAccessFlags = 0;
-	iBufferDesc.MiscFlags = 0;
-	iBufferDesc.StructureByteStride = 0;
-
-	// Give the subresource structure a pointer to the vertex data.
-	iData.pSysMem = indices;
-	iData.SysMemPitch = 0;
-	iData.SysMemSlicePitch = 0;
-
-	// Create the buffers on the nodes buffer to be rendered
-	device->CreateBuffer(&iBufferDesc, &iData, &node->iBuffer);
-
-	// Clean up local resources as we no longer need them
-	delete [] vertices;
-	delete [] indices;
-	vertices = 0;
-	indices = 0;
+	return true;
 }
+#endif
 
 /*
 ******************************************************************
-* METHOD: Render Node
+* METHOD: Cull Node
 ******************************************************************
-* Draws all visible nodes in the tree to the screen, this will
-* be called by ASGraphics.cpp, This method will utilise the frustum
-* class to check if the user can view the current quad, the terrain
-* shader is also utilised here to render each.  
+* Finds the leaves below a node for every view that can see it.
+* Each node is a cube which bounds its part of the map, the Y
+* position is not important so long as the cube is tall enough.
+* The children's bounds are gathered once and each view checks
+* them in one batch, a child is only visited by the views that can
+* see it and is skipped along with everything below it once none
+* can
 *
-* @param ASNode* - pointer to the current node
-* @param ASFrustum* - pointer to the frustum object
-* @param ID3D11DeviceContext* - Pointer to the rendering device
-* @param ASTerrainShader* - Pointer to the terrain shader
+* @param ASNode*      - pointer to the current node
+* @param unsigned int - a bit for each view that can see the node
+* @param ASFrustrum** - the frustum of each view
+* @param vector<int>* - output, one list of visible leaves per view
 */
 
-void ASQuadTree::RenderNode(ASNode* node, ASFrustrum* frustum, ID3D11DeviceContext* deviceCtx, ASTerrainShader* shader)
+void ASQuadTree::CullNode(ASNode* node, unsigned int viewMask, ASFrustrum** frusta, vector<int>* leaves)
 {
-	// Check if the node can be viewed in the frustum, the quad that has been generated is a
-	// cube which bounds the map, therefore we can use the CheckCube method in the frustum,
-	// the Y parameter is not important, so long as we have the X and Y culling values set
-	// an unsuccessful callback the parent node nor its children will have it in the view,
-	// therefore we break out the function
-	bool success = frustum->CheckCube(node->posX, 0.0f, node->posZ, (node->width / 2.0f));
-	if(!success)
+	float x[NODE_CHILDREN], y[NODE_CHILDREN], z[NODE_CHILDREN], size[NODE_CHILDREN];
+	ASNode* children[NODE_CHILDREN];
+	unsigned int childViews[NODE_CHILDREN];
+	unsigned int bits;
+
+	// A node with triangles has no children, it is visible to every view that reached it
+	if(node->leaf >= 0)
+	{
+		for(bits = viewMask; bits != 0; bits &= bits - 1)
+			leaves[ASFrustrum::GetLowestBit(bits)].push_back(node->leaf);
 		return;
+	}
 
-	// Check which child node can see whats in the current frustum
+	// Only gather a child node if it exists in the tree, 0 indicates a null pointer
+	// to the node at the current index
 	int count = 0;
 	for(int i = 0; i < NODE_CHILDREN; i++)
 	{
-		// Only populate a child node if it exists in the tree, 0 indicates a null pointer
-		// to the node at the current index
-		if(node->nodes[i] != 0)
+		ASNode* child = node->nodes[i];
+		if(child != 0)
 		{
-			count++;
-			RenderNode(node->nodes[i], frustum, deviceCtx, shader);
+			x[count]          = child->posX;
+			y[count]          = 0.0f;
+			z[count]          = child->posZ;
+			size[count]       = child->width / 2.0f;
+			childViews[count] = 0;
+			children[count++] = child;
 		}
 	}
 
-	// Check if the count is not 0, if it is then we can assume that the parent nodes have
-	// no triangles (because the child nodes contain them, therefore we need to traverse no further)
-	if(count != 0)
-		return;
-
-	// The current node has seen the triangles we want to render, set the buffers for
-	// rendering in ASGraphics.cpp
-	unsigned int stride = sizeof(ASVertex);
-	unsigned int offset = 0;
+	m_numNodesVisited += count;
 
-	deviceCtx->IASetVertexBuffers(0, 1, &node->vBuffer, &stride, &offset);
-	deviceCtx->IASetIndexBuffer(node->iBuffer, DXGI_FORMAT_R32_UINT, 0);
-	deviceCtx->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
+	// Turn each view's mask of visible children into a mask of views for each child
+	for(bits = viewMask; bits != 0; bits &= bits - 1)
+	{
+		int view = ASFrustrum::GetLowestBit(bits);
+		unsigned int visible;
 
-	// Render the polygons for this node in the shader with the amount of indices 
-	// calculated from total polygons * 3 (for each point in triangle)
-	shader->RenderShader(deviceCtx, (node->numTriangles * 3));
+		frusta[view]->CheckBoxes(x, y, z, size, size, size, count, &visible);
+		for(int i = 0; i < count; i++)
+		{
+			if(ASFrustrum::IsVisible(&visible, i))
+				childViews[i] |= 1u << view;
+		}
+	}
 
-	// Set the amount of polys that have been rendered for the frame
-	m_numPolys += node->numTriangles;
+	for(int i = 0; i < count; i++)
+	{
+		if(childViews[i] != 0)
+			CullNode(children[i], childViews[i], frusta, leaves);
+	}
 }
 
 /*
@@ -421,12 +648,12 @@ void ASQuadTree::GetMeshDimensions(int numVertices, float& centerX, float& cente
 	}
 
 	// Find the maximum of all three components
-	float maxX = (float)__max(fabs(minWidth), fabs(maxWidth));
-	float maxZ = (float)__max(fabs(minDepth), fabs(maxDepth));
+	float maxX = max(fabsf(minWidth), fabsf(maxWidth));
+	float maxZ = max(fabsf(minDepth), fabsf(maxDepth));
 
 	// Set the max bounds of the quad by multiplying the maximum of the X and Z values by 2
 	// this will give the viewing diameter of the quad
-	quadWidth = __max(maxX, maxZ) * 2.0f;
+	quadWidth = max(maxX, maxZ) * 2.0f;
 }
 
 /*
@@ -443,6 +670,35 @@ int ASQuadTree::GetPolyCount()
 	return m_numPolys;
 }
 
+/*
+******************************************************************
+* METHOD: Get Nodes Visited
+******************************************************************
+* Returns the number of nodes the last cull tested against the
+* views, the root included
+*
+* @return int - the nodes visited by the last traversal
+*/
+
+int ASQuadTree::GetNodesVisited()
+{
+	return m_numNodesVisited;
+}
+
+/*
+******************************************************************
+* METHOD: Get Leaves Drawn
+******************************************************************
+* Returns the number of leaves drawn in the current view
+*
+* @return int - the leaves drawn by the last RenderLeaves()
+*/
+
+int ASQuadTree::GetLeavesDrawn()
+{
+	return m_numLeavesDrawn;
+}
+
 /*
 ******************************************************************
 * METHOD: Get Num Triangles
@@ -558,11 +814,11 @@ void ASQuadTree::GetNodeAtPosition(ASNode* node, float x, float z, float& height
 	{
 		int vertIndex = i * 3;	// Get the next three vertices on each loop (because we read 3 each time per face)
 
-		D3DXVECTOR3 vecA = D3DXVECTOR3(node->vertices[vertIndex].x, node->vertices[vertIndex].y, node->vertices[vertIndex].z);
+		ASVector3 vecA = ASVector3(node->vertices[vertIndex].x, node->vertices[vertIndex].y, node->vertices[vertIndex].z);
 		vertIndex++;
-		D3DXVECTOR3 vecB = D3DXVECTOR3(node->vertices[vertIndex].x, node->vertices[vertIndex].y, node->vertices[vertIndex].z);
+		ASVector3 vecB = ASVector3(node->vertices[vertIndex].x, node->vertices[vertIndex].y, node->vertices[vertIndex].z);
 		vertIndex++;
-		D3DXVECTOR3 vecC = D3DXVECTOR3(node->vertices[vertIndex].x, node->vertices[vertIndex].y, node->vertices[vertIndex].z);
+		ASVector3 vecC = ASVector3(node->vertices[vertIndex].x, node->vertices[vertIndex].y, node->vertices[vertIndex].z);
 
 		// Check if the current polygon corresponds to the triangle we want to find.
 		if(GetTriangleHeightAtPosition(x, z, height, vecA, vecB, vecC) == true)
@@ -584,106 +840,63 @@ void ASQuadTree::GetNodeAtPosition(ASNode* node, float x, float z, float& height
 * @param float  - the x position we are testing at
 * @param float  - the y position we are testing at
 * @param float& - the output height for a valid interset
-* @param D3DXVECTOR3 - The first vertex
-* @param D3DXVECTOR3 - The second vertex
-* @param D3DXVECTOR3 - The third vertex
+* @param ASVector3 - The first vertex
+* @param ASVector3 - The second vertex
+* @param ASVector3 - The third vertex
 *
 * @return bool - true if successful, else false
 */
 
-bool ASQuadTree::GetTriangleHeightAtPosition(float x, float z, float& heightOut, D3DXVECTOR3 vecA, D3DXVECTOR3 vecB, D3DXVECTOR3 vecC)
+bool ASQuadTree::GetTriangleHeightAtPosition(float x, float z, float& heightOut, ASVector3 vecA, ASVector3 vecB, ASVector3 vecC)
 {
+	ASVector3 norm;
+	ASVector3 edgeNormal;
+
 	// Starting position of the ray that is being cast.
-	D3DXVECTOR3 start = D3DXVECTOR3(x, 0.0f, z);
-	D3DXVECTOR3 dir   = D3DXVECTOR3(0.0f, -1.0f, 0.0f);
+	ASVector3 start = ASVector3(x, 0.0f, z);
+	ASVector3 dir   = ASVector3(0.0f, -1.0f, 0.0f);
 
 	// Calculate the two edges from the three points given.
-	D3DXVECTOR3 edgeA = D3DXVECTOR3(vecB.x - vecA.x, vecB.y - vecA.y, vecB.z - vecA.z);
-	D3DXVECTOR3 edgeB = D3DXVECTOR3(vecC.x - vecA.x, vecC.y - vecA.y, vecC.z - vecA.z);
-
-	// Calculate the normal of the triangle from the two edges.
-	D3DXVECTOR3 norm = D3DXVECTOR3( (edgeA.y * edgeB.z) - (edgeA.z * edgeB.y),
-									(edgeA.z * edgeB.x) - (edgeA.x * edgeB.z),
-									(edgeA.x * edgeB.y) - (edgeA.y * edgeB.x));
+	ASVector3 edgeA = vecB - vecA;
+	ASVector3 edgeB = vecC - vecA;
 
-	// Calculate the magintude of the vector, then from that normalis the vector and
+	// Calculate the normal of the triangle from the two edges, normalise it and
 	// then calculate the distance from origin to plane
-	float magnitude = (float)sqrt((norm.x * norm.x) + (norm.y * norm.y) + (norm.z * norm.z));
-	norm.x = norm.x / magnitude;
-	norm.y = norm.y / magnitude;
-	norm.z = norm.z / magnitude;
+	ASVec3Cross(&norm, &edgeA, &edgeB);
+	ASVec3Normalize(&norm, &norm);
 
-	float distance = ((-norm.x * vecA.x) + (-norm.y * vecA.y) + (-norm.z * vecA.z));
+	float distance = -ASVec3Dot(&norm, &vecA);
 
 	// Get the denominator, ensuring its value is not < 0 (shouldn't happen)
-	float denominator = ((norm.x * dir.x) + (norm.y * dir.y) + (norm.z * dir.z));
+	float denominator = ASVec3Dot(&norm, &dir);
 	if(fabs(denominator) < 0.0001f)
 		return false;
 
 	// Get the numerator, then calculate the point of intersection
-	float numerator = -1.0f * (((norm.x * start.x) + (norm.y * start.y) + (norm.z * start.z)) + distance);
+	float numerator = -1.0f * (ASVec3Dot(&norm, &start) + distance);
 	float intersect = numerator / denominator;
 
 	// Get the vector at the intersection point
-	D3DXVECTOR3 vecIntersect = D3DXVECTOR3( start.x + (dir.x * intersect),
-										    start.y + (dir.y * intersect),
-										    start.z + (dir.z * intersect));
+	ASVector3 vecIntersect = start + (dir * intersect);
 
 	// Calculate the edges of the intersect vector
-	D3DXVECTOR3 intersectEdgeA = D3DXVECTOR3( vecB.x - vecA.x, vecB.y - vecA.y, vecB.z - vecA.z );
-	D3DXVECTOR3 intersectEdgeB = D3DXVECTOR3( vecC.x - vecB.x, vecC.y - vecB.y, vecC.z - vecB.z );
-	D3DXVECTOR3 intersectEdgeC = D3DXVECTOR3( vecA.x - vecC.x, vecA.y - vecC.y, vecA.z - vecC.z );
-
-	// Calculate the normal for the first edge.
-	D3DXVECTOR3 edgeNormal = D3DXVECTOR3((intersectEdgeA.y * norm.z) - (intersectEdgeA.z * norm.y),
-										 (intersectEdgeA.z * norm.x) - (intersectEdgeA.x * norm.z),
-										 (intersectEdgeA.x * norm.y) - (intersectEdgeA.y * norm.x));
-
-	// Calculate determinant to check whether the point lies within the bounds of the
-	// vec (inside, outside or edge of given point), the determinent tells us the bounds of the point
-	// relative to the input vector - this process is repeated for each of the edges, from that
-	// a height is for the intersecting vector
-	D3DXVECTOR3 vecTmp = D3DXVECTOR3(vecIntersect.x - vecA.x,
-									 vecIntersect.y - vecA.y,
-									 vecIntersect.z - vecA.z);
-
-	float determinant = ((edgeNormal.x * vecTmp.x) + (edgeNormal.y * vecTmp.y) + (edgeNormal.z * vecTmp.z));
-
-	// Check if it is outside.
-	if(determinant > 0.001f)
-		return false;
-
-	// Calculate the normal for the second edge.
-	edgeNormal.x = (intersectEdgeB.y * norm.z) - (intersectEdgeB.z * norm.y);
-	edgeNormal.y = (intersectEdgeB.z * norm.x) - (intersectEdgeB.x * norm.z);
-	edgeNormal.z = (intersectEdgeB.x * norm.y) - (intersectEdgeB.y * norm.x);
-
-	// Calculate the determinant to see if it is on the inside, outside, or directly on the edge.
-	vecTmp.x = vecIntersect.x - vecB.x;
-	vecTmp.y = vecIntersect.y - vecB.y;
-	vecTmp.z = vecIntersect.z - vecB.z;
-
-	determinant = ((edgeNormal.x * vecTmp.x) + (edgeNormal.y * vecTmp.y) + (edgeNormal.z * vecTmp.z));
-
-	// Check if it is outside.
-	if(determinant > 0.001f)
-		return false;
+	ASVector3 intersectEdges[3] = { vecB - vecA, vecC - vecB, vecA - vecC };
+	ASVector3 corners[3]        = { vecA, vecB, vecC };
 
-	// Calculate the normal for the third edge.
-	edgeNormal.x = (intersectEdgeC.y * norm.z) - (intersectEdgeC.z * norm.y);
-	edgeNormal.y = (intersectEdgeC.z * norm.x) - (intersectEdgeC.x * norm.z);
-	edgeNormal.z = (intersectEdgeC.x * norm.y) - (intersectEdgeC.y * norm.x);
-
-	// Calculate the determinant to see if it is on the inside, outside, or directly on the edge.
-	vecTmp.x = vecIntersect.x - vecC.x;
-	vecTmp.y = vecIntersect.y - vecC.y;
-	vecTmp.z = vecIntersect.z - vecC.z;
+	// For each edge, the determinant tells us whether the point lies inside, outside
+	// or on the edge relative to that edge's normal, from that a height is found
+	// for the intersecting vector
+	for(int i = 0; i < 3; i++)
+	{
+		ASVec3Cross(&edgeNormal, &intersectEdges[i], &norm);
 
-	determinant = ((edgeNormal.x * vecTmp.x) + (edgeNormal.y * vecTmp.y) + (edgeNormal.z * vecTmp.z));
+		ASVector3 vecTmp  = vecIntersect - corners[i];
+		float determinant = ASVec3Dot(&edgeNormal, &vecTmp);
 
-	// Check if it is outside.
-	if(determinant > 0.001f)
-		return false;
+		// Check if it is outside.
+		if(determinant > 0.001f)
+			return false;
+	}
 
 	// Now we have our height.
 	heightOut = vecIntersect.y;
@@ -723,16 +936,16 @@ bool ASQuadTree::IsTriangleInQuad(int index, float posX, float posZ, float width
 	// Check if the min of the x coords are in this node, if the value is greater
 	// then we know it is outside of the node therefore return false, do the same for
 	// max values
-	float minX = __min(x1, __min(x2, x3));
+	float minX = min(x1, min(x2, x3));
 	if(minX > (posX + radius))
 		return false;
-	float maxX = __max(x1, __max(x2, x3));
+	float maxX = max(x1, max(x2, x3));
 	if(maxX < (posX - radius))
 		return false;
-	float minZ = __min(z1, __min(z2, z3));
+	float minZ = min(z1, min(z2, z3));
 	if(minZ > (posZ + radius))
 		return false;
-	float maxZ = __max(z1, __max(z2, z3));
+	float maxZ = max(z1, max(z2, z3));
 	if(maxZ < (posZ - radius))
 		return false;
 
@@ -753,9 +966,14 @@ void ASQuadTree::Release()
 	if(m_parentNode)
 	{
 		ReleaseNode(m_parentNode);
-		delete m_parentNode;
-		m_parentNode = 0;
+		m_nodePool.Free(m_parentNode);
 	}
+	m_nodePool.Release();
+
+	ReleaseMesh();
+
+	m_leaves.clear();
+	m_visibleLeaves.clear();
 }
 
 /*
@@ -776,6 +994,7 @@ void ASQuadTree::ReleaseNode(ASNode* node)
 		if(node->nodes[i] != 0)
 			ReleaseNode(node->nodes[i]);
 
+#ifndef AS_HEADLESS
 		// Dispose of all other resources for this node
 		if(node->vBuffer)
 		{
@@ -788,17 +1007,16 @@ void ASQuadTree::ReleaseNode(ASNode* node)
 			node->iBuffer->Release();
 			node->iBuffer = 0;
 		}
+#endif
 		// release the nodes vertice array
 		if(node->vertices)
 		{
-			delete [] node->vertices;
-			node->vertices = 0;
+			ASDeleteArray(node->vertices);
 		}
 		// Release child nodes once we know there are no more levels of recursoion
 		for(int j = 0; j < NODE_CHILDREN; j++)
 		{
-			delete node->nodes[i];
-			node->nodes[i] = 0;
+			m_nodePool.Free(node->nodes[i]);
 		}
 	}
 }
\ No newline at end of file
@@ -9,6 +9,16 @@
 * node the player is currently standing on, by computing if there
 * are any line intersections between the object and the finite
 * amount of triangles in the current quad)
+*
+* Several views, such as the camera, a minimap and shadow cascades,
+* can be culled in one walk of the tree.  Each node's children are
+* gathered once and tested against every view that can still see
+* the node, a view drops out of a branch as soon as it cannot see
+* it, and the walk ends in a list of visible leaves for each view
+*
+* Building the tree is split from creating its buffers, Build()
+* only needs the terrain so a headless build can build and cull
+* the same tree the renderer draws
 *******************************************************************
 */
 
@@ -23,7 +33,18 @@
 
 #include "ASTerrain.h"
 #include "ASFrustrum.h"
+#include "ASProfiler.h"
+#include "ASMemory.h"
+#include "ASPool.h"
+#include <vector>
+#include <fstream>
+#include <algorithm>
+
+#ifndef AS_HEADLESS
 #include "ASTerrainShader.h"
+#endif
+
+using namespace std;
 
 /*
 ******************************************************************
@@ -38,14 +59,15 @@ private:
 	// Configuration constants
 	static const int NODE_CHILDREN = 4;    // how many children does each node have
 	static const int MAX_TRIANGLES = 15000;	// Determines the number of triangles that can be rendered at one time
+	static const int NODE_POOL_CHUNK = 256;	// nodes the pool takes from the heap at a time
 
 	// Requires an ASVertex struct to pass vertex information to shader
 	struct ASVertex 
 	{
-		D3DXVECTOR3 pos;
-		D3DXVECTOR4 texCoord;
-		D3DXVECTOR3 norm;
-		D3DXVECTOR4 color;
+		ASVector3 pos;
+		ASVector4 texCoord;
+		ASVector3 norm;
+		ASVector4 color;
 	};
 	// Holds x,y,z coordinates
 	struct ASVector
@@ -61,41 +83,64 @@ private:
 		float         posX, posZ;
 		float         width;
 		int           numTriangles;
+#ifndef AS_HEADLESS
 		ID3D11Buffer* vBuffer;
 		ID3D11Buffer* iBuffer;
+#endif
 		ASVector*     vertices;
 		ASNode*       nodes[NODE_CHILDREN];   
+		int           leaf;				// index into m_leaves, -1 unless the node holds triangles
 	};
 public:
+	// Most views one traversal can cull for, one bit each in a mask
+	static const int MAX_VIEWS = 8;
+
 	// Constructors / Destructor prototype
 	ASQuadTree();
 	ASQuadTree(const ASQuadTree&);
 	~ASQuadTree();
 
 	// Public methods
+#ifndef AS_HEADLESS
 	bool Init(ID3D11Device*, ASTerrain*);
+	bool CreateBuffers(ID3D11Device*);
 	void Render(ASFrustrum*, ASTerrainShader*, ID3D11DeviceContext*);
+	void RenderLeaves(const vector<int>&, ASTerrainShader*, ID3D11DeviceContext*);
+#endif
+	bool Build(ASTerrain*);
+	void ReleaseMesh();
+	void CullViews(ASFrustrum**, int, vector<int>*);
+	void Benchmark(ASFrustrum**, int, int);
+	int  GetLeafCount();
+	int  GetLeafTriangles(int);
 	bool GetTerrainHeightAtPosition(float, float, float&);
 	int  GetPolyCount();
+	int  GetNodesVisited();
+	int  GetLeavesDrawn();
 
 	void Release();
 
 private:
 	// Private methods
 	void GetMeshDimensions(int, float&, float&, float&);
-	void AppendNode(ASNode*, float, float, float, ID3D11Device*);
+	void AppendNode(ASNode*, float, float, float);
 	void GetNodeAtPosition(ASNode*, float, float, float&);
-	bool GetTriangleHeightAtPosition(float, float, float&, D3DXVECTOR3, D3DXVECTOR3, D3DXVECTOR3);
+	bool GetTriangleHeightAtPosition(float, float, float&, ASVector3, ASVector3, ASVector3);
 	int  GetTriangleCount(float, float, float);
 	bool IsTriangleInQuad(int, float, float, float);
-	void RenderNode(ASNode*, ASFrustrum*, ID3D11DeviceContext*, ASTerrainShader*);
+	void CullNode(ASNode*, unsigned int, ASFrustrum**, vector<int>*);
 	void ReleaseNode(ASNode*);
 
 	// Private member variables
-	ASVertex* m_vertices;		// List of vertices of mesh
+	ASVertex* m_vertices;		// List of vertices of mesh, only kept until the buffers are made
 	ASNode*   m_parentNode;		// Children nodes can be chained from this parent
 	int		  m_numTriangles;
 	int		  m_numPolys;
+	int		  m_numNodesVisited;	// nodes the last CullViews() tested against the views
+	int		  m_numLeavesDrawn;		// leaves the last RenderLeaves() drew
+	vector<ASNode*> m_leaves;		// every node that holds triangles, in drawing order
+	vector<int>     m_visibleLeaves;	// leaves Render() found, kept to reuse its memory
+	ASPool<ASNode>  m_nodePool;		// every node in the tree
 
 
 };
@@ -0,0 +1,645 @@
+/*
+******************************************************************
+* ASResourceManager.cpp
+*******************************************************************
+* Implements all methods from ASResourceManager.h
+*******************************************************************
+*/
+
+#include "ASResourceManager.h"
+
+/*
+*******************************************************************
+* Constructor
+*******************************************************************
+*/
+
+ASResourceManager::ASResourceManager()
+{
+	for(int i = 0; i < NUM_RESOURCE_TYPES; i++)
+	{
+		m_hits[i]   = 0;
+		m_misses[i] = 0;
+	}
+}
+
+/*
+*******************************************************************
+* Empty Constructor
+*******************************************************************
+*/
+
+ASResourceManager::ASResourceManager(const ASResourceManager&)
+{}
+
+/*
+*******************************************************************
+* Destructor
+*******************************************************************
+*/
+
+ASResourceManager::~ASResourceManager()
+{}
+
+/*
+*******************************************************************
+* METHOD: Get Instance
+*******************************************************************
+* Every loader shares the one manager, so a file is only ever
+* resident once however many objects use it
+*
+* @return ASResourceManager* - the manager
+*/
+
+ASResourceManager* ASResourceManager::GetInstance()
+{
+	static ASResourceManager manager;
+	return &manager;
+}
+
+/*
+*******************************************************************
+* METHOD: Acquire Texture
+*******************************************************************
+* Loads a texture, or hands out the one already loaded from the
+* same file.  The caller owns one reference to the view
+*
+* @param ID3D11Device* - the device to load the texture with
+* @param WCHAR*        - the texture file
+*
+* @return ID3D11ShaderResourceView* - the texture, 0 if it could not be loaded
+*/
+
+ID3D11ShaderResourceView* ASResourceManager::AcquireTexture(ID3D11Device* device, WCHAR* file)
+{
+	ID3D11ShaderResourceView* view = 0;
+	string key;
+
+	NormalisePath(file, key);
+	key = "texture:" + key;
+
+	ASResourceTable::iterator it = m_resources.find(key);
+	if(it != m_resources.end())
+	{
+		m_hits[RESOURCE_TEXTURE]++;
+		view = (ID3D11ShaderResourceView*)it->second.object;
+		view->AddRef();
+		return view;
+	}
+
+	HRESULT hr = D3DX11CreateShaderResourceViewFromFile(device, file, NULL, NULL, &view, NULL);
+	if(FAILED(hr))
+		return 0;
+
+	m_misses[RESOURCE_TEXTURE]++;
+
+	// The table keeps the reference the load gave us, the caller gets a new one
+	ASResource& res = m_resources[key];
+	memset(&res, 0, sizeof(res));
+	res.type   = RESOURCE_TEXTURE;
+	res.object = view;
+	res.bytes  = CalculateTextureBytes(view);
+
+	view->AddRef();
+	return view;
+}
+
+/*
+*******************************************************************
+* METHOD: Acquire Mesh
+*******************************************************************
+* Looks for a mesh that has already been loaded from a model file.
+* When one is found the caller owns one reference to each of its
+* buffers
+*
+* @param const char* - the model file
+* @param ASMeshData& - output parameter for the shared mesh
+*
+* @return bool - True if the mesh was already resident, else false
+*/
+
+bool ASResourceManager::AcquireMesh(const char* file, ASMeshData& mesh)
+{
+	AS_PROFILE("ASResourceManager::AcquireMesh");
+
+	string key;
+
+	NormalisePath(file, key);
+	key = "mesh:" + key;
+
+	ASResourceTable::iterator it = m_resources.find(key);
+	if(it == m_resources.end())
+	{
+		m_misses[RESOURCE_MESH]++;
+		return false;
+	}
+
+	m_hits[RESOURCE_MESH]++;
+	mesh = it->second.mesh;
+	mesh.vertexBuffer->AddRef();
+	mesh.indexBuffer->AddRef();
+
+	return true;
+}
+
+/*
+*******************************************************************
+* METHOD: Add Mesh
+*******************************************************************
+* Registers a mesh that has just been loaded so that the next model
+* using the same file can share it.  The manager takes its own
+* references, the caller keeps the ones it has
+*
+* @param const char*       - the model file the mesh was loaded from
+* @param const ASMeshData& - the mesh
+*/
+
+void ASResourceManager::AddMesh(const char* file, const ASMeshData& mesh)
+{
+	string key;
+
+	NormalisePath(file, key);
+	key = "mesh:" + key;
+
+	if(m_resources.find(key) != m_resources.end())
+		return;
+
+	ASResource& res = m_resources[key];
+	memset(&res, 0, sizeof(res));
+	res.type   = RESOURCE_MESH;
+	res.object = mesh.vertexBuffer;
+	res.mesh   = mesh;
+	res.bytes  = (unsigned long long)mesh.vertexStride * mesh.numVertices +
+				 (unsigned long long)((mesh.indexFormat == DXGI_FORMAT_R16_UINT) ? 2 : 4) * mesh.numIndices;
+
+	mesh.vertexBuffer->AddRef();
+	mesh.indexBuffer->AddRef();
+}
+
+/*
+*******************************************************************
+* METHOD: Acquire Vertex Shader
+*******************************************************************
+* Compiles and creates a vertex shader, or hands out the one
+* already made from the same file and entry point.  The caller owns
+* one reference to the shader and one to its byte code
+*
+* @param ID3D11Device*        - the device to create the shader with
+* @param WCHAR*               - the shader file
+* @param char*                - the entry point
+* @param ID3D11VertexShader** - output for the shader
+* @param ID3D10Blob**         - output for the byte code, used to create input layouts
+* @param ID3D10Blob**         - output for the compiler errors, 0 if there were none
+*
+* @return HRESULT - the result of compiling or creating the shader
+*/
+
+HRESULT ASResourceManager::AcquireVertexShader(ID3D11Device* device, WCHAR* file, char* entry,
+											   ID3D11VertexShader** shader, ID3D10Blob** byteCode, ID3D10Blob** err)
+{
+	ID3D11VertexShader* vShader  = 0;
+	ID3D10Blob*         vsBuffer = 0;
+	string key;
+	HRESULT hr;
+
+	*err = 0;
+	NormalisePath(file, key);
+	key = "vs:" + key + "|" + entry;
+
+	ASResourceTable::iterator it = m_resources.find(key);
+	if(it != m_resources.end())
+	{
+		m_hits[RESOURCE_SHADER]++;
+		*shader   = (ID3D11VertexShader*)it->second.object;
+		*byteCode = it->second.byteCode;
+		(*shader)->AddRef();
+		(*byteCode)->AddRef();
+		return S_OK;
+	}
+
+	hr = D3DX11CompileFromFile(file, NULL, NULL, entry, "vs_5_0", D3D10_SHADER_ENABLE_STRICTNESS,
+							   0, NULL, &vsBuffer, err, NULL);
+	if(FAILED(hr))
+		return hr;
+
+	hr = device->CreateVertexShader(vsBuffer->GetBufferPointer(), vsBuffer->GetBufferSize(), NULL, &vShader);
+	if(FAILED(hr))
+	{
+		vsBuffer->Release();
+		return hr;
+	}
+
+	m_misses[RESOURCE_SHADER]++;
+
+	ASResource& res = m_resources[key];
+	memset(&res, 0, sizeof(res));
+	res.type     = RESOURCE_SHADER;
+	res.object   = vShader;
+	res.byteCode = vsBuffer;
+	res.bytes    = vsBuffer->GetBufferSize();
+
+	vShader->AddRef();
+	vsBuffer->AddRef();
+	*shader   = vShader;
+	*byteCode = vsBuffer;
+
+	return S_OK;
+}
+
+/*
+*******************************************************************
+* METHOD: Acquire Pixel Shader
+*******************************************************************
+* Compiles and creates a pixel shader, or hands out the one already
+* made from the same file and entry point.  The caller owns one
+* reference to the shader
+*
+* @param ID3D11Device*       - the device to create the shader with
+* @param WCHAR*              - the shader file
+* @param char*               - the entry point
+* @param ID3D11PixelShader** - output for the shader
+* @param ID3D10Blob**        - output for the compiler errors, 0 if there were none
+*
+* @return HRESULT - the result of compiling or creating the shader
+*/
+
+HRESULT ASResourceManager::AcquirePixelShader(ID3D11Device* device, WCHAR* file, char* entry,
+											  ID3D11PixelShader** shader, ID3D10Blob** err)
+{
+	ID3D11PixelShader* pShader  = 0;
+	ID3D10Blob*        psBuffer = 0;
+	string key;
+	HRESULT hr;
+
+	*err = 0;
+	NormalisePath(file, key);
+	key = "ps:" + key + "|" + entry;
+
+	ASResourceTable::iterator it = m_resources.find(key);
+	if(it != m_resources.end())
+	{
+		m_hits[RESOURCE_SHADER]++;
+		*shader = (ID3D11PixelShader*)it->second.object;
+		(*shader)->AddRef();
+		return S_OK;
+	}
+
+	hr = D3DX11CompileFromFile(file, NULL, NULL, entry, "ps_5_0", D3D10_SHADER_ENABLE_STRICTNESS,
+							   0, NULL, &psBuffer, err, NULL);
+	if(FAILED(hr))
+		return hr;
+
+	hr = device->CreatePixelShader(psBuffer->GetBufferPointer(), psBuffer->GetBufferSize(), NULL, &pShader);
+	unsigned long long bytes = psBuffer->GetBufferSize();
+
+	// Pixel shaders never need their byte code again
+	psBuffer->Release();
+	if(FAILED(hr))
+		return hr;
+
+	m_misses[RESOURCE_SHADER]++;
+
+	ASResource& res = m_resources[key];
+	memset(&res, 0, sizeof(res));
+	res.type   = RESOURCE_SHADER;
+	res.object = pShader;
+	res.bytes  = bytes;
+
+	pShader->AddRef();
+	*shader = pShader;
+
+	return S_OK;
+}
+
+/*
+*******************************************************************
+* METHOD: Release Unused
+*******************************************************************
+* Drops every resource that only the manager still references, this
+* is the point where memory shared between loaders is given back
+*
+* @return int - the number of resources released
+*/
+
+int ASResourceManager::ReleaseUnused()
+{
+	int numReleased = 0;
+
+	ASResourceTable::iterator it = m_resources.begin();
+	while(it != m_resources.end())
+	{
+		// Release() returns the count that remains, so this reads the count without changing it
+		it->second.object->AddRef();
+		if(it->second.object->Release() == 1)
+		{
+			ReleaseResource(it->second);
+			it = m_resources.erase(it);
+			numReleased++;
+		}
+		else
+		{
+			++it;
+		}
+	}
+
+	return numReleased;
+}
+
+/*
+*******************************************************************
+* METHOD: Release
+*******************************************************************
+* Drops the manager's reference to every resource, objects that
+* still hold a handle keep it alive until they release it
+*/
+
+void ASResourceManager::Release()
+{
+	for(ASResourceTable::iterator it = m_resources.begin(); it != m_resources.end(); ++it)
+		ReleaseResource(it->second);
+
+	m_resources.clear();
+}
+
+/*
+*******************************************************************
+* METHOD: Get Resident Bytes
+*******************************************************************
+* @param ASResourceType - the type of resource to total
+*
+* @return unsigned long long - the bytes held by resources of that type
+*/
+
+unsigned long long ASResourceManager::GetResidentBytes(ASResourceType type)
+{
+	unsigned long long bytes = 0;
+
+	for(ASResourceTable::iterator it = m_resources.begin(); it != m_resources.end(); ++it)
+	{
+		if(it->second.type == type)
+			bytes += it->second.bytes;
+	}
+
+	return bytes;
+}
+
+/*
+*******************************************************************
+* METHOD: Get Resource Count
+*******************************************************************
+* @param ASResourceType - the type of resource to count
+*
+* @return int - the number of resident resources of that type
+*/
+
+int ASResourceManager::GetResourceCount(ASResourceType type)
+{
+	int count = 0;
+
+	for(ASResourceTable::iterator it = m_resources.begin(); it != m_resources.end(); ++it)
+	{
+		if(it->second.type == type)
+			count++;
+	}
+
+	return count;
+}
+
+/*
+*******************************************************************
+* METHOD: Report
+*******************************************************************
+* Appends the resident resources of each type to a log, along with
+* how many requests were served by a resource that was already
+* loaded
+*
+* @param const char* - a label for this report, such as "after load"
+*/
+
+void ASResourceManager::Report(const char* label)
+{
+	static const char* TYPE_NAMES[NUM_RESOURCE_TYPES] = { "textures", "meshes", "shaders" };
+	ofstream fout;
+
+	fout.open("./log/resources.txt", ios::app);
+	if(fout.fail())
+		return;
+
+	fout << "Resources " << label << ":" << endl;
+	for(int i = 0; i < NUM_RESOURCE_TYPES; i++)
+	{
+		ASResourceType type = (ASResourceType)i;
+		fout << "  " << TYPE_NAMES[i] << ": " << GetResourceCount(type) << " resident, "
+			 << (GetResidentBytes(type) / 1024) << " KB, " << m_hits[i] << " shared loads, "
+			 << m_misses[i] << " loaded from disk" << endl;
+	}
+
+	fout.close();
+}
+
+/*
+*******************************************************************
+* METHOD: Normalise Path
+*******************************************************************
+* Turns a file name into the key its resource is stored under so
+* that different spellings of one file share an entry: the path is
+* lower cased, uses forward slashes and has its "." and ".."
+* segments resolved (.\Textures\..\textures\rock.dds becomes
+* textures/rock.dds)
+*
+* @param const char* - the file name
+* @param string&     - output parameter for the key
+*/
+
+void ASResourceManager::NormalisePath(const char* file, string& key)
+{
+	string segment;
+	string prefix;
+	vector<string> segments;
+
+	const char* curr = file;
+
+	// Keep the root of absolute paths, it is not a segment that ".." may remove
+	if(curr[0] && curr[1] == ':')
+	{
+		prefix += (char)tolower((unsigned char)curr[0]);
+		prefix += ':';
+		curr += 2;
+	}
+	if(*curr == '/' || *curr == '\\')
+		prefix += '/';
+
+	for(;; curr++)
+	{
+		if(*curr == '/' || *curr == '\\' || *curr == 0)
+		{
+			if(segment == "..")
+			{
+				if(!segments.empty() && segments.back() != "..")
+					segments.pop_back();
+				else if(prefix.empty())
+					segments.push_back(segment);
+			}
+			else if(!segment.empty() && segment != ".")
+			{
+				segments.push_back(segment);
+			}
+			segment.clear();
+
+			if(*curr == 0)
+				break;
+		}
+		else
+		{
+			segment += (char)tolower((unsigned char)*curr);
+		}
+	}
+
+	key = prefix;
+	for(unsigned int i = 0; i < segments.size(); i++)
+	{
+		if(i > 0)
+			key += '/';
+		key += segments[i];
+	}
+}
+
+/*
+*******************************************************************
+* METHOD: Normalise Path
+*******************************************************************
+* Wide character version, the name is converted to UTF-8 first so
+* both versions build the same key for the same file
+*
+* @param const WCHAR* - the file name
+* @param string&      - output parameter for the key
+*/
+
+void ASResourceManager::NormalisePath(const WCHAR* file, string& key)
+{
+	string narrow;
+
+	for(const WCHAR* curr = file; *curr; curr++)
+	{
+		unsigned int c = (unsigned int)*curr;
+
+		if(c < 0x80)
+		{
+			narrow += (char)c;
+		}
+		else if(c < 0x800)
+		{
+			narrow += (char)(0xC0 | (c >> 6));
+			narrow += (char)(0x80 | (c & 0x3F));
+		}
+		else
+		{
+			narrow += (char)(0xE0 | (c >> 12));
+			narrow += (char)(0x80 | ((c >> 6) & 0x3F));
+			narrow += (char)(0x80 | (c & 0x3F));
+		}
+	}
+
+	NormalisePath(narrow.c_str(), key);
+}
+
+/*
+*******************************************************************
+* METHOD: Release Resource
+*******************************************************************
+* Drops the manager's references to one entry
+*
+* @param ASResource& - the entry to release
+*/
+
+void ASResourceManager::ReleaseResource(ASResource& res)
+{
+	if(res.type == RESOURCE_MESH && res.mesh.indexBuffer)
+	{
+		res.mesh.indexBuffer->Release();
+		res.mesh.indexBuffer = 0;
+	}
+	if(res.byteCode)
+	{
+		res.byteCode->Release();
+		res.byteCode = 0;
+	}
+	if(res.object)
+	{
+		res.object->Release();
+		res.object = 0;
+	}
+}
+
+/*
+*******************************************************************
+* METHOD: Calculate Texture Bytes
+*******************************************************************
+* Works out how much video memory a 2D texture occupies from its
+* description, counting every mip level and array slice.  Block
+* compressed formats are sized in whole 4x4 blocks
+*
+* @param ID3D11ShaderResourceView* - a view of the texture
+*
+* @return unsigned long long - the size of the texture in bytes
+*/
+
+unsigned long long ASResourceManager::CalculateTextureBytes(ID3D11ShaderResourceView* view)
+{
+	ID3D11Resource* resource = 0;
+	D3D11_RESOURCE_DIMENSION dimension;
+	D3D11_TEXTURE2D_DESC desc;
+	unsigned long long bytes = 0;
+
+	view->GetResource(&resource);
+	if(!resource)
+		return 0;
+
+	resource->GetType(&dimension);
+	if(dimension != D3D11_RESOURCE_DIMENSION_TEXTURE2D)
+	{
+		resource->Release();
+		return 0;
+	}
+
+	((ID3D11Texture2D*)resource)->GetDesc(&desc);
+	resource->Release();
+
+	// Bytes per pixel, or per 4x4 block for the compressed formats
+	unsigned int unitBytes;
+	bool         blocks = true;
+
+	switch(desc.Format)
+	{
+	case DXGI_FORMAT_BC1_UNORM:
+	case DXGI_FORMAT_BC4_UNORM:
+		unitBytes = 8;
+		break;
+	case DXGI_FORMAT_BC2_UNORM:
+	case DXGI_FORMAT_BC3_UNORM:
+	case DXGI_FORMAT_BC5_UNORM:
+		unitBytes = 16;
+		break;
+	case DXGI_FORMAT_R32G32B32A32_FLOAT:
+		unitBytes = 16;
+		blocks    = false;
+		break;
+	default:
+		unitBytes = 4;
+		blocks    = false;
+		break;
+	}
+
+	for(unsigned int mip = 0; mip < desc.MipLevels; mip++)
+	{
+		unsigned long long width  = (desc.Width  >> mip) ? (desc.Width  >> mip) : 1;
+		unsigned long long height = (desc.Height >> mip) ? (desc.Height >> mip) : 1;
+
+		if(blocks)
+			bytes += ((width + 3) / 4) * ((height + 3) / 4) * unitBytes;
+		else
+			bytes += width * height * unitBytes;
+	}
+
+	return bytes * desc.ArraySize;
+}
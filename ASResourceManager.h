@@ -0,0 +1,124 @@
+/*
+******************************************************************
+* ASResourceManager.h
+*******************************************************************
+* Shares GPU resources between everything that loads them.  Each
+* texture, mesh and shader is loaded once and kept in a table keyed
+* by its normalised path, later requests for the same file get the
+* resource that is already resident.
+*
+* The handles given out are the D3D interfaces themselves, every
+* Acquire call adds a COM reference that the caller releases with
+* the Release() it already uses.  The manager holds one more
+* reference of its own, so ReleaseUnused() can tell which entries
+* nobody else is using any more and drop them
+*******************************************************************
+*/
+
+#ifndef _ASRESOURCEMANAGER_H_
+#define _ASRESOURCEMANAGER_H_
+
+/*
+*******************************************************************
+* Includes:
+*******************************************************************
+* + ASMeshCache.h has been included for the level of detail table
+*   a shared mesh carries
+* + ASProfiler.h has been included to time loading
+*******************************************************************
+*/
+
+#include <d3d11.h>
+#include <d3dx11tex.h>
+#include <d3dx11async.h>
+#include <unordered_map>
+#include <string>
+#include <vector>
+#include <ctype.h>
+#include <fstream>
+#include "ASMeshCache.h"
+#include "ASProfiler.h"
+
+using namespace std;
+
+/*
+*******************************************************************
+* Class declaration
+*******************************************************************
+*/
+
+class ASResourceManager
+{
+public:
+	enum ASResourceType
+	{
+		RESOURCE_TEXTURE,
+		RESOURCE_MESH,
+		RESOURCE_SHADER,
+		NUM_RESOURCE_TYPES
+	};
+
+	// Everything ASModel needs to draw a mesh it did not load itself
+	struct ASMeshData
+	{
+		ID3D11Buffer*      vertexBuffer;
+		ID3D11Buffer*      indexBuffer;
+		DXGI_FORMAT        indexFormat;
+		unsigned int       vertexStride;
+		int                numVertices;
+		int                numIndices;
+		ASMeshCache::ASLod lods[ASMeshCache::MAX_LODS];
+		int                numLods;
+		float              radius;
+		float              center[3];
+	};
+
+private:
+	struct ASResource
+	{
+		ASResourceType      type;
+		unsigned long long  bytes;
+		IUnknown*           object;		// the view, vertex buffer or shader the entry owns
+		ID3D10Blob*         byteCode;	// vertex shaders keep their byte code for input layouts
+		ASMeshData          mesh;
+	};
+	typedef unordered_map<string, ASResource> ASResourceTable;
+
+public:
+	// Constructors and destructor
+	ASResourceManager();
+	ASResourceManager(const ASResourceManager&);
+	~ASResourceManager();
+
+	static ASResourceManager* GetInstance();
+
+	// Public methods
+	ID3D11ShaderResourceView* AcquireTexture(ID3D11Device*, WCHAR*);
+	bool    AcquireMesh(const char*, ASMeshData&);
+	void    AddMesh(const char*, const ASMeshData&);
+	HRESULT AcquireVertexShader(ID3D11Device*, WCHAR*, char*, ID3D11VertexShader**, ID3D10Blob**, ID3D10Blob**);
+	HRESULT AcquirePixelShader(ID3D11Device*, WCHAR*, char*, ID3D11PixelShader**, ID3D10Blob**);
+
+	int  ReleaseUnused();
+	void Release();
+
+	unsigned long long GetResidentBytes(ASResourceType);
+	int  GetResourceCount(ASResourceType);
+	void Report(const char*);
+
+	static void NormalisePath(const WCHAR*, string&);
+	static void NormalisePath(const char*, string&);
+
+private:
+	// Private methods
+	void ReleaseResource(ASResource&);
+
+	static unsigned long long CalculateTextureBytes(ID3D11ShaderResourceView*);
+
+	// Private member variables
+	ASResourceTable m_resources;
+	int             m_hits[NUM_RESOURCE_TYPES];
+	int             m_misses[NUM_RESOURCE_TYPES];
+};
+
+#endif
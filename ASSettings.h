@@ -0,0 +1,36 @@
+/*
+******************************************************************
+* ASSettings.h
+*******************************************************************
+* Settings for the screen and the world that both graphics
+* backends, ASGraphics and ASNullGraphics, share with the engine
+*******************************************************************
+*/
+
+#ifndef _ASSETTINGS_H_
+#define _ASSETTINGS_H_
+
+/*
+*******************************************************************
+* Global configuration constants
+*******************************************************************
+*/
+
+const bool  FULL_SCREEN   = false;
+const bool  VSYNC_ENABLED = true;
+const float SCREEN_DEPTH  = 1000.0f;
+const float SCREEN_NEAR   = 1.25f;
+
+// Number of enemies in the world, they are all drawn with instancing
+const int NUM_ENEMIES = 30;
+
+// Spawn coordinates for the player in the world
+const float SPAWN_X = 20.0f;
+const float SPAWN_Y = 2.0f;
+const float SPAWN_Z = 0.0f;
+
+// Height map and colour map the terrain is built from
+const char* const TERRAIN_HEIGHT_MAP = "./Textures/mapC.bmp";
+const char* const TERRAIN_COLOR_MAP  = "./Textures/colorMap.bmp";
+
+#endif
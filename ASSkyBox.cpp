@@ -19,9 +19,12 @@
 
 ASSkyBox::ASSkyBox()
 {
-	m_vBuffer = 0;
-	m_iBuffer = 0;
-	m_mesh    = 0;
+	m_vBuffer      = 0;
+	m_iBuffer      = 0;
+	m_mesh         = 0;
+	m_startIndex   = 0;
+	m_vertexStride = sizeof(ASVertex);
+	m_indexFormat  = DXGI_FORMAT_R32_UINT;
 }
 
 /*
@@ -47,20 +50,44 @@ ASSkyBox::~ASSkyBox()
 * METHOD: Init
 *******************************************************************
 * Initialise the skybox object by loading the model and then 
-* passing the vertex and index data to the buffers ready for rendering
+* passing the vertex and index data to the buffers ready for rendering,
+* the .asmesh cache of the model is used when it is up to date and
+* rebuilt from the text file when it is not
 */
 
 bool ASSkyBox::Init(ID3D11Device* device)
 {
-	// Attempt to load the model for the skybox
-	bool success = LoadSkyBox("./models/skybox.txt");
-	if(!success)
-		return false;
+	AS_PROFILE("ASSkyBox::Init");
 
-	// Initialise the index and vertex buffers
-	success = InitBuffers(device);
-	if(!success)
-		return false;
+	char* modelFile = "./models/skybox.txt";
+	char  cacheFile[MAX_PATH];
+	bool  success;
+
+	ASMeshCache::GetCachePath(modelFile, cacheFile, MAX_PATH);
+
+	if(!LoadCachedSkyBox(device, cacheFile, modelFile))
+	{
+		// Attempt to load the model for the skybox
+		success = LoadSkyBox(modelFile);
+		if(!success)
+			return false;
+
+		// Initialise the index and vertex buffers
+		success = InitBuffers(device);
+		if(!success)
+			return false;
+
+		// Rebuild the cache for next time, a failure here is not fatal.  The mesh
+		// is written with every attribute and a single level of detail so the same
+		// cache also loads as an ASModel
+		ASMeshCache::ASLod lod;
+		lod.startIndex = 0;
+		lod.numIndices = m_numIndices;
+		lod.error      = 0.0f;
+
+		ASMeshCache cache;
+		cache.Write(cacheFile, modelFile, m_mesh, sizeof(ASMesh), m_numVertices, 0, m_numIndices, &lod, 1);
+	}
 
 	// Initialise the colors for the sky (map loaded in is greatscale, this will apply
 	// two highlight colours to give the sky depth)
@@ -145,6 +172,88 @@ bool ASSkyBox::InitBuffers(ID3D11Device* device)
 	return true;
 }
 
+/*
+*******************************************************************
+* METHOD: Load Cached Sky Box
+*******************************************************************
+* Maps the skybox's .asmesh cache and creates the buffers straight
+* from the mapped streams.  The cache holds the full model layout,
+* only the position at the front of each vertex is read by the sky
+* shader so the buffer is simply bound with the cache's stride.
+* The sky is drawn at full detail, the cache's first level
+*
+* @param ID3D11Device* - the device we are rendering with
+* @param char*         - the cache file
+* @param char*         - the text file the cache was built from
+* @return bool - True if the buffers were created, false if the
+*                cache is missing or stale
+*/
+
+bool ASSkyBox::LoadCachedSkyBox(ID3D11Device* device, char* cacheFile, char* modelFile)
+{
+	ASMeshCache cache;
+	D3D11_BUFFER_DESC vBufferDesc;
+	D3D11_BUFFER_DESC iBufferDesc;
+	D3D11_SUBRESOURCE_DATA iData;
+	D3D11_SUBRESOURCE_DATA vData;
+	HRESULT hr;
+
+	if(!cache.Open(cacheFile, modelFile, sizeof(ASVertex)))
+		return false;
+
+	const ASMeshCache::ASHeader* header = cache.GetHeader();
+
+	m_numVertices  = header->numVertices;
+	m_numIndices   = header->lods[0].numIndices;
+	m_startIndex   = header->lods[0].startIndex;
+	m_vertexStride = header->vertexStride;
+	m_indexFormat  = cache.GetIndexFormat();
+
+	/*
+	* Describe the vertex buffer
+	*/ 
+
+	vBufferDesc.Usage = D3D11_USAGE_DEFAULT;
+	vBufferDesc.ByteWidth = header->vertexStride * header->numVertices;
+	vBufferDesc.BindFlags = D3D11_BIND_VERTEX_BUFFER;
+	vBufferDesc.CPUAccessFlags = 0;
+	vBufferDesc.MiscFlags = 0;
+	vBufferDesc.StructureByteStride = 0;
+
+	vData.pSysMem = cache.GetVertices();
+	vData.SysMemPitch = 0;
+	vData.SysMemSlicePitch = 0;
+
+	hr = device->CreateBuffer(&vBufferDesc, &vData, &m_vBuffer);
+	if(FAILED(hr))
+		return false;
+
+	/*
+	* Describe the index buffer
+	*/
+
+	iBufferDesc.Usage = D3D11_USAGE_DEFAULT;
+	iBufferDesc.ByteWidth = header->indexSize * header->numIndices;
+	iBufferDesc.BindFlags = D3D11_BIND_INDEX_BUFFER;
+	iBufferDesc.CPUAccessFlags = 0;
+	iBufferDesc.MiscFlags = 0;
+	iBufferDesc.StructureByteStride = 0;
+
+	iData.pSysMem = cache.GetIndices();
+	iData.SysMemPitch = 0;
+	iData.SysMemSlicePitch = 0;
+
+	hr = device->CreateBuffer(&iBufferDesc, &iData, &m_iBuffer);
+	if(FAILED(hr))
+	{
+		m_vBuffer->Release();
+		m_vBuffer = 0;
+		return false;
+	}
+
+	return true;
+}
+
 /*
 *******************************************************************
 * METHOD: Render
@@ -156,12 +265,12 @@ bool ASSkyBox::InitBuffers(ID3D11Device* device)
 void ASSkyBox::Render(ID3D11DeviceContext* deviceCtx)
 {
 	// Describe how the buffers should be layed out in memory
-	unsigned int stride = sizeof(ASVertex);
+	unsigned int stride = m_vertexStride;
 	unsigned int offset = 0;
 
 	// Set the buffers on the device
 	deviceCtx->IASetVertexBuffers(0, 1, &m_vBuffer, &stride, &offset);
-	deviceCtx->IASetIndexBuffer(m_iBuffer, DXGI_FORMAT_R32_UINT, 0);
+	deviceCtx->IASetIndexBuffer(m_iBuffer, m_indexFormat, 0);
 	deviceCtx->IASetPrimitiveTopology(D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST);
 }
 
@@ -177,6 +286,18 @@ int ASSkyBox::GetNumIndices()
 	return m_numIndices;
 }
 
+/*
+*******************************************************************
+* METHOD: Get Start Index
+*******************************************************************
+* Returns the first index of the mesh in the index buffer
+*/
+
+int ASSkyBox::GetStartIndex()
+{
+	return m_startIndex;
+}
+
 /*
 *******************************************************************
 * METHOD: Get Color A
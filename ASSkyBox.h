@@ -20,6 +20,8 @@
 #include <d3d11.h>
 #include <d3dx10math.h>
 #include <fstream>
+#include "ASMeshCache.h"
+#include "ASProfiler.h"
 
 // Use the std namespace to make our life easier calling funcs from the namespace
 using namespace std;
@@ -76,6 +78,7 @@ public:
 	void Release();
 
 	int GetNumIndices();
+	int GetStartIndex();
 	D3DXVECTOR4 GetColorA();
 	D3DXVECTOR4 GetColorB();
 
@@ -83,6 +86,7 @@ private:
 	// Private methods
 	bool InitBuffers(ID3D11Device*);
 	bool LoadSkyBox(char*);
+	bool LoadCachedSkyBox(ID3D11Device*, char*, char*);
 	bool LoadModel(char*);
 
 	// Private member variables
@@ -90,7 +94,10 @@ private:
 	ID3D11Buffer* m_iBuffer;
 	int			  m_numVertices;
 	int			  m_numIndices;
+	int			  m_startIndex;
 	ASMesh*		  m_mesh;
+	unsigned int  m_vertexStride;
+	DXGI_FORMAT   m_indexFormat;
 	D3DXVECTOR4   m_skyColorA;
 	D3DXVECTOR4	  m_skyColorB;
 
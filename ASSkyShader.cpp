@@ -57,14 +57,13 @@ bool ASSkyShader::Init(ID3D11Device* device, HWND handle, WCHAR* vs, WCHAR* ps)
 	// Set pointers to 0 and declare other local vars
 	ID3D10Blob* err	     = 0;
 	ID3D10Blob* vsBuffer = 0;
-	ID3D10Blob* psBuffer = 0;
 	D3D11_INPUT_ELEMENT_DESC vLayout[1];
 	D3D11_BUFFER_DESC cBufferDesc;
 	D3D11_BUFFER_DESC gBufferDesc;
 	HRESULT hr;
 
 	// Compile the vertex shader
-	hr = D3DX11CompileFromFile(vs, NULL, NULL, "ASSkyVertexShader", "vs_5_0", D3D10_SHADER_ENABLE_STRICTNESS, 0, NULL, &vsBuffer, &err, NULL);
+	hr = ASResourceManager::GetInstance()->AcquireVertexShader(device, vs, "ASSkyVertexShader", &m_vShader, &vsBuffer, &err);
 	if(FAILED(hr))
 	{
 		if(err)
@@ -74,7 +73,7 @@ bool ASSkyShader::Init(ID3D11Device* device, HWND handle, WCHAR* vs, WCHAR* ps)
 		return false;
 	}
 	// Compile the pixel shader
-	hr = D3DX11CompileFromFile(ps, NULL, NULL, "ASSkyPixelShader", "ps_5_0", D3D10_SHADER_ENABLE_STRICTNESS, 0, NULL, &psBuffer, &err, NULL);
+	hr = ASResourceManager::GetInstance()->AcquirePixelShader(device, ps, "ASSkyPixelShader", &m_pShader, &err);
 	if(FAILED(hr))
 	{
 		if(err)
@@ -83,14 +82,6 @@ bool ASSkyShader::Init(ID3D11Device* device, HWND handle, WCHAR* vs, WCHAR* ps)
 			MessageBox(handle, vs, L"Missing Pixel Shader File", MB_OK);
 		return false;
 	}
-	// Create the vertex shader
-	hr = device->CreateVertexShader(vsBuffer->GetBufferPointer(), vsBuffer->GetBufferSize(), NULL, &m_vShader);
-	if(FAILED(hr))
-		return false;
-	// create pixel shader
-	hr = device->CreatePixelShader(psBuffer->GetBufferPointer(), psBuffer->GetBufferSize(), NULL, &m_pShader);
-	if(FAILED(hr))
-		return false;
 
 	/*
 	 * Build the input layout
@@ -111,8 +102,6 @@ bool ASSkyShader::Init(ID3D11Device* device, HWND handle, WCHAR* vs, WCHAR* ps)
 
 	// Dispose of local resources, if we return false later they will still exist in memory (bad!)
 	vsBuffer->Release();
-	psBuffer->Release();
-	psBuffer = 0;
 	vsBuffer = 0;
 
 	/*
@@ -156,7 +145,7 @@ bool ASSkyShader::Init(ID3D11Device* device, HWND handle, WCHAR* vs, WCHAR* ps)
 * pipeline, redy for rendering
 */
 
-bool ASSkyShader::RenderSky(ID3D11DeviceContext* deviceCtx, int numIndices, D3DXMATRIX world, D3DXMATRIX view, D3DXMATRIX projection,
+bool ASSkyShader::RenderSky(ID3D11DeviceContext* deviceCtx, int numIndices, int startIndex, D3DXMATRIX world, D3DXMATRIX view, D3DXMATRIX projection,
 							D3DXVECTOR4 skyColorA, D3DXVECTOR4 skyColorB)
 {
 	// Attempt to initialise the shader
@@ -168,7 +157,7 @@ bool ASSkyShader::RenderSky(ID3D11DeviceContext* deviceCtx, int numIndices, D3DX
 	deviceCtx->IASetInputLayout(m_iLayout);
 	deviceCtx->VSSetShader(m_vShader, NULL, 0);
 	deviceCtx->PSSetShader(m_pShader, NULL, 0);
-	deviceCtx->DrawIndexed(numIndices, 0, 0);
+	deviceCtx->DrawIndexed(numIndices, startIndex, 0);
 	
 	return true;
 }
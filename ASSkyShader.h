@@ -20,6 +20,7 @@
 #include <d3dx10math.h>
 #include <d3dx11async.h>
 #include <fstream>
+#include "ASResourceManager.h"
 using namespace std;
 
 /*
@@ -54,7 +55,7 @@ public:
 	// Public methods
 	bool Init(ID3D11Device*, HWND, WCHAR*, WCHAR*);
 	void Release();
-	bool RenderSky(ID3D11DeviceContext*, int, D3DXMATRIX, D3DXMATRIX, D3DXMATRIX, D3DXVECTOR4, D3DXVECTOR4);
+	bool RenderSky(ID3D11DeviceContext*, int, int, D3DXMATRIX, D3DXMATRIX, D3DXMATRIX, D3DXVECTOR4, D3DXVECTOR4);
 
 private:
 	// Private methods
@@ -237,7 +237,7 @@ bool ASSound::LoadWavFile(char* filename, IDirectSoundBuffer8** buffer, IDirectS
 
 	// Load the audio data from the wav file into the newly created buffer.  
 	fseek(filePtr, sizeof(ASWavHeader), SEEK_SET);
-	wavData = new unsigned char[wavFile.dataSize];
+	wavData = ASNewArray<unsigned char>(wavFile.dataSize, MEMORY_AUDIO);
 	if(!wavData)
 		return false;
 
@@ -264,8 +264,7 @@ bool ASSound::LoadWavFile(char* filename, IDirectSoundBuffer8** buffer, IDirectS
 		return false;
 
 	// Release the wav data struct as it now exists in the secondary buffer
-	delete [] wavData;
-	wavData = 0;
+	ASDeleteArray(wavData);
 
 	return true;
 }
@@ -30,6 +30,7 @@
 #include <mmsystem.h>
 #include <dsound.h>
 #include <stdio.h>
+#include "ASMemory.h"
 
 /*
 ******************************************************************
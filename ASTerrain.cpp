@@ -23,9 +23,11 @@ ASTerrain::ASTerrain()
 	m_width       = 0;
 	m_numVertices = 0;
 	m_heightMap   = 0;
-	m_textures    = 0;
 	m_vertices    = 0;
-	m_detailTex   = 0;
+#ifndef AS_HEADLESS
+	m_layerTexture = 0;
+	m_layers       = 0;
+#endif
 }
 
 /*
@@ -46,24 +48,53 @@ ASTerrain::ASTerrain(const ASTerrain&)
 ASTerrain::~ASTerrain()
 {}
 
+#ifndef AS_HEADLESS
 /*
 *******************************************************************
 * METHOD: Init
 *******************************************************************
-* Initialise the terrain objects by setting default values for
-* the size of the plane, this method will also call private 
-* interface for initialising the index and vertex buffers
+* Initialise the terrain objects by building the mesh and then
+* loading the layer textures it is painted with
 *
 * @param ID3D11Device* - Pointer to the rendering device
-* @param char*         - Pointer to the heightmap bitmap file
-* @param char*         - Pointer to the color map
-* @param WCHAR*[]      - Pointer to array of textures to be loaded
-* @param WCHAR*        - Pointer to the detail texture to be loaded
+* @param const char*   - Pointer to the heightmap bitmap file
+* @param const char*   - Pointer to the color map
+* @param vector<char*> - The layer textures, in the slice order the pixel shader expects
+* @param const char*   - The texture array the layers are baked into
 * @return bool - True if successfully intiialised, else false
 */
 
-bool ASTerrain::Init(ID3D11Device* device, char* heightmapFile, char* colorMap, vector<WCHAR*> textures, WCHAR* detailTex)
+bool ASTerrain::Init(ID3D11Device* device, const char* heightmapFile, const char* colorMap, const vector<char*>& layers, const char* layerArray)
 {
+	AS_PROFILE("ASTerrain::Init");
+
+	bool success = Build(heightmapFile, colorMap);
+	if(!success)
+		return false;
+
+	// Load the texture to be applied to the map, only once the texture coordinates
+	// have been mapped to the global struct
+	return LoadTextures(device, layers, layerArray);
+}
+#endif
+
+/*
+*******************************************************************
+* METHOD: Build
+*******************************************************************
+* Loads the height and color maps and builds the terrain mesh,
+* nothing here needs a device so a headless build can build the
+* same mesh for its quad tree
+*
+* @param const char* - Pointer to the heightmap bitmap file
+* @param const char* - Pointer to the color map
+* @return bool - True if successfully built, else false
+*/
+
+bool ASTerrain::Build(const char* heightmapFile, const char* colorMap)
+{
+	AS_PROFILE("ASTerrain::Build");
+
 	// Attempt to load the heightmap and then normalise its vector
 	// so it can be passed to the geometry buffers
 	bool success = LoadMap(heightmapFile, false);
@@ -81,20 +112,14 @@ bool ASTerrain::Init(ID3D11Device* device, char* heightmapFile, char* colorMap,
 	// Populate the class struct with information on where the texture should be mapped to
 	CalculateTextureCoords();
 
-	// Load the texture to be applied to the map, only once the texture coordinates
-	// have been mapped to the global struct
-	success = LoadTextures(device, textures, detailTex);
-	if(!success)
-		return false;
-
 	// Attempt to load the color map
 	success = LoadMap(colorMap, true);
 	if(!success)
 		return false;
 
-	// Initialise the buffers through the private interface, return the callback
+	// Build the vertex array through the private interface, return the callback
 	// to check if initialisation succeeced 
-	return InitBuffers(device);
+	return InitBuffers();
 }
 
 /*
@@ -109,67 +134,68 @@ bool ASTerrain::Init(ID3D11Device* device, char* heightmapFile, char* colorMap,
 * to the heightmap (1 to 1 texture mapping is required, a map is typically
 * 256x256 px)
 *
-* @param char* - pointer to the bitmap file
+* @param const char* - pointer to the bitmap file
 * @param bool  - determines if this is the color map or not
 * @return bool - True if successfully loaded, else false
 */
 
-bool ASTerrain::LoadMap(char* mapFile, bool isColorMap)
+bool ASTerrain::LoadMap(const char* mapFile, bool isColorMap)
 {
-	FILE* readFile;
-	unsigned int count; // unsigned as this num could be large dependent on input size
-	BITMAPFILEHEADER bmpFileHeader;
-	BITMAPINFOHEADER bmpInfoHeader;
+	ifstream readFile;
+	unsigned char header[BMP_HEADER_SIZE];
+	unsigned int dataOffset;
+	int bmpWidth;
+	int bmpHeight;
 	unsigned char* bmpImg;
 	unsigned char  height;
-	int size;
 	int imageSize;
-	int err = 0;
 
-	// Open the height map file and read its contents into a char array
-	err = fopen_s(&readFile, mapFile, "rb");
-	if(err != 0)
+	// Open the height map file and read its headers, the fields are little endian and read
+	// by offset so the windows bitmap structs are not needed
+	readFile.open(mapFile, ios::in | ios::binary);
+	if(readFile.fail())
 		return false;
 
-	count = fread(&bmpFileHeader, sizeof(BITMAPFILEHEADER), 1, readFile);
-	if(count != 1)
+	readFile.read((char*)header, BMP_HEADER_SIZE);
+	if(readFile.fail() || header[0] != 'B' || header[1] != 'M')
 		return false;
 
-	count = fread(&bmpInfoHeader, sizeof(BITMAPINFOHEADER), 1, readFile);
-	if(count != 1)
-		return false;
+	memcpy(&dataOffset, header + 10, sizeof(dataOffset));
+	memcpy(&bmpWidth,   header + 18, sizeof(bmpWidth));
+	memcpy(&bmpHeight,  header + 22, sizeof(bmpHeight));
 
 	// Save the dimensions of the terrain from the heightmap and then calculate
 	// the how the map is to be translated to the world - check that the width and height are
 	// set if this is the color map, also check the texture maps 1:1 to the texture map
-	if((m_width != bmpInfoHeader.biWidth || m_height != bmpInfoHeader.biHeight) && isColorMap)
+	if((m_width != bmpWidth || m_height != bmpHeight) && isColorMap)
 		return false;
 
 	// Set the width if we are not accessing the color map
 	if(!isColorMap) {
-		m_width  = bmpInfoHeader.biWidth;
-		m_height = bmpInfoHeader.biHeight;
+		m_width  = bmpWidth;
+		m_height = bmpHeight;
 	}
 
 	imageSize = m_width * m_height * 3; // multiply by three as a bmp image has 3 channels but we only need one
 
 	// Set the char array to store all information on the input image
-	bmpImg = new unsigned char[imageSize];
+	bmpImg = ASNewArray<unsigned char>(imageSize, MEMORY_TERRAIN);
 	if(!bmpImg)
 		return false;
 
-	// Start reading from the start of the input file and then close the file pointer
-	fseek(readFile, bmpFileHeader.bfOffBits, SEEK_SET);
-	count = fread(bmpImg, 1, imageSize, readFile);
-	if(count != imageSize)
-		return false;
-	err = fclose(readFile);
-	if(err != 0)
+	// Start reading from the start of the pixel data and then close the file
+	readFile.seekg(dataOffset, ios::beg);
+	readFile.read((char*)bmpImg, imageSize);
+	if(readFile.fail())
+	{
+		ASDeleteArray(bmpImg);
 		return false;
+	}
+	readFile.close();
 
 	// Populate the ASHeightMap struct with file info
 	if(!m_heightMap) {
-		m_heightMap = new ASHeightMap[m_width * m_height];
+		m_heightMap = ASNewArray<ASHeightMap>(m_width * m_height, MEMORY_TERRAIN);
 		if(!m_heightMap)
 			return false;
 	}
@@ -178,9 +204,9 @@ bool ASTerrain::LoadMap(char* mapFile, bool isColorMap)
 	int currIndex = 0;
 	int mapIndex  = 0;
 
-	for(unsigned int j = 0; j < m_height; j++)
+	for(int j = 0; j < m_height; j++)
 	{
-		for(unsigned int i = 0; i < m_width; i++)
+		for(int i = 0; i < m_width; i++)
 		{
 			mapIndex = (m_height * j) + i;
 
@@ -189,7 +215,7 @@ bool ASTerrain::LoadMap(char* mapFile, bool isColorMap)
 			{
 				// y offset is now the calculated height based on intensity from the input image
 				height = bmpImg[currIndex];
-				m_heightMap[mapIndex].pos = D3DXVECTOR3((float)i,(float)height,(float)j);
+				m_heightMap[mapIndex].pos = ASVector3((float)i,(float)height,(float)j);
 			} 
 			// Populate color info for height map at the index
 			else 
@@ -206,8 +232,7 @@ bool ASTerrain::LoadMap(char* mapFile, bool isColorMap)
 	}
 
 	// Release temp buffers
-	delete [] bmpImg;
-	bmpImg  = 0;
+	ASDeleteArray(bmpImg);
 
 	return true;
 }
@@ -216,17 +241,15 @@ bool ASTerrain::LoadMap(char* mapFile, bool isColorMap)
 *******************************************************************
 * METHOD: Init Buffers
 *******************************************************************
-* Initialises the index and vertex buffers for the terrain
+* Builds the vertex array for the terrain, two triangles a quad,
+* the quad tree splits it into the buffers that are drawn
 *
-* @param ID3D11Device* - Pointer to the rendering device
 * @return bool - True if successfully intiialised, else false
 */
 
-bool ASTerrain::InitBuffers(ID3D11Device* device)
+bool ASTerrain::InitBuffers()
 {
-	// Position of the terrain in 3D space
-	float posX = 0;
-	float posZ = 0;
+	// Texture coordinates of the current corner
 	float texU = 0;
 	float texV = 0;
 
@@ -236,7 +259,7 @@ bool ASTerrain::InitBuffers(ID3D11Device* device)
 	m_numVertices = (m_width - 1) * (m_height - 1) * 6;
 
 	// Create the veritce and indice arrays to populate buffers
-	m_vertices = new ASVertex[m_numVertices];
+	m_vertices = ASNewArray<ASVertex>(m_numVertices, MEMORY_TERRAIN);
 	if(!m_vertices)
 		return false;
 
@@ -261,10 +284,10 @@ bool ASTerrain::InitBuffers(ID3D11Device* device)
 			texV = m_heightMap[topL].texCoord.y;
 			if(texV == 1.0f)
 				texV = 0.0f;
-			m_vertices[currIndex].pos      = D3DXVECTOR3(m_heightMap[topL].pos.x, m_heightMap[topL].pos.y, m_heightMap[topL].pos.z);
-			m_vertices[currIndex].texCoord = D3DXVECTOR4(m_heightMap[topL].texCoord.x, texV, 0.0f, 0.0f);
-			m_vertices[currIndex].normal   = D3DXVECTOR3(m_heightMap[topL].normals.x, m_heightMap[topL].normals.y, m_heightMap[topL].normals.z);
-			m_vertices[currIndex].color    = D3DXVECTOR4(m_heightMap[topL].color.x, m_heightMap[topL].color.y, m_heightMap[topL].color.z, 1.0f);
+			m_vertices[currIndex].pos      = ASVector3(m_heightMap[topL].pos.x, m_heightMap[topL].pos.y, m_heightMap[topL].pos.z);
+			m_vertices[currIndex].texCoord = ASVector4(m_heightMap[topL].texCoord.x, texV, 0.0f, 0.0f);
+			m_vertices[currIndex].normal   = ASVector3(m_heightMap[topL].normals.x, m_heightMap[topL].normals.y, m_heightMap[topL].normals.z);
+			m_vertices[currIndex].color    = ASVector4(m_heightMap[topL].color.x, m_heightMap[topL].color.y, m_heightMap[topL].color.z, 1.0f);
 			currIndex++;
 
 			// Top right
@@ -276,24 +299,24 @@ bool ASTerrain::InitBuffers(ID3D11Device* device)
 			if(texV == 1.0f)
 				texV = 0.0f;
 
-			m_vertices[currIndex].pos      = D3DXVECTOR3(m_heightMap[topR].pos.x, m_heightMap[topR].pos.y, m_heightMap[topR].pos.z);
-			m_vertices[currIndex].texCoord = D3DXVECTOR4(texU, texV, 1.0f, 0.0f);
-			m_vertices[currIndex].normal   = D3DXVECTOR3(m_heightMap[topR].normals.x, m_heightMap[topR].normals.y, m_heightMap[topR].normals.z);
-			m_vertices[currIndex].color    = D3DXVECTOR4(m_heightMap[topR].color.x, m_heightMap[topR].color.y, m_heightMap[topR].color.z, 1.0f);
+			m_vertices[currIndex].pos      = ASVector3(m_heightMap[topR].pos.x, m_heightMap[topR].pos.y, m_heightMap[topR].pos.z);
+			m_vertices[currIndex].texCoord = ASVector4(texU, texV, 1.0f, 0.0f);
+			m_vertices[currIndex].normal   = ASVector3(m_heightMap[topR].normals.x, m_heightMap[topR].normals.y, m_heightMap[topR].normals.z);
+			m_vertices[currIndex].color    = ASVector4(m_heightMap[topR].color.x, m_heightMap[topR].color.y, m_heightMap[topR].color.z, 1.0f);
 			currIndex++;
 
 			// Bottom left
-			m_vertices[currIndex].pos      = D3DXVECTOR3(m_heightMap[botL].pos.x, m_heightMap[botL].pos.y, m_heightMap[botL].pos.z);
-			m_vertices[currIndex].texCoord = D3DXVECTOR4(m_heightMap[botL].texCoord.x, m_heightMap[botL].texCoord.y, 0.0f, 1.0f);
-			m_vertices[currIndex].normal   = D3DXVECTOR3(m_heightMap[botL].normals.x, m_heightMap[botL].normals.y, m_heightMap[botL].normals.z);
-			m_vertices[currIndex].color    = D3DXVECTOR4(m_heightMap[botL].color.x, m_heightMap[botL].color.y, m_heightMap[botL].color.z, 1.0f);
+			m_vertices[currIndex].pos      = ASVector3(m_heightMap[botL].pos.x, m_heightMap[botL].pos.y, m_heightMap[botL].pos.z);
+			m_vertices[currIndex].texCoord = ASVector4(m_heightMap[botL].texCoord.x, m_heightMap[botL].texCoord.y, 0.0f, 1.0f);
+			m_vertices[currIndex].normal   = ASVector3(m_heightMap[botL].normals.x, m_heightMap[botL].normals.y, m_heightMap[botL].normals.z);
+			m_vertices[currIndex].color    = ASVector4(m_heightMap[botL].color.x, m_heightMap[botL].color.y, m_heightMap[botL].color.z, 1.0f);
 			currIndex++;
 
 			// Bottom left
-			m_vertices[currIndex].pos      = D3DXVECTOR3(m_heightMap[botL].pos.x, m_heightMap[botL].pos.y, m_heightMap[botL].pos.z);
-			m_vertices[currIndex].texCoord = D3DXVECTOR4(m_heightMap[botL].texCoord.x, m_heightMap[botL].texCoord.y, 0.0f, 1.0f);
-			m_vertices[currIndex].normal   = D3DXVECTOR3(m_heightMap[botL].normals.x, m_heightMap[botL].normals.y, m_heightMap[botL].normals.z);
-			m_vertices[currIndex].color    = D3DXVECTOR4(m_heightMap[botL].color.x, m_heightMap[botL].color.y, m_heightMap[botL].color.z, 1.0f);
+			m_vertices[currIndex].pos      = ASVector3(m_heightMap[botL].pos.x, m_heightMap[botL].pos.y, m_heightMap[botL].pos.z);
+			m_vertices[currIndex].texCoord = ASVector4(m_heightMap[botL].texCoord.x, m_heightMap[botL].texCoord.y, 0.0f, 1.0f);
+			m_vertices[currIndex].normal   = ASVector3(m_heightMap[botL].normals.x, m_heightMap[botL].normals.y, m_heightMap[botL].normals.z);
+			m_vertices[currIndex].color    = ASVector4(m_heightMap[botL].color.x, m_heightMap[botL].color.y, m_heightMap[botL].color.z, 1.0f);
 			currIndex++;
 
 			// Top right
@@ -305,20 +328,20 @@ bool ASTerrain::InitBuffers(ID3D11Device* device)
 			if(texV == 1.0f)
 				texV = 0.0f;
 
-			m_vertices[currIndex].pos      = D3DXVECTOR3(m_heightMap[topR].pos.x, m_heightMap[topR].pos.y, m_heightMap[topR].pos.z);
-			m_vertices[currIndex].texCoord = D3DXVECTOR4(texU, texV, 1.0f, 0.0f);
-			m_vertices[currIndex].normal   = D3DXVECTOR3(m_heightMap[topR].normals.x, m_heightMap[topR].normals.y, m_heightMap[topR].normals.z);
-			m_vertices[currIndex].color    = D3DXVECTOR4(m_heightMap[topR].color.x, m_heightMap[topR].color.y, m_heightMap[topR].color.z, 1.0f);
+			m_vertices[currIndex].pos      = ASVector3(m_heightMap[topR].pos.x, m_heightMap[topR].pos.y, m_heightMap[topR].pos.z);
+			m_vertices[currIndex].texCoord = ASVector4(texU, texV, 1.0f, 0.0f);
+			m_vertices[currIndex].normal   = ASVector3(m_heightMap[topR].normals.x, m_heightMap[topR].normals.y, m_heightMap[topR].normals.z);
+			m_vertices[currIndex].color    = ASVector4(m_heightMap[topR].color.x, m_heightMap[topR].color.y, m_heightMap[topR].color.z, 1.0f);
 			currIndex++;
 
 			// Bottom right
 			texU = m_heightMap[botR].texCoord.x;
 			if(texU == 0.0f) 
 				texU = 1.0f;
-			m_vertices[currIndex].pos      = D3DXVECTOR3(m_heightMap[botR].pos.x, m_heightMap[botR].pos.y, m_heightMap[botR].pos.z);
-			m_vertices[currIndex].texCoord = D3DXVECTOR4(texU, m_heightMap[botR].texCoord.y, 1.0f, 1.0f);
-			m_vertices[currIndex].normal   = D3DXVECTOR3(m_heightMap[botR].normals.x, m_heightMap[botR].normals.y, m_heightMap[botR].normals.z);
-			m_vertices[currIndex].color    = D3DXVECTOR4(m_heightMap[botR].color.x, m_heightMap[botR].color.y, m_heightMap[botR].color.z, 1.0f);
+			m_vertices[currIndex].pos      = ASVector3(m_heightMap[botR].pos.x, m_heightMap[botR].pos.y, m_heightMap[botR].pos.z);
+			m_vertices[currIndex].texCoord = ASVector4(texU, m_heightMap[botR].texCoord.y, 1.0f, 1.0f);
+			m_vertices[currIndex].normal   = ASVector3(m_heightMap[botR].normals.x, m_heightMap[botR].normals.y, m_heightMap[botR].normals.z);
+			m_vertices[currIndex].color    = ASVector4(m_heightMap[botR].color.x, m_heightMap[botR].color.y, m_heightMap[botR].color.z, 1.0f);
 			currIndex++;
 
 		}
@@ -328,51 +351,22 @@ bool ASTerrain::InitBuffers(ID3D11Device* device)
 	return true;
 }
 
+#ifndef AS_HEADLESS
 /*
 *******************************************************************
-* METHOD: Get Detail Texture
+* METHOD: Get Texture Array
 *******************************************************************
-* Returns the detail texture 
+* Returns every layer of the terrain as one texture array, the
+* slices are in the order the layers were passed to Init()
 * 
-* @return ID3D11ShaderResourceView* - pointer to the texture
+* @return ID3D11ShaderResourceView* - pointer to the texture array
 */
 
-ID3D11ShaderResourceView* ASTerrain::GetDetailTexture()
+ID3D11ShaderResourceView* ASTerrain::GetTextureArray()
 {
-	return m_detailTex->GetTexture();
-}
-
-/*
-*******************************************************************
-* METHOD: Get Textures
-*******************************************************************
-* Returns all textures for the current map
-* 
-* @param int - the index for the texture we want to retrieve
-* @param vector<ID3D11ShaderResourceView*>& - output param populated with array of res pointers
-*/
-
-void ASTerrain::GetTextures(vector<ID3D11ShaderResourceView*>& textures)
-{
-	const int size = m_textures->size();
-	for(int i = 0; i < size; i++)
-		textures.push_back(GetTextureAtIndex(i));
-}
-
-/*
-*******************************************************************
-* METHOD: Get Texture
-*******************************************************************
-* Private Interface to return the current texture loaded for the map
-* 
-* @param int - the index for the texture we want to retrieve
-* @return ID3D11ShaderResourceView* - pointer to the current texture
-*/
-
-ID3D11ShaderResourceView* ASTerrain::GetTextureAtIndex(int index)
-{
-	return m_textures->at(index).GetTexture();
+	return m_layers;
 }
+#endif
 
 /*
 *******************************************************************
@@ -437,37 +431,84 @@ void ASTerrain::CalculateTextureCoords()
 	}
 }
 
+#ifndef AS_HEADLESS
 /*
 *******************************************************************
 * METHOD: Load the map texture
 *******************************************************************
-* Loads the texture using the m_textures interface methods
+* Loads every layer as a single texture array so the terrain pass
+* binds one resource.  The array is baked from the layer files by
+* ASTextureBaker the first time, and again whenever a layer file
+* is newer than it
+*
+* @param vector<char*> - the layer textures, in slice order
+* @param const char*   - the baked texture array file
 *
 * @return bool - True if successfully loaded, else false
 */
 
-bool ASTerrain::LoadTextures(ID3D11Device* device, vector<WCHAR*> textures, WCHAR* detailTex)
+bool ASTerrain::LoadTextures(ID3D11Device* device, const vector<char*>& layers, const char* layerArray)
 {
-	const int NUM_TEXTURES = textures.size();
-	// Check we could create a texture object, then initialise it
-	m_textures = new vector<ASTexture>(NUM_TEXTURES);
-	if(!m_textures)
-		return false;
-	// Load each texture in the textures array
-	for(int i = 0; i < NUM_TEXTURES; i++) 
-		if(!m_textures->at(i).Init(device, textures.at(i)))
+	D3D11_TEXTURE2D_DESC            desc;
+	D3D11_SHADER_RESOURCE_VIEW_DESC viewDesc;
+	vector<D3D11_SUBRESOURCE_DATA>  data;
+	ASDDSFile file;
+	HRESULT hr;
+
+	if(ASTextureBaker::IsStale(layerArray, layers))
+	{
+		ASTextureBaker baker;
+		if(!baker.Bake(layerArray, layers))
 			return false;
+	}
+
+	if(!file.Init(layerArray))
+		return false;
 
-	// Load the detail texture
-	m_detailTex = new ASTexture;
-	if(!m_detailTex)
+	desc.Width              = file.GetWidth();
+	desc.Height             = file.GetHeight();
+	desc.MipLevels          = file.GetMipCount();
+	desc.ArraySize          = file.GetArraySize();
+	desc.Format             = file.GetFormat();
+	desc.SampleDesc.Count   = 1;
+	desc.SampleDesc.Quality = 0;
+	desc.Usage              = D3D11_USAGE_IMMUTABLE;
+	desc.BindFlags          = D3D11_BIND_SHADER_RESOURCE;
+	desc.CPUAccessFlags     = 0;
+	desc.MiscFlags          = 0;
+
+	// Subresources are numbered by slice first, then by level within the slice
+	data.resize(desc.ArraySize * desc.MipLevels);
+	for(unsigned int slice = 0; slice < desc.ArraySize; slice++)
+	{
+		for(unsigned int mip = 0; mip < desc.MipLevels; mip++)
+		{
+			D3D11_SUBRESOURCE_DATA& level = data[(slice * desc.MipLevels) + mip];
+			level.pSysMem          = file.GetSliceData(slice, mip);
+			level.SysMemPitch      = file.GetMipPitch(mip);
+			level.SysMemSlicePitch = 0;
+		}
+	}
+
+	hr = device->CreateTexture2D(&desc, &data[0], &m_layerTexture);
+	file.Release();
+	if(FAILED(hr))
 		return false;
-	// Set the texture, check if successful - if not blow up the app!
-	if(!m_detailTex->Init(device, detailTex))
+
+	viewDesc.Format                         = desc.Format;
+	viewDesc.ViewDimension                  = D3D11_SRV_DIMENSION_TEXTURE2DARRAY;
+	viewDesc.Texture2DArray.MostDetailedMip = 0;
+	viewDesc.Texture2DArray.MipLevels       = desc.MipLevels;
+	viewDesc.Texture2DArray.FirstArraySlice = 0;
+	viewDesc.Texture2DArray.ArraySize       = desc.ArraySize;
+
+	hr = device->CreateShaderResourceView(m_layerTexture, &viewDesc, &m_layers);
+	if(FAILED(hr))
 		return false;
 
 	return true;
 }
+#endif
 
 /*
 *******************************************************************
@@ -484,24 +525,22 @@ bool ASTerrain::LoadTextures(ID3D11Device* device, vector<WCHAR*> textures, WCHA
 bool ASTerrain::CalculateMapNormals()
 {
 	// Temp vars to store information on vertexes
-	D3DXVECTOR3 vertA;
-	D3DXVECTOR3 vertB;
-	D3DXVECTOR3 vertC;
-	D3DXVECTOR3 vecA;
-	D3DXVECTOR3 vecB;
-	D3DXVECTOR3 normSum;
-	
-	float len;
+	ASVector3 vertA;
+	ASVector3 vertB;
+	ASVector3 vertC;
+	ASVector3 vecA;
+	ASVector3 vecB;
+	ASVector3 normSum;
 
 	// Store un-normalised vectors in a temp array
-	ASLightVector* normals = new ASLightVector[(m_height - 1) * (m_width - 1)];
+	ASLightVector* normals = ASNewArray<ASLightVector>((m_height - 1) * (m_width - 1), MEMORY_TERRAIN);
 	if(!normals)
 		return false;
 
 	// Loop through all faces in the mash and compute normals between them
-	for(unsigned int j = 0; j < (m_height - 1); j++)
+	for(int j = 0; j < (m_height - 1); j++)
 	{
-		for(unsigned int i = 0; (i < m_width - 1); i++)
+		for(int i = 0; (i < m_width - 1); i++)
 		{
 			// Get the vertices that the current face is located at
 			int vertIndexA = (j * m_height) + i;
@@ -509,20 +548,18 @@ bool ASTerrain::CalculateMapNormals()
 			int vertIndexC = ((j + 1) * m_height) + i;
 
 			// Extract the X, Y, Z components of each vertice in the face
-			vertA = D3DXVECTOR3(m_heightMap[vertIndexA].pos.x, m_heightMap[vertIndexA].pos.y, m_heightMap[vertIndexA].pos.z);
-			vertB = D3DXVECTOR3(m_heightMap[vertIndexB].pos.x, m_heightMap[vertIndexB].pos.y, m_heightMap[vertIndexB].pos.z);
-			vertC = D3DXVECTOR3(m_heightMap[vertIndexC].pos.x, m_heightMap[vertIndexC].pos.y, m_heightMap[vertIndexC].pos.z);
+			vertA = m_heightMap[vertIndexA].pos;
+			vertB = m_heightMap[vertIndexB].pos;
+			vertC = m_heightMap[vertIndexC].pos;
 
 			// Calculate the vectors for this face
-			vecA = D3DXVECTOR3(vertA.x - vertC.x, vertA.y - vertC.y, vertA.z - vertC.z);
-			vecB = D3DXVECTOR3(vertC.x - vertB.x, vertC.y - vertB.y, vertC.z - vertB.z);
+			vecA = vertA - vertC;
+			vecB = vertC - vertB;
 
 			// Get the current face
 			int currFace = (j * (m_height-1)) + i;
 
-			normals[currFace].vn = D3DXVECTOR3((vecA.y * vecB.z) - (vecA.z * vecB.y),
-											   (vecA.z * vecB.x) - (vecA.x * vecB.z),
-											   (vecA.x * vecB.y) - (vecA.y * vecB.x));
+			ASVec3Cross(&normals[currFace].vn, &vecA, &vecB);
 
 		}
 	}
@@ -534,7 +571,7 @@ bool ASTerrain::CalculateMapNormals()
 		for(int i = 0; i < m_width; i++)
 		{
 			// Keeps the total of the normals at each index, so we can calculate the cumulative average
-			normSum = D3DXVECTOR3(0.0f, 0.0f, 0.0f);
+			normSum = ASVector3(0.0f, 0.0f, 0.0f);
 
 			// Set default values for indexes
 			unsigned int count = 0;
@@ -545,9 +582,7 @@ bool ASTerrain::CalculateMapNormals()
 			{
 				currIndex = ((j-1)*(m_height-1))+(i-1);
 
-				normSum.x = normals[currIndex].vn.x;
-				normSum.y = normals[currIndex].vn.y;
-				normSum.z = normals[currIndex].vn.z;
+				normSum += normals[currIndex].vn;
 				count++;
 			}
 
@@ -556,9 +591,7 @@ bool ASTerrain::CalculateMapNormals()
 			{
 				currIndex = ((j-1) * (m_height-1)) + i;
 
-				normSum.x = normals[currIndex].vn.x;
-				normSum.y = normals[currIndex].vn.y;
-				normSum.z = normals[currIndex].vn.z;
+				normSum += normals[currIndex].vn;
 				count++;
 			}
 
@@ -567,9 +600,7 @@ bool ASTerrain::CalculateMapNormals()
 			{
 				currIndex = (j * (m_height-1)) + (i-1);
 
-				normSum.x = normals[currIndex].vn.x;
-				normSum.y = normals[currIndex].vn.y;
-				normSum.z = normals[currIndex].vn.z;
+				normSum += normals[currIndex].vn;
 				count++;
 			}
 
@@ -578,29 +609,20 @@ bool ASTerrain::CalculateMapNormals()
 			{
 				currIndex = (j * (m_height-1)) + i;
 
-				normSum.x = normals[currIndex].vn.x;
-				normSum.y = normals[currIndex].vn.y;
-				normSum.z = normals[currIndex].vn.z;
+				normSum += normals[currIndex].vn;
 				count++;
 			}
 
 			// Compute the average of the faces
-			normSum.x = (normSum.x / (float)count);
-			normSum.y = (normSum.y / (float)count);
-			normSum.z = (normSum.z / (float)count);
-
-			len = sqrt((normSum.x * normSum.x) + (normSum.y + normSum.y) + (normSum.z * normSum.z));
+			normSum = normSum / (float)count;
 			currIndex = (j * m_height) + i;
 
-			m_heightMap[currIndex].normals.x = normSum.x / len;
-			m_heightMap[currIndex].normals.y = normSum.y / len;
-			m_heightMap[currIndex].normals.z = normSum.z / len;
+			ASVec3Normalize(&m_heightMap[currIndex].normals, &normSum);
 		}
 	}
 
 	// Dispose of local resources
-	delete [] normals;
-	normals = 0;
+	ASDeleteArray(normals);
 	
 	return true;
 }
@@ -615,8 +637,8 @@ bool ASTerrain::CalculateMapNormals()
 
 void ASTerrain::NormaliseHeightMap()
 {
-	for(unsigned int j = 0; j < m_height; j++)
-		for(unsigned int i = 0; i < m_width; i++)
+	for(int j = 0; j < m_height; j++)
+		for(int i = 0; i < m_width; i++)
 			m_heightMap[(m_height * j) + i].pos.y /= 15.0f;
 }
 
@@ -659,30 +681,25 @@ void ASTerrain::Release()
 	// Dispose of the height map
 	if(m_heightMap)
 	{
-		delete [] m_heightMap;
-		m_heightMap = 0;
+		ASDeleteArray(m_heightMap);
 	}
-	// Dispose of texture 
-	if(m_textures)
+#ifndef AS_HEADLESS
+	// Dispose of the layer textures
+	if(m_layers)
 	{
-		for(int i = 0; i < m_textures->size(); i++)
-			m_textures->at(i).Release();
-		
-		delete m_textures;
-		m_textures = 0;
+		m_layers->Release();
+		m_layers = 0;
 	}
-	// Release the vertice buffer
-	if(m_vertices)
+	if(m_layerTexture)
 	{
-		delete [] m_vertices;
-		m_vertices = 0;
+		m_layerTexture->Release();
+		m_layerTexture = 0;
 	}
-	// Release the detail texture
-	if(m_detailTex)
+#endif
+	// Release the vertice buffer
+	if(m_vertices)
 	{
-		m_detailTex->Release();
-		delete m_detailTex;
-		m_detailTex = 0;
+		ASDeleteArray(m_vertices);
 	}
 }
 
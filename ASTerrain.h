@@ -15,14 +15,28 @@
 *******************************************************************
 * Includes:
 *******************************************************************
+* + ASMath.h has been included for the vertex types and the normals
+* + ASProfiler.h has been included to time loading
+* + ASMemory.h has been included to tag the height map and vertices
+* + The D3D headers are left out of a headless build, which only
+*   builds the mesh for the quad tree
+*******************************************************************
 */
 
 #include <stdio.h>
-#include <d3d11.h>
-#include <d3dx10math.h>
-#include "ASTexture.h"
+#include <string.h>
+#include <fstream>
+#include "ASMath.h"
+#include "ASProfiler.h"
+#include "ASMemory.h"
 #include <vector>
 
+#ifndef AS_HEADLESS
+#include <d3d11.h>
+#include "ASDDSFile.h"
+#include "ASTextureBaker.h"
+#endif
+
 using namespace std;
 
 /*
@@ -37,23 +51,23 @@ private:
 	// Vertex structure to describe the terrain
 	struct ASVertex
 	{
-		D3DXVECTOR3 pos;
-		D3DXVECTOR4 texCoord;
-		D3DXVECTOR3 normal;
-		D3DXVECTOR4 color;
+		ASVector3 pos;
+		ASVector4 texCoord;
+		ASVector3 normal;
+		ASVector4 color;
 	};
 	// Struct to hold information on the heightmap
 	struct ASHeightMap
 	{
-		D3DXVECTOR3 pos;
-		D3DXVECTOR2 texCoord;
-		D3DXVECTOR3 normals;
-		D3DXVECTOR3 color;
+		ASVector3 pos;
+		ASVector2 texCoord;
+		ASVector3 normals;
+		ASVector3 color;
 	};
 	// Vector to calculate lighting between angles
 	struct ASLightVector
 	{
-		D3DXVECTOR3 vn;
+		ASVector3 vn;
 	};
 public:
 	// Constructors and Destructors
@@ -62,27 +76,31 @@ public:
 	~ASTerrain();
 
 	// Public methods
-	bool Init(ID3D11Device*, char*, char*, vector<WCHAR*>, WCHAR*);
+#ifndef AS_HEADLESS
+	bool Init(ID3D11Device*, const char*, const char*, const vector<char*>&, const char*);
+#endif
+	bool Build(const char*, const char*);
 	void Release();
 
 	void GetVerticeArray(void*);	
 	int GetNumVertices();
 
-	ID3D11ShaderResourceView*   GetDetailTexture();
-	void GetTextures(vector<ID3D11ShaderResourceView*>&);
+#ifndef AS_HEADLESS
+	ID3D11ShaderResourceView*   GetTextureArray();
+#endif
 
 private:
 	// Private methods
-	bool InitBuffers(ID3D11Device*);
+	bool InitBuffers();
 
 	// Texturre handlign methods
 	void CalculateTextureCoords();
-	bool LoadTextures(ID3D11Device*, vector<WCHAR*>, WCHAR*);
-
-	ID3D11ShaderResourceView*   GetTextureAtIndex(int);
+#ifndef AS_HEADLESS
+	bool LoadTextures(ID3D11Device*, const vector<char*>&, const char*);
+#endif
 
 	// Height map handling code
-	bool LoadMap(char*, bool);
+	bool LoadMap(const char*, bool);
 	void NormaliseHeightMap();
 	bool CalculateMapNormals();
 
@@ -92,12 +110,19 @@ private:
 	int m_numVertices;
 
 	ASVertex*           m_vertices;
-	ASTexture*          m_detailTex;
-	vector<ASTexture>*  m_textures;
 	ASHeightMap*        m_heightMap;
+
+#ifndef AS_HEADLESS
+	// Every layer the terrain is painted with, one slice each
+	ID3D11Texture2D*          m_layerTexture;
+	ID3D11ShaderResourceView* m_layers;
+#endif
 };
 
 // controls the size of the sample for the texture
 const int TEXTURE_TILE_SIZE = 16;
 
+// The bitmap file header and info header, the fields LoadMap needs are read by offset
+const int BMP_HEADER_SIZE = 54;
+
 #endif
\ No newline at end of file
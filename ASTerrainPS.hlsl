@@ -11,13 +11,15 @@
 ******************************************************************
 */
 
-// Depth texture, used for close high pixel quality mapping
-Texture2D depthTex  : register(t0);
+// Every terrain layer in one texture array, baked by ASTexturePacker.  The slices are
+// the depth texture, used for close high pixel quality mapping, followed by the textures
+// for different areas of the heightmap
+Texture2DArray terrainLayers : register(t0);
 
-// Textures for different areas of the heightmap
-Texture2D foliage   : register(t1);
-Texture2D rockFace  : register(t2);
-Texture2D rockFloor : register(t3);
+static const float DEPTH_LAYER      = 0.0f;
+static const float FOLIAGE_LAYER    = 1.0f;
+static const float ROCK_FACE_LAYER  = 2.0f;
+static const float ROCK_FLOOR_LAYER = 3.0f;
 
 SamplerState ASSampler;
 
@@ -72,9 +74,9 @@ float4 TerrainPixelShader(ASPixel inputPixel) : SV_TARGET
 	* Sample the four textures used for height based texture mapping
 	*/
 
-	foliageColor  = foliage.Sample(ASSampler,   inputPixel.texCoord);
-	rockColor     = rockFloor.Sample(ASSampler, inputPixel.texCoord);
-	rockFaceColor = rockFace.Sample(ASSampler,  inputPixel.texCoord);
+	foliageColor  = terrainLayers.Sample(ASSampler, float3(inputPixel.texCoord.xy, FOLIAGE_LAYER));
+	rockColor     = terrainLayers.Sample(ASSampler, float3(inputPixel.texCoord.xy, ROCK_FLOOR_LAYER));
+	rockFaceColor = terrainLayers.Sample(ASSampler, float3(inputPixel.texCoord.xy, ROCK_FACE_LAYER));
 
 	// Calculate the height of the slope at this point, this will determine which texture is to be 
 	// mapped to the certain piece of terrain
@@ -129,7 +131,7 @@ float4 TerrainPixelShader(ASPixel inputPixel) : SV_TARGET
 	{
 		// Sample the extra two bytes of coord information from the buffer (made this 4Bytes instead of 2Byes
 		// in ASTextureShader.cpp)
-		depthColor = depthTex.Sample(ASSampler, inputPixel.texCoord.zw);
+		depthColor = terrainLayers.Sample(ASSampler, float3(inputPixel.texCoord.zw, DEPTH_LAYER));
 		texColor = (texColor * depthColor * lightIntensity) * 1.5f;
 	}
 
@@ -91,7 +91,6 @@ bool ASTerrainShader::InitShader(ID3D11Device* device, HWND handle, WCHAR* vsFil
 	// Init pointers to null
 	ID3D10Blob* err = 0;
 	ID3D10Blob* vsBuffer = 0;
-	ID3D10Blob* psBuffer = 0;
 
 	// Other descriptors for buffer
 	D3D11_INPUT_ELEMENT_DESC polyLayout[4];	
@@ -104,8 +103,7 @@ bool ASTerrainShader::InitShader(ID3D11Device* device, HWND handle, WCHAR* vsFil
 
 	// Compile shaders into buffers - any errors are caught and pushed to an error stack, if the 
 	// file is not found user is alerted by a popup message
-	hr = D3DX11CompileFromFile(vsFile, NULL, NULL, "TerrainVertexShader", "vs_5_0", D3D10_SHADER_ENABLE_STRICTNESS, 
-							   0, NULL, &vsBuffer, &err, NULL);
+	hr = ASResourceManager::GetInstance()->AcquireVertexShader(device, vsFile, "TerrainVertexShader", &m_vShader, &vsBuffer, &err);
 	if(FAILED(hr))
 	{
 		if(err)
@@ -117,8 +115,7 @@ bool ASTerrainShader::InitShader(ID3D11Device* device, HWND handle, WCHAR* vsFil
 	}
 
 	// Compile the pixel shader
-	hr = D3DX11CompileFromFile(psFile, NULL, NULL, "TerrainPixelShader", "ps_5_0", D3D10_SHADER_ENABLE_STRICTNESS,
-							  0, NULL, &psBuffer, &err, NULL);
+	hr = ASResourceManager::GetInstance()->AcquirePixelShader(device, psFile, "TerrainPixelShader", &m_pShader, &err);
 	if(FAILED(hr))
 	{
 		if(err)
@@ -128,15 +125,6 @@ bool ASTerrainShader::InitShader(ID3D11Device* device, HWND handle, WCHAR* vsFil
 		return false;
 	}
 
-	// Create shader objects from the pixel and vertex buffers. These pointers will be used to interact with the 
-	// vertex and pixel shaders
-	hr = device->CreateVertexShader(vsBuffer->GetBufferPointer(), vsBuffer->GetBufferSize(), NULL, &m_vShader);
-	if(FAILED(hr))
-		return false;
-	hr = device->CreatePixelShader(psBuffer->GetBufferPointer(), psBuffer->GetBufferSize(), NULL, &m_pShader);
-	if(FAILED(hr))
-		return false;
-
 	// Create the input layout of the vertex data. We define how far apart in memory vertex and pixel data sit,
 	// in this case every 12 bytes are position and every 16 bytes after that will be color - this tells the GPU
 	// the structure of the input, so it knows to process vertex information for 12 byes and then color information 
@@ -188,9 +176,7 @@ bool ASTerrainShader::InitShader(ID3D11Device* device, HWND handle, WCHAR* vsFil
 
 	// Release the buffers and set null pointers to them as we have loaded the data into pointers
 	vsBuffer->Release();
-	psBuffer->Release();
 	vsBuffer = 0;
-	psBuffer = 0;
 
 	// Create a texture sampler to map the texture to the object
     samplerDesc.Filter = D3D11_FILTER_MIN_MAG_MIP_LINEAR;
@@ -289,15 +275,13 @@ void ASTerrainShader::RaiseShaderError(ID3D10Blob* msg, HWND handle, WCHAR* shad
 * @param D3DXVECTOR4 - the ambient color of the light
 * @param D3DXVECTOR4 - the diffuse color of the light
 * @param D3DXVECTOR3 - The vector holding direction of light
-* @param ID3D11ShaderResourceView* - Pointer to the depth texture
-* @param ID3D11ShaderResourceView*[] - Pointer to the texture array
+* @param ID3D11ShaderResourceView* - Pointer to the texture array holding every terrain layer
 *
 * @return bool - True if the shader was set, else false
 */
 
 bool ASTerrainShader::SetShaderParameters(ID3D11DeviceContext* deviceContext, D3DXMATRIX world, D3DXMATRIX view, D3DXMATRIX projection, 
-										  D3DXVECTOR4 ambient, D3DXVECTOR4 diffuse, D3DXVECTOR3 lightDir, ID3D11ShaderResourceView* depthTex,
-										  vector<ID3D11ShaderResourceView*> textures)
+										  D3DXVECTOR4 ambient, D3DXVECTOR4 diffuse, D3DXVECTOR3 lightDir, ID3D11ShaderResourceView* layers)
 {
 	HRESULT hr;
 	D3D11_MAPPED_SUBRESOURCE res;
@@ -360,13 +344,8 @@ bool ASTerrainShader::SetShaderParameters(ID3D11DeviceContext* deviceContext, D3
 	// at the next stage of the render pipeline
 	deviceContext->PSSetConstantBuffers(0, 1, &m_lBuffer);
 
-	// Set the depth texture at index 0
-	deviceContext->PSSetShaderResources(0, 1, &depthTex);
-	// Loop through each of the textures and set it in the shader, start at i=1, size+1 because
-	// the first register in the Pixel shader is set with the detail texture, therefore 
-	// any other registers need to be set on an incremented index
-	for(int i = 1; i < textures.size() + 1; i++)
-		deviceContext->PSSetShaderResources(i, 1, &textures.at(i-1));
+	// Every layer lives in the one texture array at index 0
+	deviceContext->PSSetShaderResources(0, 1, &layers);
 
 	return true;
 }
@@ -21,7 +21,6 @@
 #include <d3dx11async.h>
 #include <fstream>
 #include "ASLightShader.h"
-#include <vector>
 
 using namespace std;
 
@@ -53,14 +52,11 @@ public:
 	void Release();
 	void RenderShader(ID3D11DeviceContext*, int);
 	bool SetShaderParameters(ID3D11DeviceContext*, D3DXMATRIX, D3DXMATRIX, D3DXMATRIX, 
-							 D3DXVECTOR4, D3DXVECTOR4, D3DXVECTOR3, ID3D11ShaderResourceView*,
-							 vector<ID3D11ShaderResourceView*>);	// each resource = 1 texture
+							 D3DXVECTOR4, D3DXVECTOR4, D3DXVECTOR3, ID3D11ShaderResourceView*);
 private:
 	// Private methods
 	bool InitShader(ID3D11Device*, HWND, WCHAR*, WCHAR*);
 	void RaiseShaderError(ID3D10Blob*, HWND, WCHAR*);
-
-	int  m_numTextures;
 };
 
 #endif
\ No newline at end of file
@@ -164,7 +164,7 @@ bool ASText::InitSentence(ASSentence** sentence, int maxLen, ID3D11Device* devic
 	D3D11_SUBRESOURCE_DATA iData;
 
 	// Build the new sentence object
-	*sentence = new ASSentence;
+	*sentence = ASNew<ASSentence>(MEMORY_TEXT);
 	if(!*sentence)
 		return false;
 
@@ -176,12 +176,12 @@ bool ASText::InitSentence(ASSentence** sentence, int maxLen, ID3D11Device* devic
 	(*sentence)->numIndices = (*sentence)->numVerts;
 	
 	// Create vertex array
-	vertices = new ASVertex[(*sentence)->numVerts];
+	vertices = ASNewArray<ASVertex>((*sentence)->numVerts, MEMORY_TEXT);
 	if(!vertices)
 		return false;
 
 	// Create the indice array
-	indices = new unsigned long[(*sentence)->numVerts];
+	indices = ASNewArray<unsigned long>((*sentence)->numVerts, MEMORY_TEXT);
 	if(!indices)
 		return false;
 
@@ -227,12 +227,10 @@ bool ASText::InitSentence(ASSentence** sentence, int maxLen, ID3D11Device* devic
 		return false;
 
 	// Release the vertex array as it is no longer needed.
-	delete [] vertices;
-	vertices = 0;
+	ASDeleteArray(vertices);
 
 	// Release the index array as it is no longer needed.
-	delete [] indices;
-	indices = 0;
+	ASDeleteArray(indices);
 
 	return true;
 }
@@ -280,8 +278,8 @@ bool ASText::UpdateSentence(ASSentence* sentence, char* text, int posX, int posY
 	if(numLetters > sentence->maxLen)
 		return false;
 
-	// Create vertex array
-	vertices = new ASVertex[sentence->numVerts];
+	// Build the vertices in the frame's scratch memory, text can change every frame
+	vertices = ASFrameArena::GetInstance()->AllocateArray<ASVertex>(sentence->numVerts);
 	if(!vertices)
 		return false;
 
@@ -303,13 +301,9 @@ bool ASText::UpdateSentence(ASSentence* sentence, char* text, int posX, int posY
 	// Update the vertex buffer
 	memcpy(vertPtr, (void*)vertices, (sizeof(ASVertex) * sentence->numVerts));
 
-	// Unlock the buffer for future use
+	// Unlock the buffer for future use, the vertices go with the frame
 	deviceContext->Unmap(sentence->vBuffer, 0);
 
-	// Release the vertex array
-	delete [] vertices;
-	vertices = 0;
-
 	return true;
 }
 
@@ -338,8 +332,7 @@ void ASText::ReleaseSentence(ASSentence** sentence)
 			(*sentence)->iBuffer = 0;
 		}
 		// All objects disposed - delete the sentence and set a null ptr
-		delete *sentence;
-		*sentence = 0;
+		ASDelete(*sentence);
 	}
 }
 
@@ -19,6 +19,8 @@
 
 #include "ASFont.h"
 #include "ASFontShader.h"
+#include "ASMemory.h"
+#include "ASFrameArena.h"
 
 /*
 *******************************************************************
@@ -0,0 +1,324 @@
+/*
+******************************************************************
+* ASTextReader.cpp
+*******************************************************************
+* Implements all methods from ASTextReader.h
+*******************************************************************
+*/
+
+#include "ASTextReader.h"
+#include <math.h>
+
+/*
+*******************************************************************
+* Powers of ten that are exactly representable as a double, these
+* let ReadFloat() scale the mantissa with a single correctly rounded
+* multiply or divide
+*******************************************************************
+*/
+
+static const double POW_10[] =
+{
+	1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,
+	1e8,  1e9,  1e10, 1e11, 1e12, 1e13, 1e14, 1e15,
+	1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
+
+static const int MAX_EXACT_POW_10 = 22;
+static const int MAX_MANTISSA_DIGITS = 19;	// largest digit count that always fits in 64 bits
+
+/*
+*******************************************************************
+* Constructor
+*******************************************************************
+* @param const char*   - the first character of the text
+* @param unsigned long - the number of characters in the text
+*/
+
+ASTextReader::ASTextReader(const char* data, unsigned long size)
+{
+	m_curr = data;
+	m_end  = data + size;
+}
+
+/*
+*******************************************************************
+* Empty Constructor
+*******************************************************************
+*/
+
+ASTextReader::ASTextReader(const ASTextReader&)
+{}
+
+/*
+*******************************************************************
+* Destructor
+*******************************************************************
+*/
+
+ASTextReader::~ASTextReader()
+{}
+
+/*
+*******************************************************************
+* METHOD: Skip Past
+*******************************************************************
+* Moves the cursor to the character after the next occurrence of
+* the given character
+*
+* @param char - the character to search for
+*
+* @return bool - True if the character was found, else false
+*/
+
+bool ASTextReader::SkipPast(char c)
+{
+	while(m_curr < m_end)
+	{
+		if(*m_curr++ == c)
+			return true;
+	}
+
+	return false;
+}
+
+/*
+*******************************************************************
+* METHOD: Skip Whitespace
+*******************************************************************
+* Moves the cursor past any spaces, tabs and line breaks
+*/
+
+void ASTextReader::SkipWhitespace()
+{
+	while(m_curr < m_end && (*m_curr == ' ' || *m_curr == '\t' || *m_curr == '\r' || *m_curr == '\n'))
+		m_curr++;
+}
+
+/*
+*******************************************************************
+* METHOD: Skip Line
+*******************************************************************
+* Moves the cursor to the first character of the next line
+*/
+
+void ASTextReader::SkipLine()
+{
+	SkipPast('\n');
+}
+
+/*
+*******************************************************************
+* METHOD: Read Int
+*******************************************************************
+* Reads a signed decimal integer, skipping any whitespace in front
+* of it
+*
+* @param int& - output parameter for the value read
+*
+* @return bool - True if a number was read, else false
+*/
+
+bool ASTextReader::ReadInt(int& out)
+{
+	bool negative = false;
+	int  value    = 0;
+
+	SkipWhitespace();
+
+	if(m_curr < m_end && (*m_curr == '-' || *m_curr == '+'))
+	{
+		negative = (*m_curr == '-');
+		m_curr++;
+	}
+
+	// There must be at least one digit for this to be a number
+	if(m_curr >= m_end || *m_curr < '0' || *m_curr > '9')
+		return false;
+
+	while(m_curr < m_end && *m_curr >= '0' && *m_curr <= '9')
+	{
+		value = (value * 10) + (*m_curr - '0');
+		m_curr++;
+	}
+
+	out = negative ? -value : value;
+	return true;
+}
+
+/*
+*******************************************************************
+* METHOD: Read Float
+*******************************************************************
+* Reads a decimal floating point number in the same forms that
+* operator>> accepts ("-1", "0.5", ".5", "1e-3").  The digits are
+* gathered into a 64 bit mantissa and then scaled once by a power
+* of ten, so the mesh data we export (well under 15 significant
+* digits) is read back to exactly the same float as ifstream gives
+*
+* @param float& - output parameter for the value read
+*
+* @return bool - True if a number was read, else false
+*/
+
+bool ASTextReader::ReadFloat(float& out)
+{
+	unsigned long long mantissa = 0;
+	bool negative  = false;
+	int  numDigits = 0;
+	int  exponent  = 0;
+	bool hasDigits = false;
+
+	SkipWhitespace();
+
+	if(m_curr < m_end && (*m_curr == '-' || *m_curr == '+'))
+	{
+		negative = (*m_curr == '-');
+		m_curr++;
+	}
+
+	// Integer part - digits past the 19th no longer fit in the mantissa so they only
+	// move the decimal point
+	while(m_curr < m_end && *m_curr >= '0' && *m_curr <= '9')
+	{
+		if(numDigits < MAX_MANTISSA_DIGITS)
+		{
+			mantissa = (mantissa * 10) + (*m_curr - '0');
+			if(mantissa != 0)
+				numDigits++;
+		}
+		else
+			exponent++;
+
+		hasDigits = true;
+		m_curr++;
+	}
+
+	// Fractional part
+	if(m_curr < m_end && *m_curr == '.')
+	{
+		m_curr++;
+		while(m_curr < m_end && *m_curr >= '0' && *m_curr <= '9')
+		{
+			if(numDigits < MAX_MANTISSA_DIGITS)
+			{
+				mantissa = (mantissa * 10) + (*m_curr - '0');
+				if(mantissa != 0)
+					numDigits++;
+				exponent--;
+			}
+
+			hasDigits = true;
+			m_curr++;
+		}
+	}
+
+	if(!hasDigits)
+		return false;
+
+	// Exponent part, only consumed if it is followed by a number
+	if(m_curr < m_end && (*m_curr == 'e' || *m_curr == 'E'))
+	{
+		const char* mark = m_curr;
+		bool expNegative = false;
+		int  expValue    = 0;
+
+		m_curr++;
+		if(m_curr < m_end && (*m_curr == '-' || *m_curr == '+'))
+		{
+			expNegative = (*m_curr == '-');
+			m_curr++;
+		}
+
+		if(m_curr < m_end && *m_curr >= '0' && *m_curr <= '9')
+		{
+			while(m_curr < m_end && *m_curr >= '0' && *m_curr <= '9')
+			{
+				if(expValue < 10000)
+					expValue = (expValue * 10) + (*m_curr - '0');
+				m_curr++;
+			}
+			exponent += expNegative ? -expValue : expValue;
+		}
+		else
+			m_curr = mark;
+	}
+
+	// Scale the mantissa by the exponent, the exact table covers every value the
+	// exporters write, pow() is only hit for extreme exponents
+	double value = (double)mantissa;
+	if(exponent < 0)
+	{
+		if(-exponent <= MAX_EXACT_POW_10)
+			value /= POW_10[-exponent];
+		else
+			value /= pow(10.0, -exponent);
+	}
+	else if(exponent > 0)
+	{
+		if(exponent <= MAX_EXACT_POW_10)
+			value *= POW_10[exponent];
+		else
+			value *= pow(10.0, exponent);
+	}
+
+	out = (float)(negative ? -value : value);
+	return true;
+}
+
+/*
+*******************************************************************
+* METHOD: At End
+*******************************************************************
+* @return bool - True if every character has been read
+*/
+
+bool ASTextReader::AtEnd()
+{
+	return m_curr >= m_end;
+}
+
+/*
+*******************************************************************
+* METHOD: At End Of Line
+*******************************************************************
+* Skips spaces and tabs, then checks whether the line has finished
+*
+* @return bool - True if there is nothing else on this line
+*/
+
+bool ASTextReader::AtEndOfLine()
+{
+	while(m_curr < m_end && (*m_curr == ' ' || *m_curr == '\t' || *m_curr == '\r'))
+		m_curr++;
+
+	return (m_curr >= m_end) || (*m_curr == '\n');
+}
+
+/*
+*******************************************************************
+* METHOD: Peek
+*******************************************************************
+* @return char - the character under the cursor, or 0 at the end
+*/
+
+char ASTextReader::Peek()
+{
+	if(m_curr >= m_end)
+		return 0;
+
+	return *m_curr;
+}
+
+/*
+*******************************************************************
+* METHOD: Advance
+*******************************************************************
+* Moves the cursor on by one character
+*/
+
+void ASTextReader::Advance()
+{
+	if(m_curr < m_end)
+		m_curr++;
+}
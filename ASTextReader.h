@@ -0,0 +1,46 @@
+/*
+******************************************************************
+* ASTextReader.h
+*******************************************************************
+* Reads numbers out of a block of text held in memory (usually a
+* mapped file).  Nothing is allocated and the C locale is never
+* consulted, so it is far quicker than reading through ifstream
+*******************************************************************
+*/
+
+#ifndef _ASTEXTREADER_H_
+#define _ASTEXTREADER_H_
+
+/*
+*******************************************************************
+* Class declaration
+*******************************************************************
+*/
+
+class ASTextReader
+{
+public:
+	// Constructors and destructor
+	ASTextReader(const char*, unsigned long);
+	ASTextReader(const ASTextReader&);
+	~ASTextReader();
+
+	// Public methods
+	bool SkipPast(char);
+	void SkipWhitespace();
+	void SkipLine();
+	bool ReadInt(int&);
+	bool ReadFloat(float&);
+
+	bool AtEnd();
+	bool AtEndOfLine();
+	char Peek();
+	void Advance();
+
+private:
+	// Private member variables
+	const char* m_curr;
+	const char* m_end;
+};
+
+#endif
@@ -42,7 +42,9 @@ ASTexture::~ASTexture()
 ******************************************************************
 * METHOD: Init
 ******************************************************************
-* Initialise the Texture shader
+* Initialise the Texture shader, the texture comes from the
+* resource manager so a file used by several objects is only
+* loaded once.  Release() drops this object's reference to it
 *
 * @param ID3D11Device* - The device we are rendering with
 * @param WCHAR* - The name of the texture file we are loading
@@ -52,11 +54,11 @@ ASTexture::~ASTexture()
 
 bool ASTexture::Init(ID3D11Device* device, WCHAR* filename)
 {
-	HRESULT hr;
+	AS_PROFILE("ASTexture::Init");
 
 	// Load the texture into m_texture using the filename and device pointer
-	hr = D3DX11CreateShaderResourceViewFromFile(device, filename, NULL, NULL, &m_texture, NULL);
-	if(FAILED(hr))
+	m_texture = ASResourceManager::GetInstance()->AcquireTexture(device, filename);
+	if(!m_texture)
 		return false;
 	else
 		return true;
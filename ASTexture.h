@@ -19,6 +19,8 @@
 #include <d3d11.h>
 #include <d3dx11tex.h>
 #include <vector>
+#include "ASResourceManager.h"
+#include "ASProfiler.h"
 
 /*
 ******************************************************************
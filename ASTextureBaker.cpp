@@ -0,0 +1,220 @@
+/*
+******************************************************************
+* ASTextureBaker.cpp
+*******************************************************************
+* Implements all methods from ASTextureBaker.h
+*******************************************************************
+*/
+
+#include "ASTextureBaker.h"
+
+/*
+*******************************************************************
+* Constructor
+*******************************************************************
+*/
+
+ASTextureBaker::ASTextureBaker()
+{}
+
+/*
+*******************************************************************
+* Empty Constructor
+*******************************************************************
+*/
+
+ASTextureBaker::ASTextureBaker(const ASTextureBaker&)
+{}
+
+/*
+*******************************************************************
+* Destructor
+*******************************************************************
+*/
+
+ASTextureBaker::~ASTextureBaker()
+{}
+
+/*
+*******************************************************************
+* METHOD: Bake
+*******************************************************************
+* Packs a list of .dds files into a texture array file at the size
+* of the largest, the layers keep the order they are listed in.
+* The result is appended to ./log/texture-bake.txt
+*
+* @param const char*           - the texture array file to write
+* @param const vector<char*>&  - the layer files, in slice order
+*
+* @return bool - True if the array was written, else false
+*/
+
+bool ASTextureBaker::Bake(const char* arrayFile, const vector<char*>& layers)
+{
+	Release();
+
+	bool success = !layers.empty();
+	for(unsigned int i = 0; success && i < layers.size(); i++)
+		success = AddLayer(layers[i]);
+
+	if(success)
+		success = m_packer.Pack(0) && Write(arrayFile);
+	if(success)
+		Report(arrayFile, layers);
+
+	Release();
+	return success;
+}
+
+/*
+*******************************************************************
+* METHOD: Release
+*******************************************************************
+* Forgets every layer and frees the packed data
+*/
+
+void ASTextureBaker::Release()
+{
+	m_packer.Release();
+}
+
+/*
+*******************************************************************
+* METHOD: Is Stale
+*******************************************************************
+* Checks whether a baked array needs building again, either it is
+* missing, holds a different number of layers or one of the layer
+* files was written after it
+*
+* @param const char*          - the texture array file
+* @param const vector<char*>& - the layer files it is baked from
+*
+* @return bool - True if the array should be baked, else false
+*/
+
+bool ASTextureBaker::IsStale(const char* arrayFile, const vector<char*>& layers)
+{
+	WIN32_FILE_ATTRIBUTE_DATA baked;
+	WIN32_FILE_ATTRIBUTE_DATA source;
+	ASDDSFile file;
+
+	if(!GetFileAttributesExA(arrayFile, GetFileExInfoStandard, &baked))
+		return true;
+
+	if(!file.Init(arrayFile))
+		return true;
+
+	bool stale = (file.GetArraySize() != (int)layers.size());
+	file.Release();
+
+	for(unsigned int i = 0; !stale && i < layers.size(); i++)
+	{
+		if(GetFileAttributesExA(layers[i], GetFileExInfoStandard, &source) &&
+		   CompareFileTime(&source.ftLastWriteTime, &baked.ftLastWriteTime) > 0)
+			stale = true;
+	}
+
+	return stale;
+}
+
+/*
+*******************************************************************
+* METHOD: Add Layer
+*******************************************************************
+* Reads level 0 of a 32 bit .dds file as the next layer
+*
+* @param char* - the .dds file to read
+*
+* @return bool - True if the layer was added, else false
+*/
+
+bool ASTextureBaker::AddLayer(char* filename)
+{
+	ASDDSFile file;
+	ASTexturePacker::ASChannelOrder order;
+
+	if(!file.Init(filename))
+		return false;
+
+	switch(file.GetFormat())
+	{
+	case DXGI_FORMAT_R8G8B8A8_UNORM:
+		order = ASTexturePacker::CHANNELS_RGBA;
+		break;
+	case DXGI_FORMAT_B8G8R8A8_UNORM:
+		order = ASTexturePacker::CHANNELS_BGRA;
+		break;
+	case DXGI_FORMAT_B8G8R8X8_UNORM:
+		order = ASTexturePacker::CHANNELS_BGRX;
+		break;
+	default:
+		file.Release();
+		return false;
+	}
+
+	bool success = m_packer.AddLayer((const unsigned char*)file.GetMipData(0), file.GetWidth(), file.GetHeight(), order);
+	file.Release();
+
+	return success;
+}
+
+/*
+*******************************************************************
+* METHOD: Write
+*******************************************************************
+* Writes the packed layers as a .dds texture array
+*
+* @param const char* - the file to write
+*
+* @return bool - True if the file was written, else false
+*/
+
+bool ASTextureBaker::Write(const char* filename)
+{
+	if(m_packer.GetLayerCount() == 0 || m_packer.GetMipCount() == 0)
+		return false;
+
+	DXGI_FORMAT format = (m_packer.GetChannelOrder() == ASTexturePacker::CHANNELS_RGBA) ?
+						 DXGI_FORMAT_R8G8B8A8_UNORM : DXGI_FORMAT_B8G8R8A8_UNORM;
+
+	return ASDDSFile::Write(filename, format, m_packer.GetSize(), m_packer.GetSize(), m_packer.GetMipCount(),
+							m_packer.GetLayerCount(), m_packer.GetData(0, 0));
+}
+
+/*
+*******************************************************************
+* METHOD: Report
+*******************************************************************
+* Appends what was baked to ./log/texture-bake.txt
+*
+* @param const char*          - the texture array file
+* @param const vector<char*>& - the layer files
+*/
+
+void ASTextureBaker::Report(const char* arrayFile, const vector<char*>& layers)
+{
+	ofstream fout;
+
+	fout.open("./log/texture-bake.txt", ios::app);
+	if(fout.fail())
+		return;
+
+	int          numLayers = m_packer.GetLayerCount();
+	unsigned int size      = m_packer.GetSize();
+
+	fout << "Baked " << arrayFile << ": " << numLayers << " layers, " << size << "x" << size << ", "
+		 << m_packer.GetMipCount() << " mips, " << ((m_packer.GetLayerBytes() * numLayers) / 1024) << " KB" << endl;
+
+	for(int i = 0; i < numLayers; i++)
+	{
+		unsigned int width  = m_packer.GetLayerWidth(i);
+		unsigned int height = m_packer.GetLayerHeight(i);
+
+		fout << "  slice " << i << ": " << layers[i] << " (" << width << "x" << height;
+		if(width != size || height != size)
+			fout << ", resampled";
+		fout << ")" << endl;
+	}
+
+	fout.close();
+}
@@ -0,0 +1,63 @@
+/*
+******************************************************************
+* ASTextureBaker.h
+*******************************************************************
+* Bakes a list of 32 bit .dds files into one .dds texture array.
+* The layers are read with ASDDSFile, packed by ASTexturePacker and
+* the result written back out with ASDDSFile, so this is the only
+* part of baking that knows the layers are DXGI formats.  The
+* array is only baked again when IsStale() finds it out of date
+*******************************************************************
+*/
+
+#ifndef _ASTEXTUREBAKER_H_
+#define _ASTEXTUREBAKER_H_
+
+/*
+*******************************************************************
+* Includes:
+*******************************************************************
+* + ASDDSFile.h has been included to read the layers and write
+*   the baked array
+* + ASTexturePacker.h has been included to build the array
+*******************************************************************
+*/
+
+#include <vector>
+#include <fstream>
+#include "ASDDSFile.h"
+#include "ASTexturePacker.h"
+
+using namespace std;
+
+/*
+*******************************************************************
+* Class declaration
+*******************************************************************
+*/
+
+class ASTextureBaker
+{
+public:
+	// Constructors and destructor
+	ASTextureBaker();
+	ASTextureBaker(const ASTextureBaker&);
+	~ASTextureBaker();
+
+	// Public methods
+	bool Bake(const char*, const vector<char*>&);
+	void Release();
+
+	static bool IsStale(const char*, const vector<char*>&);
+
+private:
+	// Private methods
+	bool AddLayer(char*);
+	bool Write(const char*);
+	void Report(const char*, const vector<char*>&);
+
+	// Private member variables
+	ASTexturePacker m_packer;
+};
+
+#endif
@@ -0,0 +1,364 @@
+/*
+******************************************************************
+* ASTexturePacker.cpp
+*******************************************************************
+* Implements all methods from ASTexturePacker.h
+*******************************************************************
+*/
+
+#include "ASTexturePacker.h"
+
+/*
+*******************************************************************
+* Constructor
+*******************************************************************
+*/
+
+ASTexturePacker::ASTexturePacker()
+{
+	m_order      = CHANNELS_NONE;
+	m_size       = 0;
+	m_numMips    = 0;
+	m_layerBytes = 0;
+}
+
+/*
+*******************************************************************
+* Empty Constructor
+*******************************************************************
+*/
+
+ASTexturePacker::ASTexturePacker(const ASTexturePacker&)
+{}
+
+/*
+*******************************************************************
+* Destructor
+*******************************************************************
+*/
+
+ASTexturePacker::~ASTexturePacker()
+{}
+
+/*
+*******************************************************************
+* METHOD: Add Layer
+*******************************************************************
+* Copies a tightly packed 32 bit image as the next layer.  The
+* first layer decides the channel order, later layers stored the
+* other way round have red and blue swapped to match
+*
+* @param const unsigned char* - the pixels, 4 bytes each
+* @param unsigned int         - the width of the image
+* @param unsigned int         - the height of the image
+* @param ASChannelOrder       - the order of each pixel's bytes
+*
+* @return bool - True if the layer was added, else false
+*/
+
+bool ASTexturePacker::AddLayer(const unsigned char* pixels, unsigned int width, unsigned int height, ASChannelOrder order)
+{
+	if(!pixels || width == 0 || height == 0 || order == CHANNELS_NONE || (int)m_layers.size() >= MAX_LAYERS)
+		return false;
+
+	// The unused channel of an X8 image becomes opaque alpha
+	bool opaque = (order == CHANNELS_BGRX);
+	if(opaque)
+		order = CHANNELS_BGRA;
+
+	if(m_order == CHANNELS_NONE)
+		m_order = order;
+
+	bool swap = (order != m_order);
+
+	m_layers.push_back(ASLayer());
+
+	ASLayer& layer = m_layers.back();
+	layer.width  = width;
+	layer.height = height;
+	layer.pixels.assign(pixels, pixels + (width * height * 4));
+
+	if(!swap && !opaque)
+		return true;
+
+	for(unsigned int i = 0; i < layer.pixels.size(); i += 4)
+	{
+		if(swap)
+		{
+			unsigned char red   = layer.pixels[i];
+			layer.pixels[i]     = layer.pixels[i + 2];
+			layer.pixels[i + 2] = red;
+		}
+		if(opaque)
+			layer.pixels[i + 3] = 255;
+	}
+
+	return true;
+}
+
+/*
+*******************************************************************
+* METHOD: Pack
+*******************************************************************
+* Resamples every layer to the same size and builds its mip chain.
+* Each level is filtered from the level above it in the same layer
+*
+* @param unsigned int - the width and height of level 0, 0 to use
+*                       the largest side of any layer
+*
+* @return bool - True if the layers were packed, else false
+*/
+
+bool ASTexturePacker::Pack(unsigned int size)
+{
+	if(m_layers.empty())
+		return false;
+
+	if(size == 0)
+	{
+		for(unsigned int i = 0; i < m_layers.size(); i++)
+			size = max(size, max(m_layers[i].width, m_layers[i].height));
+	}
+
+	// Lay out one full chain, every layer repeats it
+	m_size       = size;
+	m_layerBytes = 0;
+	m_numMips    = 0;
+	for(unsigned int dim = size; m_numMips < MAX_MIPS; dim >>= 1)
+	{
+		m_mipOffsets[m_numMips++] = m_layerBytes;
+		m_layerBytes += dim * dim * 4;
+
+		if(dim == 1)
+			break;
+	}
+
+	m_data.resize((size_t)m_layerBytes * m_layers.size());
+
+	for(int i = 0; i < (int)m_layers.size(); i++)
+	{
+		const ASLayer& layer = m_layers[i];
+
+		Resample(&layer.pixels[0], layer.width, layer.height, &m_data[(size_t)i * m_layerBytes], size, size);
+
+		for(int mip = 1; mip < m_numMips; mip++)
+		{
+			unsigned int above = GetMipWidth(mip - 1);
+			unsigned int dim   = GetMipWidth(mip);
+
+			Resample(GetData(i, mip - 1), above, above, &m_data[((size_t)i * m_layerBytes) + m_mipOffsets[mip]], dim, dim);
+		}
+	}
+
+	return true;
+}
+
+/*
+*******************************************************************
+* METHOD: Release
+*******************************************************************
+* Forgets every layer and frees the packed data
+*/
+
+void ASTexturePacker::Release()
+{
+	m_layers.clear();
+	m_data.clear();
+	m_rows.clear();
+	m_order      = CHANNELS_NONE;
+	m_size       = 0;
+	m_numMips    = 0;
+	m_layerBytes = 0;
+}
+
+/*
+*******************************************************************
+* Getters for the packed array
+*******************************************************************
+*/
+
+int ASTexturePacker::GetLayerCount()
+{
+	return (int)m_layers.size();
+}
+
+unsigned int ASTexturePacker::GetLayerWidth(int layer)
+{
+	return m_layers[layer].width;
+}
+
+unsigned int ASTexturePacker::GetLayerHeight(int layer)
+{
+	return m_layers[layer].height;
+}
+
+unsigned int ASTexturePacker::GetSize()
+{
+	return m_size;
+}
+
+int ASTexturePacker::GetMipCount()
+{
+	return m_numMips;
+}
+
+ASTexturePacker::ASChannelOrder ASTexturePacker::GetChannelOrder()
+{
+	return m_order;
+}
+
+/*
+*******************************************************************
+* Getters for one mip level, every layer has the same levels
+*******************************************************************
+*/
+
+unsigned int ASTexturePacker::GetMipWidth(int mip)
+{
+	return max(m_size >> mip, 1u);
+}
+
+unsigned int ASTexturePacker::GetMipSize(int mip)
+{
+	unsigned int dim = GetMipWidth(mip);
+	return dim * dim * 4;
+}
+
+unsigned int ASTexturePacker::GetLayerBytes()
+{
+	return m_layerBytes;
+}
+
+const unsigned char* ASTexturePacker::GetData(int layer, int mip)
+{
+	return &m_data[((size_t)layer * m_layerBytes) + m_mipOffsets[mip]];
+}
+
+/*
+*******************************************************************
+* METHOD: Resample
+*******************************************************************
+* Scales a 32 bit image, first along each row and then down each
+* column.  Every channel is filtered the same way
+*
+* @param const unsigned char* - the source pixels
+* @param unsigned int         - the source width
+* @param unsigned int         - the source height
+* @param unsigned char*       - output for the scaled pixels
+* @param unsigned int         - the destination width
+* @param unsigned int         - the destination height
+*/
+
+void ASTexturePacker::Resample(const unsigned char* src, unsigned int srcWidth, unsigned int srcHeight,
+							   unsigned char* dest, unsigned int destWidth, unsigned int destHeight)
+{
+	BuildTaps(srcWidth,  destWidth,  m_tapsX, m_firstX);
+	BuildTaps(srcHeight, destHeight, m_tapsY, m_firstY);
+
+	m_rows.resize((size_t)srcHeight * destWidth * 4);
+
+	// Filter each source row to the new width
+	for(unsigned int y = 0; y < srcHeight; y++)
+	{
+		const unsigned char* row = src + ((size_t)y * srcWidth * 4);
+		float* out               = &m_rows[(size_t)y * destWidth * 4];
+
+		for(unsigned int x = 0; x < destWidth; x++)
+		{
+			float sum[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+
+			for(unsigned int t = m_firstX[x]; t < m_firstX[x + 1]; t++)
+			{
+				const unsigned char* texel = row + (m_tapsX[t].index * 4);
+				for(int c = 0; c < 4; c++)
+					sum[c] += texel[c] * m_tapsX[t].weight;
+			}
+
+			for(int c = 0; c < 4; c++)
+				out[(x * 4) + c] = sum[c];
+		}
+	}
+
+	// Then filter the columns to the new height
+	for(unsigned int y = 0; y < destHeight; y++)
+	{
+		unsigned char* out = dest + ((size_t)y * destWidth * 4);
+
+		for(unsigned int x = 0; x < destWidth * 4; x++)
+		{
+			float sum = 0.0f;
+
+			for(unsigned int t = m_firstY[y]; t < m_firstY[y + 1]; t++)
+				sum += m_rows[((size_t)m_tapsY[t].index * destWidth * 4) + x] * m_tapsY[t].weight;
+
+			out[x] = (unsigned char)max(0.0f, min(255.0f, sum + 0.5f));
+		}
+	}
+}
+
+/*
+*******************************************************************
+* METHOD: Build Taps
+*******************************************************************
+* Works out which source texels make up each destination texel
+* along one axis.  When shrinking, a destination texel covers an
+* exact span of the source and each texel counts by how much of it
+* lies inside, nothing outside the image is touched.  When growing,
+* the two nearest texels are blended and the edges wrap round
+*
+* @param unsigned int           - the source size
+* @param unsigned int           - the destination size
+* @param vector<ASTap>&         - output for the taps of every destination texel
+* @param vector<unsigned int>&  - output, the first tap of each destination texel
+*                                 with one extra entry marking the end
+*/
+
+void ASTexturePacker::BuildTaps(unsigned int srcSize, unsigned int destSize, vector<ASTap>& taps, vector<unsigned int>& first)
+{
+	ASTap tap;
+
+	taps.clear();
+	first.resize(destSize + 1);
+
+	float scale = (float)srcSize / (float)destSize;
+
+	for(unsigned int i = 0; i < destSize; i++)
+	{
+		first[i] = (unsigned int)taps.size();
+
+		if(srcSize >= destSize)
+		{
+			float start = i * scale;
+			float end   = (i + 1) * scale;
+
+			for(unsigned int k = (unsigned int)start; k < srcSize && (float)k < end; k++)
+			{
+				float covered = min(end, (float)(k + 1)) - max(start, (float)k);
+				if(covered <= 0.0f)
+					continue;
+
+				tap.index  = k;
+				tap.weight = covered / scale;
+				taps.push_back(tap);
+			}
+		}
+		else
+		{
+			// Centre of the destination texel in source texels
+			float centre = ((i + 0.5f) * scale) - 0.5f;
+			float base   = floorf(centre);
+			float frac   = centre - base;
+			int   left   = (int)base;
+
+			tap.index  = (unsigned int)((left % (int)srcSize + (int)srcSize) % (int)srcSize);
+			tap.weight = 1.0f - frac;
+			taps.push_back(tap);
+
+			tap.index  = (unsigned int)(((left + 1) % (int)srcSize + (int)srcSize) % (int)srcSize);
+			tap.weight = frac;
+			taps.push_back(tap);
+		}
+	}
+
+	first[destSize] = (unsigned int)taps.size();
+}
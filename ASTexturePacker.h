@@ -0,0 +1,118 @@
+/*
+******************************************************************
+* ASTexturePacker.h
+*******************************************************************
+* Bakes several 32 bit images into the layers of one texture array
+* so a pass that samples them all binds a single resource.  Every
+* layer is resampled to the same square size and given its own full
+* mip chain, the levels of one layer are only ever built from that
+* layer so nothing bleeds across from its neighbours.
+*
+* Shrinking uses an area weighted box filter, so odd sizes still
+* take in every texel of the level above.  Growing a smaller layer
+* uses a bilinear filter that wraps around the edges, the layers
+* are tiled over the terrain and their edges meet their opposite
+* side.  The packer works on pixels in memory only and knows
+* nothing of D3D, ASTextureBaker reads the layers from .dds files
+* and writes the packed array
+*******************************************************************
+*/
+
+#ifndef _ASTEXTUREPACKER_H_
+#define _ASTEXTUREPACKER_H_
+
+/*
+*******************************************************************
+* Includes:
+*******************************************************************
+*/
+
+#include <vector>
+#include <algorithm>
+#include <math.h>
+
+using namespace std;
+
+/*
+*******************************************************************
+* Class declaration
+*******************************************************************
+*/
+
+class ASTexturePacker
+{
+public:
+	// Most layers one array may hold
+	static const int MAX_LAYERS = 16;
+
+	// Most levels a layer's chain may have, matches ASDDSFile
+	static const int MAX_MIPS = 16;
+
+	// The order of the 4 bytes of a pixel
+	enum ASChannelOrder
+	{
+		CHANNELS_NONE,		// no layer added yet
+		CHANNELS_BGRA,
+		CHANNELS_RGBA,
+		CHANNELS_BGRX		// BGRA with the alpha unused, read as opaque
+	};
+
+private:
+	// Level 0 of one layer, 4 bytes per pixel in the packer's channel order
+	struct ASLayer
+	{
+		vector<unsigned char> pixels;
+		unsigned int          width;
+		unsigned int          height;
+	};
+	// One source texel and how much it adds to a destination texel along one axis
+	struct ASTap
+	{
+		unsigned int index;
+		float        weight;
+	};
+
+public:
+	// Constructors and destructor
+	ASTexturePacker();
+	ASTexturePacker(const ASTexturePacker&);
+	~ASTexturePacker();
+
+	// Public methods
+	bool AddLayer(const unsigned char*, unsigned int, unsigned int, ASChannelOrder);
+	bool Pack(unsigned int);
+	void Release();
+
+	int            GetLayerCount();
+	unsigned int   GetLayerWidth(int);
+	unsigned int   GetLayerHeight(int);
+	unsigned int   GetSize();
+	int            GetMipCount();
+	ASChannelOrder GetChannelOrder();
+
+	unsigned int         GetMipWidth(int);
+	unsigned int         GetMipSize(int);
+	unsigned int         GetLayerBytes();
+	const unsigned char* GetData(int, int);
+
+private:
+	// Private methods
+	void Resample(const unsigned char*, unsigned int, unsigned int, unsigned char*, unsigned int, unsigned int);
+	void BuildTaps(unsigned int, unsigned int, vector<ASTap>&, vector<unsigned int>&);
+
+	// Private member variables
+	vector<ASLayer>       m_layers;
+	ASChannelOrder        m_order;
+	unsigned int          m_size;					// width and height of level 0 once packed
+	int                   m_numMips;
+	unsigned int          m_mipOffsets[MAX_MIPS];	// byte offset of each level within a layer
+	unsigned int          m_layerBytes;
+	vector<unsigned char> m_data;					// every level of layer 0, then layer 1 and so on
+	vector<float>         m_rows;					// scratch space for Resample()
+	vector<ASTap>         m_tapsX;
+	vector<ASTap>         m_tapsY;
+	vector<unsigned int>  m_firstX;
+	vector<unsigned int>  m_firstY;
+};
+
+#endif
@@ -0,0 +1,403 @@
+/*
+******************************************************************
+* ASTextureResidency.cpp
+*******************************************************************
+* Implements all methods from ASTextureResidency.h
+*******************************************************************
+*/
+
+#include "ASTextureResidency.h"
+
+/*
+*******************************************************************
+* Constructor
+*******************************************************************
+*/
+
+ASTextureResidency::ASTextureResidency()
+{
+	m_uploadLimit = 0;
+	m_frame       = 0;
+	memset(&m_stats, 0, sizeof(m_stats));
+}
+
+/*
+*******************************************************************
+* Empty Constructor
+*******************************************************************
+*/
+
+ASTextureResidency::ASTextureResidency(const ASTextureResidency&)
+{}
+
+/*
+*******************************************************************
+* Destructor
+*******************************************************************
+*/
+
+ASTextureResidency::~ASTextureResidency()
+{}
+
+/*
+*******************************************************************
+* METHOD: Init
+*******************************************************************
+* @param unsigned long long - the most video memory streamed textures may use
+* @param unsigned long long - the most bytes loaded in one frame, 0 for no limit
+*/
+
+void ASTextureResidency::Init(unsigned long long budget, unsigned long long uploadLimit)
+{
+	Release();
+
+	m_stats.budgetBytes = budget;
+	m_uploadLimit       = uploadLimit;
+}
+
+/*
+*******************************************************************
+* METHOD: Release
+*******************************************************************
+* Forgets every texture and resets the statistics
+*/
+
+void ASTextureResidency::Release()
+{
+	unsigned long long budget = m_stats.budgetBytes;
+
+	m_textures.clear();
+	m_order.clear();
+	m_lru.clear();
+	m_frame = 0;
+
+	memset(&m_stats, 0, sizeof(m_stats));
+	m_stats.budgetBytes = budget;
+}
+
+/*
+*******************************************************************
+* METHOD: Set Budget
+*******************************************************************
+* Changes the memory budget, a smaller budget is enforced on the
+* next Update()
+*
+* @param unsigned long long - the new budget in bytes
+*/
+
+void ASTextureResidency::SetBudget(unsigned long long budget)
+{
+	m_stats.budgetBytes = budget;
+}
+
+/*
+*******************************************************************
+* METHOD: Add Texture
+*******************************************************************
+* Starts tracking a texture, only its tail levels are resident to
+* begin with.  The tail is always loaded, even over budget
+*
+* @param unsigned int              - the width of level 0
+* @param unsigned int              - the height of level 0
+* @param int                       - the number of mip levels
+* @param const unsigned long long* - the size of each level in bytes
+*
+* @return int - the texture's id, -1 if it has no levels
+*/
+
+int ASTextureResidency::AddTexture(unsigned int width, unsigned int height, int numMips, const unsigned long long* mipBytes)
+{
+	ASTexture texture;
+
+	if(numMips <= 0)
+		return -1;
+
+	memset(&texture, 0, sizeof(texture));
+	texture.numMips = min(numMips, (int)MAX_MIPS);
+	for(int i = 0; i < texture.numMips; i++)
+		texture.mipBytes[i] = mipBytes[i];
+
+	texture.tailMip      = GetTailMip(width, height, texture.numMips);
+	texture.residentMip  = texture.tailMip;
+	texture.requestedMip = texture.tailMip;
+	texture.changed      = true;
+
+	for(int i = texture.tailMip; i < texture.numMips; i++)
+		m_stats.residentBytes += texture.mipBytes[i];
+
+	m_textures.push_back(texture);
+	return (int)m_textures.size() - 1;
+}
+
+/*
+*******************************************************************
+* METHOD: Request Mip
+*******************************************************************
+* Asks for a texture to have a level resident for this frame, the
+* most detailed of several requests wins
+*
+* @param int - the texture's id
+* @param int - the most detailed level needed
+*/
+
+void ASTextureResidency::RequestMip(int id, int mip)
+{
+	ASTexture& texture = m_textures[id];
+
+	mip = max(0, min(mip, texture.tailMip));
+
+	if(texture.lastUsed != m_frame + 1)
+	{
+		texture.lastUsed     = m_frame + 1;
+		texture.requestedMip = mip;
+	}
+	else
+	{
+		texture.requestedMip = min(texture.requestedMip, mip);
+	}
+}
+
+/*
+*******************************************************************
+* METHOD: Update
+*******************************************************************
+* Ends the frame's requests and decides what to load and evict.
+* Textures used most recently load first, one level at a time from
+* the smallest missing level up, until the upload limit is reached.
+* A load that does not fit the budget evicts levels of the least
+* recently used textures, a texture requested this frame only loses
+* levels more detailed than it asked for.  Memory is not given back
+* while it fits the budget, so a texture coming back into view is
+* often still resident
+*/
+
+void ASTextureResidency::Update()
+{
+	unsigned long long uploaded = 0;
+	int i;
+
+	m_frame++;
+
+	for(i = 0; i < (int)m_textures.size(); i++)
+	{
+		ASTexture& texture = m_textures[i];
+		texture.changed = false;
+
+		// Textures not requested this frame only need their tail
+		if(texture.lastUsed != m_frame)
+			texture.requestedMip = texture.tailMip;
+	}
+
+	// A lower budget may have left us over it
+	if(m_stats.residentBytes > m_stats.budgetBytes)
+		MakeRoom(0);
+
+	// Serve the most recently used textures first
+	m_order.clear();
+	for(i = 0; i < (int)m_textures.size(); i++)
+	{
+		if(m_textures[i].requestedMip < m_textures[i].residentMip)
+			m_order.push_back(i);
+	}
+
+	ASLruCompare compare;
+	compare.textures = &m_textures;
+	stable_sort(m_order.begin(), m_order.end(), compare);
+
+	for(int j = (int)m_order.size() - 1; j >= 0; j--)
+	{
+		ASTexture& texture = m_textures[m_order[j]];
+
+		while(texture.residentMip > texture.requestedMip)
+		{
+			unsigned long long bytes = texture.mipBytes[texture.residentMip - 1];
+
+			if(m_uploadLimit > 0 && uploaded > 0 && uploaded + bytes > m_uploadLimit)
+				break;
+			if(!MakeRoom(bytes))
+				break;
+
+			texture.residentMip--;
+			texture.changed = true;
+
+			uploaded               += bytes;
+			m_stats.residentBytes  += bytes;
+			m_stats.loadedBytes    += bytes;
+			m_stats.numLoads++;
+		}
+	}
+
+	// Gather the statistics for this frame
+	m_stats.requestedBytes = 0;
+	m_stats.numPending     = 0;
+	for(i = 0; i < (int)m_textures.size(); i++)
+	{
+		const ASTexture& texture = m_textures[i];
+
+		for(int mip = texture.requestedMip; mip < texture.numMips; mip++)
+			m_stats.requestedBytes += texture.mipBytes[mip];
+
+		if(texture.residentMip > texture.requestedMip)
+			m_stats.numPending++;
+	}
+}
+
+/*
+*******************************************************************
+* Getters and setters for one texture
+*******************************************************************
+*/
+
+int ASTextureResidency::GetResidentMip(int id)
+{
+	return m_textures[id].residentMip;
+}
+
+// True if the texture's resident levels changed in the last Update()
+bool ASTextureResidency::HasChanged(int id)
+{
+	return m_textures[id].changed;
+}
+
+// Used when the GPU could not apply a decision, the texture is put back how it was
+void ASTextureResidency::SetResidentMip(int id, int mip)
+{
+	ASTexture& texture = m_textures[id];
+	int i;
+
+	for(i = texture.residentMip; i < texture.numMips; i++)
+		m_stats.residentBytes -= texture.mipBytes[i];
+
+	texture.residentMip = max(0, min(mip, texture.tailMip));
+
+	for(i = texture.residentMip; i < texture.numMips; i++)
+		m_stats.residentBytes += texture.mipBytes[i];
+}
+
+int ASTextureResidency::GetTextureCount()
+{
+	return (int)m_textures.size();
+}
+
+const ASTextureResidency::ASStats& ASTextureResidency::GetStats()
+{
+	return m_stats;
+}
+
+/*
+*******************************************************************
+* METHOD: Select Mip
+*******************************************************************
+* Picks the level whose texels best match the screen pixels an
+* object covers, one level coarser for every halving of its size
+* on screen
+*
+* @param unsigned int - the width of level 0
+* @param unsigned int - the height of level 0
+* @param int          - the number of mip levels
+* @param float        - the number of pixels the texture spans on screen
+*
+* @return int - the most detailed level worth having
+*/
+
+int ASTextureResidency::SelectMip(unsigned int width, unsigned int height, int numMips, float screenPixels)
+{
+	float texels = (float)max(width, height);
+
+	if(screenPixels >= texels)
+		return 0;
+	if(screenPixels < 1.0f)
+		return numMips - 1;
+
+	int mip = (int)floorf(logf(texels / screenPixels) / logf(2.0f));
+	return min(mip, numMips - 1);
+}
+
+/*
+*******************************************************************
+* METHOD: Get Tail Mip
+*******************************************************************
+* Finds the first level that fits inside TAIL_SIZE, it and every
+* smaller level are always resident
+*
+* @param unsigned int - the width of level 0
+* @param unsigned int - the height of level 0
+* @param int          - the number of mip levels
+*
+* @return int - the first level of the tail
+*/
+
+int ASTextureResidency::GetTailMip(unsigned int width, unsigned int height, int numMips)
+{
+	for(int i = 0; i < numMips; i++)
+	{
+		if(max(width >> i, 1u) <= TAIL_SIZE && max(height >> i, 1u) <= TAIL_SIZE)
+			return i;
+	}
+
+	return numMips - 1;
+}
+
+/*
+*******************************************************************
+* METHOD: Make Room
+*******************************************************************
+* Evicts levels until a load of the given size fits the budget,
+* taking from the least recently used textures first
+*
+* @param unsigned long long - the size of the load
+*
+* @return bool - True if the load fits, else false
+*/
+
+bool ASTextureResidency::MakeRoom(unsigned long long bytes)
+{
+	if(m_stats.residentBytes + bytes <= m_stats.budgetBytes)
+		return true;
+
+	m_lru.clear();
+	for(int i = 0; i < (int)m_textures.size(); i++)
+		m_lru.push_back(i);
+
+	ASLruCompare compare;
+	compare.textures = &m_textures;
+	stable_sort(m_lru.begin(), m_lru.end(), compare);
+
+	for(int j = 0; j < (int)m_lru.size(); j++)
+	{
+		ASTexture& texture = m_textures[m_lru[j]];
+
+		// A texture in use this frame keeps what it asked for, the others keep their tail
+		int limit = (texture.lastUsed == m_frame) ? texture.requestedMip : texture.tailMip;
+
+		while(texture.residentMip < limit)
+		{
+			Evict(texture);
+			if(m_stats.residentBytes + bytes <= m_stats.budgetBytes)
+				return true;
+		}
+	}
+
+	return false;
+}
+
+/*
+*******************************************************************
+* METHOD: Evict
+*******************************************************************
+* Drops the most detailed resident level of a texture
+*
+* @param ASTexture& - the texture
+*/
+
+void ASTextureResidency::Evict(ASTexture& texture)
+{
+	unsigned long long bytes = texture.mipBytes[texture.residentMip];
+
+	texture.residentMip++;
+	texture.changed = true;
+
+	m_stats.residentBytes -= bytes;
+	m_stats.evictedBytes  += bytes;
+	m_stats.numEvictions++;
+}
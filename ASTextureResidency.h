@@ -0,0 +1,120 @@
+/*
+******************************************************************
+* ASTextureResidency.h
+*******************************************************************
+* Decides which mip levels of each streamed texture should be held
+* in video memory.  Every frame the renderer requests the most
+* detailed level it needs for each texture it draws, Update() then
+* loads the missing levels within a per frame upload limit and
+* keeps the total under a memory budget by evicting the most
+* detailed levels of the least recently used textures.
+*
+* Only sizes and level numbers are tracked here, nothing touches
+* the GPU, so the policy can be driven and checked on its own.
+* ASTextureStreamer applies the decisions to real textures
+*******************************************************************
+*/
+
+#ifndef _ASTEXTURERESIDENCY_H_
+#define _ASTEXTURERESIDENCY_H_
+
+/*
+*******************************************************************
+* Includes:
+*******************************************************************
+*/
+
+#include <vector>
+#include <algorithm>
+#include <math.h>
+#include <string.h>
+
+using namespace std;
+
+/*
+*******************************************************************
+* Class declaration
+*******************************************************************
+*/
+
+class ASTextureResidency
+{
+public:
+	static const int MAX_MIPS = 16;
+
+	// Levels this size and smaller are loaded up front and never evicted, so every
+	// texture always has something to draw with
+	static const unsigned int TAIL_SIZE = 64;
+
+	struct ASStats
+	{
+		unsigned long long budgetBytes;
+		unsigned long long residentBytes;	// bytes of all levels in video memory
+		unsigned long long requestedBytes;	// bytes needed to satisfy every request this frame
+		unsigned long long loadedBytes;		// totals since Init
+		unsigned long long evictedBytes;
+		int                numLoads;		// levels loaded and evicted since Init
+		int                numEvictions;
+		int                numPending;		// textures still short of their request after this frame
+	};
+
+private:
+	struct ASTexture
+	{
+		unsigned long long mipBytes[MAX_MIPS];
+		int                numMips;
+		int                tailMip;			// most detailed level that is never evicted
+		int                residentMip;		// most detailed level in video memory
+		int                requestedMip;	// most detailed level asked for this frame
+		unsigned int       lastUsed;		// frame the texture was last requested
+		bool               changed;
+	};
+	// Orders textures so the least recently used come first
+	struct ASLruCompare
+	{
+		const vector<ASTexture>* textures;
+		bool operator()(int a, int b) const
+		{
+			return (*textures)[a].lastUsed < (*textures)[b].lastUsed;
+		}
+	};
+
+public:
+	// Constructors and destructor
+	ASTextureResidency();
+	ASTextureResidency(const ASTextureResidency&);
+	~ASTextureResidency();
+
+	// Public methods
+	void Init(unsigned long long, unsigned long long);
+	void Release();
+	void SetBudget(unsigned long long);
+
+	int  AddTexture(unsigned int, unsigned int, int, const unsigned long long*);
+	void RequestMip(int, int);
+	void Update();
+
+	int  GetResidentMip(int);
+	bool HasChanged(int);
+	void SetResidentMip(int, int);
+	int  GetTextureCount();
+	const ASStats& GetStats();
+
+	static int SelectMip(unsigned int, unsigned int, int, float);
+	static int GetTailMip(unsigned int, unsigned int, int);
+
+private:
+	// Private methods
+	bool MakeRoom(unsigned long long);
+	void Evict(ASTexture&);
+
+	// Private member variables
+	vector<ASTexture>  m_textures;
+	vector<int>        m_order;				// scratch lists used to sort textures
+	vector<int>        m_lru;
+	unsigned long long m_uploadLimit;		// most bytes loaded in one Update()
+	unsigned int       m_frame;
+	ASStats            m_stats;
+};
+
+#endif
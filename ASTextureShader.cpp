@@ -129,7 +129,6 @@ bool ASTextureShader::InitShader(ID3D11Device* device, HWND handle, WCHAR* vsFil
 	// Init pointers to null
 	ID3D10Blob* err = 0;
 	ID3D10Blob* vsBuffer = 0;
-	ID3D10Blob* psBuffer = 0;
 
 	// Other descriptors for buffer
 	D3D11_BUFFER_DESC cBufferDesc;
@@ -139,8 +138,7 @@ bool ASTextureShader::InitShader(ID3D11Device* device, HWND handle, WCHAR* vsFil
 
 	// Compile shaders into buffers - any errors are caught and pushed to an error stack, if the 
 	// file is not found user is alerted by a popup message
-	hr = D3DX11CompileFromFile(vsFile, NULL, NULL, "TextureVertexShader", "vs_5_0", D3D10_SHADER_ENABLE_STRICTNESS, 
-							   0, NULL, &vsBuffer, &err, NULL);
+	hr = ASResourceManager::GetInstance()->AcquireVertexShader(device, vsFile, "TextureVertexShader", &m_vShader, &vsBuffer, &err);
 	if(FAILED(hr))
 	{
 		if(err)
@@ -152,8 +150,7 @@ bool ASTextureShader::InitShader(ID3D11Device* device, HWND handle, WCHAR* vsFil
 	}
 
 	// Compile the pixel shader
-	hr = D3DX11CompileFromFile(psFile, NULL, NULL, "TexturePixelShader", "ps_5_0", D3D10_SHADER_ENABLE_STRICTNESS,
-							  0, NULL, &psBuffer, &err, NULL);
+	hr = ASResourceManager::GetInstance()->AcquirePixelShader(device, psFile, "TexturePixelShader", &m_pShader, &err);
 	if(FAILED(hr))
 	{
 		if(err)
@@ -163,15 +160,6 @@ bool ASTextureShader::InitShader(ID3D11Device* device, HWND handle, WCHAR* vsFil
 		return false;
 	}
 
-	// Create shader objects from the pixel and vertex buffers. These pointers will be used to interact with the 
-	// vertex and pixel shaders
-	hr = device->CreateVertexShader(vsBuffer->GetBufferPointer(), vsBuffer->GetBufferSize(), NULL, &m_vShader);
-	if(FAILED(hr))
-		return false;
-	hr = device->CreatePixelShader(psBuffer->GetBufferPointer(), psBuffer->GetBufferSize(), NULL, &m_pShader);
-	if(FAILED(hr))
-		return false;
-
 	// Create the input layout of the vertex data. We define how far apart in memory vertex and pixel data sit,
 	// in this case every 12 bytes are position and every 16 bytes after that will be color - this tells the GPU
 	// the structure of the input, so it knows to process vertex information for 12 byes and then color information 
@@ -201,9 +189,7 @@ bool ASTextureShader::InitShader(ID3D11Device* device, HWND handle, WCHAR* vsFil
 
 	// Release the buffers and set null pointers to them as we have loaded the data into pointers
 	vsBuffer->Release();
-	psBuffer->Release();
 	vsBuffer = 0;
-	psBuffer = 0;
 
 	// Describe the constant buffer to pass to the Vertex Shader - the CB is used to talk directly to the shader
 	cBufferDesc.Usage = D3D11_USAGE_DYNAMIC;
@@ -0,0 +1,343 @@
+/*
+******************************************************************
+* ASTextureStreamer.cpp
+*******************************************************************
+* Implements all methods from ASTextureStreamer.h
+*******************************************************************
+*/
+
+#include "ASTextureStreamer.h"
+
+/*
+*******************************************************************
+* Constructor
+*******************************************************************
+*/
+
+ASTextureStreamer::ASTextureStreamer()
+{}
+
+/*
+*******************************************************************
+* Empty Constructor
+*******************************************************************
+*/
+
+ASTextureStreamer::ASTextureStreamer(const ASTextureStreamer&)
+{}
+
+/*
+*******************************************************************
+* Destructor
+*******************************************************************
+*/
+
+ASTextureStreamer::~ASTextureStreamer()
+{}
+
+/*
+*******************************************************************
+* METHOD: Init
+*******************************************************************
+* @param unsigned long long - the most video memory streamed textures may use
+* @param unsigned long long - the most bytes uploaded in one frame, 0 for no limit
+*/
+
+void ASTextureStreamer::Init(unsigned long long budget, unsigned long long uploadLimit)
+{
+	m_residency.Init(budget, uploadLimit);
+}
+
+/*
+*******************************************************************
+* METHOD: Load
+*******************************************************************
+* Opens a .dds file for streaming and creates its texture holding
+* just the small tail levels, the rest arrive once it is requested.
+* A file that is already streaming returns the same id
+*
+* @param ID3D11Device* - the device to create the texture with
+* @param const char*   - the .dds file
+*
+* @return int - the texture's id, -1 if the file could not be used
+*/
+
+int ASTextureStreamer::Load(ID3D11Device* device, const char* filename)
+{
+	AS_PROFILE("ASTextureStreamer::Load");
+
+	ASStreamedTexture streamed;
+	unsigned long long mipBytes[ASDDSFile::MAX_MIPS];
+	string key;
+
+	ASResourceManager::NormalisePath(filename, key);
+
+	unordered_map<string, int>::iterator it = m_ids.find(key);
+	if(it != m_ids.end())
+		return it->second;
+
+	streamed.file    = new ASDDSFile;
+	streamed.texture = 0;
+	streamed.view    = 0;
+	if(!streamed.file)
+		return -1;
+
+	if(!streamed.file->Init(filename))
+	{
+		delete streamed.file;
+		return -1;
+	}
+
+	// Texture arrays are bound whole and never streamed
+	if(streamed.file->GetArraySize() != 1)
+	{
+		streamed.file->Release();
+		delete streamed.file;
+		return -1;
+	}
+
+	unsigned int width  = streamed.file->GetWidth();
+	unsigned int height = streamed.file->GetHeight();
+	int numMips         = streamed.file->GetMipCount();
+
+	// Start with just the tail, the policy only learns of the texture once it exists
+	if(!CreateTexture(device, streamed, ASTextureResidency::GetTailMip(width, height, numMips)))
+	{
+		streamed.file->Release();
+		delete streamed.file;
+		return -1;
+	}
+
+	for(int i = 0; i < numMips; i++)
+		mipBytes[i] = streamed.file->GetMipSize(i);
+
+	int id = m_residency.AddTexture(width, height, numMips, mipBytes);
+
+	m_textures.push_back(streamed);
+	m_ids[key] = id;
+
+	return id;
+}
+
+/*
+*******************************************************************
+* METHOD: Release
+*******************************************************************
+* Releases every texture and unmaps every file
+*/
+
+void ASTextureStreamer::Release()
+{
+	for(unsigned int i = 0; i < m_textures.size(); i++)
+	{
+		ASStreamedTexture& streamed = m_textures[i];
+
+		if(streamed.view)
+			streamed.view->Release();
+		if(streamed.texture)
+			streamed.texture->Release();
+		if(streamed.file)
+		{
+			streamed.file->Release();
+			delete streamed.file;
+		}
+	}
+
+	m_textures.clear();
+	m_ids.clear();
+	m_residency.Release();
+}
+
+/*
+*******************************************************************
+* METHOD: Request Size
+*******************************************************************
+* Asks for a texture to be sharp enough for the number of pixels it
+* covers on screen this frame
+*
+* @param int   - the texture's id
+* @param float - the pixels the texture spans on screen
+*/
+
+void ASTextureStreamer::RequestSize(int id, float screenPixels)
+{
+	ASDDSFile* file = m_textures[id].file;
+
+	int mip = ASTextureResidency::SelectMip(file->GetWidth(), file->GetHeight(), file->GetMipCount(), screenPixels);
+	m_residency.RequestMip(id, mip);
+}
+
+/*
+*******************************************************************
+* METHOD: Request Distance
+*******************************************************************
+* Asks for a texture wrapped once around an object of the given
+* size, seen from the given distance
+*
+* @param int   - the texture's id
+* @param float - the size of the object in world units
+* @param float - the distance from the camera to the object
+* @param float - pixels per unit at a distance of one unit
+*/
+
+void ASTextureStreamer::RequestDistance(int id, float worldSize, float distance, float projScale)
+{
+	if(distance < 1.0f)
+		distance = 1.0f;
+
+	RequestSize(id, (worldSize * projScale) / distance);
+}
+
+/*
+*******************************************************************
+* METHOD: Update
+*******************************************************************
+* Ends the frame's requests and rebuilds every texture whose
+* resident levels changed.  A texture that cannot be rebuilt keeps
+* its old levels and the policy is told so
+*
+* @param ID3D11Device* - the device to create the textures with
+*/
+
+void ASTextureStreamer::Update(ID3D11Device* device)
+{
+	AS_PROFILE("ASTextureStreamer::Update");
+
+	m_residency.Update();
+
+	for(int id = 0; id < (int)m_textures.size(); id++)
+	{
+		if(!m_residency.HasChanged(id))
+			continue;
+
+		int wanted = m_residency.GetResidentMip(id);
+		if(!CreateTexture(device, m_textures[id], wanted))
+		{
+			// The old texture is still bound, work out its first level from its size
+			D3D11_TEXTURE2D_DESC desc;
+			m_textures[id].texture->GetDesc(&desc);
+			m_residency.SetResidentMip(id, m_textures[id].file->GetMipCount() - desc.MipLevels);
+		}
+	}
+}
+
+/*
+*******************************************************************
+* METHOD: Get Texture
+*******************************************************************
+* @param int - the texture's id
+*
+* @return ID3D11ShaderResourceView* - the texture's current view
+*/
+
+ID3D11ShaderResourceView* ASTextureStreamer::GetTexture(int id)
+{
+	return m_textures[id].view;
+}
+
+/*
+*******************************************************************
+* METHOD: Get Residency
+*******************************************************************
+* @return ASTextureResidency* - the policy, for its statistics or budget
+*/
+
+ASTextureResidency* ASTextureStreamer::GetResidency()
+{
+	return &m_residency;
+}
+
+/*
+*******************************************************************
+* METHOD: Report
+*******************************************************************
+* Appends the residency statistics to ./log/texture-residency.txt
+*
+* @param const char* - a label for this report
+*/
+
+void ASTextureStreamer::Report(const char* label)
+{
+	const ASTextureResidency::ASStats& stats = m_residency.GetStats();
+	ofstream fout;
+
+	fout.open("./log/texture-residency.txt", ios::app);
+	if(fout.fail())
+		return;
+
+	fout << "Texture residency " << label << ": " << m_residency.GetTextureCount() << " textures, "
+		 << (stats.residentBytes / 1024) << " KB resident of " << (stats.budgetBytes / 1024) << " KB budget, "
+		 << (stats.requestedBytes / 1024) << " KB requested, "
+		 << stats.numLoads << " levels loaded (" << (stats.loadedBytes / 1024) << " KB), "
+		 << stats.numEvictions << " evicted (" << (stats.evictedBytes / 1024) << " KB), "
+		 << stats.numPending << " waiting" << endl;
+
+	fout.close();
+}
+
+/*
+*******************************************************************
+* METHOD: Create Texture
+*******************************************************************
+* Builds an immutable texture holding the levels from the given one
+* down, straight from the data ASDDSFile maps, and swaps it in for
+* the old one
+*
+* @param ID3D11Device*      - the device to create the texture with
+* @param ASStreamedTexture& - the texture to rebuild
+* @param int                - the most detailed level to include
+*
+* @return bool - True if the texture was rebuilt, else false
+*/
+
+bool ASTextureStreamer::CreateTexture(ID3D11Device* device, ASStreamedTexture& streamed, int firstMip)
+{
+	D3D11_TEXTURE2D_DESC   desc;
+	D3D11_SUBRESOURCE_DATA data[ASDDSFile::MAX_MIPS];
+	ID3D11Texture2D*          texture = 0;
+	ID3D11ShaderResourceView* view    = 0;
+	HRESULT hr;
+
+	ASDDSFile* file = streamed.file;
+
+	desc.Width              = file->GetMipWidth(firstMip);
+	desc.Height             = file->GetMipHeight(firstMip);
+	desc.MipLevels          = file->GetMipCount() - firstMip;
+	desc.ArraySize          = 1;
+	desc.Format             = file->GetFormat();
+	desc.SampleDesc.Count   = 1;
+	desc.SampleDesc.Quality = 0;
+	desc.Usage              = D3D11_USAGE_IMMUTABLE;
+	desc.BindFlags          = D3D11_BIND_SHADER_RESOURCE;
+	desc.CPUAccessFlags     = 0;
+	desc.MiscFlags          = 0;
+
+	for(unsigned int i = 0; i < desc.MipLevels; i++)
+	{
+		data[i].pSysMem          = file->GetMipData(firstMip + i);
+		data[i].SysMemPitch      = file->GetMipPitch(firstMip + i);
+		data[i].SysMemSlicePitch = 0;
+	}
+
+	hr = device->CreateTexture2D(&desc, data, &texture);
+	if(FAILED(hr))
+		return false;
+
+	hr = device->CreateShaderResourceView(texture, NULL, &view);
+	if(FAILED(hr))
+	{
+		texture->Release();
+		return false;
+	}
+
+	// Swap the new levels in
+	if(streamed.view)
+		streamed.view->Release();
+	if(streamed.texture)
+		streamed.texture->Release();
+
+	streamed.texture = texture;
+	streamed.view    = view;
+
+	return true;
+}
@@ -0,0 +1,86 @@
+/*
+******************************************************************
+* ASTextureStreamer.h
+*******************************************************************
+* Streams the mip levels of .dds textures into video memory as
+* they are needed.  Each file stays mapped by ASDDSFile, and
+* ASTextureResidency decides each frame which levels should be
+* resident.  When that changes the texture is recreated holding
+* just those levels, so a distant object only ever costs its small
+* levels.  The view returned by GetTexture() may change after
+* Update(), so it should be fetched every frame
+*******************************************************************
+*/
+
+#ifndef _ASTEXTURESTREAMER_H_
+#define _ASTEXTURESTREAMER_H_
+
+/*
+*******************************************************************
+* Includes:
+*******************************************************************
+* + ASDDSFile.h has been included to read the mip levels
+* + ASTextureResidency.h has been included for the streaming policy
+* + ASResourceManager.h has been included to normalise file names
+* + ASProfiler.h has been included to time uploads
+*******************************************************************
+*/
+
+#include <d3d11.h>
+#include <vector>
+#include <string>
+#include <unordered_map>
+#include <fstream>
+#include "ASDDSFile.h"
+#include "ASTextureResidency.h"
+#include "ASResourceManager.h"
+#include "ASProfiler.h"
+
+using namespace std;
+
+/*
+*******************************************************************
+* Class declaration
+*******************************************************************
+*/
+
+class ASTextureStreamer
+{
+private:
+	struct ASStreamedTexture
+	{
+		ASDDSFile*                file;
+		ID3D11Texture2D*          texture;
+		ID3D11ShaderResourceView* view;
+	};
+
+public:
+	// Constructors and destructor
+	ASTextureStreamer();
+	ASTextureStreamer(const ASTextureStreamer&);
+	~ASTextureStreamer();
+
+	// Public methods
+	void Init(unsigned long long, unsigned long long);
+	int  Load(ID3D11Device*, const char*);
+	void Release();
+
+	void RequestSize(int, float);
+	void RequestDistance(int, float, float, float);
+	void Update(ID3D11Device*);
+
+	ID3D11ShaderResourceView* GetTexture(int);
+	ASTextureResidency* GetResidency();
+	void Report(const char*);
+
+private:
+	// Private methods
+	bool CreateTexture(ID3D11Device*, ASStreamedTexture&, int);
+
+	// Private member variables
+	ASTextureResidency        m_residency;
+	vector<ASStreamedTexture> m_textures;		// indexed by the residency id
+	unordered_map<string, int> m_ids;			// normalised file name to id
+};
+
+#endif
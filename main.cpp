@@ -7,16 +7,123 @@
 * to ensure that all heavy lifting is carried out by the Engine
 * this class will safely create an ASEngine instance, if anything
 * goes wrong it will clean up gracefully by releasing objects
+*
+* Running with "-bake <model> [<model> ...]" converts each model
+* file into its .asmesh cache and exits without opening a window.
+* "-record <log>" records every frame's input to a log as the game
+* is played, and "-replay <log>" plays a recorded log back instead
+* of reading the keyboard and mouse.  "-benchmark <path>" flies the
+* camera along a path, ./paths/flythrough.txt is the standard one,
+* and writes what every frame cost to ./log/benchmark.csv.
+* "-profile" records the zones marked in the code and writes them to
+* ./log/profile.json for chrome://tracing, it may come before any of
+* the other options
+*
+* A headless build (AS_HEADLESS) has a console entry point instead,
+* "-frames <n>" sets how many frames it runs and "-fps <n>" the
+* frame rate it is held to, "-record", "-replay" and "-benchmark"
+* work as above
 *******************************************************************
 */
 
-#include "ASEngine.h";
+#include "ASEngine.h"
+
+#ifdef AS_HEADLESS
+#include <stdlib.h>
+#include <string.h>
+
+/*
+******************************************************************
+* Headless entry point
+******************************************************************
+*/
+
+int main(int argc, char** argv)
+{
+	ASEngine *Engine;
+	bool success;
+
+	Engine = new ASEngine;
+	if(!Engine)
+		return 1;
+
+	for(int i = 1; i < argc; i++)
+	{
+		if(strcmp(argv[i], "-profile") == 0)
+			Engine->SetProfiling(true);
+	}
+
+	for(int i = 1; i + 1 < argc; i++)
+	{
+		if(strcmp(argv[i], "-frames") == 0)
+			Engine->SetFrameLimit(atoi(argv[i + 1]));
+		else if(strcmp(argv[i], "-fps") == 0)
+			Engine->SetFrameRateLimit((float)atof(argv[i + 1]));
+		else if(strcmp(argv[i], "-record") == 0)
+			Engine->SetInputLog(ASInputLog::MODE_RECORD, argv[i + 1]);
+		else if(strcmp(argv[i], "-replay") == 0)
+			Engine->SetInputLog(ASInputLog::MODE_REPLAY, argv[i + 1]);
+		else if(strcmp(argv[i], "-benchmark") == 0)
+			Engine->SetBenchmark(argv[i + 1]);
+	}
+
+	success = Engine->Init();
+	if(success)
+		Engine->Run();
+
+	Engine->Release();
+	delete Engine;
+	Engine = 0;
+
+	return success ? 0 : 1;
+}
+
+#else
+#include "ASModel.h"
+
+/*
+******************************************************************
+* Bake Models
+******************************************************************
+* Converts every model named on the command line into an .asmesh
+* cache, the result of each conversion is written to the model
+* load log and a summary is shown once all files are done
+*
+* @param char* - the command line following "-bake"
+* @return int  - the number of models that failed to convert
+******************************************************************
+*/
+
+static int BakeModels(char* files)
+{
+	ASModel model;
+	int     numBaked  = 0;
+	int     numFailed = 0;
+	WCHAR   summary[128];
+
+	for(char* file = strtok(files, " \t"); file; file = strtok(0, " \t"))
+	{
+		if(model.Bake(file))
+			numBaked++;
+		else
+			numFailed++;
+	}
+
+	swprintf_s(summary, 128, L"Baked %d model(s), %d failed", numBaked, numFailed);
+	MessageBox(NULL, summary, L"Mesh Cache", MB_OK);
+
+	return numFailed;
+}
 
 int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, PSTR pCmdline, int iCmdShow)
 {
 	ASEngine *Engine;
 	bool success;
 
+	// Convert models to .asmesh caches instead of running the game
+	if(strncmp(pCmdline, "-bake", 5) == 0)
+		return BakeModels(pCmdline + 5);
+
 	// Create a new instance of ASEngine, then check it has been initialised, if a
 	// a null pointer is returned then quit out of the program (this shouldn't happen)
 	// but it's better to be safe than sorry.
@@ -24,6 +131,23 @@ int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, PSTR pCmdline,
 	if(!Engine) 
 		return 0;
 
+	// Profile the run
+	if(strncmp(pCmdline, "-profile", 8) == 0)
+	{
+		Engine->SetProfiling(true);
+		pCmdline += 8;
+		while(*pCmdline == ' ')
+			pCmdline++;
+	}
+
+	// Record the input to a log as the game is played, or replay a recorded one
+	if(strncmp(pCmdline, "-record ", 8) == 0)
+		Engine->SetInputLog(ASInputLog::MODE_RECORD, pCmdline + 8);
+	else if(strncmp(pCmdline, "-replay ", 8) == 0)
+		Engine->SetInputLog(ASInputLog::MODE_REPLAY, pCmdline + 8);
+	else if(strncmp(pCmdline, "-benchmark ", 11) == 0)
+		Engine->SetBenchmark(pCmdline + 11);
+
 	// Initialize the system, if successful enter the main game loop, otherwise despose
 	// of the Engine and exit the program gracefully - disposing of any resources
 	success = Engine->Init();
@@ -39,4 +163,6 @@ int WINAPI WinMain(HINSTANCE hInstance, HINSTANCE hPrevInstance, PSTR pCmdline,
 	Engine = 0;
 
 	return 0;
-}
\ No newline at end of file
+}
+
+#endif
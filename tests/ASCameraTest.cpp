@@ -0,0 +1,142 @@
+/*
+******************************************************************
+* ASCameraTest.cpp
+*******************************************************************
+* Checks the camera's view and world matrices and that the player
+* moves and turns the way the camera expects.  Rotations are in
+* degrees, a yaw of 90 faces down +x with +z on the left
+*******************************************************************
+*/
+
+#include "ASTest.h"
+#include "../ASCamera.h"
+#include "../ASPlayer.h"
+
+static const float TOLERANCE = 1e-4f;
+
+/*
+*******************************************************************
+* Compares a vector
+*******************************************************************
+*/
+
+static void CheckVector(const ASVector3& actual, float x, float y, float z)
+{
+	AS_CHECK_NEAR(actual.x, x, TOLERANCE);
+	AS_CHECK_NEAR(actual.y, y, TOLERANCE);
+	AS_CHECK_NEAR(actual.z, z, TOLERANCE);
+}
+
+/*
+*******************************************************************
+* A camera at (1, 2, 3) turned to face +x
+*******************************************************************
+*/
+
+static void TestCamera()
+{
+	ASCamera camera;
+	ASMatrix view;
+	ASMatrix world;
+	ASVector3 point;
+
+	camera.SetPosition(1.0f, 2.0f, 3.0f);
+	camera.SetRotation(0.0f, 90.0f, 0.0f);
+	camera.RenderCameraView();
+	camera.GetViewMatrix(view);
+
+	// Straight ahead, to the right and above the camera in view space
+	ASVector3 ahead(6.0f, 2.0f, 3.0f);
+	ASVector3 right(1.0f, 2.0f, 2.0f);
+	ASVector3 above(1.0f, 3.0f, 3.0f);
+
+	ASVec3TransformCoord(&point, &ahead, &view);
+	CheckVector(point, 0.0f, 0.0f, 5.0f);
+	ASVec3TransformCoord(&point, &right, &view);
+	CheckVector(point, 1.0f, 0.0f, 0.0f);
+	ASVec3TransformCoord(&point, &above, &view);
+	CheckVector(point, 0.0f, 1.0f, 0.0f);
+
+	// The world matrix takes the camera's own space back out, the inverse of the view
+	camera.GetWorldMatrix(world);
+
+	ASVector3 origin(0.0f, 0.0f, 0.0f);
+	ASVector3 forward(0.0f, 0.0f, 5.0f);
+	ASVec3TransformCoord(&point, &origin, &world);
+	CheckVector(point, 1.0f, 2.0f, 3.0f);
+	ASVec3TransformCoord(&point, &forward, &world);
+	CheckVector(point, 6.0f, 2.0f, 3.0f);
+}
+
+/*
+*******************************************************************
+* Ten millisecond frames, the player starts at full speed, 1.5 a
+* frame, and slows by 0.05 a frame once the key is let go
+*******************************************************************
+*/
+
+static void TestPlayer()
+{
+	ASPlayer player;
+	float x, y, z;
+	float pitch, yaw, roll;
+
+	player.SetFrameTime(10.0f);
+	player.SetPosition(0.0f, 0.0f, 0.0f);
+	player.SetRotation(0.0f, 90.0f, 0.0f);
+
+	player.MoveForward(true);
+	player.GetPosition(x, y, z);
+	AS_CHECK_NEAR(x, 1.5f, TOLERANCE);
+	AS_CHECK_NEAR(y, 0.0f, TOLERANCE);
+	AS_CHECK_NEAR(z, 0.0f, TOLERANCE);
+
+	player.MoveForward(false);
+	player.GetPosition(x, y, z);
+	AS_CHECK_NEAR(x, 2.95f, TOLERANCE);
+
+	// Turning left from 0 wraps round to just under 360
+	player.SetRotation(0.0f, 0.0f, 0.0f);
+	player.TurnLeft(true);
+	player.GetRotation(pitch, yaw, roll);
+	AS_CHECK_NEAR(yaw, 359.9f, TOLERANCE);
+
+	// The camera put where the player is faces the way the player moves
+	ASCamera camera;
+	ASMatrix view;
+	ASVector3 point;
+
+	player.SetRotation(0.0f, 90.0f, 0.0f);
+	player.GetPosition(x, y, z);
+	player.GetRotation(pitch, yaw, roll);
+	camera.SetPosition(x, y, z);
+	camera.SetRotation(pitch, yaw, roll);
+	camera.RenderCameraView();
+	camera.GetViewMatrix(view);
+
+	player.MoveForward(true);
+	player.GetPosition(x, y, z);
+
+	ASVector3 moved(x, y, z);
+	ASVec3TransformCoord(&point, &moved, &view);
+	AS_CHECK_NEAR(point.x, 0.0f, TOLERANCE);
+	AS_CHECK(point.z > 0.0f);
+}
+
+/*
+*******************************************************************
+* Main
+*******************************************************************
+*/
+
+int main()
+{
+	TestCamera();
+	TestPlayer();
+
+#ifdef AS_MATH_SSE
+	return ASTest::Finish("ASCameraTest (SSE)");
+#else
+	return ASTest::Finish("ASCameraTest (scalar)");
+#endif
+}
@@ -0,0 +1,191 @@
+/*
+******************************************************************
+* ASFrustrumTest.cpp
+*******************************************************************
+* Checks the frustum planes and every test against them.  The view
+* looks down z from the origin with a 90 degree field of view, so
+* the sides are the planes x = +-z and y = +-z, and the far plane
+* is moved in to z = 100.  The batch checks must agree with the one
+* at a time checks on both the SSE and the scalar path
+*******************************************************************
+*/
+
+#include "ASTest.h"
+#include "../ASFrustrum.h"
+
+static const float SCREEN_DEPTH = 100.0f;
+
+/*
+*******************************************************************
+* Builds the frustum every test uses
+*******************************************************************
+*/
+
+static void BuildFrustrum(ASFrustrum& frustrum)
+{
+	ASMatrix projection;
+	ASMatrix view;
+
+	ASMatrixPerspectiveFovLH(&projection, AS_PI / 2.0f, 1.0f, 1.0f, 1000.0f);
+	ASMatrixIdentity(&view);
+
+	frustrum.ConstructFrustrum(SCREEN_DEPTH, projection, view);
+}
+
+/*
+*******************************************************************
+* Points, spheres and boxes either side of each plane
+*******************************************************************
+*/
+
+static void TestPrimitives()
+{
+	ASFrustrum frustrum;
+	BuildFrustrum(frustrum);
+
+	AS_CHECK(frustrum.CheckPoint(0.0f, 0.0f, 10.0f));
+	AS_CHECK(frustrum.CheckPoint(9.0f, 0.0f, 10.0f));
+	AS_CHECK(frustrum.CheckPoint(0.0f, -9.0f, 10.0f));
+	AS_CHECK(frustrum.CheckPoint(0.0f, 0.0f, 99.0f));
+	AS_CHECK(!frustrum.CheckPoint(0.0f, 0.0f, -10.0f));
+	AS_CHECK(!frustrum.CheckPoint(0.0f, 0.0f, 101.0f));
+	AS_CHECK(!frustrum.CheckPoint(11.0f, 0.0f, 10.0f));
+	AS_CHECK(!frustrum.CheckPoint(-11.0f, 0.0f, 10.0f));
+	AS_CHECK(!frustrum.CheckPoint(0.0f, 11.0f, 10.0f));
+
+	// The centre is 2 / sqrt(2) = 1.41 outside the right hand plane
+	AS_CHECK(frustrum.CheckSphere(12.0f, 0.0f, 10.0f, 3.0f));
+	AS_CHECK(!frustrum.CheckSphere(12.0f, 0.0f, 10.0f, 1.0f));
+	AS_CHECK(frustrum.CheckSphere(0.0f, 0.0f, 102.0f, 3.0f));
+	AS_CHECK(!frustrum.CheckSphere(0.0f, 0.0f, 102.0f, 1.0f));
+
+	// A box is in while its corner nearest the inside, smallest x and largest z, is
+	AS_CHECK(frustrum.CheckRectangle(12.0f, 0.0f, 10.0f, 1.5f, 1.0f, 1.0f));
+	AS_CHECK(!frustrum.CheckRectangle(13.0f, 0.0f, 10.0f, 1.0f, 1.0f, 1.0f));
+	AS_CHECK(frustrum.CheckCube(13.0f, 0.0f, 10.0f, 2.0f));
+	AS_CHECK(!frustrum.CheckCube(13.0f, 0.0f, 10.0f, 1.0f));
+}
+
+/*
+*******************************************************************
+* The planes of a frustum built from a view that has moved and
+* turned, a quarter turn about y from (5, 0, 5) looks down +x
+*******************************************************************
+*/
+
+static void TestView()
+{
+	ASFrustrum frustrum;
+	ASMatrix   projection;
+	ASMatrix   view;
+
+	ASVector3 eye(5.0f, 0.0f, 5.0f);
+	ASVector3 at(6.0f, 0.0f, 5.0f);
+	ASVector3 up(0.0f, 1.0f, 0.0f);
+
+	ASMatrixPerspectiveFovLH(&projection, AS_PI / 2.0f, 1.0f, 1.0f, 1000.0f);
+	ASMatrixLookAtLH(&view, &eye, &at, &up);
+	frustrum.ConstructFrustrum(SCREEN_DEPTH, projection, view);
+
+	AS_CHECK(frustrum.CheckPoint(15.0f, 0.0f, 5.0f));
+	AS_CHECK(frustrum.CheckPoint(15.0f, 0.0f, 14.0f));
+	AS_CHECK(!frustrum.CheckPoint(15.0f, 0.0f, 16.0f));
+	AS_CHECK(!frustrum.CheckPoint(-5.0f, 0.0f, 5.0f));
+	AS_CHECK(!frustrum.CheckPoint(106.0f, 0.0f, 5.0f));
+}
+
+/*
+*******************************************************************
+* A row of objects sweeping across the right hand plane, 37 of them
+* so the last few go down the path that does one at a time
+*******************************************************************
+*/
+
+static void TestBatches()
+{
+	static const int COUNT = 37;
+
+	ASFrustrum frustrum;
+	BuildFrustrum(frustrum);
+
+	float x[COUNT], y[COUNT], z[COUNT], radius[COUNT];
+	float xSize[COUNT], ySize[COUNT], zSize[COUNT];
+	unsigned int mask[2];
+
+	AS_CHECK(ASFrustrum::GetMaskWords(COUNT) == 2);
+
+	for(int i = 0; i < COUNT; i++)
+	{
+		x[i]      = (i * 0.75f) - 5.0f;
+		y[i]      = (i % 3) - 1.0f;
+		z[i]      = 10.0f + (i % 5);
+		radius[i] = 0.5f + ((i % 4) * 0.5f);
+		xSize[i]  = radius[i];
+		ySize[i]  = 1.0f;
+		zSize[i]  = 0.5f;
+	}
+
+	// Separate radii
+	int numVisible = frustrum.CheckSpheres(x, y, z, radius, COUNT, mask);
+	int expected   = 0;
+	bool matches   = true;
+	for(int i = 0; i < COUNT; i++)
+	{
+		bool visible = frustrum.CheckSphere(x[i], y[i], z[i], radius[i]);
+		matches      = matches && (ASFrustrum::IsVisible(mask, i) == visible);
+		expected    += visible ? 1 : 0;
+	}
+	AS_CHECK(matches);
+	AS_CHECK(numVisible == expected);
+	AS_CHECK(expected > 0 && expected < COUNT);
+
+	// One radius and an offset from each position
+	ASVector3 offset(0.0f, 0.5f, 2.0f);
+	numVisible = frustrum.CheckSpheres(x, y, z, 1.0f, offset, COUNT, mask);
+	expected   = 0;
+	matches    = true;
+	for(int i = 0; i < COUNT; i++)
+	{
+		bool visible = frustrum.CheckSphere(x[i] + offset.x, y[i] + offset.y, z[i] + offset.z, 1.0f);
+		matches      = matches && (ASFrustrum::IsVisible(mask, i) == visible);
+		expected    += visible ? 1 : 0;
+	}
+	AS_CHECK(matches);
+	AS_CHECK(numVisible == expected);
+
+	// Boxes
+	numVisible = frustrum.CheckBoxes(x, y, z, xSize, ySize, zSize, COUNT, mask);
+	expected   = 0;
+	matches    = true;
+	for(int i = 0; i < COUNT; i++)
+	{
+		bool visible = frustrum.CheckRectangle(x[i], y[i], z[i], xSize[i], ySize[i], zSize[i]);
+		matches      = matches && (ASFrustrum::IsVisible(mask, i) == visible);
+		expected    += visible ? 1 : 0;
+	}
+	AS_CHECK(matches);
+	AS_CHECK(numVisible == expected);
+	AS_CHECK(expected > 0 && expected < COUNT);
+
+	// Bits past the last object stay clear
+	AS_CHECK((mask[1] >> (COUNT - 32)) == 0);
+}
+
+/*
+*******************************************************************
+* Main
+*******************************************************************
+*/
+
+int main()
+{
+	TestPrimitives();
+	TestView();
+	TestBatches();
+
+#ifdef AS_MATH_SSE
+	return ASTest::Finish("ASFrustrumTest (SSE)");
+#else
+	return ASTest::Finish("ASFrustrumTest (scalar)");
+#endif
+}
@@ -0,0 +1,276 @@
+/*
+******************************************************************
+* ASMathTest.cpp
+*******************************************************************
+* Checks ASMath against results worked out by hand from the D3DX
+* definitions of each function.  The Makefile builds it once with
+* SSE and once with AS_MATH_NO_SSE so both paths give the same
+*******************************************************************
+*/
+
+#include "ASTest.h"
+#include "../ASMath.h"
+
+static const float TOLERANCE = 1e-5f;
+
+/*
+*******************************************************************
+* Compares every element of a matrix
+*******************************************************************
+*/
+
+static void CheckMatrix(const ASMatrix& actual, const float expected[16], float tolerance)
+{
+	for(int row = 0; row < 4; row++)
+	{
+		for(int col = 0; col < 4; col++)
+			AS_CHECK_NEAR(actual.m[row][col], expected[(row * 4) + col], tolerance);
+	}
+}
+
+/*
+*******************************************************************
+* Compares a vector
+*******************************************************************
+*/
+
+static void CheckVector(const ASVector3& actual, float x, float y, float z, float tolerance)
+{
+	AS_CHECK_NEAR(actual.x, x, tolerance);
+	AS_CHECK_NEAR(actual.y, y, tolerance);
+	AS_CHECK_NEAR(actual.z, z, tolerance);
+}
+
+/*
+*******************************************************************
+* Row by column products, in both orders and with the output
+* aliasing each input
+*******************************************************************
+*/
+
+static void TestMultiply()
+{
+	ASMatrix a( 1.0f,  2.0f,  3.0f,  4.0f,
+				5.0f,  6.0f,  7.0f,  8.0f,
+				9.0f, 10.0f, 11.0f, 12.0f,
+			   13.0f, 14.0f, 15.0f, 16.0f);
+	ASMatrix b( 2.0f,  0.0f,  1.0f,  0.0f,
+				0.0f,  1.0f,  0.0f,  3.0f,
+				1.0f,  0.0f,  2.0f,  0.0f,
+				4.0f,  1.0f,  0.0f,  1.0f);
+	ASMatrix out;
+
+	const float ab[16] = {  21.0f,  6.0f,  7.0f, 10.0f,
+						    49.0f, 14.0f, 19.0f, 26.0f,
+						    77.0f, 22.0f, 31.0f, 42.0f,
+						   105.0f, 30.0f, 43.0f, 58.0f };
+	const float ba[16] = {  11.0f, 14.0f, 17.0f, 20.0f,
+						    44.0f, 48.0f, 52.0f, 56.0f,
+						    19.0f, 22.0f, 25.0f, 28.0f,
+						    22.0f, 28.0f, 34.0f, 40.0f };
+
+	AS_CHECK(ASMatrixMultiply(&out, &a, &b) == &out);
+	CheckMatrix(out, ab, TOLERANCE);
+	CheckMatrix(b * a, ba, TOLERANCE);
+
+	ASMatrix left = a;
+	ASMatrixMultiply(&left, &left, &b);
+	CheckMatrix(left, ab, TOLERANCE);
+
+	ASMatrix right = a;
+	ASMatrixMultiply(&right, &b, &right);
+	CheckMatrix(right, ba, TOLERANCE);
+
+	// The identity changes nothing
+	ASMatrix identity;
+	ASMatrixIdentity(&identity);
+	CheckMatrix(a * identity, &a._11, 0.0f);
+}
+
+/*
+*******************************************************************
+* An eye at (1, 2, 3) looking at (4, 2, 7).  Forward is (0.6, 0,
+* 0.8), right is up x forward = (0.8, 0, -0.6) and up stays (0, 1,
+* 0), the bottom row is minus each axis dotted with the eye
+*******************************************************************
+*/
+
+static void TestLookAtLH()
+{
+	ASVector3 eye(1.0f, 2.0f, 3.0f);
+	ASVector3 at(4.0f, 2.0f, 7.0f);
+	ASVector3 up(0.0f, 1.0f, 0.0f);
+	ASMatrix  view;
+
+	const float expected[16] = {  0.8f,  0.0f, 0.6f, 0.0f,
+								  0.0f,  1.0f, 0.0f, 0.0f,
+								 -0.6f,  0.0f, 0.8f, 0.0f,
+								  1.0f, -2.0f, -3.0f, 1.0f };
+
+	ASMatrixLookAtLH(&view, &eye, &at, &up);
+	CheckMatrix(view, expected, TOLERANCE);
+
+	// The eye goes to the origin and the target straight ahead of it
+	ASVector3 point;
+	ASVec3TransformCoord(&point, &eye, &view);
+	CheckVector(point, 0.0f, 0.0f, 0.0f, TOLERANCE);
+	ASVec3TransformCoord(&point, &at, &view);
+	CheckVector(point, 0.0f, 0.0f, 5.0f, TOLERANCE);
+}
+
+/*
+*******************************************************************
+* A 90 degree field of view at 2:1 from 1 to 101.  The y scale is
+* 1 / tan(45) = 1, x is half that and depth scales by 101 / 100
+*******************************************************************
+*/
+
+static void TestPerspectiveFovLH()
+{
+	ASMatrix projection;
+
+	const float expected[16] = { 0.5f, 0.0f,  0.0f,  0.0f,
+								 0.0f, 1.0f,  0.0f,  0.0f,
+								 0.0f, 0.0f,  1.01f, 1.0f,
+								 0.0f, 0.0f, -1.01f, 0.0f };
+
+	ASMatrixPerspectiveFovLH(&projection, AS_PI / 2.0f, 2.0f, 1.0f, 101.0f);
+	CheckMatrix(projection, expected, TOLERANCE);
+
+	// The near plane maps to depth 0, the far plane to 1, and x and y are divided by w = z
+	ASVector3 point;
+	ASVector3 nearPoint(0.0f, 0.0f, 1.0f);
+	ASVector3 farPoint(0.0f, 0.0f, 101.0f);
+	ASVector3 between(2.0f, 1.0f, 2.0f);
+
+	ASVec3TransformCoord(&point, &nearPoint, &projection);
+	CheckVector(point, 0.0f, 0.0f, 0.0f, TOLERANCE);
+	ASVec3TransformCoord(&point, &farPoint, &projection);
+	CheckVector(point, 0.0f, 0.0f, 1.0f, TOLERANCE);
+	ASVec3TransformCoord(&point, &between, &projection);
+	CheckVector(point, 0.5f, 0.5f, 0.505f, TOLERANCE);
+}
+
+/*
+*******************************************************************
+* An 800 x 600 view from 0.5 to 100.5, the corners of the near
+* plane map to the corners of clip space
+*******************************************************************
+*/
+
+static void TestOrthoLH()
+{
+	ASMatrix projection;
+
+	const float expected[16] = { 0.0025f, 0.0f,           0.0f,   0.0f,
+								 0.0f,    1.0f / 300.0f,  0.0f,   0.0f,
+								 0.0f,    0.0f,           0.01f,  0.0f,
+								 0.0f,    0.0f,          -0.005f, 1.0f };
+
+	ASMatrixOrthoLH(&projection, 800.0f, 600.0f, 0.5f, 100.5f);
+	CheckMatrix(projection, expected, TOLERANCE);
+
+	ASVector3 point;
+	ASVector3 corner(400.0f, -300.0f, 0.5f);
+	ASVector3 farCentre(0.0f, 0.0f, 100.5f);
+
+	ASVec3TransformCoord(&point, &corner, &projection);
+	CheckVector(point, 1.0f, -1.0f, 0.0f, TOLERANCE);
+	ASVec3TransformCoord(&point, &farCentre, &projection);
+	CheckVector(point, 0.0f, 0.0f, 1.0f, TOLERANCE);
+}
+
+/*
+*******************************************************************
+* A translation by (1, 2, 3) and then a quarter turn about y.  With
+* row vectors the turn takes (x, y, z) to (z, y, -x), so (1, 0, 0)
+* moves to (2, 2, 3) and then to (3, 2, -2).  Normals only turn
+*******************************************************************
+*/
+
+static void TestTransformCoord()
+{
+	ASMatrix translation, rotation, matrix;
+	ASVector3 point(1.0f, 0.0f, 0.0f);
+	ASVector3 out;
+
+	ASMatrixTranslation(&translation, 1.0f, 2.0f, 3.0f);
+	ASMatrixRotationY(&rotation, AS_PI / 2.0f);
+	ASMatrixMultiply(&matrix, &translation, &rotation);
+
+	AS_CHECK(ASVec3TransformCoord(&out, &point, &matrix) == &out);
+	CheckVector(out, 3.0f, 2.0f, -2.0f, TOLERANCE);
+
+	ASVec3TransformNormal(&out, &point, &matrix);
+	CheckVector(out, 0.0f, 0.0f, -1.0f, TOLERANCE);
+
+	// The output may be the input
+	ASVec3TransformCoord(&point, &point, &matrix);
+	CheckVector(point, 3.0f, 2.0f, -2.0f, TOLERANCE);
+
+	// A w other than 1 divides the result
+	ASMatrix halve(1.0f, 0.0f, 0.0f, 0.0f,
+				   0.0f, 1.0f, 0.0f, 0.0f,
+				   0.0f, 0.0f, 1.0f, 0.0f,
+				   0.0f, 0.0f, 0.0f, 2.0f);
+	ASVector3 unit(2.0f, 4.0f, 6.0f);
+	ASVec3TransformCoord(&out, &unit, &halve);
+	CheckVector(out, 1.0f, 2.0f, 3.0f, TOLERANCE);
+}
+
+/*
+*******************************************************************
+* Vectors and planes
+*******************************************************************
+*/
+
+static void TestVectorsAndPlanes()
+{
+	ASVector3 x(1.0f, 0.0f, 0.0f);
+	ASVector3 y(0.0f, 1.0f, 0.0f);
+	ASVector3 out;
+
+	ASVec3Cross(&out, &x, &y);
+	CheckVector(out, 0.0f, 0.0f, 1.0f, 0.0f);
+
+	ASVector3 v(3.0f, 0.0f, 4.0f);
+	AS_CHECK_NEAR(ASVec3Length(&v), 5.0f, TOLERANCE);
+	ASVec3Normalize(&out, &v);
+	CheckVector(out, 0.6f, 0.0f, 0.8f, TOLERANCE);
+
+	// The plane 3y + 4z + 10 = 0 scaled to a unit normal, 2 units from the origin
+	ASPlane plane(0.0f, 3.0f, 4.0f, 10.0f);
+	ASPlaneNormalize(&plane, &plane);
+	AS_CHECK_NEAR(plane.a, 0.0f, TOLERANCE);
+	AS_CHECK_NEAR(plane.b, 0.6f, TOLERANCE);
+	AS_CHECK_NEAR(plane.c, 0.8f, TOLERANCE);
+	AS_CHECK_NEAR(plane.d, 2.0f, TOLERANCE);
+
+	ASVector3 origin(0.0f, 0.0f, 0.0f);
+	ASVector3 above(0.0f, 0.6f, 0.8f);
+	AS_CHECK_NEAR(ASPlaneDotCoord(&plane, &origin), 2.0f, TOLERANCE);
+	AS_CHECK_NEAR(ASPlaneDotCoord(&plane, &above), 3.0f, TOLERANCE);
+	AS_CHECK_NEAR(ASPlaneDotNormal(&plane, &above), 1.0f, TOLERANCE);
+}
+
+/*
+*******************************************************************
+* Main
+*******************************************************************
+*/
+
+int main()
+{
+	TestMultiply();
+	TestLookAtLH();
+	TestPerspectiveFovLH();
+	TestOrthoLH();
+	TestTransformCoord();
+	TestVectorsAndPlanes();
+
+#ifdef AS_MATH_SSE
+	return ASTest::Finish("ASMathTest (SSE)");
+#else
+	return ASTest::Finish("ASMathTest (scalar)");
+#endif
+}
@@ -0,0 +1,259 @@
+/*
+******************************************************************
+* ASMeshOptimizerTest.cpp
+*******************************************************************
+* Checks that each pass of the optimiser only reorders a mesh, the
+* same triangles come out wound the same way, and that reordering
+* for the vertex cache never makes the cache miss more
+*******************************************************************
+*/
+
+#include "ASTest.h"
+#include "../ASMeshOptimizer.h"
+
+/*
+*******************************************************************
+* Test mesh
+*******************************************************************
+*/
+
+// Vertices along each side of the grid
+static const int GRID_SIZE = 33;
+
+// One triangle, rotated so the smallest index is first to keep its winding
+struct ASTriangle
+{
+	unsigned long v[3];
+
+	bool operator<(const ASTriangle& other) const
+	{
+		if(v[0] != other.v[0]) return v[0] < other.v[0];
+		if(v[1] != other.v[1]) return v[1] < other.v[1];
+		return v[2] < other.v[2];
+	}
+	bool operator==(const ASTriangle& other) const
+	{
+		return v[0] == other.v[0] && v[1] == other.v[1] && v[2] == other.v[2];
+	}
+};
+
+/*
+*******************************************************************
+* Builds a flat grid of positions, two triangles a square, with the
+* triangles shuffled so the index list starts out cache unfriendly
+*******************************************************************
+*/
+
+static void MakeGrid(vector<float>& positions, vector<unsigned long>& indices)
+{
+	positions.clear();
+	indices.clear();
+
+	for(int z = 0; z < GRID_SIZE; z++)
+	{
+		for(int x = 0; x < GRID_SIZE; x++)
+		{
+			positions.push_back((float)x);
+			positions.push_back(0.0f);
+			positions.push_back((float)z);
+		}
+	}
+
+	for(int z = 0; z < GRID_SIZE - 1; z++)
+	{
+		for(int x = 0; x < GRID_SIZE - 1; x++)
+		{
+			unsigned long corner = (z * GRID_SIZE) + x;
+
+			indices.push_back(corner);
+			indices.push_back(corner + GRID_SIZE);
+			indices.push_back(corner + 1);
+
+			indices.push_back(corner + 1);
+			indices.push_back(corner + GRID_SIZE);
+			indices.push_back(corner + GRID_SIZE + 1);
+		}
+	}
+
+	// A fixed LCG so every run shuffles the same way
+	unsigned int seed = 12345;
+	int numTris = (int)indices.size() / 3;
+	for(int i = numTris - 1; i > 0; i--)
+	{
+		seed = (seed * 1103515245) + 12345;
+		int j = (int)((seed >> 16) % (unsigned int)(i + 1));
+		for(int k = 0; k < 3; k++)
+			swap(indices[(i * 3) + k], indices[(j * 3) + k]);
+	}
+}
+
+/*
+*******************************************************************
+* Sorted list of the triangles in an index list
+*******************************************************************
+*/
+
+static vector<ASTriangle> GetTriangles(const vector<unsigned long>& indices)
+{
+	vector<ASTriangle> triangles;
+
+	for(unsigned int i = 0; i + 2 < indices.size(); i += 3)
+	{
+		int first = 0;
+		for(int j = 1; j < 3; j++)
+		{
+			if(indices[i + j] < indices[i + first])
+				first = j;
+		}
+
+		ASTriangle tri;
+		for(int j = 0; j < 3; j++)
+			tri.v[j] = indices[i + ((first + j) % 3)];
+		triangles.push_back(tri);
+	}
+
+	sort(triangles.begin(), triangles.end());
+	return triangles;
+}
+
+/*
+*******************************************************************
+* ACMR of an index list with the optimiser's FIFO cache size
+*******************************************************************
+*/
+
+static float GetACMR(const vector<unsigned long>& indices, int numVertices)
+{
+	float acmr, atvr;
+	ASMeshOptimizer::AnalyzeVertexCache(&indices[0], (int)indices.size(), numVertices,
+										ASMeshOptimizer::FIFO_CACHE_SIZE, acmr, atvr);
+	return acmr;
+}
+
+/*
+*******************************************************************
+* Reordering for the vertex cache keeps every triangle and misses
+* the cache less than the shuffled list did
+*******************************************************************
+*/
+
+static void TestVertexCache()
+{
+	vector<float> positions;
+	vector<unsigned long> indices;
+	MakeGrid(positions, indices);
+
+	int numVertices = GRID_SIZE * GRID_SIZE;
+	vector<ASTriangle> before = GetTriangles(indices);
+	float acmrBefore = GetACMR(indices, numVertices);
+
+	ASMeshOptimizer optimizer;
+	optimizer.OptimizeVertexCache(&indices[0], (int)indices.size(), numVertices);
+
+	AS_CHECK(indices.size() == before.size() * 3);
+	AS_CHECK(GetTriangles(indices) == before);
+
+	float acmrAfter = GetACMR(indices, numVertices);
+	AS_CHECK(acmrAfter <= acmrBefore);
+	AS_CHECK(acmrAfter < 1.0f);
+
+	// An already optimised list does not get worse
+	optimizer.OptimizeVertexCache(&indices[0], (int)indices.size(), numVertices);
+	AS_CHECK(GetTriangles(indices) == before);
+	AS_CHECK(GetACMR(indices, numVertices) <= acmrAfter);
+}
+
+/*
+*******************************************************************
+* Ordering for overdraw only moves whole clusters around, so the
+* triangles are the same and the cache barely notices
+*******************************************************************
+*/
+
+static void TestOverdraw()
+{
+	vector<float> positions;
+	vector<unsigned long> indices;
+	MakeGrid(positions, indices);
+
+	int numVertices = GRID_SIZE * GRID_SIZE;
+	vector<ASTriangle> before = GetTriangles(indices);
+
+	ASMeshOptimizer optimizer;
+	optimizer.OptimizeVertexCache(&indices[0], (int)indices.size(), numVertices);
+	float acmrCache = GetACMR(indices, numVertices);
+
+	optimizer.OptimizeOverdraw(&indices[0], (int)indices.size(), &positions[0], sizeof(float) * 3, numVertices);
+
+	AS_CHECK(GetTriangles(indices) == before);
+	AS_CHECK(GetACMR(indices, numVertices) <= acmrCache * 1.05f);
+}
+
+/*
+*******************************************************************
+* Renumbering for vertex fetch moves the positions along with the
+* indices, drops unused vertices and numbers them in first use order
+*******************************************************************
+*/
+
+static void TestVertexFetch()
+{
+	vector<float> positions;
+	vector<unsigned long> indices;
+	MakeGrid(positions, indices);
+
+	int numVertices = GRID_SIZE * GRID_SIZE;
+
+	// A vertex no triangle uses is dropped
+	positions.push_back(-1.0f);
+	positions.push_back(-1.0f);
+	positions.push_back(-1.0f);
+	numVertices++;
+
+	vector<float>         oldPositions = positions;
+	vector<unsigned long> oldIndices   = indices;
+
+	ASMeshOptimizer optimizer;
+	int numUsed = optimizer.OptimizeVertexFetch(&positions[0], sizeof(float) * 3, numVertices,
+												&indices[0], (int)indices.size());
+
+	AS_CHECK(numUsed == GRID_SIZE * GRID_SIZE);
+
+	// Every corner of every triangle is still in the same place
+	bool samePositions = true;
+	unsigned long highest = 0;
+	bool firstUseOrder = true;
+	for(unsigned int i = 0; i < indices.size(); i++)
+	{
+		for(int k = 0; k < 3; k++)
+		{
+			if(positions[(indices[i] * 3) + k] != oldPositions[(oldIndices[i] * 3) + k])
+				samePositions = false;
+		}
+
+		if(indices[i] > highest + 1 || (i == 0 && indices[i] != 0))
+			firstUseOrder = false;
+		highest = max(highest, indices[i]);
+	}
+	AS_CHECK(samePositions);
+	AS_CHECK(firstUseOrder);
+	AS_CHECK((int)highest == numUsed - 1);
+
+	// Renumbering does not change the cache behaviour
+	AS_CHECK_NEAR(GetACMR(indices, numUsed), GetACMR(oldIndices, numVertices), 1e-6f);
+}
+
+/*
+*******************************************************************
+* Main
+*******************************************************************
+*/
+
+int main()
+{
+	TestVertexCache();
+	TestOverdraw();
+	TestVertexFetch();
+
+	return ASTest::Finish("ASMeshOptimizerTest");
+}
@@ -0,0 +1,210 @@
+/*
+******************************************************************
+* ASMeshSimplifierTest.cpp
+*******************************************************************
+* Checks that simplifying a mesh reaches the index count it was
+* asked for, that every index it writes is a vertex of the full
+* detail mesh and that it stops early when the error is too high
+*******************************************************************
+*/
+
+#include "ASTest.h"
+#include "../ASMeshSimplifier.h"
+
+/*
+*******************************************************************
+* Test mesh
+*******************************************************************
+*/
+
+// Vertices along each side of the grid
+static const int GRID_SIZE = 33;
+
+// Each vertex carries more than its position, as the models do
+struct ASTestVertex
+{
+	float pos[3];
+	float texCoord[2];
+};
+
+/*
+*******************************************************************
+* Builds a grid of vertices, two triangles a square, raised into a
+* gentle hill so the collapses have some error to weigh
+*******************************************************************
+*/
+
+static void MakeGrid(vector<ASTestVertex>& vertices, vector<unsigned long>& indices, float height)
+{
+	vertices.clear();
+	indices.clear();
+
+	for(int z = 0; z < GRID_SIZE; z++)
+	{
+		for(int x = 0; x < GRID_SIZE; x++)
+		{
+			float u = (float)x / (GRID_SIZE - 1);
+			float v = (float)z / (GRID_SIZE - 1);
+
+			ASTestVertex vert = { { (float)x, height * sinf(u * 3.14159f) * sinf(v * 3.14159f), (float)z }, { u, v } };
+			vertices.push_back(vert);
+		}
+	}
+
+	for(int z = 0; z < GRID_SIZE - 1; z++)
+	{
+		for(int x = 0; x < GRID_SIZE - 1; x++)
+		{
+			unsigned long corner = (z * GRID_SIZE) + x;
+
+			indices.push_back(corner);
+			indices.push_back(corner + GRID_SIZE);
+			indices.push_back(corner + 1);
+
+			indices.push_back(corner + 1);
+			indices.push_back(corner + GRID_SIZE);
+			indices.push_back(corner + GRID_SIZE + 1);
+		}
+	}
+}
+
+/*
+*******************************************************************
+* True if every index is a vertex of the mesh and no triangle has
+* collapsed down to a line
+*******************************************************************
+*/
+
+static bool IsValid(const unsigned long* indices, int numIndices, int numVertices)
+{
+	if(numIndices % 3 != 0)
+		return false;
+
+	for(int i = 0; i < numIndices; i += 3)
+	{
+		unsigned long a = indices[i];
+		unsigned long b = indices[i + 1];
+		unsigned long c = indices[i + 2];
+
+		if(a >= (unsigned long)numVertices || b >= (unsigned long)numVertices || c >= (unsigned long)numVertices)
+			return false;
+		if(a == b || b == c || a == c)
+			return false;
+	}
+	return true;
+}
+
+/*
+*******************************************************************
+* Each level of detail reaches its target and stays in range, and
+* the open border of the grid is never moved
+*******************************************************************
+*/
+
+static void TestTarget()
+{
+	vector<ASTestVertex>  vertices;
+	vector<unsigned long> indices;
+	MakeGrid(vertices, indices, 4.0f);
+
+	int numVertices = (int)vertices.size();
+	int numIndices  = (int)indices.size();
+
+	ASMeshSimplifier simplifier;
+	AS_CHECK(simplifier.Init(&vertices[0], sizeof(ASTestVertex), numVertices, &indices[0], numIndices));
+
+	vector<unsigned long> output(numIndices);
+	float fractions[3] = { 0.5f, 0.25f, 0.125f };
+
+	for(int i = 0; i < 3; i++)
+	{
+		int   target = ((int)(numIndices * fractions[i]) / 3) * 3;
+		float error  = -1.0f;
+		int   count  = simplifier.Simplify(target, 1e30f, &output[0], error);
+
+		AS_CHECK(count > 0);
+		AS_CHECK(count <= target);
+		AS_CHECK(IsValid(&output[0], count, numVertices));
+		AS_CHECK(error >= 0.0f);
+
+		// Every border vertex is still used
+		vector<bool> used(numVertices, false);
+		for(int j = 0; j < count; j++)
+			used[output[j]] = true;
+
+		bool bordersKept = true;
+		for(int j = 0; j < GRID_SIZE; j++)
+		{
+			if(!used[j] || !used[(GRID_SIZE * (GRID_SIZE - 1)) + j] ||
+			   !used[j * GRID_SIZE] || !used[(j * GRID_SIZE) + GRID_SIZE - 1])
+				bordersKept = false;
+		}
+		AS_CHECK(bordersKept);
+	}
+
+	// Asking for the full mesh changes nothing
+	float error = -1.0f;
+	AS_CHECK(simplifier.Simplify(numIndices, 1e30f, &output[0], error) == numIndices);
+	AS_CHECK(output == indices);
+	AS_CHECK(error == 0.0f);
+
+	simplifier.Release();
+}
+
+/*
+*******************************************************************
+* A flat grid collapses for free, a curved one stops short of the
+* target once every collapse left would cost more than allowed
+*******************************************************************
+*/
+
+static void TestMaxError()
+{
+	vector<ASTestVertex>  vertices;
+	vector<unsigned long> indices;
+	vector<unsigned long> output;
+
+	ASMeshSimplifier simplifier;
+	float error;
+	int   target;
+	int   count;
+
+	MakeGrid(vertices, indices, 0.0f);
+	output.resize(indices.size());
+	target = ((int)indices.size() / 6) * 3;
+
+	AS_CHECK(simplifier.Init(&vertices[0], sizeof(ASTestVertex), (int)vertices.size(), &indices[0], (int)indices.size()));
+	count = simplifier.Simplify(target, 1e-6f, &output[0], error);
+	AS_CHECK(count <= target);
+	AS_CHECK(IsValid(&output[0], count, (int)vertices.size()));
+	AS_CHECK_NEAR(error, 0.0f, 1e-6f);
+	simplifier.Release();
+
+	MakeGrid(vertices, indices, 8.0f);
+	target = 3;
+
+	AS_CHECK(simplifier.Init(&vertices[0], sizeof(ASTestVertex), (int)vertices.size(), &indices[0], (int)indices.size()));
+	count = simplifier.Simplify(target, 1e-4f, &output[0], error);
+	AS_CHECK(count > target);
+	AS_CHECK(count <= (int)indices.size());
+	AS_CHECK(IsValid(&output[0], count, (int)vertices.size()));
+	AS_CHECK(error <= 1e-4f);
+	simplifier.Release();
+
+	// Nothing to simplify
+	AS_CHECK(!simplifier.Init(&vertices[0], sizeof(ASTestVertex), (int)vertices.size(), &indices[0], 2));
+}
+
+/*
+*******************************************************************
+* Main
+*******************************************************************
+*/
+
+int main()
+{
+	TestTarget();
+	TestMaxError();
+
+	return ASTest::Finish("ASMeshSimplifierTest");
+}
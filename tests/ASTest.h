@@ -0,0 +1,90 @@
+/*
+******************************************************************
+* ASTest.h
+*******************************************************************
+* The little a test program needs.  Each check that fails prints
+* where it was and what it compared, main() returns the number of
+* failures so make stops on the first program that has any:
+*
+*     AS_CHECK(packer.Pack(0));
+*     AS_CHECK_NEAR(m._11, 1.0f, 1e-5f);
+*     return ASTest::Finish("ASTexturePackerTest");
+*******************************************************************
+*/
+
+#ifndef _ASTEST_H_
+#define _ASTEST_H_
+
+/*
+*******************************************************************
+* Includes:
+*******************************************************************
+*/
+
+#include <stdio.h>
+#include <math.h>
+
+/*
+*******************************************************************
+* Checks
+*******************************************************************
+*/
+
+#define AS_CHECK(condition) \
+	ASTest::Check((condition) ? true : false, #condition, __FILE__, __LINE__)
+
+#define AS_CHECK_NEAR(actual, expected, tolerance) \
+	ASTest::CheckNear((double)(actual), (double)(expected), (double)(tolerance), #actual, __FILE__, __LINE__)
+
+/*
+*******************************************************************
+* Class declaration
+*******************************************************************
+*/
+
+class ASTest
+{
+public:
+	static int& GetFailures()
+	{
+		static int failures = 0;
+		return failures;
+	}
+
+	static int& GetChecks()
+	{
+		static int checks = 0;
+		return checks;
+	}
+
+	static bool Check(bool passed, const char* text, const char* file, int line)
+	{
+		GetChecks()++;
+		if(!passed)
+		{
+			GetFailures()++;
+			printf("%s(%d): failed %s\n", file, line, text);
+		}
+		return passed;
+	}
+
+	static bool CheckNear(double actual, double expected, double tolerance, const char* text, const char* file, int line)
+	{
+		GetChecks()++;
+		if(!(fabs(actual - expected) <= tolerance))
+		{
+			GetFailures()++;
+			printf("%s(%d): %s is %.6f, expected %.6f\n", file, line, text, actual, expected);
+			return false;
+		}
+		return true;
+	}
+
+	static int Finish(const char* name)
+	{
+		printf("%s: %d checks, %d failed\n", name, GetChecks(), GetFailures());
+		return GetFailures();
+	}
+};
+
+#endif
@@ -0,0 +1,221 @@
+/*
+******************************************************************
+* ASTexturePackerTest.cpp
+*******************************************************************
+* Checks the layout of a packed array and that its filters keep
+* every layer to itself, take in every texel of odd sized levels
+* and wrap around the edges when growing a layer
+*******************************************************************
+*/
+
+#include "ASTest.h"
+#include "../ASTexturePacker.h"
+
+/*
+*******************************************************************
+* Fills a width x height image with one value in every channel
+*******************************************************************
+*/
+
+static vector<unsigned char> MakeImage(unsigned int width, unsigned int height, unsigned char value)
+{
+	return vector<unsigned char>(width * height * 4, value);
+}
+
+/*
+*******************************************************************
+* Sets every channel of one pixel
+*******************************************************************
+*/
+
+static void SetPixel(vector<unsigned char>& image, unsigned int width, unsigned int x, unsigned int y, unsigned char value)
+{
+	for(int c = 0; c < 4; c++)
+		image[(((y * width) + x) * 4) + c] = value;
+}
+
+/*
+*******************************************************************
+* Every layer repeats one chain, the levels follow each other from
+* the largest down and the layers follow each other in order
+*******************************************************************
+*/
+
+static void TestLayout()
+{
+	ASTexturePacker packer;
+
+	vector<unsigned char> large = MakeImage(8, 8, 0);
+	vector<unsigned char> small = MakeImage(4, 4, 0);
+
+	AS_CHECK(packer.AddLayer(&large[0], 8, 8, ASTexturePacker::CHANNELS_BGRA));
+	AS_CHECK(packer.AddLayer(&small[0], 4, 4, ASTexturePacker::CHANNELS_BGRA));
+	AS_CHECK(packer.Pack(0));
+
+	// Sized to the largest layer, down to 1x1
+	AS_CHECK(packer.GetLayerCount() == 2);
+	AS_CHECK(packer.GetSize() == 8);
+	AS_CHECK(packer.GetMipCount() == 4);
+	AS_CHECK(packer.GetMipWidth(3) == 1);
+	AS_CHECK(packer.GetMipSize(1) == 4 * 4 * 4);
+	AS_CHECK(packer.GetLayerBytes() == (64 + 16 + 4 + 1) * 4);
+
+	AS_CHECK(packer.GetData(0, 2) - packer.GetData(0, 0) == (64 + 16) * 4);
+	AS_CHECK(packer.GetData(1, 0) - packer.GetData(0, 0) == (int)packer.GetLayerBytes());
+	AS_CHECK(packer.GetData(1, 3) - packer.GetData(1, 0) == (64 + 16 + 4) * 4);
+
+	// Nothing to pack, or a layer the packer can not take
+	packer.Release();
+	AS_CHECK(!packer.Pack(0));
+	AS_CHECK(!packer.AddLayer(&small[0], 4, 4, ASTexturePacker::CHANNELS_NONE));
+	AS_CHECK(!packer.AddLayer(&small[0], 0, 4, ASTexturePacker::CHANNELS_BGRA));
+
+	for(int i = 0; i < ASTexturePacker::MAX_LAYERS; i++)
+		packer.AddLayer(&small[0], 4, 4, ASTexturePacker::CHANNELS_BGRA);
+	AS_CHECK(!packer.AddLayer(&small[0], 4, 4, ASTexturePacker::CHANNELS_BGRA));
+}
+
+/*
+*******************************************************************
+* A white layer between two black ones, no level of any layer may
+* pick up anything from its neighbours
+*******************************************************************
+*/
+
+static void TestSliceIsolation()
+{
+	ASTexturePacker packer;
+
+	vector<unsigned char> black = MakeImage(8, 8, 0);
+	vector<unsigned char> white = MakeImage(8, 8, 255);
+
+	packer.AddLayer(&black[0], 8, 8, ASTexturePacker::CHANNELS_BGRA);
+	packer.AddLayer(&white[0], 8, 8, ASTexturePacker::CHANNELS_BGRA);
+	packer.AddLayer(&black[0], 8, 8, ASTexturePacker::CHANNELS_BGRA);
+	AS_CHECK(packer.Pack(0));
+
+	for(int layer = 0; layer < 3; layer++)
+	{
+		unsigned char expected = (layer == 1) ? 255 : 0;
+		bool          matches  = true;
+
+		for(int mip = 0; mip < packer.GetMipCount(); mip++)
+		{
+			const unsigned char* data = packer.GetData(layer, mip);
+			for(unsigned int i = 0; i < packer.GetMipSize(mip); i++)
+				matches = matches && (data[i] == expected);
+		}
+
+		AS_CHECK(matches);
+	}
+}
+
+/*
+*******************************************************************
+* A 5x5 layer halves to 2x2 and then 1x1.  The only lit texel is
+* in the last row and column, which a filter that rounds the size
+* down would drop.  Texel (1,1) of level 1 covers 0.4 of it each
+* way and level 2 averages level 1's four texels
+*******************************************************************
+*/
+
+static void TestOddSizeMip()
+{
+	ASTexturePacker packer;
+
+	vector<unsigned char> image = MakeImage(5, 5, 0);
+	SetPixel(image, 5, 4, 4, 250);
+
+	packer.AddLayer(&image[0], 5, 5, ASTexturePacker::CHANNELS_BGRA);
+	AS_CHECK(packer.Pack(0));
+	AS_CHECK(packer.GetMipCount() == 3);
+	AS_CHECK(packer.GetMipWidth(1) == 2);
+
+	// Level 0 is the layer as it was
+	AS_CHECK(packer.GetData(0, 0)[(((4 * 5) + 4) * 4)] == 250);
+
+	const unsigned char* level1 = packer.GetData(0, 1);
+	AS_CHECK(level1[0]  == 0);
+	AS_CHECK(level1[4]  == 0);
+	AS_CHECK(level1[8]  == 0);
+	AS_CHECK(level1[12] == 40);
+	AS_CHECK(level1[15] == 40);
+
+	AS_CHECK(packer.GetData(0, 2)[0] == 10);
+}
+
+/*
+*******************************************************************
+* A 2x2 layer grown to 4x4, black on the left and 200 on the right.
+* The first column of the result sits before the centre of the
+* first source texel and blends a quarter of the right hand column
+* back in, clamping to the edge would leave it black
+*******************************************************************
+*/
+
+static void TestEdgeWrap()
+{
+	ASTexturePacker packer;
+
+	vector<unsigned char> image = MakeImage(2, 2, 0);
+	SetPixel(image, 2, 1, 0, 200);
+	SetPixel(image, 2, 1, 1, 200);
+
+	packer.AddLayer(&image[0], 2, 2, ASTexturePacker::CHANNELS_BGRA);
+	AS_CHECK(packer.Pack(4));
+
+	const unsigned char* level0 = packer.GetData(0, 0);
+	for(unsigned int y = 0; y < 4; y++)
+	{
+		const unsigned char* row = level0 + (y * 4 * 4);
+		AS_CHECK(row[0]  == 50);
+		AS_CHECK(row[4]  == 50);
+		AS_CHECK(row[8]  == 150);
+		AS_CHECK(row[12] == 150);
+	}
+}
+
+/*
+*******************************************************************
+* The first layer decides the channel order, an RGBA layer after a
+* BGRA one has red and blue swapped and an X8 layer becomes opaque
+*******************************************************************
+*/
+
+static void TestChannelOrder()
+{
+	ASTexturePacker packer;
+
+	unsigned char bgra[4] = { 1, 2, 3, 4 };
+	unsigned char rgba[4] = { 1, 2, 3, 4 };
+	unsigned char bgrx[4] = { 1, 2, 3, 0 };
+
+	packer.AddLayer(bgra, 1, 1, ASTexturePacker::CHANNELS_BGRA);
+	packer.AddLayer(rgba, 1, 1, ASTexturePacker::CHANNELS_RGBA);
+	packer.AddLayer(bgrx, 1, 1, ASTexturePacker::CHANNELS_BGRX);
+	AS_CHECK(packer.Pack(0));
+	AS_CHECK(packer.GetChannelOrder() == ASTexturePacker::CHANNELS_BGRA);
+
+	const unsigned char* swapped = packer.GetData(1, 0);
+	AS_CHECK(swapped[0] == 3 && swapped[1] == 2 && swapped[2] == 1 && swapped[3] == 4);
+
+	const unsigned char* opaque = packer.GetData(2, 0);
+	AS_CHECK(opaque[0] == 1 && opaque[1] == 2 && opaque[2] == 3 && opaque[3] == 255);
+}
+
+/*
+*******************************************************************
+* Main
+*******************************************************************
+*/
+
+int main()
+{
+	TestLayout();
+	TestSliceIsolation();
+	TestOddSizeMip();
+	TestEdgeWrap();
+	TestChannelOrder();
+
+	return ASTest::Finish("ASTexturePackerTest");
+}
@@ -0,0 +1,218 @@
+/*
+******************************************************************
+* ASTextureResidencyTest.cpp
+*******************************************************************
+* Drives the residency policy over its budget and checks which
+* levels it evicts, in what order, and that the resident total it
+* reports always matches the levels it holds
+*******************************************************************
+*/
+
+#include "ASTest.h"
+#include "../ASTextureResidency.h"
+
+/*
+*******************************************************************
+* Test textures
+*******************************************************************
+*/
+
+// Every test texture is 256x256 BGRA with a full chain, so level 2 (64x64) starts the tail
+static const unsigned int TEXTURE_SIZE = 256;
+static const int          TEXTURE_MIPS = 9;
+
+static const unsigned long long MIP0_BYTES = 256 * 256 * 4;
+static const unsigned long long MIP1_BYTES = 128 * 128 * 4;
+static const unsigned long long TAIL_BYTES = (64 * 64 * 4) + (32 * 32 * 4) + (16 * 16 * 4) +
+											 (8 * 8 * 4) + (4 * 4 * 4) + (2 * 2 * 4) + 4;
+
+/*
+*******************************************************************
+* Adds one test texture
+*******************************************************************
+*/
+
+static int AddTexture(ASTextureResidency& residency)
+{
+	unsigned long long mipBytes[TEXTURE_MIPS];
+
+	for(int i = 0; i < TEXTURE_MIPS; i++)
+	{
+		unsigned int size = TEXTURE_SIZE >> i;
+		mipBytes[i] = size * size * 4;
+	}
+
+	return residency.AddTexture(TEXTURE_SIZE, TEXTURE_SIZE, TEXTURE_MIPS, mipBytes);
+}
+
+/*
+*******************************************************************
+* Adds up the levels every texture says it holds
+*******************************************************************
+*/
+
+static unsigned long long GetHeldBytes(ASTextureResidency& residency)
+{
+	unsigned long long bytes = 0;
+
+	for(int i = 0; i < residency.GetTextureCount(); i++)
+	{
+		int mip = residency.GetResidentMip(i);
+		bytes += TAIL_BYTES;
+		if(mip <= 1) bytes += MIP1_BYTES;
+		if(mip == 0) bytes += MIP0_BYTES;
+	}
+	return bytes;
+}
+
+/*
+*******************************************************************
+* Three textures and room for two at full detail, the one used
+* longest ago loses its levels, most detailed first, and the ones
+* in use this frame keep what they asked for
+*******************************************************************
+*/
+
+static void TestEviction()
+{
+	ASTextureResidency residency;
+	unsigned long long full = MIP0_BYTES + MIP1_BYTES;
+
+	residency.Init((TAIL_BYTES * 3) + (full * 2), 0);
+
+	int a = AddTexture(residency);
+	int b = AddTexture(residency);
+	int c = AddTexture(residency);
+
+	// Only the tails are loaded up front
+	AS_CHECK(residency.GetResidentMip(a) == 2);
+	AS_CHECK(residency.GetStats().residentBytes == TAIL_BYTES * 3);
+
+	// a then b fit the budget
+	residency.RequestMip(a, 0);
+	residency.Update();
+	residency.RequestMip(b, 0);
+	residency.Update();
+
+	AS_CHECK(residency.GetResidentMip(a) == 0);
+	AS_CHECK(residency.GetResidentMip(b) == 0);
+	AS_CHECK(residency.GetStats().numEvictions == 0);
+	AS_CHECK(residency.GetStats().residentBytes == residency.GetStats().budgetBytes);
+
+	// c does not, a was used longest ago and gives up level 0 and then level 1
+	residency.RequestMip(c, 0);
+	residency.Update();
+
+	const ASTextureResidency::ASStats& stats = residency.GetStats();
+	AS_CHECK(residency.GetResidentMip(a) == 2);
+	AS_CHECK(residency.GetResidentMip(b) == 0);
+	AS_CHECK(residency.GetResidentMip(c) == 0);
+	AS_CHECK(residency.HasChanged(a));
+	AS_CHECK(!residency.HasChanged(b));
+	AS_CHECK(stats.numEvictions == 2);
+	AS_CHECK(stats.evictedBytes == full);
+	AS_CHECK(stats.numLoads == 6);
+	AS_CHECK(stats.loadedBytes == full * 3);
+	AS_CHECK(stats.residentBytes == GetHeldBytes(residency));
+	AS_CHECK(stats.residentBytes <= stats.budgetBytes);
+
+	// All three in use, nothing may be taken from b or c so a waits
+	residency.RequestMip(a, 0);
+	residency.RequestMip(b, 0);
+	residency.RequestMip(c, 0);
+	residency.Update();
+
+	AS_CHECK(residency.GetResidentMip(a) == 2);
+	AS_CHECK(residency.GetResidentMip(b) == 0);
+	AS_CHECK(residency.GetResidentMip(c) == 0);
+	AS_CHECK(stats.numEvictions == 2);
+	AS_CHECK(stats.numPending == 1);
+	AS_CHECK(stats.requestedBytes == (TAIL_BYTES * 3) + (full * 3));
+
+	// With c used since, a smaller budget is taken from b first
+	residency.RequestMip(c, 0);
+	residency.Update();
+	residency.SetBudget((TAIL_BYTES * 3) + full);
+	residency.Update();
+
+	AS_CHECK(residency.GetResidentMip(b) == 2);
+	AS_CHECK(residency.GetResidentMip(c) == 0);
+	AS_CHECK(stats.numEvictions == 4);
+	AS_CHECK(stats.evictedBytes == full * 2);
+	AS_CHECK(stats.residentBytes == GetHeldBytes(residency));
+	AS_CHECK(stats.residentBytes == stats.budgetBytes);
+
+	// The tails are never evicted, even with no budget at all
+	residency.SetBudget(0);
+	residency.Update();
+
+	AS_CHECK(residency.GetResidentMip(a) == 2);
+	AS_CHECK(residency.GetResidentMip(b) == 2);
+	AS_CHECK(residency.GetResidentMip(c) == 2);
+	AS_CHECK(stats.residentBytes == TAIL_BYTES * 3);
+	AS_CHECK(stats.evictedBytes == full * 3);
+}
+
+/*
+*******************************************************************
+* The upload limit spreads a texture's loads over several frames,
+* the first load of a frame always goes through
+*******************************************************************
+*/
+
+static void TestUploadLimit()
+{
+	ASTextureResidency residency;
+
+	residency.Init(MIP0_BYTES * 4, MIP1_BYTES);
+
+	int a = AddTexture(residency);
+
+	residency.RequestMip(a, 0);
+	residency.Update();
+	AS_CHECK(residency.GetResidentMip(a) == 1);
+	AS_CHECK(residency.GetStats().numPending == 1);
+
+	residency.RequestMip(a, 0);
+	residency.Update();
+	AS_CHECK(residency.GetResidentMip(a) == 0);
+	AS_CHECK(residency.GetStats().numPending == 0);
+	AS_CHECK(residency.GetStats().residentBytes == TAIL_BYTES + MIP1_BYTES + MIP0_BYTES);
+
+	// Putting a level back by hand keeps the total right
+	residency.SetResidentMip(a, 1);
+	AS_CHECK(residency.GetStats().residentBytes == TAIL_BYTES + MIP1_BYTES);
+}
+
+/*
+*******************************************************************
+* Choosing a level from the screen size and finding the tail
+*******************************************************************
+*/
+
+static void TestSelectMip()
+{
+	AS_CHECK(ASTextureResidency::SelectMip(256, 256, TEXTURE_MIPS, 512.0f) == 0);
+	AS_CHECK(ASTextureResidency::SelectMip(256, 256, TEXTURE_MIPS, 128.0f) == 1);
+	AS_CHECK(ASTextureResidency::SelectMip(256, 256, TEXTURE_MIPS, 100.0f) == 1);
+	AS_CHECK(ASTextureResidency::SelectMip(256, 256, TEXTURE_MIPS, 0.5f) == TEXTURE_MIPS - 1);
+
+	AS_CHECK(ASTextureResidency::GetTailMip(256, 256, TEXTURE_MIPS) == 2);
+	AS_CHECK(ASTextureResidency::GetTailMip(512, 64, 10) == 3);
+	AS_CHECK(ASTextureResidency::GetTailMip(32, 32, 6) == 0);
+}
+
+/*
+*******************************************************************
+* Main
+*******************************************************************
+*/
+
+int main()
+{
+	TestEviction();
+	TestUploadLimit();
+	TestSelectMip();
+
+	return ASTest::Finish("ASTextureResidencyTest");
+}